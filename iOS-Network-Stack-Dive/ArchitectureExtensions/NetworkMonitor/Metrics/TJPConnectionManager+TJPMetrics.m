@@ -12,6 +12,10 @@
 
 #import "TJPMetricsCollector.h"
 
+@interface TJPConnectionManager (TJPMetricsPrivate)
+// 内部写合并刷新方法
+- (void)writeCoalescedData:(dispatch_data_t)data frameCount:(NSUInteger)frameCount withTimeout:(NSTimeInterval)timeout tag:(long)tag;
+@end
 
 @implementation TJPConnectionManager (TJPMetrics)
 + (void)initialize {
@@ -27,6 +31,9 @@
         
         [self swizzleMethod:@selector(socket:didConnectToHost:port:)
                  withMethod:@selector(metrics_socket:didConnectToHost:port:)];
+        
+        [self swizzleMethod:@selector(writeCoalescedData:frameCount:withTimeout:tag:)
+                 withMethod:@selector(metrics_writeCoalescedData:frameCount:withTimeout:tag:)];
     });
 }
 
@@ -61,4 +68,16 @@
     [[TJPMetricsCollector sharedInstance] incrementCounter:TJPMetricsKeyConnectionSuccess];
     [self metrics_socket:sock didConnectToHost:host port:port];
 }
+
+// 写合并刷新 每次刷新对应一次写系统调用
+- (void)metrics_writeCoalescedData:(dispatch_data_t)data frameCount:(NSUInteger)frameCount withTimeout:(NSTimeInterval)timeout tag:(long)tag {
+    TJPMetricsCollector *metrics = [TJPMetricsCollector sharedInstance];
+    [metrics incrementCounter:TJPMetricsKeyWriteCoalescedFlushes];
+    [metrics incrementCounter:TJPMetricsKeyWriteCoalescedFrames by:frameCount];
+    [metrics recordEvent:TJPMetricsEventWriteCoalescedFlush withParameters:@{
+        @"frames": @(frameCount),
+        @"bytes": @(dispatch_data_get_size(data))
+    }];
+    [self metrics_writeCoalescedData:data frameCount:frameCount withTimeout:timeout tag:tag];
+}
 @end
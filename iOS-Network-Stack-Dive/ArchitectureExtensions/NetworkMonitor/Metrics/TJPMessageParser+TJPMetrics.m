@@ -20,6 +20,7 @@
     dispatch_once(&onceToken, ^{
         [self swizzleFeedData];
         [self swizzleNextPacket];
+        [self swizzleDrainPackets];
         [self swizzleReset];
     });
 }
@@ -49,6 +50,18 @@
     method_exchangeImplementations(originMethod, swizzledMethod);
 }
 
++ (void)swizzleDrainPackets {
+    Class class = [self class];
+    
+    SEL originSEL = @selector(drainPacketsWithLimit:);
+    SEL swizzledSEL = @selector(metrics_drainPacketsWithLimit:);
+    
+    Method originMethod = class_getInstanceMethod(class, originSEL);
+    Method swizzledMethod = class_getInstanceMethod(class, swizzledSEL);
+    
+    method_exchangeImplementations(originMethod, swizzledMethod);
+}
+
 + (void)swizzleReset {
     Class class = [self class];
     
@@ -74,7 +87,7 @@
     TJPMetricsCollector *metrics = [TJPMetricsCollector sharedInstance];
     
     // 记录缓冲区状态
-    [metrics addValue:self.buffer.length forKey:TJPMetricsKeyParsedBufferSize];
+    [metrics addValue:self.usedBufferSize forKey:TJPMetricsKeyParsedBufferSize];
     
     NSTimeInterval start = CACurrentMediaTime();
     TJPParsedPacket *packet = [self metrics_nextPacket];
@@ -101,9 +114,39 @@
     return packet;
 }
 
+- (NSArray<TJPParsedPacket *> *)metrics_drainPacketsWithLimit:(NSUInteger)limit {
+    TJPMetricsCollector *metrics = [TJPMetricsCollector sharedInstance];
+    
+    // 记录缓冲区状态
+    [metrics addValue:self.usedBufferSize forKey:TJPMetricsKeyParsedBufferSize];
+    
+    // 整批只记录一次耗时样本
+    NSTimeInterval start = CACurrentMediaTime();
+    NSArray<TJPParsedPacket *> *packets = [self metrics_drainPacketsWithLimit:limit];
+    NSTimeInterval duration = CACurrentMediaTime() - start;
+    
+    if (packets.count > 0) {
+        NSUInteger payloadBytes = 0;
+        for (TJPParsedPacket *packet in packets) {
+            payloadBytes += packet.payload.length;
+        }
+        [metrics addTimeSample:duration forKey:TJPMetricsKeyParsedPacketsTime];
+        [metrics incrementCounter:TJPMetricsKeyParsedPackets by:packets.count];
+        [metrics incrementCounter:TJPMetricsKeyPayloadBytes by:payloadBytes];
+    }
+    
+    if (self.currentState == TJPParseStateError) {
+        // 解析失败埋点
+        [metrics incrementCounter:TJPMetricsKeyParseErrors];
+        [metrics addTimeSample:duration forKey:TJPMetricsKeyParsedErrorsTime];
+    }
+    
+    return packets;
+}
+
 - (void)metrics_reset {
     // 记录异常重置事件
-    if (self.buffer.length > 0) {
+    if (self.usedBufferSize > 0) {
         [[TJPMetricsCollector sharedInstance] incrementCounter:TJPMetricsKeyParserResets];
     }
     [self metrics_reset];
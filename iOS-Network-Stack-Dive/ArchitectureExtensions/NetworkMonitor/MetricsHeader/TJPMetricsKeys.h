@@ -15,6 +15,11 @@ extern NSString * const TJPMetricsKeyConnectionSuccess;
 #pragma mark - 网络相关指标
 extern NSString * const TJPMetricsKeyRTT;                       // 通用RTT指标(s)
 
+#pragma mark - 写合并指标
+extern NSString * const TJPMetricsKeyWriteCoalescedFlushes;     // 合并写次数(即写系统调用次数)
+extern NSString * const TJPMetricsKeyWriteCoalescedFrames;      // 经合并写出的帧总数
+extern NSString * const TJPMetricsEventWriteCoalescedFlush;     // 单次合并写事件 参数包含帧数和字节数
+
 #pragma mark - 心跳指标相关
 // 基本计数指标
 extern NSString * const TJPMetricsKeyHeartbeatSend;             // 心跳发送次数
@@ -15,6 +15,11 @@ NSString * const TJPMetricsKeyConnectionSuccess = @"connection_success";
 #pragma mark - 网络相关指标
 NSString * const TJPMetricsKeyRTT = @"rtt";
 
+#pragma mark - 写合并指标
+NSString * const TJPMetricsKeyWriteCoalescedFlushes = @"write_coalesced_flushes";
+NSString * const TJPMetricsKeyWriteCoalescedFrames = @"write_coalesced_frames";
+NSString * const TJPMetricsEventWriteCoalescedFlush = @"write_coalesced_flush";
+
 
 #pragma mark - 心跳相关指标
 NSString * const TJPMetricsKeyHeartbeatSend = @"heartbeat_send";
@@ -15,6 +15,18 @@ NS_ASSUME_NONNULL_BEGIN
 /// 组装数据包
 + (NSData *)buildPacketWithMessageType:(TJPMessageType)msgType sequence:(uint32_t)sequence payload:(NSData *)payload encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionID:(NSString *)sessionID;
 
+/// 组装数据包 协议头与载荷分段组成dispatch_data 不拷贝载荷
++ (nullable dispatch_data_t)buildPacketDataWithMessageType:(TJPMessageType)msgType sequence:(uint32_t)sequence payload:(nullable NSData *)payload encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionID:(NSString *)sessionID;
+
+/// 构建协议头 时间戳取当前时间 字段均为网络字节序
++ (TJPFinalAdavancedHeader)headerWithMessageType:(TJPMessageType)msgType sequence:(uint32_t)sequence bodyLength:(uint32_t)bodyLength checksum:(uint32_t)checksum encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionID:(uint16_t)sessionID;
+
+/// 将载荷包装为dispatch_data 不拷贝 dispatch_data持有载荷
++ (dispatch_data_t)dispatchDataWithPayload:(NSData *)payload;
+
+/// 拼接协议头与已包装的载荷 重传时复用载荷段
++ (dispatch_data_t)packetDataWithHeader:(TJPFinalAdavancedHeader)header payloadData:(dispatch_data_t)payloadData;
+
 + (uint16_t)sessionIDFromUUID:(NSString *)uuidString;
 @end
 
@@ -23,6 +23,39 @@
         return nil;
     }
     
+    // 计算数据体的CRC32
+    uint32_t checksum = 0;
+    if (payload.length > 0) {
+        checksum = [TJPNetworkUtil crc32ForData:payload];
+    }
+    TJPFinalAdavancedHeader header = [self headerWithMessageType:msgType sequence:sequence bodyLength:(uint32_t)payload.length checksum:checksum encryptType:encryptType compressType:compressType sessionID:[self sessionIDFromUUID:sessionID]];
+    
+    // 构建完整协议包
+    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packet appendData:payload];
+    return packet;
+}
+
++ (dispatch_data_t)buildPacketDataWithMessageType:(TJPMessageType)msgType sequence:(uint32_t)sequence payload:(NSData *)payload encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionID:(NSString *)sessionID {
+    if (!payload) {
+        payload = [NSData data];
+    }
+    
+    if (payload.length > TJPMAX_BODY_SIZE) {
+        TJPLOG_ERROR(@"负载数据过大: %lu > %d", (unsigned long)payload.length, TJPMAX_BODY_SIZE);
+        return nil;
+    }
+    
+    uint32_t checksum = 0;
+    if (payload.length > 0) {
+        checksum = [TJPNetworkUtil crc32ForData:payload];
+    }
+    TJPFinalAdavancedHeader header = [self headerWithMessageType:msgType sequence:sequence bodyLength:(uint32_t)payload.length checksum:checksum encryptType:encryptType compressType:compressType sessionID:[self sessionIDFromUUID:sessionID]];
+    
+    return [self packetDataWithHeader:header payloadData:[self dispatchDataWithPayload:payload]];
+}
+
++ (TJPFinalAdavancedHeader)headerWithMessageType:(TJPMessageType)msgType sequence:(uint32_t)sequence bodyLength:(uint32_t)bodyLength checksum:(uint32_t)checksum encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionID:(uint16_t)sessionID {
     // 初始化协议头
     TJPFinalAdavancedHeader header = {0};
     //网络字节序转换
@@ -31,25 +64,31 @@
     header.version_minor = kProtocolVersionMinor;
     header.msgType = htons(msgType);
     header.sequence = htonl(sequence);
-    header.timestamp = htonl((uint32_t)[[NSDate date] timeIntervalSince1970]); // 当前时间戳
+    header.timestamp = htonl((uint32_t)time(NULL)); // 当前时间戳
     header.encrypt_type = encryptType;
     header.compress_type = compressType;
-    header.session_id = htons([self sessionIDFromUUID:sessionID]);
-
+    header.session_id = htons(sessionID);
+    header.bodyLength = htonl(bodyLength);
+    header.checksum = htonl(checksum);  // 注意要转换为网络字节序
     
-    header.bodyLength = htonl((uint32_t)payload.length);
-    
-    // 计算数据体的CRC32
-     uint32_t checksum = 0;
-     if (payload.length > 0) {
-         checksum = [TJPNetworkUtil crc32ForData:payload];
-     }
-     header.checksum = htonl(checksum);  // 注意要转换为网络字节序
-    
-    // 构建完整协议包
-    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
-    [packet appendData:payload];
-    return packet;
+    return header;
+}
+
++ (dispatch_data_t)dispatchDataWithPayload:(NSData *)payload {
+    if (payload.length == 0) {
+        return dispatch_data_empty;
+    }
+    // 可变数据先固定内容 不可变数据copy无开销
+    NSData *immutablePayload = [payload copy];
+    return dispatch_data_create(immutablePayload.bytes, immutablePayload.length, NULL, ^{
+        (void)immutablePayload;
+    });
+}
+
++ (dispatch_data_t)packetDataWithHeader:(TJPFinalAdavancedHeader)header payloadData:(dispatch_data_t)payloadData {
+    // 协议头只有28字节 拷贝一份 载荷段直接引用
+    dispatch_data_t headerData = dispatch_data_create(&header, sizeof(header), NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+    return dispatch_data_create_concat(headerData, payloadData);
 }
 
 // 从UUID字符串生成16位会话ID
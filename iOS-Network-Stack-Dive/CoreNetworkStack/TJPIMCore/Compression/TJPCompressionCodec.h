@@ -0,0 +1,69 @@
+//
+//  TJPCompressionCodec.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/15.
+//  消息体zlib压缩
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 会话级zlib编解码器
+ *
+ * 设计说明：
+ * - 每个实例持有一个deflate流和一个inflate流 首次使用时初始化 之后每条消息只做Reset
+ *   避免每条消息重复分配zlib内部约256KB的窗口和哈希表
+ * - 每条消息独立压缩(Z_FINISH) 不依赖前序消息 重传和乱序不影响解压
+ * - 低于阈值的载荷、图片音视频等已压缩内容直接跳过 压缩收益不足时也按原文发送
+ * - 解压输出有上限 超出即中止 防止压缩炸弹
+ * - 可选预置字典 压缩前以字典填充窗口 短消息也有历史可引用 消息之间仍互不依赖
+ *   解压端按流头部的字典ID自动选择字典 无需单独配置
+ * - 非线程安全 发送端由会话在sessionQueue使用 接收端由解析器在解析队列使用
+ */
+@interface TJPCompressionCodec : NSObject
+
+/// 低于该长度的载荷不压缩 默认TJP_COMPRESSION_MIN_SIZE
+@property (nonatomic, assign) NSUInteger minimumLength;
+/// 解压输出上限 默认TJP_COMPRESSION_MAX_INFLATED_SIZE
+@property (nonatomic, assign) NSUInteger maximumInflatedLength;
+/// 压缩使用的预置字典 nil表示不使用 由对端协商结果决定
+@property (nonatomic, strong, nullable) NSData *presetDictionary;
+
+
+/// 初始化方法
+/// - Parameter level: zlib压缩级别 0-9 传-1使用zlib默认级别
+- (instancetype)initWithCompressionLevel:(int)level;
+
+/// 判断载荷是否值得压缩 只检查长度和内容类型 不实际压缩
+- (BOOL)shouldCompressData:(NSData *)data;
+
+/// 压缩载荷 不值得压缩或压缩后收益不足时返回nil
+/// - Parameters:
+///   - data: 原始载荷
+///   - cpuTime: 输出本次压缩占用的CPU时间(秒) 跳过时为0
+- (nullable NSData *)compressData:(NSData *)data cpuTime:(nullable NSTimeInterval *)cpuTime;
+
+/// 解压载荷 数据损坏或输出超过上限时返回nil
+- (nullable NSData *)decompressData:(NSData *)data error:(NSError **)error;
+
+/// 解压分为两段的载荷 用于环形缓冲区跨越尾部的读取视图 不做拼接拷贝
+/// - Parameters:
+///   - firstBytes: 第一段
+///   - firstLength: 第一段长度
+///   - secondBytes: 第二段 可为NULL
+///   - secondLength: 第二段长度
+///   - error: 错误信息
+- (nullable NSData *)decompressBytes:(const void *)firstBytes length:(NSUInteger)firstLength secondBytes:(nullable const void *)secondBytes length:(NSUInteger)secondLength error:(NSError **)error;
+
+/// 清除预置字典和压缩阈值设置 重置压缩流 用于断线和会话复用
+- (void)reset;
+
+/// 统计信息 压缩/跳过/解压消息数、字节数、CPU时间、拒绝的压缩炸弹数
+- (NSDictionary *)statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
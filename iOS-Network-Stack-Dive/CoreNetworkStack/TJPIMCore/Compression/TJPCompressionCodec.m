@@ -0,0 +1,333 @@
+//
+//  TJPCompressionCodec.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/15.
+//
+
+#import "TJPCompressionCodec.h"
+#import <zlib.h>
+#import <time.h>
+#import "TJPNetworkDefine.h"
+#import "TJPErrorUtil.h"
+#import "TJPCompressionDictionary.h"
+
+// 解压输出缓冲区初始倍数 不足时翻倍 不超过上限
+static const NSUInteger kTJPInflateInitialRatio = 4;
+// 内容类型标签之后的Value偏移 Tag(2)+Length(4)
+static const NSUInteger kTJPContentValueOffset = 6;
+
+/// 已压缩格式的文件头 命中时跳过压缩
+static BOOL TJPHasCompressedSignature(const uint8_t *bytes, NSUInteger length) {
+    if (length < 4) {
+        return NO;
+    }
+    // JPEG / PNG / GIF / ZIP / GZIP
+    if (bytes[0] == 0xFF && bytes[1] == 0xD8 && bytes[2] == 0xFF) return YES;
+    if (bytes[0] == 0x89 && bytes[1] == 'P' && bytes[2] == 'N' && bytes[3] == 'G') return YES;
+    if (bytes[0] == 'G' && bytes[1] == 'I' && bytes[2] == 'F' && bytes[3] == '8') return YES;
+    if (bytes[0] == 'P' && bytes[1] == 'K' && bytes[2] == 0x03 && bytes[3] == 0x04) return YES;
+    if (bytes[0] == 0x1F && bytes[1] == 0x8B) return YES;
+    // zlib流 CMF=0x78且头部校验通过
+    if (bytes[0] == 0x78 && ((bytes[0] << 8) | bytes[1]) % 31 == 0) return YES;
+    // MP3(ID3)
+    if (bytes[0] == 'I' && bytes[1] == 'D' && bytes[2] == '3') return YES;
+    if (length < 12) {
+        return NO;
+    }
+    // MP4/MOV/HEIC/M4A 第4字节起为ftyp
+    if (memcmp(bytes + 4, "ftyp", 4) == 0) return YES;
+    // WebP / WAV之外的RIFF容器
+    if (memcmp(bytes, "RIFF", 4) == 0 && memcmp(bytes + 8, "WEBP", 4) == 0) return YES;
+    return NO;
+}
+
+static inline uint64_t TJPThreadCPUTimeNanoseconds(void) {
+    return clock_gettime_nsec_np(CLOCK_THREAD_CPUTIME_ID);
+}
+
+@implementation TJPCompressionCodec {
+    int _level;
+    z_stream _deflateStream;
+    z_stream _inflateStream;
+    BOOL _deflateReady;
+    BOOL _inflateReady;
+    
+    // 统计
+    NSUInteger _compressedCount;
+    NSUInteger _dictionaryCount;
+    NSUInteger _skippedCount;
+    uint64_t _compressInputBytes;
+    uint64_t _compressOutputBytes;
+    uint64_t _compressCPUNanoseconds;
+    NSUInteger _inflatedCount;
+    uint64_t _inflateInputBytes;
+    uint64_t _inflateOutputBytes;
+    uint64_t _inflateCPUNanoseconds;
+    NSUInteger _rejectedCount;
+}
+
+- (instancetype)init {
+    return [self initWithCompressionLevel:Z_DEFAULT_COMPRESSION];
+}
+
+- (instancetype)initWithCompressionLevel:(int)level {
+    if (self = [super init]) {
+        _level = level;
+        _minimumLength = TJP_COMPRESSION_MIN_SIZE;
+        _maximumInflatedLength = TJP_COMPRESSION_MAX_INFLATED_SIZE;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_deflateReady) {
+        deflateEnd(&_deflateStream);
+    }
+    if (_inflateReady) {
+        inflateEnd(&_inflateStream);
+    }
+}
+
+#pragma mark - Compress
+- (BOOL)shouldCompressData:(NSData *)data {
+    // 下面需要读取两字节内容标签 不依赖minimumLength的取值
+    if (data.length < 2 || data.length < self.minimumLength) {
+        return NO;
+    }
+    
+    const uint8_t *bytes = data.bytes;
+    // 业务消息为TLV 图片音视频内容直接跳过
+    uint16_t contentTag = (uint16_t)((bytes[0] << 8) | bytes[1]);
+    if (contentTag == TJPContentTypeImage || contentTag == TJPContentTypeAudio || contentTag == TJPContentTypeVideo) {
+        return NO;
+    }
+    
+    // 裸数据或TLV包裹的已压缩格式
+    if (TJPHasCompressedSignature(bytes, data.length)) {
+        return NO;
+    }
+    if (data.length > kTJPContentValueOffset && TJPHasCompressedSignature(bytes + kTJPContentValueOffset, data.length - kTJPContentValueOffset)) {
+        return NO;
+    }
+    return YES;
+}
+
+- (nullable NSData *)compressData:(NSData *)data cpuTime:(nullable NSTimeInterval *)cpuTime {
+    if (cpuTime) {
+        *cpuTime = 0;
+    }
+    if (![self shouldCompressData:data] || data.length > UINT_MAX) {
+        _skippedCount++;
+        return nil;
+    }
+    if (![self prepareDeflateStream]) {
+        return nil;
+    }
+    
+    uint64_t start = TJPThreadCPUTimeNanoseconds();
+    
+    // 字典需在每次Reset之后、首次deflate之前设置
+    NSData *dictionary = self.presetDictionary;
+    if (dictionary && deflateSetDictionary(&_deflateStream, dictionary.bytes, (uInt)dictionary.length) != Z_OK) {
+        TJPLOG_WARN(@"[TJPCompressionCodec] 预置字典设置失败，不使用字典压缩");
+        dictionary = nil;
+    }
+    
+    // 只接受有收益的结果 输出缓冲区按收益下限分配 放不下即说明不值得压缩
+    NSUInteger limit = (NSUInteger)(data.length * (1.0 - TJP_COMPRESSION_MIN_SAVING));
+    NSMutableData *output = [NSMutableData dataWithLength:limit];
+    
+    _deflateStream.next_in = (Bytef *)data.bytes;
+    _deflateStream.avail_in = (uInt)data.length;
+    _deflateStream.next_out = output.mutableBytes;
+    _deflateStream.avail_out = (uInt)limit;
+    int status = deflate(&_deflateStream, Z_FINISH);
+    NSUInteger produced = limit - _deflateStream.avail_out;
+    deflateReset(&_deflateStream);
+    
+    uint64_t elapsed = TJPThreadCPUTimeNanoseconds() - start;
+    _compressCPUNanoseconds += elapsed;
+    if (cpuTime) {
+        *cpuTime = elapsed / (double)NSEC_PER_SEC;
+    }
+    
+    if (status != Z_STREAM_END) {
+        // Z_OK或Z_BUF_ERROR表示输出超出收益下限
+        _skippedCount++;
+        TJPLOG_DEBUG(@"[TJPCompressionCodec] 压缩收益不足，按原文发送，长度: %lu", (unsigned long)data.length);
+        return nil;
+    }
+    
+    output.length = produced;
+    _compressedCount++;
+    if (dictionary) {
+        _dictionaryCount++;
+    }
+    _compressInputBytes += data.length;
+    _compressOutputBytes += produced;
+    return output;
+}
+
+- (BOOL)prepareDeflateStream {
+    if (_deflateReady) {
+        return YES;
+    }
+    memset(&_deflateStream, 0, sizeof(_deflateStream));
+    if (deflateInit(&_deflateStream, _level) != Z_OK) {
+        TJPLOG_ERROR(@"[TJPCompressionCodec] deflate流初始化失败");
+        return NO;
+    }
+    _deflateReady = YES;
+    return YES;
+}
+
+#pragma mark - Decompress
+- (nullable NSData *)decompressData:(NSData *)data error:(NSError **)error {
+    return [self decompressBytes:data.bytes length:data.length secondBytes:NULL length:0 error:error];
+}
+
+- (nullable NSData *)decompressBytes:(const void *)firstBytes length:(NSUInteger)firstLength secondBytes:(nullable const void *)secondBytes length:(NSUInteger)secondLength error:(NSError **)error {
+    NSUInteger inputLength = firstLength + secondLength;
+    if (inputLength == 0 || inputLength > UINT_MAX) {
+        [self fillError:error code:TJPErrorProtocolDecompressionFailed description:@"压缩数据长度无效"];
+        return nil;
+    }
+    if (![self prepareInflateStream]) {
+        [self fillError:error code:TJPErrorProtocolDecompressionFailed description:@"解压流初始化失败"];
+        return nil;
+    }
+    
+    uint64_t start = TJPThreadCPUTimeNanoseconds();
+    NSUInteger maxLength = self.maximumInflatedLength;
+    NSUInteger capacity = MIN(MAX(inputLength * kTJPInflateInitialRatio, (NSUInteger)4096), maxLength);
+    NSMutableData *output = [NSMutableData dataWithLength:capacity];
+    
+    const Bytef *segments[2] = {firstBytes, secondBytes};
+    NSUInteger segmentLengths[2] = {firstLength, secondLength};
+    NSUInteger segmentIndex = 0;
+    NSUInteger produced = 0;
+    int status = Z_OK;
+    
+    while (status != Z_STREAM_END) {
+        // 当前段读完后切换到下一段
+        if (_inflateStream.avail_in == 0) {
+            while (segmentIndex < 2 && segmentLengths[segmentIndex] == 0) {
+                segmentIndex++;
+            }
+            if (segmentIndex >= 2) {
+                status = Z_DATA_ERROR;  // 输入耗尽但流未结束
+                break;
+            }
+            _inflateStream.next_in = (Bytef *)segments[segmentIndex];
+            _inflateStream.avail_in = (uInt)segmentLengths[segmentIndex];
+            segmentIndex++;
+        }
+        
+        if (produced == output.length) {
+            if (output.length >= maxLength) {
+                status = Z_MEM_ERROR;   // 超出上限
+                break;
+            }
+            output.length = MIN(output.length * 2, maxLength);
+        }
+        
+        _inflateStream.next_out = (Bytef *)output.mutableBytes + produced;
+        _inflateStream.avail_out = (uInt)(output.length - produced);
+        NSUInteger before = _inflateStream.avail_out;
+        status = inflate(&_inflateStream, Z_NO_FLUSH);
+        produced += before - _inflateStream.avail_out;
+        
+        if (status == Z_NEED_DICT) {
+            // 流头部携带字典ID 按ID选择预置字典
+            NSData *dictionary = [TJPCompressionDictionary dictionaryForId:(uint32_t)_inflateStream.adler];
+            if (!dictionary) {
+                TJPLOG_ERROR(@"[TJPCompressionCodec] 未知的压缩字典ID: 0x%08lX", (unsigned long)_inflateStream.adler);
+                break;
+            }
+            status = inflateSetDictionary(&_inflateStream, dictionary.bytes, (uInt)dictionary.length);
+        } else if (status == Z_BUF_ERROR) {
+            status = Z_OK;  // 需要更多输入或输出空间 继续循环
+        } else if (status != Z_OK && status != Z_STREAM_END) {
+            break;
+        }
+    }
+    
+    // 流结束后仍有剩余输入视为格式错误
+    BOOL trailingData = _inflateStream.avail_in > 0;
+    for (NSUInteger i = segmentIndex; i < 2; i++) {
+        trailingData = trailingData || segmentLengths[i] > 0;
+    }
+    inflateReset(&_inflateStream);
+    _inflateCPUNanoseconds += TJPThreadCPUTimeNanoseconds() - start;
+    
+    if (status == Z_MEM_ERROR) {
+        _rejectedCount++;
+        TJPLOG_WARN(@"[TJPCompressionCodec] 解压输出超过上限 %lu 字节，已中止，压缩长度: %lu", (unsigned long)maxLength, (unsigned long)inputLength);
+        [self fillError:error code:TJPErrorProtocolDecompressedTooLarge description:@"解压后长度超过限制"];
+        return nil;
+    }
+    if (status != Z_STREAM_END || trailingData) {
+        TJPLOG_ERROR(@"[TJPCompressionCodec] 解压失败，zlib状态: %d", status);
+        [self fillError:error code:TJPErrorProtocolDecompressionFailed description:@"压缩数据损坏"];
+        return nil;
+    }
+    
+    output.length = produced;
+    _inflatedCount++;
+    _inflateInputBytes += inputLength;
+    _inflateOutputBytes += produced;
+    return output;
+}
+
+- (BOOL)prepareInflateStream {
+    if (_inflateReady) {
+        return YES;
+    }
+    memset(&_inflateStream, 0, sizeof(_inflateStream));
+    if (inflateInit(&_inflateStream) != Z_OK) {
+        TJPLOG_ERROR(@"[TJPCompressionCodec] inflate流初始化失败");
+        return NO;
+    }
+    _inflateReady = YES;
+    return YES;
+}
+
+- (void)fillError:(NSError **)error code:(TJPNetworkError)code description:(NSString *)description {
+    if (error) {
+        *error = [TJPErrorUtil errorWithCode:code description:description userInfo:@{}];
+    }
+}
+
+#pragma mark - Reset
+- (void)reset {
+    self.presetDictionary = nil;
+    self.minimumLength = TJP_COMPRESSION_MIN_SIZE;
+    if (_deflateReady) {
+        deflateReset(&_deflateStream);
+    }
+    if (_inflateReady) {
+        inflateReset(&_inflateStream);
+    }
+}
+
+#pragma mark - Statistics
+- (NSDictionary *)statistics {
+    double ratio = _compressInputBytes > 0 ? (double)_compressOutputBytes / _compressInputBytes : 1.0;
+    return @{
+        @"compressedMessages": @(_compressedCount),
+        @"dictionaryMessages": @(_dictionaryCount),
+        @"skippedMessages": @(_skippedCount),
+        @"compressInputBytes": @(_compressInputBytes),
+        @"compressOutputBytes": @(_compressOutputBytes),
+        @"compressionRatio": @(ratio),
+        @"compressCPUTime": @(_compressCPUNanoseconds / (double)NSEC_PER_SEC),
+        @"inflatedMessages": @(_inflatedCount),
+        @"inflateInputBytes": @(_inflateInputBytes),
+        @"inflateOutputBytes": @(_inflateOutputBytes),
+        @"inflateCPUTime": @(_inflateCPUNanoseconds / (double)NSEC_PER_SEC),
+        @"rejectedMessages": @(_rejectedCount)
+    };
+}
+
+@end
@@ -0,0 +1,34 @@
+//
+//  TJPCompressionDictionary.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/16.
+//  压缩预置字典
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * zlib预置字典
+ *
+ * 设计说明：
+ * - 短文本消息单独压缩时 deflate窗口为空 几乎没有可引用的历史 预置字典提供常见聊天用语、
+ *   业务字段名和文本消息TLV头作为初始窗口
+ * - 压缩流头部携带字典的Adler-32作为字典ID 接收端据此选择字典 不需要额外协议字段
+ * - 字典内容一经发布不可修改 修改会改变字典ID 新版本需新增字典并保留旧版本用于解压
+ */
+@interface TJPCompressionDictionary : NSObject
+
+/// 默认字典 按出现频率从低到高排列 越常用越靠后
++ (NSData *)defaultDictionary;
+
+/// 默认字典ID 即字典内容的Adler-32
++ (uint32_t)defaultDictionaryId;
+
+/// 按字典ID查找字典 未知ID返回nil
++ (nullable NSData *)dictionaryForId:(uint32_t)dictionaryId;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,56 @@
+//
+//  TJPCompressionDictionary.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/16.
+//
+
+#import "TJPCompressionDictionary.h"
+#import <zlib.h>
+#import "TJPCoreTypes.h"
+
+// 按频率从低到高 deflate从窗口末尾起的距离越短编码越省
+static NSString * const kTJPDefaultDictionaryText =
+    @"\"groupId\":\"\"userId\":\"\"to\":\"\"from\":\"\"timestamp\":\"msgId\":\"{\"type\":\"text\",\"content\":\""
+    @"https://www.http://.com.cn .jpg.png"
+    @"meeting tomorrow today tonight weekend where when what time how about let me know on my way "
+    @"good morning good night see you later talk to you later no problem of course sounds good "
+    @"I'm not sure do you have a moment can you please thank you very much sorry for the late reply "
+    @"okay ok yes no sure got it thanks hello hi hey haha lol "
+    @"开会 下班 上班 吃饭 一起 地方 时间 已经 还是 就是 不是 没有 那个 这个 一下 知道 可以 "
+    @"现在 明天 今天 为什么 怎么 什么 他们 你们 我们 我们一起 你在哪 到了吗 等一下 稍等 马上 "
+    @"对的 是的 哦哦 嗯嗯 辛苦了 早上好 晚安 在吗 不客气 没问题 谢谢 好的收到 收到 好的 你好 哈哈哈哈 ";
+
+@implementation TJPCompressionDictionary
+
++ (NSData *)defaultDictionary {
+    static NSData *dictionary;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableData *data = [[kTJPDefaultDictionaryText dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+        // 文本消息TLV头 Tag + Length高位 几乎每条消息都以此开头 放在最末
+        uint8_t textTLVPrefix[] = {(uint8_t)(TJPContentTypeText >> 8), (uint8_t)(TJPContentTypeText & 0xFF), 0x00, 0x00, 0x00};
+        [data appendBytes:textTLVPrefix length:sizeof(textTLVPrefix)];
+        dictionary = [data copy];
+    });
+    return dictionary;
+}
+
++ (uint32_t)defaultDictionaryId {
+    static uint32_t dictionaryId;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSData *dictionary = [self defaultDictionary];
+        dictionaryId = (uint32_t)adler32(adler32(0L, Z_NULL, 0), dictionary.bytes, (uInt)dictionary.length);
+    });
+    return dictionaryId;
+}
+
++ (nullable NSData *)dictionaryForId:(uint32_t)dictionaryId {
+    if (dictionaryId == [self defaultDictionaryId]) {
+        return [self defaultDictionary];
+    }
+    return nil;
+}
+
+@end
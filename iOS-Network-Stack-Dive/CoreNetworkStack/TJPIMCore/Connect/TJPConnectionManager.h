@@ -27,6 +27,14 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) BOOL useTLS;
 /// 连接时限窗口 默认30秒
 @property (nonatomic, assign) NSTimeInterval connectionTimeout;
+/// 写合并 默认关闭 开启后窗口内的非紧急帧合并为一次聚合写
+@property (nonatomic, assign) BOOL writeCoalescingEnabled;
+/// 写合并窗口 默认2毫秒
+@property (nonatomic, assign) NSTimeInterval writeCoalescingInterval;
+/// 写合并字节阈值 待发送数据达到后立即写出 默认16KB
+@property (nonatomic, assign) NSUInteger writeCoalescingMaxBytes;
+/// 在socket回调队列直接回调收到的数据 默认NO 经主线程转发
+@property (nonatomic, assign) BOOL deliversReceivedDataInline;
 
 /// 标志位
 @property (nonatomic, readonly) BOOL isConnected;
@@ -46,6 +54,10 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)sendData:(NSData *)data;
 /// 带超时的发送消息
 - (void)sendData:(NSData *)data withTimeout:(NSTimeInterval)timeout tag:(long)tag;
+/// 发送分段数据包 写队列为空时直接writev聚合写 未写完部分交给socket写队列
+- (void)sendPacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag;
+/// 带优先级的发送 开启写合并时紧急消息不等待窗口 连同已合并的帧立即写出
+- (void)sendPacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag priority:(TJPMessagePriority)priority;
 /// 开始TLS
 - (void)startTLS:(NSDictionary *)settings;
 
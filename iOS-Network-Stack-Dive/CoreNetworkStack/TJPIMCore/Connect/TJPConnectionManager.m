@@ -7,6 +7,8 @@
 
 #import "TJPConnectionManager.h"
 #import <GCDAsyncSocket.h>
+#import <sys/uio.h>
+#import <limits.h>
 #import "TJPNetworkDefine.h"
 #import "TJPConnectStateMachine.h"
 
@@ -21,6 +23,18 @@
 @property (nonatomic, assign) TJPConnectionState internalState;
 @property (nonatomic, assign) uint8_t majorVersion;
 @property (nonatomic, assign) uint8_t minorVersion;
+/// 已交给socket写队列但尚未完成的写操作数 仅在socketQueue访问
+@property (nonatomic, assign) NSUInteger queuedSocketWrites;
+/// 已请求TLS 加密连接不能绕过socket直接写
+@property (nonatomic, assign) BOOL tlsRequested;
+
+//写合并状态 仅在socketQueue访问
+@property (nonatomic, strong, nullable) dispatch_data_t coalescingData;
+@property (nonatomic, assign) NSUInteger coalescedFrameCount;
+@property (nonatomic, assign) NSTimeInterval coalescedTimeout;
+@property (nonatomic, assign) long coalescedTag;
+/// 每次刷新递增 使过期的窗口定时回调失效
+@property (nonatomic, assign) uint64_t coalescingGeneration;
 
 
 @end
@@ -37,6 +51,10 @@
         _useTLS = NO; // 默认不使用TLS
         _majorVersion = kProtocolVersionMajor;
         _minorVersion = kProtocolVersionMinor;
+        _writeCoalescingEnabled = NO;
+        _writeCoalescingInterval = TJP_DEFAULT_WRITE_COALESCING_INTERVAL;
+        _writeCoalescingMaxBytes = TJP_DEFAULT_WRITE_COALESCING_MAX_BYTES;
+        _coalescedTimeout = -1;
 
     }
     return self;
@@ -136,6 +154,7 @@
     dispatch_async(self.socketQueue, ^{
         TJPLOG_INFO(@"[TJPConnectionManager] 连接管理器强制断开");
         // 立即关闭socket，不等待优雅断开
+        [self resetCoalescingBuffer];
         if (self.socket) {
             [self.socket disconnect];
             self.socket = nil;
@@ -191,6 +210,8 @@
                 [self.delegate connectionWillDisconnect:self reason:reason];
             });
         }
+        // 窗口内未写出的帧随连接一起丢弃 避免定时刷新写向正在关闭的socket
+        [self resetCoalescingBuffer];
         if (self.socket) {
             [self.socket disconnect];
         }
@@ -208,7 +229,30 @@
             return;
         }
         
-        [self.socket writeData:data withTimeout:timeout tag:tag];
+        if (self.writeCoalescingEnabled) {
+            [self coalescePacketData:TJPDispatchDataWithData(data) withTimeout:timeout tag:tag urgent:NO];
+            return;
+        }
+        [self enqueueSocketWrite:data withTimeout:timeout tag:tag];
+    });
+}
+
+- (void)sendPacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag {
+    [self sendPacketData:data withTimeout:timeout tag:tag priority:TJPMessagePriorityNormal];
+}
+
+- (void)sendPacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag priority:(TJPMessagePriority)priority {
+    dispatch_async(self.socketQueue, ^{
+        if (self.internalState != TJPConnectionStateConnected) {
+            TJPLOG_WARN(@"[TJPConnectionManager] 当前未连接，无法发送数据");
+            return;
+        }
+        
+        if (self.writeCoalescingEnabled) {
+            [self coalescePacketData:data withTimeout:timeout tag:tag urgent:(priority == TJPMessagePriorityUrgent)];
+            return;
+        }
+        [self writePacketData:data withTimeout:timeout tag:tag];
     });
 }
 
@@ -219,6 +263,9 @@
             return;
         }
         
+        // TLS之前入队的帧仍按明文发出
+        [self flushCoalescedWrites];
+        self.tlsRequested = YES;
         [self.socket startTLS:settings ?: @{
             (NSString *)kCFStreamSSLPeerName: self.currentHost
         }];
@@ -233,6 +280,155 @@
 }
 
 #pragma mark - Private Methods
+static dispatch_data_t TJPDispatchDataWithData(NSData *data) {
+    NSData *immutableData = [data copy];
+    if (immutableData.length == 0) {
+        return dispatch_data_empty;
+    }
+    return dispatch_data_create(immutableData.bytes, immutableData.length, NULL, ^{
+        (void)immutableData;
+    });
+}
+
+- (void)coalescePacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag urgent:(BOOL)urgent {
+    // 拼接只引用分段 不拷贝
+    self.coalescingData = self.coalescingData ? dispatch_data_create_concat(self.coalescingData, data) : data;
+    self.coalescedFrameCount++;
+    self.coalescedTag = tag;
+    if (timeout >= 0 && (self.coalescedTimeout < 0 || timeout < self.coalescedTimeout)) {
+        self.coalescedTimeout = timeout;
+    }
+    
+    // 紧急消息或达到字节阈值立即写出 已合并的帧一并带上保证顺序
+    if (urgent || dispatch_data_get_size(self.coalescingData) >= self.writeCoalescingMaxBytes) {
+        [self flushCoalescedWrites];
+        return;
+    }
+    
+    // 窗口内首帧启动延迟刷新
+    if (self.coalescedFrameCount == 1) {
+        uint64_t generation = self.coalescingGeneration;
+        __weak typeof(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.writeCoalescingInterval * NSEC_PER_SEC)), self.socketQueue, ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            // 窗口已被提前刷新时忽略
+            if (!strongSelf || strongSelf.coalescingGeneration != generation) return;
+            [strongSelf flushCoalescedWrites];
+        });
+    }
+}
+
+- (void)flushCoalescedWrites {
+    dispatch_data_t data = self.coalescingData;
+    NSUInteger frameCount = self.coalescedFrameCount;
+    NSTimeInterval timeout = self.coalescedTimeout;
+    long tag = self.coalescedTag;
+    [self resetCoalescingBuffer];
+    
+    if (!data || frameCount == 0) {
+        return;
+    }
+    [self writeCoalescedData:data frameCount:frameCount withTimeout:timeout tag:tag];
+}
+
+- (void)writeCoalescedData:(dispatch_data_t)data frameCount:(NSUInteger)frameCount withTimeout:(NSTimeInterval)timeout tag:(long)tag {
+    [self writePacketData:data withTimeout:timeout tag:tag];
+}
+
+- (void)resetCoalescingBuffer {
+    self.coalescingData = nil;
+    self.coalescedFrameCount = 0;
+    self.coalescedTimeout = -1;
+    self.coalescedTag = 0;
+    self.coalescingGeneration++;
+}
+
+- (void)writePacketData:(dispatch_data_t)data withTimeout:(NSTimeInterval)timeout tag:(long)tag {
+    size_t totalSize = dispatch_data_get_size(data);
+    size_t written = 0;
+    // 写队列中还有数据时直接写会打乱顺序
+    if (self.queuedSocketWrites == 0 && !self.tlsRequested) {
+        written = [self writeVectoredData:data];
+    }
+    
+    if (written < totalSize) {
+        // 剩余部分交给socket 由其处理可写事件和超时
+        dispatch_data_t remaining = dispatch_data_create_subrange(data, written, totalSize - written);
+        [self enqueueSocketWrite:(NSData *)remaining withTimeout:timeout tag:tag];
+    }
+}
+
+- (void)enqueueSocketWrite:(NSData *)data withTimeout:(NSTimeInterval)timeout tag:(long)tag {
+    self.queuedSocketWrites++;
+    [self.socket writeData:data withTimeout:timeout tag:tag];
+}
+
+/// 按分段直接writev 分段数超过TJP_MAX_WRITE_IOV_COUNT时分批写 返回已写入字节数 失败或不可写时返回0
+- (size_t)writeVectoredData:(dispatch_data_t)data {
+    __block size_t regionCount = 0;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        regionCount++;
+        return true;
+    });
+    if (regionCount == 0) {
+        return 0;
+    }
+    
+    // 分段数随合并帧数增长 放在堆上 块内只捕获指针
+    struct iovec *iov = calloc(regionCount, sizeof(struct iovec));
+    if (!iov) {
+        return 0;
+    }
+    __block size_t iovIndex = 0;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        iov[iovIndex].iov_base = (void *)buffer;
+        iov[iovIndex].iov_len = size;
+        iovIndex++;
+        return true;
+    });
+    
+    // socketFD只能在GCDAsyncSocket内部队列访问 同时避免与其写操作交错
+    __block size_t totalWritten = 0;
+    __block int writeErrno = 0;
+    GCDAsyncSocket *socket = self.socket;
+    [socket performBlock:^{
+        int fd = socket.socketFD;
+        if (fd < 0) {
+            return;
+        }
+        size_t next = 0;
+        while (next < regionCount) {
+            int batchCount = (int)MIN(regionCount - next, (size_t)TJP_MAX_WRITE_IOV_COUNT);
+            size_t batchSize = 0;
+            for (int i = 0; i < batchCount; i++) {
+                batchSize += iov[next + i].iov_len;
+            }
+            
+            ssize_t result;
+            do {
+                result = writev(fd, iov + next, batchCount);
+            } while (result < 0 && errno == EINTR);
+            if (result < 0) {
+                writeErrno = errno;
+                break;
+            }
+            totalWritten += (size_t)result;
+            // 只写出一部分说明发送缓冲区已满 剩余部分等待可写
+            if ((size_t)result < batchSize) {
+                break;
+            }
+            next += batchCount;
+        }
+    }];
+    free(iov);
+    
+    // EAGAIN时等待socket可写 其他错误由socket写队列上报
+    if (writeErrno != 0 && writeErrno != EAGAIN && writeErrno != EWOULDBLOCK) {
+        TJPLOG_WARN(@"[TJPConnectionManager] writev失败 errno=%d，转交socket写队列", writeErrno);
+    }
+    return totalWritten;
+}
+
 - (void)handleError:(NSError *)error withReason:(TJPDisconnectReason)reason {
     self.disconnectReason = reason;
     [self setInternalState:TJPConnectionStateDisconnected];
@@ -280,6 +476,8 @@
 
 - (void)socket:(GCDAsyncSocket *)sock didConnectToHost:(NSString *)host port:(uint16_t)port {
     [self cancelConnectionTimeoutTimer];
+    self.queuedSocketWrites = 0;
+    self.tlsRequested = self.useTLS;
     [self setInternalState:TJPConnectionStateConnected];
     
     if ([self.delegate respondsToSelector:@selector(connectionDidConnect:)]) {
@@ -299,15 +497,26 @@
 
 - (void)socket:(GCDAsyncSocket *)sock didReadData:(NSData *)data withTag:(long)tag {
     if ([self.delegate respondsToSelector:@selector(connection:didReceiveData:)]) {
-        dispatch_async(dispatch_get_main_queue(), ^{
+        if (self.deliversReceivedDataInline) {
+            // 由接收方在当前队列解析 省去一次队列切换
             [self.delegate connection:self didReceiveData:data];
-        });
+        } else {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self.delegate connection:self didReceiveData:data];
+            });
+        }
     }
     
     // 继续读取数据
     [sock readDataWithTimeout:-1 tag:0];
 }
 
+- (void)socket:(GCDAsyncSocket *)sock didWriteDataWithTag:(long)tag {
+    if (self.queuedSocketWrites > 0) {
+        self.queuedSocketWrites--;
+    }
+}
+
 - (void)socketDidDisconnect:(GCDAsyncSocket *)sock withError:(NSError *)err {
     TJPDisconnectReason reason = self.disconnectReason;
     
@@ -348,6 +557,9 @@
     }
     
     self.disconnectReason = reason;
+    // 断开时未完成的写操作被丢弃 不会再回调
+    self.queuedSocketWrites = 0;
+    [self resetCoalescingBuffer];
     [self setInternalState:TJPConnectionStateDisconnected];
     
     if ([self.delegate respondsToSelector:@selector(connection:didDisconnectWithError:reason:)]) {
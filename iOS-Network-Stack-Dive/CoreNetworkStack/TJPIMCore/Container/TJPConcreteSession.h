@@ -56,6 +56,15 @@ NS_ASSUME_NONNULL_BEGIN
 /// 初始化方法
 - (instancetype)initWithConfiguration:(TJPNetworkConfig *)config;
 
+/// 发送队列状态 包含窗口在途额度、各优先级队列深度和排队时延直方图
+- (NSDictionary *)getSendQueueStatus;
+
+/// 压缩统计 包含压缩/跳过消息数、压缩率和CPU耗时
+- (NSDictionary *)getCompressionStatus;
+
+/// 解析通道统计 包含队列深度、提交/完成数和排队时延
+- (NSDictionary *)getParseLaneStatus;
+
 //*****************************************************
 //   埋点统计 具体实现看TJPConcreteSession+TJPMetrics.h 通过hook相关方法增加埋点
 - (void)handleACKForSequence:(uint32_t)sequence;
@@ -76,10 +85,22 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) NSUInteger useCount;
 /// 是否在池中
 @property (nonatomic, assign) BOOL isPooled;
+/// 池内空闲链表前驱 后继 仅由会话池在池队列上维护
+@property (nonatomic, weak, nullable) TJPConcreteSession *poolPrev;
+@property (nonatomic, strong, nullable) TJPConcreteSession *poolNext;
+/// 是否为预连接待命会话
+@property (nonatomic, assign, readonly) BOOL isStandby;
 
 - (void)resetForReuse;
 - (BOOL)checkHealthyForSession;
 
+/// 进入待命 连接建立后心跳按后台间隔运行
+- (void)enterStandby;
+/// 结束待命交给调用方 保留连接和协商结果 不走resetForReuse
+- (void)promoteFromStandby;
+/// 已连接且完成版本握手 可直接发送 可在任意队列调用
+- (BOOL)isStandbyReady;
+
 //*****************************************************
 
 
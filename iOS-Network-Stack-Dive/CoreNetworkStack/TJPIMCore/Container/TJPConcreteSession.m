@@ -29,9 +29,20 @@
 #import "TJPConnectionDelegate.h"
 #import "TJPConnectionManager.h"
 #import "TJPMessageStateMachine.h"
+#import "TJPSelectiveAck.h"
+#import "TJPTimerWheel.h"
+#import "TJPSendWindow.h"
+#import "TJPSendScheduler.h"
+#import "TJPFragmentTransfer.h"
+#import "TJPFragmentReassembler.h"
+#import "TJPCompressionCodec.h"
+#import "TJPCompressionDictionary.h"
+#import "TJPParseLaneScheduler.h"
 
 
 static const NSTimeInterval kDefaultRetryInterval = 10;
+// sessionQueue归属标记 值为会话自身
+static void *kTJPSessionQueueKey = &kTJPSessionQueueKey;
 
 @interface TJPConcreteSession () <TJPConnectionDelegate, TJPReconnectPolicyDelegate, TJPMessageManagerDelegate, TJPMessageManagerNetworkDelegate>
 
@@ -41,8 +52,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 @property (nonatomic, strong) TJPConnectionManager *connectionManager;
 @property (nonatomic, strong) dispatch_queue_t sessionQueue;
 
-//消息超时重传定时器
-@property (nonatomic, strong) NSMutableDictionary<NSString *, dispatch_source_t> *retransmissionTimers;
+//消息超时重传时间轮 所有待确认消息共用一个刻度定时器
+@property (nonatomic, strong) TJPTimerWheel *retransmissionWheel;
 
 /// 动态心跳
 @property (nonatomic, strong) TJPDynamicHeartbeat *heartbeatManager;
@@ -50,6 +61,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 @property (nonatomic, strong) TJPSequenceManager *seqManager;
 /// 协议处理
 @property (nonatomic, strong) TJPMessageParser *parser;
+/// 解析通道 解析器只在此通道内访问 保证同一会话的数据按到达顺序解析
+@property (nonatomic, strong) TJPParseLane *parseLane;
 /// 消息管理
 @property (nonatomic, strong) TJPMessageManager *messageManager;
 
@@ -60,8 +73,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 @property (nonatomic, strong) NSDate *lastHandshakeTime;
 //断开连接事件
 @property (nonatomic, strong) NSDate *disconnectionTime;
-//是否完成握手
-@property (nonatomic, assign) BOOL hasCompletedHandshake;
+//是否完成握手 在收包路径写入 会话池在poolQueue读取 需原子访问
+@property (atomic, assign) BOOL hasCompletedHandshake;
 
 //协商后的版本号
 @property (nonatomic, assign) uint16_t negotiatedVersion;
@@ -69,6 +82,34 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 //协商后的特性标志
 @property (nonatomic, assign) uint16_t negotiatedFeatures;
 
+//是否为预连接待命会话
+@property (nonatomic, assign, readwrite) BOOL isStandby;
+
+//状态机回调中发布的是否已连接 状态机的currentState不能跨队列读取
+@property (atomic, assign) BOOL publishedConnected;
+
+/*    延迟确认 仅在sessionQueue访问    */
+//待确认的已收到序列号
+@property (nonatomic, strong) NSMutableIndexSet *pendingAckSequences;
+//每次发送ACK后递增 使过期的延迟回调失效
+@property (nonatomic, assign) uint64_t delayedAckGeneration;
+
+/*    发送窗口 仅在sessionQueue访问    */
+//在途额度控制与排队
+@property (nonatomic, strong) TJPSendWindow *sendWindow;
+//是否已向代理通知窗口关闭
+@property (nonatomic, assign) BOOL sendWindowBlocked;
+
+/*    大消息分片 仅在sessionQueue访问    */
+//发送中的分片传输 key为原始消息ID 断线后保留用于续传
+@property (nonatomic, strong) NSMutableDictionary<NSString *, TJPFragmentTransfer *> *fragmentTransfers;
+//接收端分片重组
+@property (nonatomic, strong) TJPFragmentReassembler *fragmentReassembler;
+
+/*    压缩 仅在sessionQueue访问    */
+//发送端压缩 复用deflate流
+@property (nonatomic, strong) TJPCompressionCodec *compressionCodec;
+
 
 /*        Debug          */
 @property (nonatomic, assign) BOOL hasSetupComponents;
@@ -102,13 +143,29 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
         _sessionId = [[NSUUID UUID] UUIDString];
         _disconnectReason = TJPDisconnectReasonNone;
 
-        _retransmissionTimers = [NSMutableDictionary dictionary];
         _pendingMessages = [NSMutableDictionary dictionary];
         _sequenceToMessageId = [NSMutableDictionary dictionary];
+        _pendingAckSequences = [NSMutableIndexSet indexSet];
+        _fragmentTransfers = [NSMutableDictionary dictionary];
+        _fragmentReassembler = [[TJPFragmentReassembler alloc] initWithMaxTransfers:TJP_FRAGMENT_MAX_REASSEMBLIES timeout:TJP_FRAGMENT_REASSEMBLY_TIMEOUT];
+        _compressionCodec = [[TJPCompressionCodec alloc] init];
         
         // 创建专用队列（串行，中等优先级）
         _sessionQueue = dispatch_queue_create("com.concreteSession.tjp.sessionQueue", DISPATCH_QUEUE_SERIAL);
         dispatch_set_target_queue(_sessionQueue, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0));
+        // 标记队列归属 用于判断当前是否已在本会话的sessionQueue
+        dispatch_queue_set_specific(_sessionQueue, kTJPSessionQueueKey, (__bridge void *)self, NULL);
+        
+        // 重传时间轮 刻度与原单消息定时器的100ms精度一致
+        _retransmissionWheel = [[TJPTimerWheel alloc] initWithTickInterval:TJP_TIMER_WHEEL_TICK_INTERVAL slotCount:TJP_TIMER_WHEEL_SLOT_COUNT queue:_sessionQueue];
+        __weak typeof(self) weakSelf = self;
+        _retransmissionWheel.expirationHandler = ^(NSArray<NSString *> *expiredKeys) {
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) return;
+            for (NSString *messageId in expiredKeys) {
+                [strongSelf handleRetransmissionForMessageId:messageId];
+            }
+        };
         
         // 初始化各组件
         [self setupComponentWithConfig:config];
@@ -148,7 +205,14 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     _connectionManager.delegate = self;
     _connectionManager.connectionTimeout = 30.0;
     _connectionManager.useTLS = config.useTLS;
+    _connectionManager.writeCoalescingEnabled = config.writeCoalescingEnabled;
+    _connectionManager.writeCoalescingInterval = config.writeCoalescingInterval;
+    _connectionManager.writeCoalescingMaxBytes = config.writeCoalescingMaxBytes;
+    _connectionManager.deliversReceivedDataInline = (config.parseExecutionMode == TJPParseExecutionModeInline);
     TJPLOG_DEBUG(@"[TJPConcreteSession] 连接管理器初始化完成: %@", _connectionManager);
+    
+    // 初始化发送窗口
+    _sendWindow = [[TJPSendWindow alloc] initWithMaxInFlightMessages:config.sendWindowMaxMessages maxInFlightBytes:config.sendWindowMaxBytes];
 
     // 初始化序列号管理
     _seqManager = [[TJPSequenceManager alloc] initWithSessionId:_sessionId];
@@ -164,6 +228,7 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 
     // 初始化协议解析器
     _parser = [[TJPMessageParser alloc] initWithBufferStrategy:TJPBufferStrategyAuto];
+    _parseLane = [[TJPNetworkCoordinator shared].parseLaneScheduler laneWithLabel:_sessionId];
     TJPLOG_DEBUG(@"[TJPConcreteSession] 协议解析器初始化完成: %@", _parser);
 
     // 初始化重连策略
@@ -227,6 +292,7 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
         if (!strongSelf) return;
         
         TJPLOG_INFO(@"[TJPConcreteSession] 会话 %@ 状态变化: %@ -> %@", strongSelf.sessionId, oldState, newState);
+        strongSelf.publishedConnected = [newState isEqualToString:TJPConnectStateConnected];
         
         // 通知代理
         if (strongSelf.delegate && [strongSelf.delegate respondsToSelector:@selector(session:didChangeState:)]) {
@@ -243,6 +309,10 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
             // 此处只启动心跳 不初始化心跳
             if (strongSelf.heartbeatManager) {
                 [strongSelf.heartbeatManager updateSession:strongSelf];
+                if (strongSelf.isStandby) {
+                    // 待命会话只需保活 心跳启动后切到后台间隔
+                    [strongSelf.heartbeatManager setHeartbeatMode:TJPHeartbeatModeBackground force:YES];
+                }
                 TJPLOG_INFO(@"[TJPConcreteSession] 心跳已启动，当前间隔 %.1f 秒", strongSelf.heartbeatManager.currentInterval);
             } else {
                 TJPLOG_ERROR(@"[TJPConcreteSession] 注意:心跳管理器未初始化，请检查心跳初始化逻辑!!!!");
@@ -325,32 +395,42 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 }
 
 - (void)connection:(TJPConnectionManager *)connection didReceiveData:(NSData *)data {
-    dispatch_async([TJPNetworkCoordinator shared].parseQueue, ^{
-        TJPLOG_INFO(@"[TJPConcreteSession] 读取到数据，大小: %lu字节，准备解析", (unsigned long)data.length);
+    if (self.config.parseExecutionMode == TJPParseExecutionModeInline) {
+        // 已在socket回调队列 直接解析
+        [self parseReceivedData:data];
+        return;
+    }
+    [self.parseLane dispatchAsync:^{
+        [self parseReceivedData:data];
+    }];
+}
 
-        // 使用解析器解析数据
-        [self.parser feedData:data];
-        
-        int packetCount = 0;
+/// 解析一次读取的数据并批量处理完整数据包 同一会话内串行调用
+- (void)parseReceivedData:(NSData *)data {
+    TJPLOG_INFO(@"[TJPConcreteSession] 读取到数据，大小: %lu字节，准备解析", (unsigned long)data.length);
 
-        // 解析数据
-        while ([self.parser hasCompletePacket]) {
-            packetCount++;
+    // 使用解析器解析数据
+    [self.parser feedData:data];
+    
+    // 一次取出本次缓冲区内全部完整数据包 批量处理
+    NSArray<TJPParsedPacket *> *packets = [self.parser drainPacketsWithLimit:0];
+    if (self.parser.currentState == TJPParseStateError) {
+        TJPLOG_ERROR(@"[TJPConcreteSession] 第 %lu 个数据包解析失败，解析器进入错误状态", (unsigned long)packets.count + 1);
+    }
+    
+    // 处理数据包
+    [self processReceivedPackets:packets];
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 本次数据解析完成，共处理 %lu 个数据包", (unsigned long)packets.count);
+}
 
-            TJPLOG_INFO(@"[TJPConcreteSession] 开始解析第 %d 个数据包", packetCount);
-            TJPParsedPacket *packet = [self.parser nextPacket];
-            if (!packet) {
-                TJPLOG_ERROR(@"[TJPConcreteSession] 第 %d 个数据包解析失败，TJPParsedPacket为空", packetCount);
-                return;
-            }
-            TJPLOG_INFO(@"[TJPConcreteSession] 第 %d 个数据包解析成功 - 类型:%hu, 序列号:%u, 载荷大小:%lu", packetCount, packet.messageType, packet.sequence, (unsigned long)packet.payload.length);
-        
-            // 处理数据包
-            [self processReceivedPacket:packet];
-        }
-        
-        TJPLOG_INFO(@"[TJPConcreteSession] 本次数据解析完成，共处理 %d 个数据包", packetCount);
-    });
+/// 已在sessionQueue时直接执行 否则异步投递 内联解析模式下收包处理不再额外切换队列
+- (void)performOnSessionQueue:(dispatch_block_t)block {
+    if (dispatch_get_specific(kTJPSessionQueueKey) == (__bridge void *)self) {
+        block();
+    } else {
+        dispatch_async(self.sessionQueue, block);
+    }
 }
 
 
@@ -410,6 +490,15 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     return [self.messageManager sendMessage:data messageType:messageType encryptType:encryptType compressType:compressType completion:completion];
 }
 
+- (NSString *)sendData:(NSData *)data
+           messageType:(TJPMessageType)messageType
+           encryptType:(TJPEncryptType)encryptType
+          compressType:(TJPCompressType)compressType
+              priority:(TJPMessagePriority)priority
+            completion:(void(^)(NSString *messageId, NSError *error))completion {
+    return [self.messageManager sendMessage:data messageType:messageType encryptType:encryptType compressType:compressType priority:priority completion:completion];
+}
+
 /// 发送心跳包
 - (void)sendHeartbeat:(NSData *)heartbeatData {
     dispatch_async(self.sessionQueue, ^{
@@ -418,7 +507,7 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
             return;
         }
         TJPLOG_INFO(@"[TJPConcreteSession] 正在发送心跳包");
-        [self.connectionManager sendData:heartbeatData withTimeout:-1 tag:0];
+        [self sendControlPacket:heartbeatData messageType:TJPMessageTypeHeartbeat sequence:0];
     });
 }
 
@@ -636,39 +725,354 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
             return;
         }
         
-        //创建序列号
-        uint32_t seq = [self.seqManager nextSequenceForCategory:TJPMessageCategoryNormal];
-        
-        // 更新消息管理器对应的消息序列号
-        message.sequence = seq;
-        
-        // 建立序列号到消息ID的映射
-        self.sequenceToMessageId[@(seq)] = message.messageId;
-        
-        //构造协议包  实际通过Socket发送的协议包(协议头+原始数据)
-        NSData *packet = [TJPMessageBuilder buildPacketWithMessageType:message.messageType sequence:seq payload:message.payload encryptType:message.encryptType compressType:message.compressType sessionID:self.sessionId];
-        
-        if (!packet) {
-            TJPLOG_ERROR(@"[TJPConcreteSession] 消息包构建失败");
+        // 超过分片大小的消息拆分发送 对端不支持时整包发送
+        if ([self isFragmentationEnabled] && message.payload.length > TJP_FRAGMENT_SIZE) {
+            [self startFragmentTransferForMessage:message];
+        } else {
+            // 入队前压缩 窗口按线路字节计费
+            [self compressMessageIfNeeded:message];
+            // 进入发送窗口 窗口关闭时按优先级排队 等待ACK释放额度
+            [self.sendWindow enqueueMessage:message];
+        }
+        [self drainSendWindow];
+    });
+}
+
+#pragma mark - Flow Control
+/// 在窗口额度内发出排队消息 需在sessionQueue调用
+- (void)drainSendWindow {
+    if (![self.stateMachine.currentState isEqualToString:TJPConnectStateConnected]) {
+        return;
+    }
+    
+    // 同一传输每轮只放行一个分片 下一个分片在本轮结束后排到队尾
+    // 大消息不会一次把窗口内的分片全部写入socket 其他消息在下一轮即可插入
+    NSMutableArray<TJPFragmentTransfer *> *advancedTransfers = nil;
+    TJPMessageContext *message = nil;
+    while ((message = [self.sendWindow dequeueSendableMessage])) {
+        TJPFragmentTransfer *transfer = [self transmitMessage:message];
+        if (transfer) {
+            if (!advancedTransfers) {
+                advancedTransfers = [NSMutableArray array];
+            }
+            [advancedTransfers addObject:transfer];
+        }
+    }
+    // 只有窗口拒绝的消息才算排队 先判断背压再补入下一个分片
+    [self updateSendBackpressure];
+    
+    for (TJPFragmentTransfer *transfer in advancedTransfers) {
+        [self enqueueNextFragmentOfTransfer:transfer];
+    }
+}
+
+/// 控制帧以Urgent优先级进入调度器 先于排队的数据消息发出
+- (void)sendControlPacket:(NSData *)packet messageType:(TJPMessageType)messageType sequence:(uint32_t)sequence {
+    TJPMessageContext *context = [TJPMessageContext controlContextWithPacket:packet messageType:messageType seq:sequence sessionId:self.sessionId];
+    [self performOnSessionQueue:^{
+        // 未连接时直接丢弃 不在队列中滞留 对端会按自身策略重传
+        if (![self.stateMachine.currentState isEqualToString:TJPConnectStateConnected]) {
+            TJPLOG_INFO(@"[TJPConcreteSession] 当前未连接，丢弃控制帧，类型=%hu", messageType);
+            return;
+        }
+        [self.sendWindow enqueueMessage:context];
+        [self drainSendWindow];
+    }];
+}
+
+/// 分配序列号并写入socket 需在sessionQueue调用
+/// 返回已发出分片所属的传输 由调用方在本轮结束后入队下一个分片 其余情况返回nil
+- (TJPFragmentTransfer *)transmitMessage:(TJPMessageContext *)message {
+    // 控制帧已构建完成 不分配序列号 不等待确认
+    if (message.controlPacket) {
+        [self.connectionManager sendPacketData:[message buildPacketData] withTimeout:-1 tag:message.sequence priority:TJPMessagePriorityUrgent];
+        return nil;
+    }
+    
+    // 所属传输已失败或已取消的分片不再发出
+    TJPFragmentTransfer *transfer = nil;
+    if (message.parentMessageId) {
+        transfer = self.fragmentTransfers[message.parentMessageId];
+        if (!transfer) {
+            [self.sendWindow releaseMessageId:message.messageId];
+            return nil;
+        }
+    }
+    
+    //创建序列号
+    uint32_t seq = [self.seqManager nextSequenceForCategory:TJPMessageCategoryNormal];
+    
+    // 更新消息管理器对应的消息序列号
+    message.sequence = seq;
+    
+    // 建立序列号到消息ID的映射
+    self.sequenceToMessageId[@(seq)] = message.messageId;
+    
+    //构造协议包  实际通过Socket发送的协议包(协议头+原始数据)
+    //协议头与载荷分段 不拼接拷贝 载荷段缓存在上下文中供重传复用
+    dispatch_data_t packet = [message buildPacketData];
+    
+    if (!packet) {
+        TJPLOG_ERROR(@"[TJPConcreteSession] 消息包构建失败");
+        [self.sendWindow releaseMessageId:message.messageId];
+        [self.messageManager updateMessage:message.messageId toState:TJPMessageStateFailed];
+        return nil;
+    }
+    
+    // 将消息加入待确认列表 记录首次发送时间用于RTT采样
+    message.sendTime = [NSDate date];
+    self.pendingMessages[message.messageId] = message;
+
+    //设置超时重传
+    [self scheduleRetransmissionForMessageId:message.messageId];
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 消息即将发出, 序列号: %u, 大小: %lu字节", seq, (unsigned long)dispatch_data_get_size(packet));
+    //使用连接管理器发送消息
+    [self.connectionManager sendPacketData:packet withTimeout:-1 tag:seq priority:message.priority];
+    return transfer;
+}
+
+/// 排队状态变化时通知代理 只在开关切换时回调
+- (void)updateSendBackpressure {
+    BOOL blocked = self.sendWindow.queuedCount > 0;
+    if (blocked == self.sendWindowBlocked) {
+        return;
+    }
+    self.sendWindowBlocked = blocked;
+    
+    NSUInteger queuedCount = self.sendWindow.queuedCount;
+    NSUInteger queuedBytes = self.sendWindow.queuedBytes;
+    if (blocked) {
+        TJPLOG_WARN(@"[TJPConcreteSession] 发送窗口已满 在途 %lu 条/%lu 字节 排队 %lu 条", (unsigned long)self.sendWindow.inFlightCount, (unsigned long)self.sendWindow.inFlightBytes, (unsigned long)queuedCount);
+    } else {
+        TJPLOG_INFO(@"[TJPConcreteSession] 发送窗口已恢复");
+    }
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (blocked) {
+            if ([self.delegate respondsToSelector:@selector(session:sendWindowDidCloseWithQueuedMessages:queuedBytes:)]) {
+                [self.delegate session:self sendWindowDidCloseWithQueuedMessages:queuedCount queuedBytes:queuedBytes];
+            }
+        } else if ([self.delegate respondsToSelector:@selector(sessionSendWindowDidOpen:)]) {
+            [self.delegate sessionSendWindowDidOpen:self];
+        }
+    });
+}
+
+/// 清空发送窗口 未发出的排队消息标记失败 需在sessionQueue调用
+- (void)resetSendWindow {
+    NSArray<TJPMessageContext *> *queued = [self.sendWindow reset];
+    NSUInteger failedCount = 0;
+    for (TJPMessageContext *message in queued) {
+        // 分片由所属传输在重连后续传 控制帧直接丢弃
+        if (message.parentMessageId || message.controlPacket) {
+            continue;
+        }
+        [self.messageManager updateMessage:message.messageId toState:TJPMessageStateFailed];
+        failedCount++;
+    }
+    if (failedCount > 0) {
+        TJPLOG_WARN(@"[TJPConcreteSession] 连接断开 %lu 条排队消息发送失败", (unsigned long)failedCount);
+    }
+    [self updateSendBackpressure];
+}
+
+- (NSDictionary *)getSendQueueStatus {
+    __block NSDictionary *status;
+    
+    dispatch_sync(self.sessionQueue, ^{
+        status = @{
+            @"inFlightMessages": @(self.sendWindow.inFlightCount),
+            @"inFlightBytes": @(self.sendWindow.inFlightBytes),
+            @"queuedMessages": @(self.sendWindow.queuedCount),
+            @"queuedBytes": @(self.sendWindow.queuedBytes),
+            @"advertisedMessages": @(self.sendWindow.advertisedMessages),
+            @"advertisedBytes": @(self.sendWindow.advertisedBytes),
+            @"priorities": [self.sendWindow.scheduler statistics],
+            @"latencyBucketBounds": [TJPSendScheduler latencyHistogramBounds]
+        };
+    });
+    
+    return status;
+}
+
+/// 对端通告接收窗口 在解析队列调用
+- (void)handleFlowWindowValue:(NSData *)value {
+    if (value.length != 8) {
+        TJPLOG_WARN(@"[TJPConcreteSession] 接收窗口通告长度错误: %lu", (unsigned long)value.length);
+        return;
+    }
+    uint32_t maxMessages = 0;
+    uint32_t maxBytes = 0;
+    [value getBytes:&maxMessages range:NSMakeRange(0, sizeof(uint32_t))];
+    [value getBytes:&maxBytes range:NSMakeRange(sizeof(uint32_t), sizeof(uint32_t))];
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 对端通告接收窗口: %u 条/%u 字节", ntohl(maxMessages), ntohl(maxBytes));
+    
+    dispatch_async(self.sessionQueue, ^{
+        self.sendWindow.advertisedMessages = ntohl(maxMessages);
+        self.sendWindow.advertisedBytes = ntohl(maxBytes);
+        // 窗口可能扩大
+        [self drainSendWindow];
+    });
+}
+
+
+
+#pragma mark - Compression
+- (BOOL)isCompressionEnabled {
+    return (self.negotiatedFeatures & TJP_FEATURE_COMPRESSION) != 0;
+}
+
+/// 按消息的压缩类型压缩载荷 对端未协商压缩时改为不压缩 需在sessionQueue调用
+- (void)compressMessageIfNeeded:(TJPMessageContext *)message {
+    if (message.compressType != TJPCompressTypeZlib) {
+        return;
+    }
+    if (![self isCompressionEnabled]) {
+        message.compressType = TJPCompressTypeNone;
+        return;
+    }
+    [message compressPayloadWithCodec:self.compressionCodec];
+}
+
+/// 按协商结果配置压缩字典 双方都支持压缩和字典时启用 否则恢复为无字典压缩
+- (void)applyCompressionFeatures:(uint16_t)features {
+    dispatch_async(self.sessionQueue, ^{
+        uint16_t required = TJP_FEATURE_COMPRESSION | TJP_FEATURE_COMPRESSION_DICTIONARY;
+        if ((features & required) != required) {
+            [self.compressionCodec reset];
             return;
         }
+        self.compressionCodec.presetDictionary = [TJPCompressionDictionary defaultDictionary];
+        self.compressionCodec.minimumLength = TJP_COMPRESSION_DICTIONARY_MIN_SIZE;
+    });
+}
+
+- (NSDictionary *)getParseLaneStatus {
+    return [self.parseLane statistics];
+}
+
+- (NSDictionary *)getCompressionStatus {
+    __block NSDictionary *status;
+    
+    dispatch_sync(self.sessionQueue, ^{
+        status = [self.compressionCodec statistics];
+    });
+    
+    return status;
+}
+
+
+#pragma mark - Fragmentation
+- (BOOL)isFragmentationEnabled {
+    return (self.negotiatedFeatures & TJP_FEATURE_FRAGMENTATION) != 0;
+}
+
+/// 创建分片传输并入队首个分片 需在sessionQueue调用
+- (void)startFragmentTransferForMessage:(TJPMessageContext *)message {
+    TJPFragmentTransfer *transfer = [[TJPFragmentTransfer alloc] initWithMessage:message fragmentSize:TJP_FRAGMENT_SIZE];
+    self.fragmentTransfers[message.messageId] = transfer;
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 消息 %@ 大小 %lu 字节，拆分为 %lu 个分片发送，传输ID: %u", message.messageId, (unsigned long)message.payload.length, (unsigned long)transfer.fragmentCount, transfer.transferId);
+    [self enqueueNextFragmentOfTransfer:transfer];
+}
+
+/// 同一传输每次只入队一个分片 需在sessionQueue调用
+- (void)enqueueNextFragmentOfTransfer:(TJPFragmentTransfer *)transfer {
+    TJPMessageContext *fragment = [transfer nextFragmentContext];
+    if (fragment) {
+        // 每个分片独立压缩 接收端先解压再重组
+        [self compressMessageIfNeeded:fragment];
+        [self.sendWindow enqueueMessage:fragment];
+    }
+}
+
+/// 分片被确认 全部确认后原始消息视为发送成功 需在sessionQueue调用
+- (void)handleFragmentAcknowledged:(TJPMessageContext *)fragment {
+    TJPFragmentTransfer *transfer = self.fragmentTransfers[fragment.parentMessageId];
+    if (!transfer) {
+        return;
+    }
+    
+    [transfer acknowledgeFragmentAtIndex:fragment.fragmentIndex];
+    if (!transfer.isComplete) {
+        return;
+    }
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 消息 %@ 全部 %lu 个分片已确认", fragment.parentMessageId, (unsigned long)transfer.fragmentCount);
+    [self.fragmentTransfers removeObjectForKey:fragment.parentMessageId];
+    [self.messageManager updateMessage:fragment.parentMessageId toState:TJPMessageStateSent];
+}
+
+/// 分片传输失败 取消其在途分片并标记原始消息失败 需在sessionQueue调用
+- (void)failFragmentTransferForMessageId:(NSString *)parentMessageId {
+    if (!self.fragmentTransfers[parentMessageId]) {
+        return;
+    }
+    [self.fragmentTransfers removeObjectForKey:parentMessageId];
+    
+    for (TJPMessageContext *pending in [self.pendingMessages allValues]) {
+        if (![pending.parentMessageId isEqualToString:parentMessageId]) {
+            continue;
+        }
+        [self.retransmissionWheel cancelKey:pending.messageId];
+        [self.pendingMessages removeObjectForKey:pending.messageId];
+        [self.sequenceToMessageId removeObjectForKey:@(pending.sequence)];
+        [self.sendWindow releaseMessageId:pending.messageId];
+    }
+    
+    TJPLOG_ERROR(@"[TJPConcreteSession] 消息 %@ 分片传输失败", parentMessageId);
+    [self.messageManager updateMessage:parentMessageId toState:TJPMessageStateFailed];
+}
+
+/// 重连后从第一个未确认分片续传 对端不再支持分片时标记失败 需在sessionQueue调用
+- (void)resumeFragmentTransfers {
+    if (self.fragmentTransfers.count == 0) {
+        return;
+    }
+    
+    for (NSString *parentMessageId in [self.fragmentTransfers allKeys]) {
+        TJPFragmentTransfer *transfer = self.fragmentTransfers[parentMessageId];
+        if (![self isFragmentationEnabled]) {
+            [self failFragmentTransferForMessageId:parentMessageId];
+            continue;
+        }
         
-        // 将消息加入待确认列表
-        self.pendingMessages[message.messageId] = message;
+        TJPLOG_INFO(@"[TJPConcreteSession] 续传消息 %@，已确认 %lu/%lu 个分片", parentMessageId, (unsigned long)transfer.acknowledgedCount, (unsigned long)transfer.fragmentCount);
+        [transfer rewindToFirstUnacknowledgedFragment];
+        [self enqueueNextFragmentOfTransfer:transfer];
+    }
+    [self drainSendWindow];
+}
 
-        //设置超时重传
-        [self scheduleRetransmissionForMessageId:message.messageId];
+/// 处理收到的分片 在解析通道或socket回调队列调用
+- (void)handleFragmentPacket:(TJPParsedPacket *)packet {
+    [self performOnSessionQueue:^{
+        NSData *completedData = nil;
+        TJPFragmentReassemblyResult result = [self.fragmentReassembler appendFragmentPayload:packet.payload completedData:&completedData];
+        
+        // 校验失败不确认 由对端超时重传
+        if (result == TJPFragmentReassemblyResultInvalid) {
+            TJPLOG_WARN(@"[TJPConcreteSession] 丢弃无效分片，序列号: %u", packet.sequence);
+            return;
+        }
         
-        TJPLOG_INFO(@"[TJPConcreteSession] 消息即将发出, 序列号: %u, 大小: %lu字节", seq, (unsigned long)packet.length);
-        //使用连接管理器发送消息
-        [self.connectionManager sendData:packet withTimeout:-1 tag:seq];
+        // 重复分片也需确认 对端可能未收到上次的ACK
+        [self acknowledgeReceivedPackets:@[packet]];
         
-        // 可以增加通知MessageManager消息已通过网络发送，等待ACK
-    });
+        if (result == TJPFragmentReassemblyResultCompleted) {
+            TJPParsedPacket *message = [TJPParsedPacket packetWithHeader:packet.header];
+            message.payload = completedData;
+            message.messageType = TJPMessageTypeNormalData;
+            
+            TJPLOG_INFO(@"[TJPConcreteSession] 分片重组完成，消息大小: %lu 字节", (unsigned long)completedData.length);
+            [self notifyReceivedPackets:@[message]];
+        }
+    }];
 }
 
 
-
 #pragma mark - Version Handshake
 - (void)performVersionHandshake {
     //协议版本握手逻辑
@@ -707,8 +1111,9 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     // 主版本占用高8位，次版本占用低8位
     uint16_t versionValue = htons((majorVersion << 8) | minorVersion);
     
-    // 使用定义的特性标志  启用已读回执功能
-    uint16_t featureFlags = htons(TJP_FEATURE_BASIC | TJP_FEATURE_READ_RECEIPT | TJP_FEATURE_ENCRYPTION);
+    // 使用定义的特性标志  启用已读回执、选择性确认、大消息分片、压缩功能
+    uint16_t requestedFeatures = TJP_FEATURE_BASIC | TJP_FEATURE_READ_RECEIPT | TJP_FEATURE_ENCRYPTION | TJP_FEATURE_SELECTIVE_ACK | TJP_FEATURE_FRAGMENTATION | TJP_FEATURE_COMPRESSION | TJP_FEATURE_COMPRESSION_DICTIONARY;
+    uint16_t featureFlags = htons(requestedFeatures);
     
     [tlvData appendBytes:&versionTag length:sizeof(uint16_t)];          //Tag
     [tlvData appendBytes:&versionLength length:sizeof(uint32_t)];       //Length
@@ -716,7 +1121,7 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     [tlvData appendBytes:&featureFlags length:sizeof(uint16_t)];        // Value: 特性
     
     // 记录日志，便于调试
-    TJPLOG_INFO(@"[TJPConcreteSession] 发送版本协商: 版本=%d.%d, 特性=0x%04X, TLV标签=0x%04X", majorVersion, minorVersion, (TJP_FEATURE_BASIC | TJP_FEATURE_READ_RECEIPT | TJP_FEATURE_ENCRYPTION), TJP_TLV_TAG_VERSION_REQUEST);
+    TJPLOG_INFO(@"[TJPConcreteSession] 发送版本协商: 版本=%d.%d, 特性=0x%04X, TLV标签=0x%04X", majorVersion, minorVersion, requestedFeatures, TJP_TLV_TAG_VERSION_REQUEST);
     
     header.bodyLength = htonl((uint32_t)tlvData.length);
     
@@ -819,6 +1224,15 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     
     // 取消定时器
     [self cancelAllRetransmissionTimersSync];
+    [self discardDelayedAcks];
+    [self resetSendWindow];
+    [self failAllFragmentTransfers];
+    [self.fragmentReassembler removeAllTransfers];
+    
+    // 复用后可能连接到不同的服务器 清除协商结果和压缩字典 重新握手
+    [self.compressionCodec reset];
+    self.negotiatedFeatures = 0;
+    self.hasCompletedHandshake = NO;
     
     // 重置状态变量
     self.disconnectReason = TJPDisconnectReasonNone;
@@ -835,6 +1249,38 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 }
 
 
+- (void)enterStandby {
+    self.isStandby = YES;
+    // 已连接时直接切换 未连接时在连接成功后切换
+    if ([self.connectState isEqualToString:TJPConnectStateConnected]) {
+        [self.heartbeatManager setHeartbeatMode:TJPHeartbeatModeBackground force:YES];
+    }
+}
+
+- (void)promoteFromStandby {
+    TJPLOG_INFO(@"[TJPConcreteSession] 待命会话 %@ 投入使用，协商特性: 0x%04X", self.sessionId, self.negotiatedFeatures);
+    self.isStandby = NO;
+    self.lastActiveTime = [NSDate date];
+    self.useCount++;
+    self.isPooled = NO;
+    // 应用不在前台时保持后台间隔 由心跳管理器的生命周期通知切回
+    [self.heartbeatManager setHeartbeatMode:TJPHeartbeatModeForeground force:NO];
+}
+
+- (BOOL)isStandbyReady {
+    // 会话池在poolQueue调用 只读取原子发布的状态
+    return self.hasCompletedHandshake && self.publishedConnected;
+}
+
+/// 会话复用前未完成的分片传输全部失败 需在sessionQueue调用
+- (void)failAllFragmentTransfers {
+    for (TJPFragmentTransfer *transfer in [self.fragmentTransfers allValues]) {
+        [self.messageManager updateMessage:transfer.message.messageId toState:TJPMessageStateFailed];
+    }
+    [self.fragmentTransfers removeAllObjects];
+}
+
+
 #pragma mark - Private Methods
 - (void)prepareForConnection {
     // 增加池化层后连接时才初始化心跳 但不启动
@@ -850,6 +1296,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 - (void)handleSequenceReset:(TJPMessageCategory)category {
     TJPLOG_WARN(@"[TJPConcreteSession] 会话 %@ 类别 %d 序列号即将重置", self.sessionId, (int)category);
     
+    // 这里是本端发送序列号 与防重放窗口跟踪的对端序列号无关 对端回绕由窗口自行识别
+    
     // 检查是否有该类别的待确认消息
     NSMutableArray<NSString *> *affectedMessages = [NSMutableArray array];
     for (NSString *messageId in self.pendingMessages.allKeys) {
@@ -872,12 +1320,18 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 - (void)handleConnectedState {
     // 如果有积压消息 发送积压消息
     [self flushPendingMessages];
+    
+    // 未完成的分片传输从断点续传
+    dispatch_async(self.sessionQueue, ^{
+        [self resumeFragmentTransfers];
+    });
 
     // 判断是否需要握手
     if ([self shouldPerformHandshake]) {
         [self performVersionHandshake];
     } else {
         TJPLOG_INFO(@"[TJPConcreteSession] 使用现有协商结果，跳过版本握手");
+        [self applyCompressionFeatures:self.negotiatedFeatures];
     }
 }
 
@@ -904,11 +1358,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 
 - (void)scheduleRetransmissionForMessageId:(NSString *)messageId {
     // 取消之前可能存在的重传计时器
-    dispatch_source_t existingTimer = self.retransmissionTimers[messageId];
-    if (existingTimer) {
+    if ([self.retransmissionWheel cancelKey:messageId]) {
         TJPLOG_INFO(@"[TJPConcreteSession] 因重新安排重传而取消消息 %@ 的旧重传计时器", messageId);
-        dispatch_source_cancel(existingTimer);
-        [self.retransmissionTimers removeObjectForKey:messageId];
     }
     
     //获取消息上下文
@@ -924,53 +1375,30 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
         return;
     }
     
-    //创建GCD定时器
-    __weak typeof(self) weakSelf = self;
-    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.sessionQueue);
-    
-    //设置定时器间隔 (默认3秒一次)
-    NSTimeInterval retryInterval = context.retryTimeout > 0 ? context.retryTimeout : kDefaultRetryInterval;
-    uint64_t intervalInNanoseconds = (uint64_t)(retryInterval * NSEC_PER_SEC);
-    
-    
-    dispatch_source_set_timer(timer,
-                              dispatch_time(DISPATCH_TIME_NOW, intervalInNanoseconds),
-                              DISPATCH_TIME_FOREVER, // 不重复
-                              (1ull * NSEC_PER_SEC) / 10); // 100ms的精度
-    
-    dispatch_source_set_event_handler(timer, ^{
-        __strong typeof(weakSelf) strongSelf = weakSelf;
-        if (!strongSelf) return;
-        
-        [strongSelf handleRetransmissionForMessageId:messageId];
-    });
-    
-    // 设置定时器取消处理函数
-    dispatch_source_set_cancel_handler(timer, ^{
-        TJPLOG_INFO(@"[TJPConcreteSession] 取消消息 %@ 的重传计时器", messageId);
-    });
-    
-    // 保存定时器
-    self.retransmissionTimers[messageId] = timer;
-    
-    // 启动定时器
-    dispatch_resume(timer);
+    //设置重传间隔 到期后由时间轮批量回调handleRetransmissionForMessageId:
+    NSTimeInterval retryInterval = [self retransmissionTimeoutForContext:context];
+    [self.retransmissionWheel scheduleKey:messageId sequence:context.sequence afterInterval:retryInterval];
     
     TJPLOG_INFO(@"[TJPConcreteSession] 为消息 %@ 安排重传，间隔 %.1f 秒，当前重试次数 %ld", messageId, retryInterval, (long)context.retryCount);
 }
 
 
+/// 按测得RTT计算的重传超时 含指数退避 心跳未初始化时退回消息自身的超时配置
+- (NSTimeInterval)retransmissionTimeoutForContext:(TJPMessageContext *)context {
+    TJPNetworkCondition *condition = self.heartbeatManager.networkCondition;
+    if (!condition) {
+        return context.retryTimeout > 0 ? context.retryTimeout : kDefaultRetryInterval;
+    }
+    return [condition retransmissionTimeoutForRetryCount:context.retryCount];
+}
+
 // 重传处理方法
 - (void)handleRetransmissionForMessageId:(NSString *)messageId {
     // 获取消息上下文
     TJPMessageContext *context = self.pendingMessages[messageId];
         
-    // 清理计时器
-    dispatch_source_t timer = self.retransmissionTimers[messageId];
-    if (timer) {
-        dispatch_source_cancel(timer);
-        [self.retransmissionTimers removeObjectForKey:messageId];
-    }
+    // 清理计时器 时间轮回调时任务已移除 此处处理直接调用的情况
+    [self.retransmissionWheel cancelKey:messageId];
     
     // 如果消息已确认，不需要重传
     if (!context) {
@@ -994,13 +1422,19 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     if (context.retryCount >= context.maxRetryCount) {
         TJPLOG_ERROR(@"[TJPConcreteSession] 消息 %@ 重传失败，已达最大重试次数 %ld", messageId, (long)context.maxRetryCount);
 
-        // 移除待确认消息
+        // 移除待确认消息 释放窗口额度
         [self.pendingMessages removeObjectForKey:messageId];
         [self.sequenceToMessageId removeObjectForKey:@(context.sequence)];
+        [self.sendWindow releaseMessageId:messageId];
         
-        // 通知MessageManager连接异常
-        [self.messageManager updateMessage:messageId toState:TJPMessageStateFailed];
+        // 通知MessageManager连接异常 分片失败时整条消息失败
+        if (context.parentMessageId) {
+            [self failFragmentTransferForMessageId:context.parentMessageId];
+        } else {
+            [self.messageManager updateMessage:messageId toState:TJPMessageStateFailed];
+        }
         
+        [self drainSendWindow];
         return;
     }
     
@@ -1009,8 +1443,10 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     
     // 执行重传
     TJPLOG_INFO(@"[TJPConcreteSession] 重传消息 %@，第 %ld 次尝试", messageId, (long)context.retryCount + 1);
-    NSData *packet = [context buildRetryPacket];
-    [self.connectionManager sendData:packet withTimeout:-1 tag:context.sequence];
+    dispatch_data_t packet = [context buildRetryPacketData];
+    if (packet) {
+        [self.connectionManager sendPacketData:packet withTimeout:-1 tag:context.sequence];
+    }
     
     // 通知MessageManager状态变化：重新发送中
     [self.messageManager updateMessage:messageId toState:TJPMessageStateSending];
@@ -1027,15 +1463,9 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 }
 
 - (void)cancelAllRetransmissionTimersSync {
-    if (!_retransmissionTimers) return;
+    if (!_retransmissionWheel) return;
     
-    for (NSString *key in [_retransmissionTimers allKeys]) {
-        dispatch_source_t timer = _retransmissionTimers[key];
-        if (timer) {
-            dispatch_source_cancel(timer);
-        }
-    }
-    [_retransmissionTimers removeAllObjects];
+    [_retransmissionWheel cancelAll];
     
     TJPLOG_INFO(@"[TJPConcreteSession] 已清理所有重传计时器");
 }
@@ -1051,8 +1481,11 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
        
        for (NSString *messageId in [self.pendingMessages allKeys]) {
            TJPMessageContext *context = self.pendingMessages[messageId];
-           NSData *packet = [context buildRetryPacket];
-           [self.connectionManager sendData:packet withTimeout:-1 tag:context.sequence];
+           // 积压重发同样是重传 标记后其ACK不参与RTT采样 sendTime被刷新也不会导致RTT偏大
+           dispatch_data_t packet = [context buildRetryPacketData];
+           if (packet) {
+               [self.connectionManager sendPacketData:packet withTimeout:-1 tag:context.sequence];
+           }
            [self scheduleRetransmissionForMessageId:messageId];
        }
    });
@@ -1126,13 +1559,57 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
    // 清理待确认消息
    [self.pendingMessages removeAllObjects];
    
+   // 清空发送窗口 排队消息标记失败
+   [self resetSendWindow];
+   
+   // 丢弃未发出的延迟确认 对端会重传
+   [self discardDelayedAcks];
+   
+   // 断线后字典配置失效 重连时按协商结果重新启用
+   [self.compressionCodec reset];
+   
    // 停止网络监控
    [TJPMetricsConsoleReporter stop];
 }
 
 
+- (void)processReceivedPackets:(NSArray<TJPParsedPacket *> *)packets {
+    if (packets.count == 0) {
+        return;
+    }
+    
+    // 严格按解析顺序分发 连续的普通数据包合并处理 主线程通知和已读回执每段只调度一次
+    // 遇到其他类型的包先处理完之前的数据包 不改变线路上的先后顺序
+    NSMutableArray<TJPParsedPacket *> *dataPackets = nil;
+    for (TJPParsedPacket *packet in packets) {
+        if (packet.messageType == TJPMessageTypeNormalData && !packet.isDuplicate) {
+            if (!dataPackets) {
+                dataPackets = [NSMutableArray arrayWithCapacity:packets.count];
+            }
+            [dataPackets addObject:packet];
+            continue;
+        }
+        [self flushReceivedDataPackets:dataPackets];
+        [self processReceivedPacket:packet];
+    }
+    [self flushReceivedDataPackets:dataPackets];
+}
+
+- (void)flushReceivedDataPackets:(NSMutableArray<TJPParsedPacket *> *)dataPackets {
+    if (dataPackets.count == 0) {
+        return;
+    }
+    TJPLOG_INFO(@"[TJPConcreteSession] 批量处理普通数据包，数量: %lu", (unsigned long)dataPackets.count);
+    [self handleDataPackets:[dataPackets copy]];
+    [dataPackets removeAllObjects];
+}
+
 - (void)processReceivedPacket:(TJPParsedPacket *)packet {
     TJPLOG_INFO(@"[TJPConcreteSession] 处理数据包: 类型=%hu, 序列号=%u", packet.messageType, packet.sequence);
+    if (packet.isDuplicate) {
+        [self acknowledgeDuplicatePacket:packet];
+        return;
+    }
    switch (packet.messageType) {
        case TJPMessageTypeNormalData:
            TJPLOG_INFO(@"[TJPConcreteSession] 处理普通数据包，序列号: %u", packet.sequence);
@@ -1142,9 +1619,16 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
            TJPLOG_INFO(@"[TJPConcreteSession] 处理心跳包，序列号: %u", packet.sequence);
            [self.heartbeatManager heartbeatACKNowledgedForSequence:packet.sequence];
            break;
-       case TJPMessageTypeACK:
-           TJPLOG_INFO(@"[TJPConcreteSession] 处理ACK包，序列号: %u", packet.sequence);
-           [self handleACKForSequence:packet.sequence];
+       case TJPMessageTypeACK: {
+           NSIndexSet *sequences = [self selectiveAckSequencesFromPacket:packet];
+           if (sequences) {
+               TJPLOG_INFO(@"[TJPConcreteSession] 处理SACK包，确认 %lu 个序列号", (unsigned long)sequences.count);
+               [self handleACKForSequences:sequences];
+           } else {
+               TJPLOG_INFO(@"[TJPConcreteSession] 处理ACK包，序列号: %u", packet.sequence);
+               [self handleACKForSequence:packet.sequence];
+           }
+       }
            break;
        case TJPMessageTypeControl:
            TJPLOG_INFO(@"[TJPConcreteSession] 处理控制包，序列号: %u", packet.sequence);
@@ -1154,6 +1638,10 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
            TJPLOG_INFO(@"[TJPConcreteSession] 收到已读回执，序列号: %u", packet.sequence);
            [self handleReadReceiptPacket:packet];
        break;
+       case TJPMessageTypeFragment:
+           TJPLOG_INFO(@"[TJPConcreteSession] 收到消息分片，序列号: %u", packet.sequence);
+           [self handleFragmentPacket:packet];
+           break;
        default:
            TJPLOG_WARN(@"[TJPConcreteSession] 收到未知消息类型 %hu", packet.messageType);
            break;
@@ -1161,42 +1649,88 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 }
 
 - (void)handleDataPacket:(TJPParsedPacket *)packet {
-   if (!packet.payload) {
-       TJPLOG_ERROR(@"[TJPConcreteSession] 数据包载荷为空");
-       return;
-   }
+    [self handleDataPackets:@[packet]];
+}
+
+- (void)handleDataPackets:(NSArray<TJPParsedPacket *> *)packets {
+    NSMutableArray<TJPParsedPacket *> *validPackets = [NSMutableArray arrayWithCapacity:packets.count];
+    for (TJPParsedPacket *packet in packets) {
+        if (!packet.payload) {
+            TJPLOG_ERROR(@"[TJPConcreteSession] 数据包载荷为空，序列号: %u", packet.sequence);
+            continue;
+        }
+        [validPackets addObject:packet];
+    }
+    if (validPackets.count == 0) {
+        return;
+    }
     
-    // 发送消息接收通知 用于UI更新
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [[NSNotificationCenter defaultCenter] postNotificationName:kTJPMessageReceivedNotification
-                                                            object:nil
-                                                          userInfo:@{
-            @"data": packet.payload,
-            @"sequence": @(packet.sequence),
-            @"sessionId": self.sessionId ?: @"",
-            @"timestamp": [NSDate date],
-            @"messageType": @(packet.messageType)
-        }];
-        
-        TJPLOG_INFO(@"[TJPConcreteSession] 消息接收通知已发出，序列号: %u", packet.sequence);
-    });
-   
-   // 向上层通知收到数据 用于核心业务逻辑处理
-   if (self.delegate && [self.delegate respondsToSelector:@selector(session:didReceiveRawData:)]) {
-       dispatch_async(dispatch_get_main_queue(), ^{
-           [self.delegate session:self didReceiveRawData:packet.payload];
-       });
-   }
-   
-    // 发送ACK确认 - 确认接收到的数据包
-    [self sendAckForPacket:packet messageCategory:TJPMessageCategoryNormal];
+    [self notifyReceivedPackets:validPackets];
+    [self acknowledgeReceivedPackets:validPackets];
     
     // 简单策略：延迟2秒自动发送已读回执（应用层） 实际项目中可以根据需要手动调用
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2.0 * NSEC_PER_SEC)), self.sessionQueue, ^{
-        [self sendReadReceiptForMessageSequence:packet.sequence];
+        for (TJPParsedPacket *packet in validPackets) {
+            [self sendReadReceiptForMessageSequence:packet.sequence];
+        }
     });
 }
 
+/// 发送消息接收通知 用于UI更新  向上层通知收到数据 用于核心业务逻辑处理
+- (void)notifyReceivedPackets:(NSArray<TJPParsedPacket *> *)packets {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        BOOL notifyDelegate = self.delegate && [self.delegate respondsToSelector:@selector(session:didReceiveRawData:)];
+        for (TJPParsedPacket *packet in packets) {
+            [[NSNotificationCenter defaultCenter] postNotificationName:kTJPMessageReceivedNotification
+                                                                object:nil
+                                                              userInfo:@{
+                @"data": packet.payload,
+                @"sequence": @(packet.sequence),
+                @"sessionId": self.sessionId ?: @"",
+                @"timestamp": [NSDate date],
+                @"messageType": @(packet.messageType)
+            }];
+            
+            if (notifyDelegate) {
+                [self.delegate session:self didReceiveRawData:packet.payload];
+            }
+        }
+        
+        TJPLOG_INFO(@"[TJPConcreteSession] 消息接收通知已发出，数量: %lu", (unsigned long)packets.count);
+    });
+}
+
+/// 发送ACK确认 - 确认接收到的数据包 对端支持时累计后合并为一个SACK
+- (void)acknowledgeReceivedPackets:(NSArray<TJPParsedPacket *> *)packets {
+    if ([self isSelectiveAckEnabled]) {
+        NSMutableIndexSet *sequences = [NSMutableIndexSet indexSet];
+        for (TJPParsedPacket *packet in packets) {
+            [sequences addIndex:packet.sequence];
+        }
+        [self scheduleDelayedAckForSequences:sequences];
+    } else {
+        for (TJPParsedPacket *packet in packets) {
+            [self sendAckForPacket:packet messageCategory:TJPMessageCategoryNormal];
+        }
+    }
+}
+
+/// 重传的重复包不再上抛 按原类型重新确认 对端收到后停止重传
+- (void)acknowledgeDuplicatePacket:(TJPParsedPacket *)packet {
+    TJPLOG_INFO(@"[TJPConcreteSession] 收到重复包，重新确认，类型=%hu, 序列号: %u", packet.messageType, packet.sequence);
+    switch (packet.messageType) {
+        case TJPMessageTypeControl:
+            [self sendAckForPacket:packet messageCategory:TJPMessageCategoryControl];
+            break;
+        case TJPMessageTypeReadReceipt:
+            [self sendAckForPacket:packet messageCategory:TJPMessageCategoryNormal];
+            break;
+        default:
+            [self acknowledgeReceivedPackets:@[packet]];
+            break;
+    }
+}
+
 - (void)handleControlPacket:(TJPParsedPacket *)packet {
    // 解析控制包数据，处理版本协商等控制消息
    TJPLOG_INFO(@"[TJPConcreteSession] 收到控制包，长度: %lu", (unsigned long)packet.payload.length);
@@ -1245,6 +1779,11 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
                     [self.delegate session:self didCompleteVersionNegotiation:self.negotiatedVersion features:self.negotiatedFeatures];
                 });
             }
+        } else if (tag == TJP_TLV_TAG_FLOW_WINDOW) {
+            // 接收窗口通告 Value紧随Tag和Length
+            if (packet.payload.length >= 6 + (NSUInteger)length) {
+                [self handleFlowWindowValue:[packet.payload subdataWithRange:NSMakeRange(6, length)]];
+            }
         } else {
             TJPLOG_INFO(@"[TJPConcreteSession] 收到未知控制消息，标签: 0x%04X", tag);
         }
@@ -1271,11 +1810,22 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     
     // 示例：判断是否支持压缩
     if (features & TJP_FEATURE_COMPRESSION) {
-        TJPLOG_INFO(@"[TJPConcreteSession] 启用压缩功能");
-        // 配置压缩
+        TJPLOG_INFO(@"[TJPConcreteSession] 启用压缩功能，压缩阈值: %d 字节", TJP_COMPRESSION_MIN_SIZE);
     } else {
-        TJPLOG_INFO(@"[TJPConcreteSession] 禁用压缩功能");
-        // 禁用压缩
+        TJPLOG_INFO(@"[TJPConcreteSession] 禁用压缩功能，消息按原文发送");
+    }
+    
+    if ((features & TJP_FEATURE_COMPRESSION) && (features & TJP_FEATURE_COMPRESSION_DICTIONARY)) {
+        TJPLOG_INFO(@"[TJPConcreteSession] 启用预置字典压缩，字典ID: 0x%08X，压缩阈值: %d 字节", [TJPCompressionDictionary defaultDictionaryId], TJP_COMPRESSION_DICTIONARY_MIN_SIZE);
+    }
+    [self applyCompressionFeatures:features];
+    
+    if (features & TJP_FEATURE_SELECTIVE_ACK) {
+        TJPLOG_INFO(@"[TJPConcreteSession] 启用延迟选择性确认");
+    }
+    
+    if (features & TJP_FEATURE_FRAGMENTATION) {
+        TJPLOG_INFO(@"[TJPConcreteSession] 启用大消息分片，分片大小: %d 字节", TJP_FRAGMENT_SIZE);
     }
     
     // 配置其他功能
@@ -1320,63 +1870,150 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
     [ackPacket appendData:ackData];
     
     // 发送ACK数据包
-    [self.connectionManager sendData:ackPacket withTimeout:-1 tag:ackSeq];
+    [self sendControlPacket:ackPacket messageType:TJPMessageTypeACK sequence:ackSeq];
     
     TJPLOG_INFO(@"[TJPConcreteSession] 已发送 %@ ACK确认包，确认序列号: %u", [self messageTypeToString:packet.messageType], packet.sequence);
 }
 
+- (BOOL)isSelectiveAckEnabled {
+    return (self.negotiatedFeatures & TJP_FEATURE_SELECTIVE_ACK) != 0;
+}
+
+- (void)scheduleDelayedAckForSequences:(NSIndexSet *)sequences {
+    [self performOnSessionQueue:^{
+        BOOL wasEmpty = self.pendingAckSequences.count == 0;
+        [self.pendingAckSequences addIndexes:sequences];
+        
+        // 累计足够多的包立即确认
+        if (self.pendingAckSequences.count >= TJP_DELAYED_ACK_MAX_PACKETS) {
+            [self flushDelayedAcks];
+            return;
+        }
+        
+        // 首个待确认包启动延迟计时
+        if (wasEmpty) {
+            uint64_t generation = self.delayedAckGeneration;
+            __weak typeof(self) weakSelf = self;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(TJP_DELAYED_ACK_INTERVAL * NSEC_PER_SEC)), self.sessionQueue, ^{
+                __strong typeof(weakSelf) strongSelf = weakSelf;
+                if (!strongSelf || strongSelf.delayedAckGeneration != generation) return;
+                [strongSelf flushDelayedAcks];
+            });
+        }
+    }];
+}
+
+/// 发送累计的SACK 需在sessionQueue调用
+- (void)flushDelayedAcks {
+    self.delayedAckGeneration++;
+    if (self.pendingAckSequences.count == 0) {
+        return;
+    }
+    
+    NSIndexSet *sequences = [self.pendingAckSequences copy];
+    [self.pendingAckSequences removeAllIndexes];
+    
+    NSData *ackPacket = [TJPSelectiveAck ackPacketWithSequences:sequences sessionID:[TJPMessageBuilder sessionIDFromUUID:self.sessionId]];
+    [self sendControlPacket:ackPacket messageType:TJPMessageTypeACK sequence:(uint32_t)sequences.firstIndex];
+    
+    TJPLOG_INFO(@"[TJPConcreteSession] 已发送SACK确认包，确认 %lu 个序列号，起始序列号: %lu", (unsigned long)sequences.count, (unsigned long)sequences.firstIndex);
+}
+
+- (void)discardDelayedAcks {
+    self.delayedAckGeneration++;
+    [self.pendingAckSequences removeAllIndexes];
+}
+
+- (NSIndexSet *)selectiveAckSequencesFromPacket:(TJPParsedPacket *)packet {
+    // 未协商时不尝试按TLV解析 兼容旧格式ACK包体
+    if (![self isSelectiveAckEnabled] || packet.payload.length <= sizeof(uint16_t) + sizeof(uint32_t)) {
+        return nil;
+    }
+    
+    NSData *value = [packet tlvValueForTag:TJP_TLV_TAG_SELECTIVE_ACK];
+    return value ? [TJPSelectiveAck sequencesFromValue:value] : nil;
+}
+
 - (void)handleACKForSequence:(uint32_t)sequence {
     TJPLOG_INFO(@"[TJPConcreteSession] 进入handleACKForSequence方法，序列号: %u", sequence);
-   dispatch_async(self.sessionQueue, ^{
-       // 通过序列号查找messageId
-       
-       NSString *messageId = self.sequenceToMessageId[@(sequence)];
-       TJPMessageContext *context = self.pendingMessages[messageId];
-
-       if (context) {
-           switch (context.messageType) {
-               case TJPMessageTypeNormalData:
-                   TJPLOG_INFO(@"[TJPConcreteSession] 收到消息ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
-                   break;
-               case TJPMessageTypeControl:
-                   TJPLOG_INFO(@"[TJPConcreteSession] 收到控制消息ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
-                   break;
-               case TJPMessageTypeReadReceipt:
-                   TJPLOG_INFO(@"[TJPConcreteSession] 收到已读回执ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
-                   break;
-               default:
-                   TJPLOG_INFO(@"[TJPConcreteSession] 收到ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
-                   break;
-           }
-           // 通知MessageManager状态转换
-           [self.messageManager updateMessage:messageId toState:TJPMessageStateSent];
-                           
-           // 从待确认消息列表中移除
-           [self.pendingMessages removeObjectForKey:messageId];
-           
-           // 取消对应的重传计时器
-           dispatch_source_t timer = self.retransmissionTimers[messageId];
-           if (timer) {
-               TJPLOG_INFO(@"[TJPConcreteSession] 因收到ACK而取消消息 %u 的重传计时器", sequence);
-               dispatch_source_cancel(timer);
-               [self.retransmissionTimers removeObjectForKey:messageId];
-           }
-           // 对于普通消息，启动延迟清理（等待已读回执）
-           if (context.messageType == TJPMessageTypeNormalData) {
-               [self scheduleSequenceMappingCleanupForSequence:sequence messageId:messageId];
-           } else {
-               // 控制消息等不需要已读回执，直接清理
-               [self.sequenceToMessageId removeObjectForKey:@(sequence)];
-           }
-           
-       } else if ([self.heartbeatManager isHeartbeatSequence:sequence]) {
-           // 处理心跳ACK
-           TJPLOG_INFO(@"[TJPConcreteSession] 处理心跳ACK，序列号: %u", sequence);
-           [self.heartbeatManager heartbeatACKNowledgedForSequence:sequence];
-       } else {
-           TJPLOG_INFO(@"[TJPConcreteSession] 收到未知消息的ACK，序列号: %u", sequence);
-       }
-   });
+   [self performOnSessionQueue:^{
+       [self acknowledgeSequence:sequence];
+       [self drainSendWindow];
+   }];
+}
+
+- (void)handleACKForSequences:(NSIndexSet *)sequences {
+    // 一次调度完成全部序列号的确认和重传计时器取消
+    [self performOnSessionQueue:^{
+        [sequences enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+            [self acknowledgeSequence:(uint32_t)idx];
+        }];
+        // 整批确认后统一补发排队消息
+        [self drainSendWindow];
+    }];
+}
+
+/// 确认单个序列号 需在sessionQueue调用
+- (void)acknowledgeSequence:(uint32_t)sequence {
+    // 通过序列号查找messageId
+    
+    NSString *messageId = self.sequenceToMessageId[@(sequence)];
+    TJPMessageContext *context = self.pendingMessages[messageId];
+
+    if (context) {
+        switch (context.messageType) {
+            case TJPMessageTypeNormalData:
+                TJPLOG_INFO(@"[TJPConcreteSession] 收到消息ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
+                break;
+            case TJPMessageTypeControl:
+                TJPLOG_INFO(@"[TJPConcreteSession] 收到控制消息ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
+                break;
+            case TJPMessageTypeReadReceipt:
+                TJPLOG_INFO(@"[TJPConcreteSession] 收到已读回执ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
+                break;
+            case TJPMessageTypeFragment:
+                TJPLOG_INFO(@"[TJPConcreteSession] 收到分片ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
+                break;
+            default:
+                TJPLOG_INFO(@"[TJPConcreteSession] 收到ACK, ID: %@, 序列号: %u", messageId ?: @"unknown", sequence);
+                break;
+        }
+        // Karn算法 只采样未重传过的消息 重传后无法确定ACK对应哪次发送
+        if (!context.isRetransmitted && context.sendTime) {
+            NSTimeInterval rtt = [[NSDate date] timeIntervalSinceDate:context.sendTime] * 1000; //转毫秒
+            [self.heartbeatManager.networkCondition updateRTTWithSample:rtt];
+        }
+        
+        // 通知MessageManager状态转换 分片全部确认后才更新原始消息
+        if (context.parentMessageId) {
+            [self handleFragmentAcknowledged:context];
+        } else {
+            [self.messageManager updateMessage:messageId toState:TJPMessageStateSent];
+        }
+                        
+        // 从待确认消息列表中移除 释放窗口额度
+        [self.pendingMessages removeObjectForKey:messageId];
+        [self.sendWindow releaseMessageId:messageId];
+        
+        // 取消对应的重传计时器
+        if ([self.retransmissionWheel cancelKey:messageId]) {
+            TJPLOG_INFO(@"[TJPConcreteSession] 因收到ACK而取消消息 %u 的重传计时器", sequence);
+        }
+        // 对于普通消息，启动延迟清理（等待已读回执）
+        if (context.messageType == TJPMessageTypeNormalData) {
+            [self scheduleSequenceMappingCleanupForSequence:sequence messageId:messageId];
+        } else {
+            // 控制消息等不需要已读回执，直接清理
+            [self.sequenceToMessageId removeObjectForKey:@(sequence)];
+        }
+        
+    } else if ([self.heartbeatManager isHeartbeatSequence:sequence]) {
+        // 处理心跳ACK
+        TJPLOG_INFO(@"[TJPConcreteSession] 处理心跳ACK，序列号: %u", sequence);
+        [self.heartbeatManager heartbeatACKNowledgedForSequence:sequence];
+    } else {
+        TJPLOG_INFO(@"[TJPConcreteSession] 收到未知消息的ACK，序列号: %u", sequence);
+    }
 }
 
 - (void)scheduleSequenceMappingCleanupForSequence:(uint32_t)sequence messageId:(NSString *)messageId {
@@ -1491,7 +2128,7 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
                                                              sessionID:self.sessionId];
         
         if (packet) {
-            [self.connectionManager sendData:packet withTimeout:-1 tag:readReceiptSeq];
+            [self sendControlPacket:packet messageType:TJPMessageTypeReadReceipt sequence:readReceiptSeq];
             TJPLOG_INFO(@"[TJPConcreteSession] 已读回执已发送，确认消息序列号: %u", messageSequence);
         }
     });
@@ -1547,6 +2184,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
             return @"确认";
         case TJPMessageTypeControl:
             return @"控制消息";
+        case TJPMessageTypeFragment:
+            return @"消息分片";
         default:
             return @"未知类型";
     }
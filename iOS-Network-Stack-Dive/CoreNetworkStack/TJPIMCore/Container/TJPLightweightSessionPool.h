@@ -18,6 +18,7 @@ typedef struct {
     NSTimeInterval maxIdleTime;     //最大空闲时间
     NSTimeInterval cleanupInterval; //清理间隔
     NSUInteger maxReuseCount;       //最大复用次数
+    NSUInteger maxStandbyCount;     //每种类型最多预连接的待命会话数 0为不启用
 } TJPSessionPoolConfig;
 
 // 会话池统计信息
@@ -28,6 +29,8 @@ typedef struct {
     NSUInteger hitCount;            //命中次数
     NSUInteger missCount;           //未命中次数
     double hitRate;                 //命中率
+    NSUInteger standbySessions;     //待命会话数
+    NSUInteger standbyHitCount;     //直接取用待命会话的次数
     
 } TJPSessionPoolStats;
 
@@ -106,6 +109,44 @@ typedef struct {
                     count:(NSUInteger)count
                withConfig:(TJPNetworkConfig *)config;
 
+/**
+ * 为指定类型保持预连接的待命会话
+ * 待命会话已完成连接和版本握手 心跳按后台间隔运行 获取时直接交出 不再付出建连和握手耗时
+ * 待命数量按该类型近期的获取速率调整 至少保留1个 不超过maxStandbyCount
+ * 重复调用会更新目标主机配置 主机变化时旧的待命会话在下次刷新时替换
+ * @param type 会话类型
+ * @param config 网络配置 需包含主机和端口
+ */
+- (void)enableStandbyForType:(TJPSessionType)type withConfig:(TJPNetworkConfig *)config;
+
+/**
+ * 停止指定类型的待命会话并断开已有的待命连接
+ * @param type 会话类型
+ */
+- (void)disableStandbyForType:(TJPSessionType)type;
+
+/**
+ * 网络切换后重建全部待命会话 旧连接随网络失效
+ */
+- (void)rebuildStandbySessions;
+
+/**
+ * 网络不可用时断开全部待命会话 直到rebuildStandbySessions
+ */
+- (void)drainStandbySessions;
+
+/**
+ * 获取指定类型当前的待命目标数
+ * @param type 会话类型
+ */
+- (NSUInteger)getStandbyTargetForType:(TJPSessionType)type;
+
+/**
+ * 获取指定类型已就绪(已连接并完成握手)的待命会话数
+ * @param type 会话类型
+ */
+- (NSUInteger)getReadyStandbyCountForType:(TJPSessionType)type;
+
 /**
  * 获取池统计信息
  */
@@ -7,18 +7,41 @@
 
 #import "TJPLightweightSessionPool.h"
 #import "TJPConcreteSession.h"
+#import "TJPSessionIdleList.h"
 #import "TJPNetworkCoordinator.h"
 #import "TJPNetworkConfig.h"
 #import "TJPNetworkDefine.h"
+#import <time.h>
 
 // 默认配置常量
 static const TJPSessionPoolConfig kDefaultPoolConfig = {
     .maxPoolSize = 5,           // 每种类型最多5个会话
     .maxIdleTime = 300,         // 5分钟空闲超时
     .cleanupInterval = 60,      // 1分钟清理一次
-    .maxReuseCount = 50         // 最多复用50次
+    .maxReuseCount = 50,        // 最多复用50次
+    .maxStandbyCount = 2        // 每种类型最多2个待命会话
 };
 
+/// 单个会话类型的待命状态 仅在poolQueue访问
+@interface TJPStandbyTypeState : NSObject
+
+// 待命会话的目标主机配置
+@property (nonatomic, strong) TJPNetworkConfig *config;
+// 待命会话 含连接中和已就绪的
+@property (nonatomic, strong) TJPSessionIdleList *sessions;
+// 平滑后的获取速率 次/秒
+@property (nonatomic, assign) double acquireRate;
+// 上次采样时该类型的累计获取次数和时间
+@property (nonatomic, assign) NSUInteger lastAcquireCount;
+@property (nonatomic, assign) uint64_t lastSampleTime;
+// 当前目标待命数
+@property (nonatomic, assign) NSUInteger target;
+
+@end
+
+@implementation TJPStandbyTypeState
+@end
+
 
 @interface TJPLightweightSessionPool () {
     // 健康检查缓存
@@ -28,8 +51,8 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
 
 }
 
-// 按类型存储的会话池
-@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSMutableArray<TJPConcreteSession *> *> *sessionPools;
+// 按类型存储的会话池 每种类型一条按活跃时间排序的空闲链表
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, TJPSessionIdleList *> *sessionPools;
 // 活跃会话池
 @property (nonatomic, strong) NSMutableSet<TJPConcreteSession *> *activeSessions;
 // 池管理队列
@@ -37,10 +60,19 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
 
 @property (nonatomic, strong) dispatch_source_t cleanupTimer;
 
+// 按类型的待命会话状态
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, TJPStandbyTypeState *> *standbyStates;
+@property (nonatomic, strong) dispatch_source_t standbyTimer;
+// 网络不可用时暂停补充待命会话
+@property (nonatomic, assign) BOOL standbySuspended;
+
 
 // 统计信息
 @property (nonatomic, assign) NSUInteger hitCount;
 @property (nonatomic, assign) NSUInteger missCount;
+@property (nonatomic, assign) NSUInteger standbyHitCount;
+// 按类型累计的获取次数(命中+未命中) 用于估算待命数
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> *typeAcquireCounts;
 
 // 池状态
 @property (nonatomic, assign) BOOL isRunning;
@@ -74,6 +106,8 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         
         _sessionPools = [NSMutableDictionary dictionary];
         _activeSessions = [NSMutableSet set];
+        _standbyStates = [NSMutableDictionary dictionary];
+        _typeAcquireCounts = [NSMutableDictionary dictionary];
         
         _poolQueue = dispatch_queue_create("com.tjp.sessionpool.queue", DISPATCH_QUEUE_SERIAL);
         
@@ -116,6 +150,13 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         self.isRunning = NO;
         
         [self stopCleanupTimer];
+        [self stopStandbyTimer];
+        
+        // 断开待命会话
+        for (TJPStandbyTypeState *state in self.standbyStates.allValues) {
+            [self discardStandbySessionsInState:state];
+        }
+        [self.standbyStates removeAllObjects];
         
         // 断开活跃会话
         for (TJPConcreteSession *session in [self.activeSessions copy]) {
@@ -125,14 +166,14 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         
         // 清理池中会话
         for (NSNumber *typeKey in [self.sessionPools allKeys]) {
-            // 获取对应类型的池数组
-            NSMutableArray *pool = self.sessionPools[typeKey];
+            // 获取对应类型的空闲链表
+            TJPSessionIdleList *pool = self.sessionPools[typeKey];
             
-            for (TJPConcreteSession *session in [pool copy]) {
+            for (TJPConcreteSession *session in [pool allSessions]) {
                 [session disconnectWithReason:TJPDisconnectReasonUserInitiated];
                 session.isPooled = NO;
             }
-            [pool removeAllObjects];
+            [pool removeAllSessions];
         }
         [self.sessionPools removeAllObjects];
         TJPLOG_INFO(@"[SessionPool] 会话池已停止");
@@ -166,23 +207,38 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
             if (session) {
                 [self.activeSessions addObject:session];
                 self.missCount++;
+                [self recordAcquireForType:type];
             }
             return;
         }
         
-        // 尝试从池中获取可复用的会话
+        [self recordAcquireForType:type];
+        
+        // 优先取用已连接并完成握手的待命会话 保留连接和协商结果
+        session = [self takeStandbySessionForType:type withConfig:config];
+        if (session) {
+            self.hitCount++;
+            self.standbyHitCount++;
+            [self.activeSessions addObject:session];
+            [session promoteFromStandby];
+            TJPLOG_INFO(@"[SessionPool] 取用待命会话 %@ (类型:%lu)", session.sessionId, (unsigned long)type);
+            
+            // 补充被取走的待命会话
+            dispatch_async(self.poolQueue, ^{
+                [self replenishStandbyForType:type];
+            });
+            return;
+        }
+        
+        // 尝试从池中获取可复用的会话 候选已从空闲链表摘除
         session = [self getReusableSessionForType:type];
         
         if (session) {
             // 获取到池
             self.hitCount++;
-            // 先加入活跃集合 避免提前释放
+            // 加入活跃列表
             [self.activeSessions addObject:session];
             
-            //从池中移除 加入活跃列表
-            NSMutableArray *pool = [self getPoolForType:type];
-            [pool removeObject:session];
-            
             session.isPooled = NO;
             session.lastActiveTime = [NSDate date];
             
@@ -260,9 +316,9 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         //从活跃列表移除
         [self.activeSessions removeObject:concreteSession];
         
-        //从池中移除
-        NSMutableArray *pool = [self getPoolForType:concreteSession.sessionType];
-        [pool removeObject:concreteSession];
+        //从池中或待命列表中移除
+        [[self getPoolForType:concreteSession.sessionType] removeSession:concreteSession];
+        [self.standbyStates[@(concreteSession.sessionType)].sessions removeSession:concreteSession];
         
         //断开连接
         [concreteSession disconnectWithReason:TJPDisconnectReasonUserInitiated];
@@ -276,7 +332,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     if (count == 0) return;
     dispatch_async(self.poolQueue, ^{
         // 获取对应类型的池
-        NSMutableArray *pool = [self getPoolForType:type];
+        TJPSessionIdleList *pool = [self getPoolForType:type];
         NSUInteger currentCount = pool.count;
         NSUInteger targetCount = MIN(count, self.config.maxPoolSize);
         
@@ -305,6 +361,224 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     });
 }
 
+#pragma mark - Standby
+- (void)enableStandbyForType:(TJPSessionType)type withConfig:(TJPNetworkConfig *)config {
+    if (config.host.length == 0) {
+        TJPLOG_WARN(@"[SessionPool] 待命会话需要主机地址，类型 %lu 未启用", (unsigned long)type);
+        return;
+    }
+    dispatch_async(self.poolQueue, ^{
+        if (!self.isRunning || self.config.maxStandbyCount == 0) {
+            return;
+        }
+        
+        TJPStandbyTypeState *state = self.standbyStates[@(type)];
+        if (!state) {
+            state = [[TJPStandbyTypeState alloc] init];
+            state.sessions = [[TJPSessionIdleList alloc] init];
+            state.lastAcquireCount = [self.typeAcquireCounts[@(type)] unsignedIntegerValue];
+            state.lastSampleTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+            state.target = 1;
+            self.standbyStates[@(type)] = state;
+            TJPLOG_INFO(@"[SessionPool] 启用类型 %lu 的待命会话，目标 %@:%u", (unsigned long)type, config.host, config.port);
+        } else if (![self standbyState:state matchesConfig:config]) {
+            // 目标主机变化 旧的待命连接不再可用
+            TJPLOG_INFO(@"[SessionPool] 类型 %lu 的待命目标变更为 %@:%u", (unsigned long)type, config.host, config.port);
+            [self discardStandbySessionsInState:state];
+        }
+        state.config = config;
+        
+        if (!self.standbyTimer) {
+            [self startStandbyTimer];
+        }
+        [self replenishStandbyForType:type];
+    });
+}
+
+- (void)disableStandbyForType:(TJPSessionType)type {
+    dispatch_async(self.poolQueue, ^{
+        TJPStandbyTypeState *state = self.standbyStates[@(type)];
+        if (!state) {
+            return;
+        }
+        [self discardStandbySessionsInState:state];
+        [self.standbyStates removeObjectForKey:@(type)];
+        if (self.standbyStates.count == 0) {
+            [self stopStandbyTimer];
+        }
+        TJPLOG_INFO(@"[SessionPool] 停用类型 %lu 的待命会话", (unsigned long)type);
+    });
+}
+
+- (void)rebuildStandbySessions {
+    dispatch_async(self.poolQueue, ^{
+        self.standbySuspended = NO;
+        for (NSNumber *typeKey in self.standbyStates) {
+            [self discardStandbySessionsInState:self.standbyStates[typeKey]];
+            [self replenishStandbyForType:[typeKey unsignedIntegerValue]];
+        }
+        TJPLOG_INFO(@"[SessionPool] 网络切换，重建待命会话");
+    });
+}
+
+- (void)drainStandbySessions {
+    dispatch_async(self.poolQueue, ^{
+        self.standbySuspended = YES;
+        for (TJPStandbyTypeState *state in self.standbyStates.allValues) {
+            [self discardStandbySessionsInState:state];
+        }
+        TJPLOG_INFO(@"[SessionPool] 网络不可用，断开全部待命会话");
+    });
+}
+
+- (NSUInteger)getStandbyTargetForType:(TJPSessionType)type {
+    __block NSUInteger target = 0;
+    dispatch_sync(self.poolQueue, ^{
+        target = self.standbyStates[@(type)].target;
+    });
+    return target;
+}
+
+- (NSUInteger)getReadyStandbyCountForType:(TJPSessionType)type {
+    __block NSUInteger count = 0;
+    dispatch_sync(self.poolQueue, ^{
+        for (TJPConcreteSession *session in [self.standbyStates[@(type)].sessions allSessions]) {
+            if ([session isStandbyReady]) {
+                count++;
+            }
+        }
+    });
+    return count;
+}
+
+/// 累计该类型的获取次数 需在poolQueue上调用
+- (void)recordAcquireForType:(TJPSessionType)type {
+    self.typeAcquireCounts[@(type)] = @([self.typeAcquireCounts[@(type)] unsignedIntegerValue] + 1);
+}
+
+- (BOOL)standbyState:(TJPStandbyTypeState *)state matchesConfig:(TJPNetworkConfig *)config {
+    return [state.config.host isEqualToString:config.host] && state.config.port == config.port;
+}
+
+/// 取出一个已就绪的待命会话 目标主机不一致时不取用 需在poolQueue上调用
+- (TJPConcreteSession *)takeStandbySessionForType:(TJPSessionType)type withConfig:(TJPNetworkConfig *)config {
+    TJPStandbyTypeState *state = self.standbyStates[@(type)];
+    if (!state || state.sessions.count == 0 || (config && ![self standbyState:state matchesConfig:config])) {
+        return nil;
+    }
+    
+    // 待命列表不超过maxStandbyCount 连接中的会话跳过
+    for (TJPConcreteSession *session = state.sessions.head; session; session = session.poolNext) {
+        if ([session isStandbyReady]) {
+            [state.sessions removeSession:session];
+            return session;
+        }
+    }
+    return nil;
+}
+
+/// 按获取速率更新目标待命数 需在poolQueue上调用
+- (void)updateStandbyTargetForType:(TJPSessionType)type state:(TJPStandbyTypeState *)state {
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    double elapsed = (double)(now - state.lastSampleTime) / NSEC_PER_SEC;
+    if (elapsed <= 0) {
+        return;
+    }
+    
+    NSUInteger acquireCount = [self.typeAcquireCounts[@(type)] unsignedIntegerValue];
+    double instantRate = (double)(acquireCount - state.lastAcquireCount) / elapsed;
+    state.acquireRate = TJP_STANDBY_RATE_SMOOTHING * instantRate + (1 - TJP_STANDBY_RATE_SMOOTHING) * state.acquireRate;
+    state.lastAcquireCount = acquireCount;
+    state.lastSampleTime = now;
+    
+    // 预留未来一段时间的获取量 至少保留1个 冷启动和网络切换后的首次获取也能命中
+    NSUInteger target = (NSUInteger)ceil(state.acquireRate * TJP_STANDBY_LOOKAHEAD);
+    target = MAX(target, 1);
+    target = MIN(target, self.config.maxStandbyCount);
+    if (target != state.target) {
+        TJPLOG_INFO(@"[SessionPool] 类型 %lu 获取速率 %.3f次/秒，待命目标 %lu -> %lu", (unsigned long)type, state.acquireRate, (unsigned long)state.target, (unsigned long)target);
+        state.target = target;
+    }
+}
+
+/// 清理失效的待命会话并补足到目标数 需在poolQueue上调用
+- (void)replenishStandbyForType:(TJPSessionType)type {
+    TJPStandbyTypeState *state = self.standbyStates[@(type)];
+    if (!state || !self.isRunning || !self.poolEnabled || self.standbySuspended) {
+        return;
+    }
+    
+    // 超过连接超时仍未连上或已断开的会话移除
+    NSDate *now = [NSDate date];
+    for (TJPConcreteSession *session in [state.sessions allSessions]) {
+        BOOL disconnected = [session.connectState isEqualToString:TJPConnectStateDisconnected];
+        if (disconnected && [now timeIntervalSinceDate:session.createdTime] > state.config.connectTimeout) {
+            TJPLOG_INFO(@"[SessionPool] 待命会话 %@ 已断开，移除", session.sessionId);
+            [state.sessions removeSession:session];
+            [self discardStandbySession:session];
+        } else if ([session isStandbyReady]) {
+            // 应用回到前台时心跳管理器会切回前台间隔 待命会话重新切到后台间隔
+            [session enterStandby];
+        }
+    }
+    
+    // 速率下降 多余的待命会话从最早建立的开始断开
+    while (state.sessions.count > state.target) {
+        [self discardStandbySession:[state.sessions popTail]];
+    }
+    
+    while (state.sessions.count < state.target) {
+        TJPConcreteSession *session = [self createNewSessionForType:type withConfig:state.config];
+        if (!session) {
+            break;
+        }
+        [session enterStandby];
+        [state.sessions insertSession:session];
+        [session connectToHost:state.config.host port:state.config.port];
+        TJPLOG_INFO(@"[SessionPool] 创建待命会话 %@ (类型:%lu)，待命数 %lu/%lu", session.sessionId, (unsigned long)type, (unsigned long)state.sessions.count, (unsigned long)state.target);
+    }
+}
+
+- (void)refreshStandbySessions {
+    for (NSNumber *typeKey in self.standbyStates) {
+        TJPSessionType type = [typeKey unsignedIntegerValue];
+        [self updateStandbyTargetForType:type state:self.standbyStates[typeKey]];
+        [self replenishStandbyForType:type];
+    }
+}
+
+- (void)discardStandbySessionsInState:(TJPStandbyTypeState *)state {
+    TJPConcreteSession *session = nil;
+    while ((session = [state.sessions popHead])) {
+        [self discardStandbySession:session];
+    }
+}
+
+- (void)discardStandbySession:(TJPConcreteSession *)session {
+    [session disconnectWithReason:TJPDisconnectReasonUserInitiated];
+}
+
+- (void)startStandbyTimer {
+    [self stopStandbyTimer];
+    
+    self.standbyTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.poolQueue);
+    uint64_t interval = (uint64_t)(TJP_STANDBY_REFRESH_INTERVAL * NSEC_PER_SEC);
+    dispatch_source_set_timer(self.standbyTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, (1ull * NSEC_PER_SEC) / 10);
+    
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(self.standbyTimer, ^{
+        [weakSelf refreshStandbySessions];
+    });
+    dispatch_resume(self.standbyTimer);
+}
+
+- (void)stopStandbyTimer {
+    if (self.standbyTimer) {
+        dispatch_source_cancel(self.standbyTimer);
+        self.standbyTimer = nil;
+    }
+}
+
 #pragma mark - Private Method
 - (void)setupApplicationNotifications {
     [[NSNotificationCenter defaultCenter] addObserver:self
@@ -359,101 +633,43 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
 }
 
 - (TJPConcreteSession *)getReusableSessionForType:(TJPSessionType)type {
-    NSMutableArray *pool = [self getPoolForType:type];
+    TJPSessionIdleList *pool = self.sessionPools[@(type)];
     
-    if (!pool || pool.count == 0) {
+    if (pool.count == 0) {
         TJPLOG_INFO(@"[SessionPool] 类型 %lu 的池为空或不存在", (unsigned long)type);
         return nil;
     }
     
-    // 创建数组副本，避免在遍历时修改原数组
-    NSArray *poolCopy = [pool copy];
-    
-    // 寻找最适合复用的会话（空闲时间短且使用次数少的优先）
-    TJPConcreteSession *bestSession = nil;
-    NSTimeInterval shortestIdleTime = INFINITY;
-    NSMutableArray *sessionsToRemove = [NSMutableArray array];
-
-    
-    for (TJPConcreteSession *session in poolCopy) {
-        // 强引用保持会话，防止在检查过程中被释放
-        TJPConcreteSession *strongSession = session;
-        
-        // 验证会话有效性
-        if (!strongSession || !strongSession.sessionId || strongSession.sessionId.length == 0) {
-            TJPLOG_INFO(@"[SessionPool] 发现无效会话: %@，标记移除", strongSession.sessionId);
-            [sessionsToRemove addObject:strongSession];
-            continue;
-        }
-
-        // 检查会话健康状况
-        @try {
-            if (![strongSession checkHealthyForSession]) {
-                TJPLOG_INFO(@"[SessionPool] 会话 %@ 健康检查失败，标记移除", strongSession.sessionId);
-                [sessionsToRemove addObject:strongSession];
-                continue;
-            }
-        } @catch (NSException *exception) {
-            TJPLOG_INFO(@"[SessionPool] 健康检查异常: %@，会话: %@", exception.reason, strongSession.sessionId ?: @"unknown");
-            [sessionsToRemove addObject:strongSession];
-            continue;
-        }
-        
-        // 计算空闲时间
-        NSTimeInterval idleTime = 0;
+    // 链表头部即最近活跃的会话 只对准备返回的候选做健康检查
+    // 不健康的候选摘除后交给池队列异步断开 获取路径不做清理
+    TJPConcreteSession *candidate = nil;
+    while ((candidate = [pool popHead])) {
+        BOOL healthy = NO;
         @try {
-            NSDate *lastActiveTime = strongSession.lastActiveTime;
-            if (lastActiveTime) {
-                idleTime = [[NSDate date] timeIntervalSinceDate:lastActiveTime];
-            }
+            healthy = candidate.sessionId.length > 0 && [candidate checkHealthyForSession];
         } @catch (NSException *exception) {
-            TJPLOG_INFO(@"[SessionPool] 计算空闲时间异常: %@", exception.reason);
-            [sessionsToRemove addObject:strongSession];
-            continue;
+            TJPLOG_INFO(@"[SessionPool] 健康检查异常: %@，会话: %@", exception.reason, candidate.sessionId ?: @"unknown");
         }
         
-        // 选择最佳会话
-        if (idleTime < shortestIdleTime) {
-            shortestIdleTime = idleTime;
-            bestSession = strongSession;
+        if (healthy) {
+            TJPLOG_INFO(@"[SessionPool] 找到最佳会话: %@", candidate.sessionId);
+            return candidate;
         }
         
-        TJPLOG_INFO(@"[SessionPool] 会话 %@ 检查通过，空闲时间: %.1f秒", strongSession.sessionId, idleTime);
-        
-        // 安全移除无效会话
-        [self safelyRemoveSessionsFromPool:sessionsToRemove fromPool:pool];
-        
-        if (bestSession) {
-            TJPLOG_INFO(@"[SessionPool] 找到最佳会话: %@，空闲时间: %.1f秒", bestSession.sessionId, shortestIdleTime);
-        } else {
-            TJPLOG_INFO(@"[SessionPool] 未找到可复用的会话");
-        }
+        TJPLOG_INFO(@"[SessionPool] 会话 %@ 健康检查失败，移出池", candidate.sessionId ?: @"unknown");
+        [self evictSessionLater:candidate];
     }
     
-    return bestSession;
+    TJPLOG_INFO(@"[SessionPool] 未找到可复用的会话");
+    return nil;
 }
 
-- (void)safelyRemoveSessionsFromPool:(NSArray *)sessionsToRemove fromPool:(NSMutableArray *)pool {
-    if (sessionsToRemove.count == 0) return;
-    
-    TJPLOG_INFO(@"[SessionPool] 准备移除 %lu 个无效会话", (unsigned long)sessionsToRemove.count);
-    
-    for (TJPConcreteSession *session in sessionsToRemove) {
-        @try {
-            // 安全移除，不触发额外的释放
-            if ([pool containsObject:session]) {
-                [pool removeObject:session];
-                TJPLOG_INFO(@"[SessionPool] 已移除会话: %@", session.sessionId ?: @"unknown");
-                
-                // 标记为非池状态，但不调用断开
-                if (session) {
-                    session.isPooled = NO;
-                }
-            }
-        } @catch (NSException *exception) {
-            TJPLOG_INFO(@"[SessionPool] 移除会话异常: %@", exception.reason);
-        }
-    }
+/// 已摘除的会话延后断开 需在poolQueue上调用
+- (void)evictSessionLater:(TJPConcreteSession *)session {
+    session.isPooled = NO;
+    dispatch_async(self.poolQueue, ^{
+        [session disconnectWithReason:TJPDisconnectReasonIdleTimeout];
+    });
 }
 
 - (void)startCleanupTimer {
@@ -487,7 +703,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     }
 }
 
-- (NSMutableArray *)getPoolForType:(TJPSessionType)type {
+- (TJPSessionIdleList *)getPoolForType:(TJPSessionType)type {
     // 验证 sessionPools
     if (!self.sessionPools) {
         TJPLOG_ERROR(@"[SessionPool] sessionPools 为 nil，重新初始化");
@@ -495,10 +711,10 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     }
     
     NSNumber *typeKey = @(type);
-    NSMutableArray *pool = self.sessionPools[typeKey];
+    TJPSessionIdleList *pool = self.sessionPools[typeKey];
     
     if (!pool) {
-        pool = [NSMutableArray array];
+        pool = [[TJPSessionIdleList alloc] init];
         self.sessionPools[typeKey] = pool;
         TJPLOG_INFO(@"[SessionPool] 创建类型 %lu 的新池，容量: %lu", (unsigned long)type, (unsigned long)self.config.maxPoolSize);
     }
@@ -541,7 +757,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
 
 - (BOOL)shouldPoolSession:(TJPConcreteSession *)session {
     //检查池是否已满
-    NSMutableArray *pool = [self getPoolForType:session.sessionType];
+    TJPSessionIdleList *pool = [self getPoolForType:session.sessionType];
     if (pool.count >= self.config.maxPoolSize) {
         return NO;
     }
@@ -595,7 +811,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         self.sessionPools = [NSMutableDictionary dictionary];
     }
     
-    NSMutableArray *pool = [self getPoolForType:session.sessionType];
+    TJPSessionIdleList *pool = [self getPoolForType:session.sessionType];
     
     // 验证获取到的池
     if (!pool) {
@@ -603,28 +819,29 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         return;
     }
     
-    // 检查池是否已满
-    if (pool.count >= self.config.maxPoolSize) {
-        TJPLOG_INFO(@"[SessionPool] 类型 %lu 的池已满，移除最旧会话", (unsigned long)session.sessionType);
-        TJPConcreteSession *oldestSession = [pool firstObject];
-        if (oldestSession) {
-            [pool removeObject:oldestSession];
-            [oldestSession prepareForRelease];
-        }
-    }
-    
     // 检查是否已在池中
-    if ([pool containsObject:session]) {
+    if ([pool containsSession:session]) {
         TJPLOG_WARN(@"[SessionPool] 会话 %@ 已在池中，跳过添加", session.sessionId);
         return;
     }
     
+    // 检查池是否已满 淘汰链表尾部最久未活跃的会话
+    if (pool.count >= self.config.maxPoolSize) {
+        TJPLOG_INFO(@"[SessionPool] 类型 %lu 的池已满，移除最旧会话", (unsigned long)session.sessionType);
+        TJPConcreteSession *oldestSession = [pool popTail];
+        oldestSession.isPooled = NO;
+        [oldestSession prepareForRelease];
+    }
+    
+    // 归还即视为刚活跃 空闲链表按此排序 空闲超时也从此刻开始计算
+    NSDate *now = [NSDate date];
     session.isPooled = YES;
-    session.lastReleaseTime = [NSDate date];
+    session.lastActiveTime = now;
+    session.lastReleaseTime = now;
     
     // try-catch 防护
     @try {
-        [pool addObject:session];
+        [pool insertSession:session];
         TJPLOG_INFO(@"[SessionPool] 成功添加会话 %@ 到类型 %lu 的池中，池大小: %lu/%lu",
                    session.sessionId, (unsigned long)session.sessionType,
                    (unsigned long)pool.count, (unsigned long)self.config.maxPoolSize);
@@ -650,12 +867,13 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
 }
 
 - (NSUInteger)performCleanupForType:(TJPSessionType)type {
-    NSMutableArray *pool = [self getPoolForType:type];
+    TJPSessionIdleList *pool = [self getPoolForType:type];
     NSMutableArray *sessionsToRemove = [NSMutableArray array];
     
     NSDate *now = [NSDate date];
     
-    for (TJPConcreteSession *session in [pool copy]) {
+    // 过期淘汰和健康检查都在定时清理中完成 不占用获取路径
+    for (TJPConcreteSession *session in [pool allSessions]) {
         BOOL shouldRemove = NO;
         
         // 检查空闲时间
@@ -678,7 +896,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     
     // 移除无效会话
     for (TJPConcreteSession *session in sessionsToRemove) {
-        [pool removeObject:session];
+        [pool removeSession:session];
         [session disconnectWithReason:TJPDisconnectReasonIdleTimeout];
         session.isPooled = NO;
     }
@@ -694,12 +912,16 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     dispatch_sync(self.poolQueue, ^{
         stats.activeSessions = self.activeSessions.count;
         
-        for (NSMutableArray *pool in self.sessionPools.allValues) {
+        for (TJPSessionIdleList *pool in self.sessionPools.allValues) {
             stats.pooledSessions += pool.count;
         }
+        for (TJPStandbyTypeState *state in self.standbyStates.allValues) {
+            stats.standbySessions += state.sessions.count;
+        }
         
-        stats.totalSessions = stats.activeSessions + stats.pooledSessions;
+        stats.totalSessions = stats.activeSessions + stats.pooledSessions + stats.standbySessions;
         stats.hitCount = self.hitCount;
+        stats.standbyHitCount = self.standbyHitCount;
         stats.missCount = self.missCount;
         
         NSUInteger totalRequests = self.hitCount + self.missCount;
@@ -721,7 +943,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         }
         
         // 统计池中会话
-        NSMutableArray *pool = self.sessionPools[@(type)];
+        TJPSessionIdleList *pool = self.sessionPools[@(type)];
         count += pool.count;
     });
     
@@ -732,7 +954,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     __block NSUInteger count = 0;
     
     dispatch_sync(self.poolQueue, ^{
-        NSMutableArray *pool = self.sessionPools[@(type)];
+        TJPSessionIdleList *pool = self.sessionPools[@(type)];
         count = pool.count;
     });
     
@@ -743,6 +965,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
     dispatch_async(self.poolQueue, ^{
         self.hitCount = 0;
         self.missCount = 0;
+        self.standbyHitCount = 0;
         TJPLOG_INFO(@"[SessionPool] 已重置会话池统计信息");
     });
 }
@@ -788,6 +1011,7 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
         TJPLOG_INFO(@"总会话数: %lu", (unsigned long)stats.totalSessions);
         TJPLOG_INFO(@"活跃会话: %lu", (unsigned long)stats.activeSessions);
         TJPLOG_INFO(@"池中会话: %lu", (unsigned long)stats.pooledSessions);
+        TJPLOG_INFO(@"待命会话: %lu, 待命命中: %lu", (unsigned long)stats.standbySessions, (unsigned long)stats.standbyHitCount);
         TJPLOG_INFO(@"命中率: %.2f%% (%lu/%lu)", stats.hitRate * 100, (unsigned long)stats.hitCount, (unsigned long)(stats.hitCount + stats.missCount));
         
         for (NSNumber *typeKey in [self.sessionPools allKeys]) {
@@ -812,7 +1036,8 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
             @"maxPoolSize": @(self.config.maxPoolSize),
             @"maxIdleTime": @(self.config.maxIdleTime),
             @"cleanupInterval": @(self.config.cleanupInterval),
-            @"maxReuseCount": @(self.config.maxReuseCount)
+            @"maxReuseCount": @(self.config.maxReuseCount),
+            @"maxStandbyCount": @(self.config.maxStandbyCount)
         };
         info[@"stats"] = @{
             @"totalSessions": @(stats.totalSessions),
@@ -820,7 +1045,9 @@ static const TJPSessionPoolConfig kDefaultPoolConfig = {
             @"pooledSessions": @(stats.pooledSessions),
             @"hitCount": @(stats.hitCount),
             @"missCount": @(stats.missCount),
-            @"hitRate": @(stats.hitRate)
+            @"hitRate": @(stats.hitRate),
+            @"standbySessions": @(stats.standbySessions),
+            @"standbyHitCount": @(stats.standbyHitCount)
         };
         
         NSMutableDictionary *typeInfo = [NSMutableDictionary dictionary];
@@ -13,14 +13,14 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @protocol TJPSessionProtocol;
-@class Reachability, TJPNetworkConfig, TJPLightweightSessionPool;
+@class Reachability, TJPNetworkConfig, TJPLightweightSessionPool, TJPParseLaneScheduler;
 
 @interface TJPNetworkCoordinator : NSObject <TJPSessionDelegate>
-/// 管理当前正在使用的会话 按sessionId索引
-@property (nonatomic, strong, readonly) NSMapTable<NSString *, id<TJPSessionProtocol>> *sessionMap;
+/// 当前正在使用的会话 按sessionId索引 每次读取返回不可变快照
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, id<TJPSessionProtocol>> *sessionMap;
 
-/// Session类型 为多路复用做支撑
-@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSString *> *sessionTypeMap;
+/// Session类型到sessionId的映射 为多路复用做支撑 每次读取返回不可变快照
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSString *> *sessionTypeMap;
 
 /// 会话池 管理会话复用
 @property (nonatomic, strong) TJPLightweightSessionPool *sessionPool;
@@ -28,10 +28,10 @@ NS_ASSUME_NONNULL_BEGIN
 /// 网络状态
 @property (nonatomic, strong) Reachability *reachability;
 
-/// session专用队列 串行:增删改查操作
+/// session专用队列 串行:重连、状态同步等会话管理操作 会话查找不经过此队列
 @property (nonatomic, strong) dispatch_queue_t sessionQueue;
-/// 解析专用队列  串行：数据解析专用
-@property (nonatomic, strong) dispatch_queue_t parseQueue;
+/// 解析通道调度器 每个会话一个串行解析通道 会话间按CPU核数并行
+@property (nonatomic, strong, readonly) TJPParseLaneScheduler *parseLaneScheduler;
 /// 监控专用队列  串行：网络监控相关
 @property (nonatomic, strong) dispatch_queue_t monitorQueue;
 
@@ -56,6 +56,10 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)scheduleReconnectForSession:(id<TJPSessionProtocol>)session;
 /// 移除会话
 - (void)removeSession:(id<TJPSessionProtocol>)session;
+/// 按类型获取会话 无锁竞争 可在发送路径频繁调用
+- (nullable id<TJPSessionProtocol>)sessionForType:(TJPSessionType)type;
+/// 为指定类型保持预连接的待命会话 冷启动时已知服务器地址可提前调用 聊天和信令会话在首次创建后自动启用
+- (void)enableStandbySessionsForType:(TJPSessionType)type withConfig:(TJPNetworkConfig *)config;
 
 @end
 
@@ -15,12 +15,17 @@
 #import "TJPNetworkDefine.h"
 #import "TJPReconnectPolicy.h"
 #import "TJPLightweightSessionPool.h"
+#import "TJPParseLaneScheduler.h"
+#import "TJPSessionRegistry.h"
 
 
 
 @interface TJPNetworkCoordinator () <TJPSessionDelegate>
 @property (nonatomic, strong) TJPNetworkConfig *currConfig;
 
+// 活跃会话注册表 写时复制 查找无需排队
+@property (nonatomic, strong) TJPSessionRegistry *sessionRegistry;
+
 // 上次报告的状态
 @property (nonatomic, assign) NetworkStatus lastReportedStatus;
 
@@ -50,8 +55,7 @@
 - (instancetype)init {
     if (self = [super init]) {
         _networkChangeDebounceInterval = 2;
-        _sessionMap = [NSMapTable strongToStrongObjectsMapTable];
-        _sessionTypeMap = [NSMutableDictionary dictionary];
+        _sessionRegistry = [[TJPSessionRegistry alloc] init];
         _sessionPool = [TJPLightweightSessionPool sharedPool];
         
         // 初始化队列
@@ -73,9 +77,8 @@
 - (void)setupQueues {
     // 串行队列,只处理会话
     _sessionQueue = dispatch_queue_create("com.networkCoordinator.tjp.sessionQueue", DISPATCH_QUEUE_SERIAL);
-    // 专用数据解析队列 并发高优先级
-    _parseQueue = dispatch_queue_create("com.networkCoordinator.tjp.parseQueue", DISPATCH_QUEUE_CONCURRENT);
-    dispatch_set_target_queue(_parseQueue, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0));
+    // 数据解析 每个会话独占串行通道 工作队列数等于CPU核数
+    _parseLaneScheduler = [[TJPParseLaneScheduler alloc] initWithWorkerCount:0];
     // 串行监控队列
     _monitorQueue = dispatch_queue_create("com.networkCoordinator.tjp.monitorQueue", DISPATCH_QUEUE_SERIAL);
     dispatch_set_target_queue(_monitorQueue, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
@@ -104,7 +107,8 @@
         .maxPoolSize = 3,        // 每种类型最多3个会话
         .maxIdleTime = 180,      // 3分钟空闲超时
         .cleanupInterval = 30,   // 30秒清理一次
-        .maxReuseCount = 30      // 最多复用30次
+        .maxReuseCount = 30,     // 最多复用30次
+        .maxStandbyCount = 2     // 每种类型最多2个待命会话
     };
     
     [self.sessionPool startWithConfig:poolConfig];
@@ -434,29 +438,25 @@
 }
 
 - (NSArray *)safeGetAllSessions {
-    __block NSArray *sessions;
-    dispatch_sync(self->_sessionQueue, ^{
-        sessions = [[_sessionMap objectEnumerator] allObjects];
-    });
-    return sessions;
+    return [self.sessionRegistry allSessions];
 }
 
 //安全获取单个会话的方法
 - (id<TJPSessionProtocol>)safeGetSessionWithId:(NSString *)sessionId {
-    __block id<TJPSessionProtocol> session = nil;
-    dispatch_sync(self->_sessionQueue, ^{
-        session = [self.sessionMap objectForKey:sessionId];
-    });
-    return session;
+    return [self.sessionRegistry sessionWithId:sessionId];
 }
 
 //获取当前会话总数
 - (NSUInteger)sessionCount {
-    __block NSUInteger count = 0;
-    dispatch_sync(self->_sessionQueue, ^{
-        count = self.sessionMap.count;
-    });
-    return count;
+    return self.sessionRegistry.count;
+}
+
+- (NSDictionary<NSString *, id<TJPSessionProtocol>> *)sessionMap {
+    return self.sessionRegistry.sessionsById;
+}
+
+- (NSDictionary<NSNumber *, NSString *> *)sessionTypeMap {
+    return self.sessionRegistry.sessionIdsByType;
 }
 
 
@@ -464,6 +464,13 @@
 - (void)notifySessionsOfNetworkStatus:(BOOL)available {
     NSArray *sessions = [self safeGetAllSessions];
     
+    // 待命连接随网络切换失效 恢复后按新网络重建
+    if (available) {
+        [self.sessionPool rebuildStandbySessions];
+    } else {
+        [self.sessionPool drainStandbySessions];
+    }
+    
     for (id<TJPSessionProtocol> session in sessions) {
         if (available) {
             // 通知会话网络恢复
@@ -499,6 +506,11 @@
         return nil;
     }
     
+    // 聊天和信令对建连耗时敏感 拿到目标主机后保持待命会话 之后的获取不再等待建连和握手
+    if (type == TJPSessionTypeChat || type == TJPSessionTypeSignaling) {
+        [self.sessionPool enableStandbyForType:type withConfig:config];
+    }
+    
     
     
     // 设置会话属性
@@ -523,58 +535,30 @@
         }
     }
     
-    // 同步队列避免静态条件
-    dispatch_sync(self->_sessionQueue, ^{
-        // 再次验证 sessionId（防止在异步操作中被修改）
-        if (!session.sessionId || session.sessionId.length == 0) {
-            TJPLOG_ERROR(@"[TJPNetworkCoordinator] 会话ID在队列操作中变为无效");
-            return;
-        }
-        
-        // 检查是否已存在相同 sessionId 的会话
-        id<TJPSessionProtocol> existingSession = [self.sessionMap objectForKey:session.sessionId];
-        if (existingSession) {
-            TJPLOG_WARN(@"[TJPNetworkCoordinator] 发现重复sessionId: %@，移除旧会话", session.sessionId);
-            [self.sessionMap removeObjectForKey:session.sessionId];
-        }
-        
-        // 加入活跃会话表
-        [self.sessionMap setObject:session forKey:session.sessionId];
-        
-        // 记录会话类型映射
-        NSString *previousSessionId = self.sessionTypeMap[@(type)];
-        if (previousSessionId) {
-            TJPLOG_INFO(@"[TJPNetworkCoordinator] 类型 %lu 的会话映射从 %@ 更新为 %@", (unsigned long)type, previousSessionId, session.sessionId);
-        }
-        
-        // 记录会话类型映射
-        self.sessionTypeMap[@(type)] = session.sessionId;
-        
-        
-        TJPLOG_INFO(@"[TJPNetworkCoordinator] 成功从池中获得会话: %@, 总活跃数 : %lu", session.sessionId, (unsigned long)self.sessionMap.count);
-    });
+    if (!session.sessionId || session.sessionId.length == 0) {
+        TJPLOG_ERROR(@"[TJPNetworkCoordinator] 会话ID无效，无法加入活跃会话表");
+        return session;
+    }
+    
+    // 加入活跃会话表并记录类型映射 同sessionId的旧会话被替换
+    NSString *previousSessionId = [self.sessionRegistry registerSession:session type:type];
+    if (previousSessionId) {
+        TJPLOG_INFO(@"[TJPNetworkCoordinator] 类型 %lu 的会话映射从 %@ 更新为 %@", (unsigned long)type, previousSessionId, session.sessionId);
+    }
+    
+    TJPLOG_INFO(@"[TJPNetworkCoordinator] 成功从池中获得会话: %@, 总活跃数 : %lu", session.sessionId, (unsigned long)self.sessionRegistry.count);
     return session;
 }
 
 // 根据类型获取会话
 - (id<TJPSessionProtocol>)sessionForType:(TJPSessionType)type {
-    __block id<TJPSessionProtocol> session = nil;
-    dispatch_sync(self->_sessionQueue, ^{
-        NSString *sessionId = self.sessionTypeMap[@(type)];
-        if (sessionId) {
-            session = [self.sessionMap objectForKey:sessionId];
-        }
-    });
-    return session;
+    return [self.sessionRegistry sessionForType:type];
 }
 
 
 - (void)updateAllSessionsState:(TJPConnectState)state {
     dispatch_barrier_async(self->_sessionQueue, ^{
-        NSEnumerator *enumerator = [self.sessionMap objectEnumerator];
-        id<TJPSessionProtocol> session;
-        
-        while ((session = [enumerator nextObject])) {
+        for (id<TJPSessionProtocol> session in [self.sessionRegistry allSessions]) {
             if ([session respondsToSelector:@selector(updateConnectionState:)]) {
                 //事件驱动状态变更
                 [session updateConnectionState:state];
@@ -586,47 +570,22 @@
 
 
 - (void)removeSession:(id<TJPSessionProtocol>)session {
+    // 先从活跃会话表和类型映射中移除 之后的查找立即看不到该会话
+    [self.sessionRegistry unregisterSession:session];
+    TJPLOG_INFO(@"[TJPNetworkCoordinator] 移除活跃会话: %@, 剩下数量: %lu",  session.sessionId, (unsigned long)self.sessionRegistry.count);
+    
     // 移除逻辑修改 不再直接销毁 而是放入池中
     dispatch_barrier_async(self->_sessionQueue, ^{
-        // 先从活跃会话表中移除
-        [self.sessionMap removeObjectForKey:session.sessionId];
-        
-        // 从类型映射表中移除
-        TJPSessionType sessionType = TJPSessionTypeDefault;
-        if ([session isKindOfClass:[TJPConcreteSession class]]) {
-            sessionType = ((TJPConcreteSession *)session).sessionType;
-        }
-        
-        NSString *currentSessionId = self.sessionTypeMap[@(sessionType)];
-        if ([currentSessionId isEqualToString:session.sessionId]) {
-            [self.sessionTypeMap removeObjectForKey:@(sessionType)];
-        }
-
-        
-        TJPLOG_INFO(@"[TJPNetworkCoordinator] 移除活跃会话: %@, 剩下数量: %lu",  session.sessionId, (unsigned long)self.sessionMap.count);
-        
-        // 新增归还到会话池逻辑
         [self.sessionPool releaseSession:session];
     });
 }
 
 // 新增：强制移除会话（不放入池中）
 - (void)forceRemoveSession:(id<TJPSessionProtocol>)session {
+    // 从活跃会话表和类型映射移除
+    [self.sessionRegistry unregisterSession:session];
+    
     dispatch_barrier_async(self->_sessionQueue, ^{
-        // 从活跃会话表移除
-        [self.sessionMap removeObjectForKey:session.sessionId];
-        
-        // 从类型映射移除
-        TJPSessionType sessionType = TJPSessionTypeDefault;
-        if ([session isKindOfClass:[TJPConcreteSession class]]) {
-            sessionType = ((TJPConcreteSession *)session).sessionType;
-        }
-        
-        NSString *currentSessionId = self.sessionTypeMap[@(sessionType)];
-        if ([currentSessionId isEqualToString:session.sessionId]) {
-            [self.sessionTypeMap removeObjectForKey:@(sessionType)];
-        }
-        
         // 强制从池中移除（不复用）
         [self.sessionPool removeSession:session];
         
@@ -732,6 +691,13 @@
     [self.sessionPool warmupPoolForType:type count:count withConfig:config];
 }
 
+/**
+ * 启用待命会话
+ */
+- (void)enableStandbySessionsForType:(TJPSessionType)type withConfig:(TJPNetworkConfig *)config {
+    [self.sessionPool enableStandbyForType:type withConfig:config];
+}
+
 /**
  * 获取会话池统计
  */
@@ -0,0 +1,52 @@
+//
+//  TJPSessionIdleList.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//  会话池空闲链表
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TJPConcreteSession;
+
+/**
+ * 按lastActiveTime排序的侵入式双向链表
+ *
+ * 设计说明：
+ * - 链表指针存放在会话自身(poolPrev/poolNext) 无额外节点分配
+ * - 头部是最近活跃的会话 即最佳复用候选 尾部是最久未活跃的会话 池满时优先淘汰
+ * - 取头、摘除、淘汰尾部均为O(1) 插入从头部按活跃时间定位 归还的会话通常刚活跃过 一般停在头部
+ * - 非线程安全 由会话池在poolQueue上访问
+ */
+@interface TJPSessionIdleList : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger count;
+/// 最近活跃的会话
+@property (nonatomic, strong, readonly, nullable) TJPConcreteSession *head;
+/// 最久未活跃的会话
+@property (nonatomic, weak, readonly, nullable) TJPConcreteSession *tail;
+
+/// 按lastActiveTime插入 已在链表中则忽略
+- (void)insertSession:(TJPConcreteSession *)session;
+
+/// 摘除指定会话 不在链表中返回NO
+- (BOOL)removeSession:(TJPConcreteSession *)session;
+
+/// 取出头部会话
+- (nullable TJPConcreteSession *)popHead;
+
+/// 取出尾部会话
+- (nullable TJPConcreteSession *)popTail;
+
+- (BOOL)containsSession:(TJPConcreteSession *)session;
+
+/// 从头到尾的会话快照
+- (NSArray<TJPConcreteSession *> *)allSessions;
+
+- (void)removeAllSessions;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,107 @@
+//
+//  TJPSessionIdleList.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//
+
+#import "TJPSessionIdleList.h"
+#import "TJPConcreteSession.h"
+
+@interface TJPSessionIdleList ()
+
+@property (nonatomic, assign, readwrite) NSUInteger count;
+@property (nonatomic, strong, readwrite, nullable) TJPConcreteSession *head;
+@property (nonatomic, weak, readwrite, nullable) TJPConcreteSession *tail;
+
+@end
+
+@implementation TJPSessionIdleList
+
+- (void)dealloc {
+    // 逐个断开链接 避免长链递归释放
+    [self removeAllSessions];
+}
+
+- (BOOL)containsSession:(TJPConcreteSession *)session {
+    // 会话按类型只会进入一个链表 有前驱或是头部即在链表中
+    return session && (self.head == session || session.poolPrev.poolNext == session);
+}
+
+- (void)insertSession:(TJPConcreteSession *)session {
+    if (!session || [self containsSession:session]) {
+        return;
+    }
+
+    NSDate *activeTime = session.lastActiveTime ?: [NSDate distantPast];
+    TJPConcreteSession *next = self.head;
+    while (next && [next.lastActiveTime ?: [NSDate distantPast] compare:activeTime] == NSOrderedDescending) {
+        next = next.poolNext;
+    }
+
+    TJPConcreteSession *prev = next ? next.poolPrev : self.tail;
+    session.poolPrev = prev;
+    session.poolNext = next;
+    if (prev) {
+        prev.poolNext = session;
+    } else {
+        self.head = session;
+    }
+    if (next) {
+        next.poolPrev = session;
+    } else {
+        self.tail = session;
+    }
+    self.count++;
+}
+
+- (BOOL)removeSession:(TJPConcreteSession *)session {
+    if (![self containsSession:session]) {
+        return NO;
+    }
+
+    TJPConcreteSession *prev = session.poolPrev;
+    TJPConcreteSession *next = session.poolNext;
+    if (prev) {
+        prev.poolNext = next;
+    } else {
+        self.head = next;
+    }
+    if (next) {
+        next.poolPrev = prev;
+    } else {
+        self.tail = prev;
+    }
+    session.poolPrev = nil;
+    session.poolNext = nil;
+    self.count--;
+    return YES;
+}
+
+- (nullable TJPConcreteSession *)popHead {
+    TJPConcreteSession *session = self.head;
+    [self removeSession:session];
+    return session;
+}
+
+- (nullable TJPConcreteSession *)popTail {
+    TJPConcreteSession *session = self.tail;
+    [self removeSession:session];
+    return session;
+}
+
+- (NSArray<TJPConcreteSession *> *)allSessions {
+    NSMutableArray<TJPConcreteSession *> *sessions = [NSMutableArray arrayWithCapacity:self.count];
+    for (TJPConcreteSession *session = self.head; session; session = session.poolNext) {
+        [sessions addObject:session];
+    }
+    return sessions;
+}
+
+- (void)removeAllSessions {
+    while (self.head) {
+        [self popHead];
+    }
+}
+
+@end
@@ -0,0 +1,52 @@
+//
+//  TJPSessionRegistry.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//  活跃会话注册表
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@protocol TJPSessionProtocol;
+
+/**
+ * 活跃会话注册表
+ *
+ * 设计说明：
+ * - 读多写少 每次发送都要按类型查会话 增删只在创建、回收会话时发生
+ * - 写时复制 写操作复制当前表修改后发布为新的不可变快照 读操作只取快照指针
+ * - 快照指针的读取只持锁一次指针赋值的时间 查找不会排在重连等会话管理操作之后
+ * - 写操作之间由独立的锁串行化 读写互不阻塞
+ */
+@interface TJPSessionRegistry : NSObject
+
+/// 按sessionId索引的会话快照
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, id<TJPSessionProtocol>> *sessionsById;
+/// 会话类型到sessionId的映射快照
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSString *> *sessionIdsByType;
+/// 会话数
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/// 按sessionId查找
+- (nullable id<TJPSessionProtocol>)sessionWithId:(NSString *)sessionId;
+
+/// 按类型查找
+- (nullable id<TJPSessionProtocol>)sessionForType:(TJPSessionType)type;
+
+/// 全部会话
+- (NSArray<id<TJPSessionProtocol>> *)allSessions;
+
+/// 注册会话 替换相同sessionId的旧会话 并将该类型映射到此会话
+/// - Returns: 该类型之前映射的sessionId 没有则为nil
+- (nullable NSString *)registerSession:(id<TJPSessionProtocol>)session type:(TJPSessionType)type;
+
+/// 移除会话 仍映射到该会话的类型一并移除
+/// - Returns: 会话是否在表中
+- (BOOL)unregisterSession:(id<TJPSessionProtocol>)session;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,148 @@
+//
+//  TJPSessionRegistry.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//
+
+#import "TJPSessionRegistry.h"
+#import <os/lock.h>
+#import "TJPSessionProtocol.h"
+#import "TJPNetworkDefine.h"
+
+/// 不可变快照 发布后不再修改
+@interface TJPSessionRegistrySnapshot : NSObject
+
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, id<TJPSessionProtocol>> *sessionsById;
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSString *> *sessionIdsByType;
+
+- (instancetype)initWithSessions:(NSDictionary<NSString *, id<TJPSessionProtocol>> *)sessionsById types:(NSDictionary<NSNumber *, NSString *> *)sessionIdsByType;
+
+@end
+
+@implementation TJPSessionRegistrySnapshot
+
+- (instancetype)initWithSessions:(NSDictionary<NSString *, id<TJPSessionProtocol>> *)sessionsById types:(NSDictionary<NSNumber *, NSString *> *)sessionIdsByType {
+    if (self = [super init]) {
+        _sessionsById = [sessionsById copy];
+        _sessionIdsByType = [sessionIdsByType copy];
+    }
+    return self;
+}
+
+@end
+
+
+@implementation TJPSessionRegistry {
+    TJPSessionRegistrySnapshot *_snapshot;
+    os_unfair_lock _snapshotLock;   // 只保护快照指针的读取和替换
+    os_unfair_lock _writeLock;      // 串行化写操作
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _snapshotLock = OS_UNFAIR_LOCK_INIT;
+        _writeLock = OS_UNFAIR_LOCK_INIT;
+        _snapshot = [[TJPSessionRegistrySnapshot alloc] initWithSessions:@{} types:@{}];
+    }
+    return self;
+}
+
+#pragma mark - Read
+- (TJPSessionRegistrySnapshot *)currentSnapshot {
+    os_unfair_lock_lock(&_snapshotLock);
+    TJPSessionRegistrySnapshot *snapshot = _snapshot;
+    os_unfair_lock_unlock(&_snapshotLock);
+    return snapshot;
+}
+
+- (NSDictionary<NSString *, id<TJPSessionProtocol>> *)sessionsById {
+    return [self currentSnapshot].sessionsById;
+}
+
+- (NSDictionary<NSNumber *, NSString *> *)sessionIdsByType {
+    return [self currentSnapshot].sessionIdsByType;
+}
+
+- (NSUInteger)count {
+    return [self currentSnapshot].sessionsById.count;
+}
+
+- (nullable id<TJPSessionProtocol>)sessionWithId:(NSString *)sessionId {
+    if (!sessionId) {
+        return nil;
+    }
+    return [self currentSnapshot].sessionsById[sessionId];
+}
+
+- (nullable id<TJPSessionProtocol>)sessionForType:(TJPSessionType)type {
+    // 同一快照内完成两次查找 不会看到类型映射与会话表不一致的中间状态
+    TJPSessionRegistrySnapshot *snapshot = [self currentSnapshot];
+    NSString *sessionId = snapshot.sessionIdsByType[@(type)];
+    return sessionId ? snapshot.sessionsById[sessionId] : nil;
+}
+
+- (NSArray<id<TJPSessionProtocol>> *)allSessions {
+    return [self currentSnapshot].sessionsById.allValues;
+}
+
+#pragma mark - Write
+- (nullable NSString *)registerSession:(id<TJPSessionProtocol>)session type:(TJPSessionType)type {
+    NSString *sessionId = session.sessionId;
+    if (sessionId.length == 0) {
+        return nil;
+    }
+
+    os_unfair_lock_lock(&_writeLock);
+    TJPSessionRegistrySnapshot *snapshot = [self currentSnapshot];
+    NSMutableDictionary<NSString *, id<TJPSessionProtocol>> *sessions = [snapshot.sessionsById mutableCopy];
+    NSMutableDictionary<NSNumber *, NSString *> *types = [snapshot.sessionIdsByType mutableCopy];
+
+    if (sessions[sessionId] && sessions[sessionId] != session) {
+        TJPLOG_WARN(@"[TJPSessionRegistry] 发现重复sessionId: %@，替换旧会话", sessionId);
+    }
+    sessions[sessionId] = session;
+    NSString *previousSessionId = types[@(type)];
+    types[@(type)] = sessionId;
+
+    TJPSessionRegistrySnapshot *retired = [self publishSnapshot:[[TJPSessionRegistrySnapshot alloc] initWithSessions:sessions types:types]];
+    os_unfair_lock_unlock(&_writeLock);
+    // 旧快照在写锁外释放 最后一个引用触发的会话析构不会阻塞其他写者
+    retired = nil;
+    return previousSessionId;
+}
+
+- (BOOL)unregisterSession:(id<TJPSessionProtocol>)session {
+    NSString *sessionId = session.sessionId;
+    if (!sessionId) {
+        return NO;
+    }
+
+    TJPSessionRegistrySnapshot *retired = nil;
+    os_unfair_lock_lock(&_writeLock);
+    TJPSessionRegistrySnapshot *snapshot = [self currentSnapshot];
+    BOOL exists = snapshot.sessionsById[sessionId] != nil;
+    NSArray<NSNumber *> *mappedTypes = [snapshot.sessionIdsByType allKeysForObject:sessionId];
+    if (exists || mappedTypes.count > 0) {
+        NSMutableDictionary<NSString *, id<TJPSessionProtocol>> *sessions = [snapshot.sessionsById mutableCopy];
+        NSMutableDictionary<NSNumber *, NSString *> *types = [snapshot.sessionIdsByType mutableCopy];
+        [sessions removeObjectForKey:sessionId];
+        [types removeObjectsForKeys:mappedTypes];
+        retired = [self publishSnapshot:[[TJPSessionRegistrySnapshot alloc] initWithSessions:sessions types:types]];
+    }
+    os_unfair_lock_unlock(&_writeLock);
+    // 被移除的会话可能只剩旧快照持有 在写锁外析构
+    retired = nil;
+    return exists;
+}
+
+/// 替换快照 需持有写锁 返回旧快照 由调用方在释放写锁后丢弃
+- (TJPSessionRegistrySnapshot *)publishSnapshot:(TJPSessionRegistrySnapshot *)snapshot {
+    os_unfair_lock_lock(&_snapshotLock);
+    TJPSessionRegistrySnapshot *previous = _snapshot;
+    _snapshot = snapshot;
+    os_unfair_lock_unlock(&_snapshotLock);
+    return previous;
+}
+
+@end
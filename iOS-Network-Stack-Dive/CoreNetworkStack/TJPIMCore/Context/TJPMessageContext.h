@@ -8,6 +8,8 @@
 #import <Foundation/Foundation.h>
 #import "TJPCoreTypes.h"
 
+@class TJPCompressionCodec;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface TJPMessageContext : NSObject
@@ -36,6 +38,27 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) uint32_t sequence;
 
 
+//分片信息
+/// 分片所属的原始消息ID 非分片为nil
+@property (nonatomic, copy, nullable) NSString *parentMessageId;
+/// 分片序号
+@property (nonatomic, assign) NSUInteger fragmentIndex;
+
+
+//控制帧
+/// 已构建好的控制帧 ACK/已读回执/心跳 不占窗口额度 不等待确认 普通消息为nil
+@property (nonatomic, strong, readonly, nullable) NSData *controlPacket;
+
+
+//压缩信息
+/// 线路上的载荷 压缩后为压缩数据 否则与payload相同
+@property (nonatomic, strong, readonly) NSData *wirePayload;
+/// 压缩率 压缩后长度/原始长度 未压缩为1
+@property (nonatomic, assign, readonly) double compressionRatio;
+/// 压缩占用的CPU时间(秒)
+@property (nonatomic, assign, readonly) NSTimeInterval compressionTime;
+
+
 //时间信息
 /// 发送时间
 @property (nonatomic, strong) NSDate *sendTime;
@@ -56,12 +79,20 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) NSInteger maxRetryCount;
 /// 重试超时时间(秒)
 @property (nonatomic, assign) NSTimeInterval retryTimeout;
+/// 是否重传过 包括重连后的积压重发 ACK无法区分对应哪次发送 不参与RTT采样
+@property (nonatomic, assign) BOOL isRetransmitted;
 /// 最后错误信息
 @property (nonatomic, strong) NSError *lastError;      
 
-/// 工厂创建方法
+/// 工厂创建方法 优先级取消息类型的默认值
 + (instancetype)contextWithData:(NSData *)data seq:(uint32_t)seq messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionId:(NSString *)sessionId;
 
+/// 控制帧上下文 以Urgent优先级经调度器发出
++ (instancetype)controlContextWithPacket:(NSData *)packet messageType:(TJPMessageType)messageType seq:(uint32_t)seq sessionId:(NSString *)sessionId;
+
+/// 消息类型的默认优先级 ACK/控制/心跳/已读回执为Urgent 其余为Normal
++ (TJPMessagePriority)defaultPriorityForMessageType:(TJPMessageType)messageType;
+
 //状态查询方法
 - (BOOL)isInProgress;
 - (BOOL)isCompleted;
@@ -72,8 +103,15 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)needsRetransmission;
 - (NSString *)stateDisplayString;
 
+//按compressType压缩载荷 需在首次构建数据包前调用 不值得压缩时compressType改为None
+- (void)compressPayloadWithCodec:(TJPCompressionCodec *)codec;
+
 //构建重传包
 - (NSData *)buildRetryPacket;
+//构建数据包 协议头与载荷分段 载荷段及校验和首次构建后缓存复用
+- (nullable dispatch_data_t)buildPacketData;
+//构建重传包 只重建协议头 复用载荷段
+- (nullable dispatch_data_t)buildRetryPacketData;
 //是否重传
 - (BOOL)shouldRetry;
 //计算经过时间
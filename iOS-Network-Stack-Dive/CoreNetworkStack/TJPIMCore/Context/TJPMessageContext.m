@@ -9,15 +9,27 @@
 #import "TJPNetworkUtil.h"
 #import "TJPMessageBuilder.h"
 #import "TJPNetworkDefine.h"
+#import "TJPCompressionCodec.h"
 
 @interface TJPMessageContext ()
 // 消息内容
 @property (nonatomic, strong, readwrite) NSData *payload;
+// 压缩后的载荷
+@property (nonatomic, strong) NSData *compressedPayload;
+// 控制帧
+@property (nonatomic, strong, readwrite, nullable) NSData *controlPacket;
+@property (nonatomic, assign, readwrite) double compressionRatio;
+@property (nonatomic, assign, readwrite) NSTimeInterval compressionTime;
 
 
 @end
 
-@implementation TJPMessageContext
+@implementation TJPMessageContext {
+    // 载荷段缓存 重传时只重建协议头
+    dispatch_data_t _payloadData;
+    uint32_t _payloadChecksum;
+    uint16_t _sessionIDHash;
+}
 
 + (instancetype)contextWithData:(NSData *)data seq:(uint32_t)seq messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType sessionId:(NSString *)sessionId {
     // 创建上下文实例对象
@@ -28,6 +40,8 @@
     context.encryptType = encryptType;
     context.compressType = compressType;
     context.sessionId = sessionId;
+    context.priority = [self defaultPriorityForMessageType:messageType];
+    context.compressionRatio = 1.0;
     
     // 默认重试设置
     context.retryCount = 0;
@@ -45,6 +59,25 @@
     return context;
 }
 
++ (instancetype)controlContextWithPacket:(NSData *)packet messageType:(TJPMessageType)messageType seq:(uint32_t)seq sessionId:(NSString *)sessionId {
+    TJPMessageContext *context = [self contextWithData:[NSData data] seq:seq messageType:messageType encryptType:TJPEncryptTypeNone compressType:TJPCompressTypeNone sessionId:sessionId];
+    context.controlPacket = packet;
+    context.priority = TJPMessagePriorityUrgent;
+    return context;
+}
+
++ (TJPMessagePriority)defaultPriorityForMessageType:(TJPMessageType)messageType {
+    switch (messageType) {
+        case TJPMessageTypeHeartbeat:
+        case TJPMessageTypeACK:
+        case TJPMessageTypeControl:
+        case TJPMessageTypeReadReceipt:
+            return TJPMessagePriorityUrgent;
+        default:
+            return TJPMessagePriorityNormal;
+    }
+}
+
 - (BOOL)isInProgress {
     return self.state == TJPMessageStateSending ||
            self.state == TJPMessageStateRetrying;
@@ -93,13 +126,63 @@
     }
 }
 
+- (NSData *)wirePayload {
+    return self.compressedPayload ?: self.payload;
+}
+
+- (void)compressPayloadWithCodec:(TJPCompressionCodec *)codec {
+    // 载荷段已缓存 重传时不再改变线路格式
+    if (_payloadData || self.compressType != TJPCompressTypeZlib || self.compressedPayload) {
+        return;
+    }
+    
+    NSTimeInterval cpuTime = 0;
+    NSData *compressed = [codec compressData:self.payload cpuTime:&cpuTime];
+    self.compressionTime = cpuTime;
+    if (!compressed) {
+        self.compressType = TJPCompressTypeNone;
+        return;
+    }
+    
+    self.compressedPayload = compressed;
+    self.compressionRatio = (double)compressed.length / self.payload.length;
+    TJPLOG_DEBUG(@"消息 %@ 压缩 %lu -> %lu 字节，压缩率 %.2f，耗时 %.3fms", self.messageId, (unsigned long)self.payload.length, (unsigned long)compressed.length, self.compressionRatio, cpuTime * 1000);
+}
+
 - (NSData *)buildRetryPacket {
+    // dispatch_data可桥接为NSData
+    return (NSData *)[self buildRetryPacketData];
+}
+
+- (dispatch_data_t)buildPacketData {
+    if (self.controlPacket) {
+        return [TJPMessageBuilder dispatchDataWithPayload:self.controlPacket];
+    }
+    
+    NSData *wirePayload = self.wirePayload;
+    if (!_payloadData) {
+        if (wirePayload.length > TJPMAX_BODY_SIZE) {
+            TJPLOG_ERROR(@"负载数据过大: %lu > %d", (unsigned long)wirePayload.length, TJPMAX_BODY_SIZE);
+            return nil;
+        }
+        // 校验和覆盖线路上的数据 接收端先校验再解压
+        _payloadChecksum = wirePayload.length > 0 ? [TJPNetworkUtil crc32ForData:wirePayload] : 0;
+        _sessionIDHash = [TJPMessageBuilder sessionIDFromUUID:self.sessionId];
+        _payloadData = [TJPMessageBuilder dispatchDataWithPayload:wirePayload ?: [NSData data]];
+    }
+    
+    TJPFinalAdavancedHeader header = [TJPMessageBuilder headerWithMessageType:self.messageType sequence:self.sequence bodyLength:(uint32_t)wirePayload.length checksum:_payloadChecksum encryptType:self.encryptType compressType:self.compressType sessionID:_sessionIDHash];
+    return [TJPMessageBuilder packetDataWithHeader:header payloadData:_payloadData];
+}
+
+- (dispatch_data_t)buildRetryPacketData {
     _retryCount++;
+    self.isRetransmitted = YES;
     // 更新发送时间
     self.sendTime = [NSDate date];
-    self.lastRetryTime = [NSDate date];
+    self.lastRetryTime = self.sendTime;
     
-    return [TJPMessageBuilder buildPacketWithMessageType:self.messageType sequence:self.sequence payload:self.payload encryptType:self.encryptType compressType:self.compressType sessionID:self.sessionId];
+    return [self buildPacketData];
 }
 
 
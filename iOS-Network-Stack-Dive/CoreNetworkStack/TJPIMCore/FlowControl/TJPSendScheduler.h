@@ -0,0 +1,60 @@
+//
+//  TJPSendScheduler.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/13.
+//  按消息优先级调度发送顺序
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TJPMessageContext;
+
+/**
+ * 多级发送调度器
+ *
+ * 设计说明：
+ * - Urgent严格优先 只要有紧急消息就先发
+ * - High/Normal/Low按字节做差额轮询(DRR) 权重4:2:1 大消息消耗本级额度 不会饿死其他级别
+ * - 同一级别内先进先出
+ * - 记录每级队列深度和排队时延直方图
+ * - 非线程安全 由会话在sessionQueue上访问
+ */
+@interface TJPSendScheduler : NSObject
+
+/// 排队消息数
+@property (nonatomic, readonly) NSUInteger count;
+/// 排队字节数
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
+
+/// 初始化方法
+/// - Parameter quantum: 每轮基础字节额度 乘以级别权重后累加
+- (instancetype)initWithQuantum:(NSUInteger)quantum;
+
+/// 消息入队
+- (void)enqueueMessage:(TJPMessageContext *)message;
+
+/// 下一条将要发出的消息 不出队 重复调用结果相同
+- (nullable TJPMessageContext *)peekMessage;
+
+/// 取出下一条消息 并记录排队时延
+- (nullable TJPMessageContext *)dequeueMessage;
+
+/// 清空队列 按优先级从高到低返回
+- (NSArray<TJPMessageContext *> *)removeAllMessages;
+
+/// 指定优先级的排队消息数
+- (NSUInteger)queueDepthForPriority:(TJPMessagePriority)priority;
+
+/// 调度统计 每个优先级的队列深度、字节数、出队数和时延直方图
+- (NSDictionary *)statistics;
+
+/// 时延直方图各桶上界 毫秒 最后一桶无上界
++ (NSArray<NSNumber *> *)latencyHistogramBounds;
+
+@end
+
+NS_ASSUME_NONNULL_END
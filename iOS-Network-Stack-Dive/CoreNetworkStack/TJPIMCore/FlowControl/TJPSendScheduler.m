@@ -0,0 +1,206 @@
+//
+//  TJPSendScheduler.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/13.
+//
+
+#import "TJPSendScheduler.h"
+#import <time.h>
+#import "TJPMessageContext.h"
+#import "TJPSendWindow.h"
+
+// 优先级层数 与TJPMessagePriority一一对应
+#define kTJPSchedulerLevels (TJPMessagePriorityUrgent + 1)
+// 时延直方图桶数 比上界数多一个溢出桶
+#define kTJPLatencyBucketCount 8
+
+// DRR权重 下标为优先级 Urgent严格优先不参与
+static const NSUInteger kTJPSchedulerWeights[kTJPSchedulerLevels] = {1, 2, 4, 0};
+// 时延直方图上界 毫秒
+static const uint64_t kTJPLatencyBucketBounds[kTJPLatencyBucketCount - 1] = {1, 5, 10, 50, 100, 500, 1000};
+// DRR轮询顺序 从高到低
+static const TJPMessagePriority kTJPSchedulerRoundRobin[] = {TJPMessagePriorityHigh, TJPMessagePriorityNormal, TJPMessagePriorityLow};
+static const NSUInteger kTJPSchedulerRoundRobinCount = sizeof(kTJPSchedulerRoundRobin) / sizeof(kTJPSchedulerRoundRobin[0]);
+
+@interface TJPSendScheduler ()
+
+/// 按优先级分层的队列 下标为优先级
+@property (nonatomic, strong) NSArray<NSMutableArray<TJPMessageContext *> *> *queues;
+/// 入队时间 纳秒
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *enqueueTimes;
+
+@end
+
+@implementation TJPSendScheduler {
+    NSUInteger _quantum;
+    NSUInteger _deficits[kTJPSchedulerLevels];
+    NSUInteger _levelBytes[kTJPSchedulerLevels];
+    uint64_t _dequeuedCounts[kTJPSchedulerLevels];
+    uint64_t _latencyHistograms[kTJPSchedulerLevels][kTJPLatencyBucketCount];
+    
+    NSUInteger _roundRobinIndex;     // 当前轮询位置
+    BOOL _currentLevelCredited;      // 当前级别本轮是否已累加额度
+}
+
+- (instancetype)initWithQuantum:(NSUInteger)quantum {
+    if (self = [super init]) {
+        _quantum = MAX(quantum, (NSUInteger)1);
+        _enqueueTimes = [NSMutableDictionary dictionary];
+        
+        NSMutableArray *queues = [NSMutableArray arrayWithCapacity:kTJPSchedulerLevels];
+        for (NSUInteger i = 0; i < kTJPSchedulerLevels; i++) {
+            [queues addObject:[NSMutableArray array]];
+        }
+        _queues = [queues copy];
+    }
+    return self;
+}
+
+#pragma mark - Public Method
+- (void)enqueueMessage:(TJPMessageContext *)message {
+    NSUInteger level = [self levelForMessage:message];
+    [self.queues[level] addObject:message];
+    _levelBytes[level] += [TJPSendWindow windowBytesForMessage:message];
+    _count++;
+    _totalBytes += [TJPSendWindow windowBytesForMessage:message];
+    self.enqueueTimes[message.messageId] = @(clock_gettime_nsec_np(CLOCK_UPTIME_RAW));
+}
+
+- (nullable TJPMessageContext *)peekMessage {
+    NSInteger level = [self selectLevel];
+    return level >= 0 ? self.queues[level].firstObject : nil;
+}
+
+- (nullable TJPMessageContext *)dequeueMessage {
+    NSInteger level = [self selectLevel];
+    if (level < 0) {
+        return nil;
+    }
+    
+    NSMutableArray<TJPMessageContext *> *queue = self.queues[level];
+    TJPMessageContext *message = queue.firstObject;
+    [queue removeObjectAtIndex:0];
+    
+    NSUInteger bytes = [TJPSendWindow windowBytesForMessage:message];
+    _levelBytes[level] -= bytes;
+    _count--;
+    _totalBytes -= bytes;
+    
+    if (level != TJPMessagePriorityUrgent) {
+        _deficits[level] -= bytes;
+        // 队列排空后额度清零 避免空闲级别囤积额度
+        if (queue.count == 0) {
+            _deficits[level] = 0;
+            [self advanceRoundRobin];
+        }
+    }
+    
+    [self recordLatencyForMessage:message level:level];
+    return message;
+}
+
+- (NSArray<TJPMessageContext *> *)removeAllMessages {
+    NSMutableArray<TJPMessageContext *> *messages = [NSMutableArray arrayWithCapacity:_count];
+    for (NSInteger level = kTJPSchedulerLevels - 1; level >= 0; level--) {
+        [messages addObjectsFromArray:self.queues[level]];
+        [self.queues[level] removeAllObjects];
+        _levelBytes[level] = 0;
+        _deficits[level] = 0;
+    }
+    [self.enqueueTimes removeAllObjects];
+    _count = 0;
+    _totalBytes = 0;
+    _roundRobinIndex = 0;
+    _currentLevelCredited = NO;
+    return messages;
+}
+
+- (NSUInteger)queueDepthForPriority:(TJPMessagePriority)priority {
+    return priority < kTJPSchedulerLevels ? self.queues[priority].count : 0;
+}
+
+- (NSDictionary *)statistics {
+    NSMutableDictionary *statistics = [NSMutableDictionary dictionaryWithCapacity:kTJPSchedulerLevels];
+    for (NSUInteger level = 0; level < kTJPSchedulerLevels; level++) {
+        NSMutableArray<NSNumber *> *histogram = [NSMutableArray arrayWithCapacity:kTJPLatencyBucketCount];
+        for (NSUInteger bucket = 0; bucket < kTJPLatencyBucketCount; bucket++) {
+            [histogram addObject:@(_latencyHistograms[level][bucket])];
+        }
+        statistics[@(level)] = @{
+            @"queueDepth": @(self.queues[level].count),
+            @"queuedBytes": @(_levelBytes[level]),
+            @"dequeued": @(_dequeuedCounts[level]),
+            @"latencyHistogram": histogram
+        };
+    }
+    return statistics;
+}
+
++ (NSArray<NSNumber *> *)latencyHistogramBounds {
+    NSMutableArray<NSNumber *> *bounds = [NSMutableArray arrayWithCapacity:kTJPLatencyBucketCount - 1];
+    for (NSUInteger i = 0; i < kTJPLatencyBucketCount - 1; i++) {
+        [bounds addObject:@(kTJPLatencyBucketBounds[i])];
+    }
+    return bounds;
+}
+
+#pragma mark - Private Method
+- (NSUInteger)levelForMessage:(TJPMessageContext *)message {
+    return MIN((NSUInteger)message.priority, (NSUInteger)kTJPSchedulerLevels - 1);
+}
+
+/// 选出下一条消息所在级别 没有消息时返回-1
+/// 选中后再次调用结果不变 只有出队才会推进轮询
+- (NSInteger)selectLevel {
+    if (_count == 0) {
+        return -1;
+    }
+    if (self.queues[TJPMessagePriorityUrgent].count > 0) {
+        return TJPMessagePriorityUrgent;
+    }
+    
+    while (YES) {
+        TJPMessagePriority level = kTJPSchedulerRoundRobin[_roundRobinIndex];
+        NSMutableArray<TJPMessageContext *> *queue = self.queues[level];
+        if (queue.count == 0) {
+            _deficits[level] = 0;
+            [self advanceRoundRobin];
+            continue;
+        }
+        
+        if (!_currentLevelCredited) {
+            _deficits[level] += _quantum * kTJPSchedulerWeights[level];
+            _currentLevelCredited = YES;
+        }
+        
+        // 额度足够发送队首 否则保留额度 轮到下一级
+        if ([TJPSendWindow windowBytesForMessage:queue.firstObject] <= _deficits[level]) {
+            return level;
+        }
+        [self advanceRoundRobin];
+    }
+}
+
+- (void)advanceRoundRobin {
+    _roundRobinIndex = (_roundRobinIndex + 1) % kTJPSchedulerRoundRobinCount;
+    _currentLevelCredited = NO;
+}
+
+- (void)recordLatencyForMessage:(TJPMessageContext *)message level:(NSUInteger)level {
+    NSNumber *enqueueTime = self.enqueueTimes[message.messageId];
+    [self.enqueueTimes removeObjectForKey:message.messageId];
+    _dequeuedCounts[level]++;
+    if (!enqueueTime) {
+        return;
+    }
+    
+    uint64_t latencyMs = (clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - enqueueTime.unsignedLongLongValue) / NSEC_PER_MSEC;
+    NSUInteger bucket = 0;
+    while (bucket < kTJPLatencyBucketCount - 1 && latencyMs >= kTJPLatencyBucketBounds[bucket]) {
+        bucket++;
+    }
+    _latencyHistograms[level][bucket]++;
+}
+
+@end
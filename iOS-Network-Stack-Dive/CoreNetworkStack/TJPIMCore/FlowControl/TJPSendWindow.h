@@ -0,0 +1,72 @@
+//
+//  TJPSendWindow.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/12.
+//  发送窗口 限制单个会话未确认消息的数量和字节数
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TJPMessageContext, TJPSendScheduler;
+
+/**
+ * 基于额度的发送窗口
+ *
+ * 设计说明：
+ * - 同时限制在途消息数和在途字节数 任一耗尽即关闭窗口 收到ACK后释放额度
+ * - 窗口关闭时消息进入TJPSendScheduler排队 Urgent严格优先 其余按权重轮询
+ * - 窗口内没有在途消息时 超过字节预算的单条消息也允许发出 避免永久阻塞
+ * - 控制帧经调度器排在Urgent级 出队时不占额度 也不计入在途
+ * - 对端可通过控制消息通告接收窗口 实际限制取本地与通告的较小值
+ * - 非线程安全 由会话在sessionQueue上访问
+ */
+@interface TJPSendWindow : NSObject
+
+/// 本地最大在途消息数 0表示不限制
+@property (nonatomic, assign) NSUInteger maxInFlightMessages;
+/// 本地最大在途字节数 0表示不限制
+@property (nonatomic, assign) NSUInteger maxInFlightBytes;
+/// 对端通告的接收窗口 消息数 0表示未通告
+@property (nonatomic, assign) NSUInteger advertisedMessages;
+/// 对端通告的接收窗口 字节数 0表示未通告
+@property (nonatomic, assign) NSUInteger advertisedBytes;
+
+/// 在途消息数
+@property (nonatomic, readonly) NSUInteger inFlightCount;
+/// 在途字节数
+@property (nonatomic, readonly) NSUInteger inFlightBytes;
+/// 排队消息数
+@property (nonatomic, readonly) NSUInteger queuedCount;
+/// 排队字节数
+@property (nonatomic, readonly) NSUInteger queuedBytes;
+/// 排队调度器 用于读取统计
+@property (nonatomic, strong, readonly) TJPSendScheduler *scheduler;
+
+
+/// 初始化方法
+/// - Parameters:
+///   - maxInFlightMessages: 最大在途消息数 0表示不限制
+///   - maxInFlightBytes: 最大在途字节数 0表示不限制
+- (instancetype)initWithMaxInFlightMessages:(NSUInteger)maxInFlightMessages maxInFlightBytes:(NSUInteger)maxInFlightBytes;
+
+/// 消息加入发送队列
+- (void)enqueueMessage:(TJPMessageContext *)message;
+
+/// 取出下一条可发送的消息并占用额度 窗口关闭或队列为空时返回nil
+- (nullable TJPMessageContext *)dequeueSendableMessage;
+
+/// 释放消息占用的额度 ACK或最终失败时调用 消息不在途时返回NO
+- (BOOL)releaseMessageId:(NSString *)messageId;
+
+/// 清空在途和排队状态 返回尚未发出的排队消息
+- (NSArray<TJPMessageContext *> *)reset;
+
+/// 消息计入窗口的字节数 协议头+线路载荷 入队前需完成压缩 控制帧为整帧长度
++ (NSUInteger)windowBytesForMessage:(TJPMessageContext *)message;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,119 @@
+//
+//  TJPSendWindow.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/12.
+//
+
+#import "TJPSendWindow.h"
+#import "TJPMessageContext.h"
+#import "TJPSendScheduler.h"
+#import "TJPNetworkDefine.h"
+
+@interface TJPSendWindow ()
+
+/// 在途消息占用的字节数
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *inFlightMessages;
+
+@end
+
+@implementation TJPSendWindow
+
+- (instancetype)initWithMaxInFlightMessages:(NSUInteger)maxInFlightMessages maxInFlightBytes:(NSUInteger)maxInFlightBytes {
+    if (self = [super init]) {
+        _maxInFlightMessages = maxInFlightMessages;
+        _maxInFlightBytes = maxInFlightBytes;
+        _inFlightMessages = [NSMutableDictionary dictionary];
+        _scheduler = [[TJPSendScheduler alloc] initWithQuantum:TJP_SEND_SCHEDULER_QUANTUM];
+    }
+    return self;
+}
+
+#pragma mark - Public Method
+- (void)enqueueMessage:(TJPMessageContext *)message {
+    [self.scheduler enqueueMessage:message];
+}
+
+- (nullable TJPMessageContext *)dequeueSendableMessage {
+    // 只看调度器选中的消息 窗口不足时不让其他消息插队
+    TJPMessageContext *message = [self.scheduler peekMessage];
+    if (!message) {
+        return nil;
+    }
+    if (message.controlPacket) {
+        [self.scheduler dequeueMessage];
+        return message;
+    }
+    NSUInteger bytes = [TJPSendWindow windowBytesForMessage:message];
+    if (![self canAcquireBytes:bytes]) {
+        return nil;
+    }
+    
+    [self.scheduler dequeueMessage];
+    self.inFlightMessages[message.messageId] = @(bytes);
+    _inFlightBytes += bytes;
+    return message;
+}
+
+- (BOOL)releaseMessageId:(NSString *)messageId {
+    NSNumber *bytes = messageId ? self.inFlightMessages[messageId] : nil;
+    if (!bytes) {
+        return NO;
+    }
+    [self.inFlightMessages removeObjectForKey:messageId];
+    _inFlightBytes -= bytes.unsignedIntegerValue;
+    return YES;
+}
+
+- (NSArray<TJPMessageContext *> *)reset {
+    [self.inFlightMessages removeAllObjects];
+    _inFlightBytes = 0;
+    return [self.scheduler removeAllMessages];
+}
+
++ (NSUInteger)windowBytesForMessage:(TJPMessageContext *)message {
+    if (message.controlPacket) {
+        return message.controlPacket.length;
+    }
+    return sizeof(TJPFinalAdavancedHeader) + message.wirePayload.length;
+}
+
+#pragma mark - Getter
+- (NSUInteger)inFlightCount {
+    return self.inFlightMessages.count;
+}
+
+- (NSUInteger)queuedCount {
+    return self.scheduler.count;
+}
+
+- (NSUInteger)queuedBytes {
+    return self.scheduler.totalBytes;
+}
+
+#pragma mark - Private Method
+- (BOOL)canAcquireBytes:(NSUInteger)bytes {
+    NSUInteger messageLimit = [self effectiveLimitWithLocal:self.maxInFlightMessages advertised:self.advertisedMessages];
+    NSUInteger byteLimit = [self effectiveLimitWithLocal:self.maxInFlightBytes advertised:self.advertisedBytes];
+    
+    if (messageLimit > 0 && self.inFlightCount >= messageLimit) {
+        return NO;
+    }
+    // 窗口为空时放行超大消息 否则它永远发不出去
+    if (byteLimit > 0 && self.inFlightCount > 0 && _inFlightBytes + bytes > byteLimit) {
+        return NO;
+    }
+    return YES;
+}
+
+- (NSUInteger)effectiveLimitWithLocal:(NSUInteger)local advertised:(NSUInteger)advertised {
+    if (local == 0) {
+        return advertised;
+    }
+    if (advertised == 0) {
+        return local;
+    }
+    return MIN(local, advertised);
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  TJPFragmentCodec.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//  分片编解码
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// 分片头 主机字节序
+typedef struct {
+    uint32_t transferId;    // 发送方为每条大消息分配的传输ID 重连后不变
+    uint16_t index;         // 分片序号 从0开始
+    uint16_t count;         // 分片总数
+    uint32_t totalLength;   // 原始消息总长度
+    uint32_t offset;        // 本分片在原始消息中的偏移
+    uint32_t checksum;      // 本分片数据的CRC32
+} TJPFragmentHeader;
+
+/**
+ * 分片编解码
+ *
+ * 协议格式：
+ * - 分片消息类型为TJPMessageTypeFragment 每个分片独立分配序列号并单独确认
+ * - 载荷开头为一个TLV Tag = TJP_TLV_TAG_FRAGMENT_HEADER Value为20字节分片头 均为网络字节序
+ * - 分片头之后直接跟分片数据 不再做TLV封装
+ */
+@interface TJPFragmentCodec : NSObject
+
+/// 分片头TLV总长度 Tag(2)+Length(4)+Value(20)
+@property (class, nonatomic, readonly) NSUInteger headerLength;
+
+/// 计算分片数
++ (NSUInteger)fragmentCountForLength:(NSUInteger)length fragmentSize:(NSUInteger)fragmentSize;
+
+/// 构建指定序号的分片载荷
+/// - Parameters:
+///   - data: 原始消息
+///   - transferId: 传输ID
+///   - index: 分片序号
+///   - fragmentSize: 分片大小
++ (NSData *)fragmentPayloadForData:(NSData *)data transferId:(uint32_t)transferId index:(NSUInteger)index fragmentSize:(NSUInteger)fragmentSize;
+
+/// 解析分片载荷 只校验结构 不校验CRC
+/// - Parameters:
+///   - payload: 分片消息载荷
+///   - header: 输出分片头
+///   - chunkRange: 输出分片数据在载荷中的范围
++ (BOOL)parseFragmentPayload:(NSData *)payload header:(TJPFragmentHeader *)header chunkRange:(NSRange *)chunkRange;
+
+@end
+
+NS_ASSUME_NONNULL_END
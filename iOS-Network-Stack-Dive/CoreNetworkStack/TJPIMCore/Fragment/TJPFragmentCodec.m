@@ -0,0 +1,85 @@
+//
+//  TJPFragmentCodec.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//
+
+#import "TJPFragmentCodec.h"
+#import <libkern/OSByteOrder.h>
+#import "TJPNetworkUtil.h"
+
+// 分片头Value长度
+static const uint32_t kTJPFragmentHeaderValueLength = 20;
+// 分片头TLV总长度
+static const NSUInteger kTJPFragmentHeaderLength = sizeof(uint16_t) + sizeof(uint32_t) + kTJPFragmentHeaderValueLength;
+
+@implementation TJPFragmentCodec
+
++ (NSUInteger)headerLength {
+    return kTJPFragmentHeaderLength;
+}
+
++ (NSUInteger)fragmentCountForLength:(NSUInteger)length fragmentSize:(NSUInteger)fragmentSize {
+    if (length == 0 || fragmentSize == 0) {
+        return 0;
+    }
+    return (length + fragmentSize - 1) / fragmentSize;
+}
+
++ (NSData *)fragmentPayloadForData:(NSData *)data transferId:(uint32_t)transferId index:(NSUInteger)index fragmentSize:(NSUInteger)fragmentSize {
+    NSUInteger count = [self fragmentCountForLength:data.length fragmentSize:fragmentSize];
+    NSParameterAssert(index < count && count <= UINT16_MAX);
+    
+    NSUInteger offset = index * fragmentSize;
+    NSUInteger chunkLength = MIN(fragmentSize, data.length - offset);
+    const uint8_t *chunk = (const uint8_t *)data.bytes + offset;
+    
+    uint8_t header[kTJPFragmentHeaderLength];
+    OSWriteBigInt16(header, 0, TJP_TLV_TAG_FRAGMENT_HEADER);
+    OSWriteBigInt32(header, 2, kTJPFragmentHeaderValueLength);
+    OSWriteBigInt32(header, 6, transferId);
+    OSWriteBigInt16(header, 10, (uint16_t)index);
+    OSWriteBigInt16(header, 12, (uint16_t)count);
+    OSWriteBigInt32(header, 14, (uint32_t)data.length);
+    OSWriteBigInt32(header, 18, (uint32_t)offset);
+    OSWriteBigInt32(header, 22, [TJPNetworkUtil crc32UpdateWithCRC:0 bytes:chunk length:chunkLength]);
+    
+    NSMutableData *payload = [NSMutableData dataWithCapacity:kTJPFragmentHeaderLength + chunkLength];
+    [payload appendBytes:header length:kTJPFragmentHeaderLength];
+    [payload appendBytes:chunk length:chunkLength];
+    return payload;
+}
+
++ (BOOL)parseFragmentPayload:(NSData *)payload header:(TJPFragmentHeader *)header chunkRange:(NSRange *)chunkRange {
+    if (payload.length < kTJPFragmentHeaderLength) {
+        return NO;
+    }
+    
+    const uint8_t *bytes = payload.bytes;
+    if (OSReadBigInt16(bytes, 0) != TJP_TLV_TAG_FRAGMENT_HEADER || OSReadBigInt32(bytes, 2) != kTJPFragmentHeaderValueLength) {
+        return NO;
+    }
+    
+    TJPFragmentHeader parsed;
+    parsed.transferId = OSReadBigInt32(bytes, 6);
+    parsed.index = OSReadBigInt16(bytes, 10);
+    parsed.count = OSReadBigInt16(bytes, 12);
+    parsed.totalLength = OSReadBigInt32(bytes, 14);
+    parsed.offset = OSReadBigInt32(bytes, 18);
+    parsed.checksum = OSReadBigInt32(bytes, 22);
+    
+    NSUInteger chunkLength = payload.length - kTJPFragmentHeaderLength;
+    if (parsed.count == 0 || parsed.index >= parsed.count || chunkLength == 0) {
+        return NO;
+    }
+    if ((uint64_t)parsed.offset + chunkLength > parsed.totalLength) {
+        return NO;
+    }
+    
+    *header = parsed;
+    *chunkRange = NSMakeRange(kTJPFragmentHeaderLength, chunkLength);
+    return YES;
+}
+
+@end
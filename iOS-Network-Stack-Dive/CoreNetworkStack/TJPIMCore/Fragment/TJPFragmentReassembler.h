@@ -0,0 +1,47 @@
+//
+//  TJPFragmentReassembler.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//  分片重组
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 接收端分片重组
+ *
+ * 设计说明：
+ * - 收到某条消息的首个分片时按原始长度预分配缓冲区 分片数据直接拷贝到对应偏移
+ * - 每个分片单独校验CRC 校验失败的分片不确认 由发送方重传
+ * - 非末尾分片长度必须一致且偏移等于序号乘以分片长度 保证无重叠无空洞
+ * - 重组状态按传输ID保存 断线重连后发送方续传的分片可继续拼接
+ * - 超时或超出并发上限的重组会被丢弃 最近完成的传输ID会被记住 迟到的重传直接判为重复
+ * - 非线程安全 由会话在sessionQueue上访问
+ */
+@interface TJPFragmentReassembler : NSObject
+
+/// 正在重组的消息数
+@property (nonatomic, readonly) NSUInteger activeTransferCount;
+
+
+/// 初始化方法
+/// - Parameters:
+///   - maxTransfers: 同时重组的消息数上限
+///   - timeout: 无新分片到达的超时时间(秒)
+- (instancetype)initWithMaxTransfers:(NSUInteger)maxTransfers timeout:(NSTimeInterval)timeout;
+
+/// 处理一个分片消息载荷
+/// - Parameters:
+///   - payload: 分片消息载荷
+///   - completedData: 全部到齐时输出重组后的消息
+- (TJPFragmentReassemblyResult)appendFragmentPayload:(NSData *)payload completedData:(NSData * _Nullable * _Nullable)completedData;
+
+/// 丢弃全部重组状态
+- (void)removeAllTransfers;
+
+@end
+
+NS_ASSUME_NONNULL_END
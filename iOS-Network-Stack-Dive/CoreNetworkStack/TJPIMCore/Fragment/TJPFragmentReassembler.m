@@ -0,0 +1,215 @@
+//
+//  TJPFragmentReassembler.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//
+
+#import "TJPFragmentReassembler.h"
+#import <time.h>
+#import "TJPFragmentCodec.h"
+#import "TJPNetworkUtil.h"
+#import "TJPNetworkDefine.h"
+
+// 记住的最近完成传输ID数
+static const NSUInteger kTJPCompletedTransferHistory = 64;
+
+/// 单条消息的重组状态
+@interface TJPFragmentAssembly : NSObject
+
+@property (nonatomic, strong) NSMutableData *buffer;
+@property (nonatomic, strong) NSMutableIndexSet *receivedIndexes;
+@property (nonatomic, assign) uint16_t count;
+@property (nonatomic, assign) uint32_t totalLength;
+/// 非末尾分片长度 0表示尚未收到非末尾分片
+@property (nonatomic, assign) uint32_t fragmentSize;
+/// 末尾分片偏移 UINT32_MAX表示尚未收到
+@property (nonatomic, assign) uint32_t lastFragmentOffset;
+@property (nonatomic, assign) uint64_t receivedBytes;
+@property (nonatomic, assign) uint64_t lastUpdateTime;
+
+@end
+
+@implementation TJPFragmentAssembly
+@end
+
+
+@interface TJPFragmentReassembler ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, TJPFragmentAssembly *> *assemblies;
+@property (nonatomic, strong) NSMutableOrderedSet<NSNumber *> *completedTransferIds;
+
+@end
+
+@implementation TJPFragmentReassembler {
+    NSUInteger _maxTransfers;
+    uint64_t _timeoutNanoseconds;
+}
+
+- (instancetype)initWithMaxTransfers:(NSUInteger)maxTransfers timeout:(NSTimeInterval)timeout {
+    if (self = [super init]) {
+        _maxTransfers = MAX(maxTransfers, (NSUInteger)1);
+        _timeoutNanoseconds = (uint64_t)(timeout * NSEC_PER_SEC);
+        _assemblies = [NSMutableDictionary dictionary];
+        _completedTransferIds = [NSMutableOrderedSet orderedSet];
+    }
+    return self;
+}
+
+- (NSUInteger)activeTransferCount {
+    return self.assemblies.count;
+}
+
+#pragma mark - Public Method
+- (TJPFragmentReassemblyResult)appendFragmentPayload:(NSData *)payload completedData:(NSData * _Nullable * _Nullable)completedData {
+    TJPFragmentHeader header;
+    NSRange chunkRange;
+    if (![TJPFragmentCodec parseFragmentPayload:payload header:&header chunkRange:&chunkRange]) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片格式错误，长度: %lu", (unsigned long)payload.length);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    if (header.totalLength > TJPMAX_BODY_SIZE) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片声明的消息长度 %u 超过上限", header.totalLength);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    
+    const uint8_t *chunk = (const uint8_t *)payload.bytes + chunkRange.location;
+    if ([TJPNetworkUtil crc32UpdateWithCRC:0 bytes:chunk length:chunkRange.length] != header.checksum) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片CRC校验失败 传输ID: %u 序号: %u", header.transferId, header.index);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    [self purgeExpiredAssembliesAt:now];
+    
+    NSNumber *key = @(header.transferId);
+    if ([self.completedTransferIds containsObject:key]) {
+        return TJPFragmentReassemblyResultDuplicate;
+    }
+    
+    TJPFragmentAssembly *assembly = self.assemblies[key];
+    if (!assembly) {
+        assembly = [self createAssemblyForHeader:header];
+        self.assemblies[key] = assembly;
+    } else if (assembly.count != header.count || assembly.totalLength != header.totalLength) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片与已收分片不一致 传输ID: %u", header.transferId);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    
+    if ([assembly.receivedIndexes containsIndex:header.index]) {
+        assembly.lastUpdateTime = now;
+        return TJPFragmentReassemblyResultDuplicate;
+    }
+    if (![self validateHeader:header chunkLength:(uint32_t)chunkRange.length forAssembly:assembly]) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片偏移或长度不合法 传输ID: %u 序号: %u", header.transferId, header.index);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    
+    // 直接写入预分配缓冲区对应偏移
+    memcpy((uint8_t *)assembly.buffer.mutableBytes + header.offset, chunk, chunkRange.length);
+    [assembly.receivedIndexes addIndex:header.index];
+    assembly.receivedBytes += chunkRange.length;
+    assembly.lastUpdateTime = now;
+    
+    if (assembly.receivedIndexes.count < assembly.count) {
+        return TJPFragmentReassemblyResultIncomplete;
+    }
+    
+    [self.assemblies removeObjectForKey:key];
+    
+    // 末尾分片先于其他分片到达时 补做偏移校验 校验失败不记为已完成 合法的重传可以重新重组
+    BOOL lastOffsetValid = assembly.count == 1 || assembly.lastFragmentOffset == (uint64_t)assembly.fragmentSize * (assembly.count - 1);
+    if (assembly.receivedBytes != assembly.totalLength || !lastOffsetValid) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 分片拼接后长度不一致 传输ID: %u", header.transferId);
+        return TJPFragmentReassemblyResultInvalid;
+    }
+    [self rememberCompletedTransferId:key];
+    
+    if (completedData) {
+        *completedData = assembly.buffer;
+    }
+    return TJPFragmentReassemblyResultCompleted;
+}
+
+- (void)removeAllTransfers {
+    [self.assemblies removeAllObjects];
+    [self.completedTransferIds removeAllObjects];
+}
+
+#pragma mark - Private Method
+- (TJPFragmentAssembly *)createAssemblyForHeader:(TJPFragmentHeader)header {
+    // 超出并发上限时淘汰最久未更新的重组
+    if (self.assemblies.count >= _maxTransfers) {
+        __block NSNumber *oldestKey = nil;
+        __block uint64_t oldestTime = UINT64_MAX;
+        [self.assemblies enumerateKeysAndObjectsUsingBlock:^(NSNumber *key, TJPFragmentAssembly *assembly, BOOL *stop) {
+            if (assembly.lastUpdateTime < oldestTime) {
+                oldestTime = assembly.lastUpdateTime;
+                oldestKey = key;
+            }
+        }];
+        if (oldestKey) {
+            TJPLOG_WARN(@"[TJPFragmentReassembler] 重组数达到上限 丢弃传输ID: %@", oldestKey);
+            [self.assemblies removeObjectForKey:oldestKey];
+        }
+    }
+    
+    TJPFragmentAssembly *assembly = [[TJPFragmentAssembly alloc] init];
+    assembly.buffer = [NSMutableData dataWithLength:header.totalLength];
+    assembly.receivedIndexes = [NSMutableIndexSet indexSet];
+    assembly.count = header.count;
+    assembly.totalLength = header.totalLength;
+    assembly.lastFragmentOffset = UINT32_MAX;
+    return assembly;
+}
+
+- (BOOL)validateHeader:(TJPFragmentHeader)header chunkLength:(uint32_t)chunkLength forAssembly:(TJPFragmentAssembly *)assembly {
+    BOOL isLast = header.index == header.count - 1;
+    if (isLast) {
+        // 末尾分片必须恰好到消息结尾
+        if ((uint64_t)header.offset + chunkLength != header.totalLength) {
+            return NO;
+        }
+        if (assembly.fragmentSize > 0 && header.offset != (uint64_t)assembly.fragmentSize * header.index) {
+            return NO;
+        }
+        assembly.lastFragmentOffset = header.offset;
+        return YES;
+    }
+    
+    // 非末尾分片长度一致 偏移由序号决定 首个分片校验通过后才记录分片大小
+    uint32_t fragmentSize = assembly.fragmentSize > 0 ? assembly.fragmentSize : chunkLength;
+    if (chunkLength == 0 || chunkLength != fragmentSize || header.offset != (uint64_t)fragmentSize * header.index) {
+        return NO;
+    }
+    assembly.fragmentSize = fragmentSize;
+    return YES;
+}
+
+- (void)purgeExpiredAssembliesAt:(uint64_t)now {
+    if (self.assemblies.count == 0) {
+        return;
+    }
+    NSMutableArray<NSNumber *> *expiredKeys = nil;
+    for (NSNumber *key in self.assemblies) {
+        if (now - self.assemblies[key].lastUpdateTime > _timeoutNanoseconds) {
+            if (!expiredKeys) {
+                expiredKeys = [NSMutableArray array];
+            }
+            [expiredKeys addObject:key];
+        }
+    }
+    if (expiredKeys.count > 0) {
+        TJPLOG_WARN(@"[TJPFragmentReassembler] 丢弃 %lu 个超时的分片重组", (unsigned long)expiredKeys.count);
+        [self.assemblies removeObjectsForKeys:expiredKeys];
+    }
+}
+
+- (void)rememberCompletedTransferId:(NSNumber *)transferId {
+    [self.completedTransferIds addObject:transferId];
+    if (self.completedTransferIds.count > kTJPCompletedTransferHistory) {
+        [self.completedTransferIds removeObjectAtIndex:0];
+    }
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  TJPFragmentTransfer.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//  发送端大消息分片传输
+
+#import <Foundation/Foundation.h>
+
+@class TJPMessageContext;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 一条大消息的发送端分片状态
+ *
+ * 设计说明：
+ * - 分片上下文按需生成 同一时刻只有一个分片在发送队列中 发出后再入队下一个
+ *   使其他消息可以在分片之间插入 大消息不会长时间占用连接
+ * - 记录已确认的分片 断线重连后从第一个未确认分片续传 传输ID保持不变
+ * - 非线程安全 由会话在sessionQueue上访问
+ */
+@interface TJPFragmentTransfer : NSObject
+
+/// 原始消息
+@property (nonatomic, strong, readonly) TJPMessageContext *message;
+/// 传输ID
+@property (nonatomic, assign, readonly) uint32_t transferId;
+/// 分片大小
+@property (nonatomic, assign, readonly) NSUInteger fragmentSize;
+/// 分片总数
+@property (nonatomic, assign, readonly) NSUInteger fragmentCount;
+/// 已确认分片数
+@property (nonatomic, assign, readonly) NSUInteger acknowledgedCount;
+/// 全部分片已确认
+@property (nonatomic, assign, readonly, getter=isComplete) BOOL complete;
+
+
+/// 初始化方法
+/// - Parameters:
+///   - message: 原始消息
+///   - fragmentSize: 分片大小
+- (instancetype)initWithMessage:(TJPMessageContext *)message fragmentSize:(NSUInteger)fragmentSize;
+
+/// 生成下一个待发送分片的上下文 已确认的分片跳过 全部生成后返回nil
+- (nullable TJPMessageContext *)nextFragmentContext;
+
+/// 标记分片已确认
+- (void)acknowledgeFragmentAtIndex:(NSUInteger)index;
+
+/// 回退到第一个未确认分片 用于重连后续传
+- (void)rewindToFirstUnacknowledgedFragment;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,73 @@
+//
+//  TJPFragmentTransfer.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//
+
+#import "TJPFragmentTransfer.h"
+#import "TJPMessageContext.h"
+#import "TJPFragmentCodec.h"
+
+@interface TJPFragmentTransfer ()
+
+@property (nonatomic, strong) NSMutableIndexSet *acknowledgedIndexes;
+/// 下一个待生成的分片序号
+@property (nonatomic, assign) NSUInteger nextFragmentIndex;
+
+@end
+
+@implementation TJPFragmentTransfer
+
+- (instancetype)initWithMessage:(TJPMessageContext *)message fragmentSize:(NSUInteger)fragmentSize {
+    if (self = [super init]) {
+        _message = message;
+        _transferId = arc4random();
+        _fragmentSize = fragmentSize;
+        _fragmentCount = [TJPFragmentCodec fragmentCountForLength:message.payload.length fragmentSize:fragmentSize];
+        _acknowledgedIndexes = [NSMutableIndexSet indexSet];
+    }
+    return self;
+}
+
+- (NSUInteger)acknowledgedCount {
+    return self.acknowledgedIndexes.count;
+}
+
+- (BOOL)isComplete {
+    return self.acknowledgedIndexes.count >= self.fragmentCount;
+}
+
+- (nullable TJPMessageContext *)nextFragmentContext {
+    while (self.nextFragmentIndex < self.fragmentCount && [self.acknowledgedIndexes containsIndex:self.nextFragmentIndex]) {
+        self.nextFragmentIndex++;
+    }
+    if (self.nextFragmentIndex >= self.fragmentCount) {
+        return nil;
+    }
+    
+    NSUInteger index = self.nextFragmentIndex++;
+    NSData *payload = [TJPFragmentCodec fragmentPayloadForData:self.message.payload transferId:self.transferId index:index fragmentSize:self.fragmentSize];
+    
+    // 序列号在发出时分配 压缩加密等属性沿用原始消息
+    TJPMessageContext *fragment = [TJPMessageContext contextWithData:payload seq:0 messageType:TJPMessageTypeFragment encryptType:self.message.encryptType compressType:self.message.compressType sessionId:self.message.sessionId];
+    fragment.messageId = [NSString stringWithFormat:@"%@#%lu", self.message.messageId, (unsigned long)index];
+    fragment.priority = self.message.priority;
+    fragment.maxRetryCount = self.message.maxRetryCount;
+    fragment.retryTimeout = self.message.retryTimeout;
+    fragment.parentMessageId = self.message.messageId;
+    fragment.fragmentIndex = index;
+    return fragment;
+}
+
+- (void)acknowledgeFragmentAtIndex:(NSUInteger)index {
+    if (index < self.fragmentCount) {
+        [self.acknowledgedIndexes addIndex:index];
+    }
+}
+
+- (void)rewindToFirstUnacknowledgedFragment {
+    self.nextFragmentIndex = 0;
+}
+
+@end
@@ -722,6 +722,9 @@
             @"networkQuality": @(self.networkCondition.qualityLevel),
             @"roundTripTime": @(self.networkCondition.roundTripTime),
             @"packetLossRate": @(self.networkCondition.packetLossRate),
+            @"smoothedRoundTripTime": @(self.networkCondition.smoothedRoundTripTime),
+            @"roundTripTimeVariance": @(self.networkCondition.roundTripTimeVariance),
+            @"retransmissionTimeout": @(self.networkCondition.retransmissionTimeout),
             @"lastModeChangeTime": @(self.lastModeChangeTime),
             @"isTransitioning": @(self.isTransitioning),
             @"backgroundTransitions": @(self.backgroundTransitionCounter)
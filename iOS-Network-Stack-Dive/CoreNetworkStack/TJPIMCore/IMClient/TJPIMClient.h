@@ -61,6 +61,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type completion:(void(^)(NSString *msgId, NSError *error))completion;
 - (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType completion:(void (^)(NSString *msgId, NSError *error))completion;
+/**
+ * 指定优先级的发送方法 未指定优先级的方法按内容类型取默认值
+ */
+- (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type priority:(TJPMessagePriority)priority completion:(void(^)(NSString *msgId, NSError *error))completion;
+- (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType priority:(TJPMessagePriority)priority completion:(void (^)(NSString *msgId, NSError *error))completion;
 /**
  * 检查指定类型的会话是否已连接
  */
@@ -11,6 +11,7 @@
 #import "TJPNetworkConfig.h"
 #import "TJPNetworkDefine.h"
 #import "TJPErrorUtil.h"
+#import "TJPMessageContext.h"
 
 
 @interface TJPIMClient ()
@@ -86,7 +87,8 @@
     
     // 保存到通道
     self.channels[@(type)] = session;
-    self.connectionStates[@(type)] = TJPConnectStateConnecting;
+    // 待命会话取出时已连接 KVO不会再收到连接成功的变化
+    self.connectionStates[@(type)] = [session.connectState isEqualToString:TJPConnectStateConnected] ? TJPConnectStateConnected : TJPConnectStateConnecting;
     
     TJPLOG_INFO(@"[TJPIMClient] 获取会话成功: %@，开始设置KVO", session.sessionId ?: @"nil");
 
@@ -167,6 +169,14 @@
 }
 
 - (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType completion:(void (^)(NSString * msgId, NSError *error))completion {
+    return [self sendMessage:message throughType:type encryptType:encryptType compressType:compressType priority:[self defaultPriorityForMessage:message] completion:completion];
+}
+
+- (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type priority:(TJPMessagePriority)priority completion:(void (^)(NSString *msgId, NSError *error))completion {
+    return [self sendMessage:message throughType:type encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeZlib priority:priority completion:completion];
+}
+
+- (NSString *)sendMessage:(id<TJPMessageProtocol>)message throughType:(TJPSessionType)type encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType priority:(TJPMessagePriority)priority completion:(void (^)(NSString * msgId, NSError *error))completion {
     id<TJPSessionProtocol> session = self.channels[@(type)];
     
     if (!session) {
@@ -188,13 +198,31 @@
         TJPLOG_ERROR(@"[TJPIMClient] 消息序列化失败，无法发送");
         return nil;
     }
-    NSString *messageId = [session sendData:tlvData messageType:message.messageType encryptType:encryptType compressType:compressType completion:completion];
+    NSString *messageId = [session sendData:tlvData messageType:message.messageType encryptType:encryptType compressType:compressType priority:priority completion:completion];
     
     TJPLOG_INFO(@"[TJPIMClient] 通过类型 %lu 的会话发送消息成功，大小: %lu 字节", (unsigned long)type, (unsigned long)tlvData.length);
     return messageId;
 }
 
 
+/// 未指定优先级时的默认值 控制类消息紧急 文本和位置优先于图片语音 视频和文件等大块传输让路
+- (TJPMessagePriority)defaultPriorityForMessage:(id<TJPMessageProtocol>)message {
+    if (message.messageType != TJPMessageTypeNormalData) {
+        return [TJPMessageContext defaultPriorityForMessageType:message.messageType];
+    }
+    switch (message.contentType) {
+        case TJPContentTypeText:
+        case TJPContentTypeLocation:
+            return TJPMessagePriorityHigh;
+        case TJPContentTypeVideo:
+        case TJPContentTypeFile:
+            return TJPMessagePriorityLow;
+        default:
+            return TJPMessagePriorityNormal;
+    }
+}
+
+
 #pragma mark - State Management
 - (BOOL)isConnectedForType:(TJPSessionType)type {
     TJPConnectState state = [self getConnectionStateForType:type];
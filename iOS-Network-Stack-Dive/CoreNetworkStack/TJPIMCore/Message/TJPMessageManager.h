@@ -40,6 +40,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSString *)sendMessage:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType completion:(void(^)(NSString *messageId, NSError *error))completion;
 
+/**
+ * 创建并发送消息
+ * @param messageType 消息类型
+ * @param encryptType 加密类型
+ * @param compressType 压缩类型
+ * @param priority 发送优先级 未指定时取消息类型的默认值
+ * @param completion 回调
+ */
+- (NSString *)sendMessage:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType priority:(TJPMessagePriority)priority completion:(void(^)(NSString *messageId, NSError *error))completion;
+
 
 /// 获取消息上下文
 - (TJPMessageContext *)messageWithId:(NSString *)messageId;
@@ -65,6 +65,10 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
 }
 
 - (NSString *)sendMessage:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType completion:(void (^)(NSString *messageId, NSError *error))completion {
+    return [self sendMessage:data messageType:messageType encryptType:encryptType compressType:compressType priority:[TJPMessageContext defaultPriorityForMessageType:messageType] completion:completion];
+}
+
+- (NSString *)sendMessage:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType priority:(TJPMessagePriority)priority completion:(void (^)(NSString *messageId, NSError *error))completion {
     __block NSString *messageId = nil;
     __block NSError *validationError = nil;
     
@@ -83,7 +87,8 @@ static const NSTimeInterval kDefaultRetryInterval = 10;
         }
         
         // 创建消息上下文 序列号稍后由会话分配
-        TJPMessageContext *context = [TJPMessageContext contextWithData:data seq:0 messageType:messageType encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:self.sessionId];
+        TJPMessageContext *context = [TJPMessageContext contextWithData:data seq:0 messageType:messageType encryptType:TJPEncryptTypeCRC32 compressType:compressType sessionId:self.sessionId];
+        context.priority = priority;
         messageId = context.messageId;
         
         // 消息状态机管理消息状态
@@ -31,10 +31,22 @@ typedef NS_ENUM(NSUInteger, TJPNetworkQualityLevel) {
 /// 是否拥塞
 @property (nonatomic, assign, readonly) BOOL isCongested;
 
+/// 平滑往返延迟 毫秒 (Jacobson/Karels SRTT)
+@property (nonatomic, assign, readonly) NSTimeInterval smoothedRoundTripTime;
+/// 往返延迟偏差 毫秒 (Jacobson/Karels RTTVAR)
+@property (nonatomic, assign, readonly) NSTimeInterval roundTripTimeVariance;
+/// 当前重传超时 秒 未退避 尚无样本时为初始值
+@property (nonatomic, assign, readonly) NSTimeInterval retransmissionTimeout;
 
+
+/// 更新RTT样本 毫秒 同时更新SRTT/RTTVAR和重传超时
+/// 重传过的消息无法区分ACK对应哪次发送 调用方按Karn算法不应提交其样本
 - (void)updateRTTWithSample:(NSTimeInterval)rtt;
 - (void)updateLostWithSample:(BOOL)isLost;
 
+/// 第retryCount次重传前的等待时间 秒 按2^retryCount指数退避 并限制在上下限内
+- (NSTimeInterval)retransmissionTimeoutForRetryCount:(NSInteger)retryCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -6,17 +6,22 @@
 //
 
 #import "TJPNetworkCondition.h"
+#import "TJPNetworkDefine.h"
 
 
 #define kMaxRTTSamples 10   //RTT样本数量
 #define kWeightFactor 0.1  //丢包率加权因子
+#define kSRTTGain 0.125     //SRTT平滑系数 α=1/8
+#define kRTTVARGain 0.25    //RTTVAR平滑系数 β=1/4
+#define kMaxBackoffShift 16 //指数退避最大位移 防止溢出
 
 @interface TJPNetworkCondition ()
 
 /// 记录数据
 @property (nonatomic, strong) NSMutableArray<NSNumber *> *rttSamples;
 @property (nonatomic, strong) NSMutableArray<NSNumber *> *lostSamples;
-
+/// 是否已有RTO样本
+@property (nonatomic, assign) BOOL hasRTOSample;
 
 @end
 
@@ -30,6 +35,7 @@
         _packetLossRate = 0.0;
         _rttSamples = [[NSMutableArray alloc] initWithCapacity:kMaxRTTSamples];
         _lostSamples = [[NSMutableArray alloc] initWithCapacity:kMaxRTTSamples];
+        _retransmissionTimeout = TJP_RTO_INITIAL_INTERVAL;
     }
     return self;
 }
@@ -43,8 +49,19 @@
         
         //更新当前RTT
         _roundTripTime = [self _weightAverageForSamples:_rttSamples];
+        
+        //更新重传超时
+        [self _updateRetransmissionTimeoutWithSample:rtt];
+    }
+}
+
+- (NSTimeInterval)retransmissionTimeoutForRetryCount:(NSInteger)retryCount {
+    @synchronized (self) {
+        int shift = (int)MIN(MAX(retryCount, 0), kMaxBackoffShift);
+        return MIN(ldexp(_retransmissionTimeout, shift), TJP_RTO_MAX_INTERVAL);
     }
 }
+
 - (void)updateLostWithSample:(BOOL)isLost {
     @synchronized (self) {
         if (_lostSamples.count >= kMaxRTTSamples) {
@@ -61,6 +78,27 @@
     }
 }
 
+- (void)_updateRetransmissionTimeoutWithSample:(NSTimeInterval)rtt {
+    if (rtt < 0) {
+        return;
+    }
+    
+    if (!_hasRTOSample) {
+        //首个样本 RTTVAR取一半
+        _smoothedRoundTripTime = rtt;
+        _roundTripTimeVariance = rtt / 2;
+        _hasRTOSample = YES;
+    } else {
+        //先用旧SRTT更新偏差 再更新SRTT
+        _roundTripTimeVariance = (1 - kRTTVARGain) * _roundTripTimeVariance + kRTTVARGain * fabs(_smoothedRoundTripTime - rtt);
+        _smoothedRoundTripTime = (1 - kSRTTGain) * _smoothedRoundTripTime + kSRTTGain * rtt;
+    }
+    
+    //RTO = SRTT + max(G, 4*RTTVAR) 时钟粒度G取时间轮刻度
+    NSTimeInterval rto = _smoothedRoundTripTime / 1000.0 + MAX(TJP_TIMER_WHEEL_TICK_INTERVAL, 4 * _roundTripTimeVariance / 1000.0);
+    _retransmissionTimeout = MIN(MAX(rto, TJP_RTO_MIN_INTERVAL), TJP_RTO_MAX_INTERVAL);
+}
+
 - (CGFloat)_weightAverageForSamples:(NSMutableArray<NSNumber *> *)samples {
     //总和
     CGFloat sum = 0;
@@ -6,6 +6,7 @@
 //
 
 #import "TJPLogManager.h"
+#include <limits.h>
 
 #ifndef TJPNetworkDefine_h
 #define TJPNetworkDefine_h
@@ -64,6 +65,42 @@
 #define TJPMAX_TIME_WINDOW 60 // 60秒时间窗口，防重放攻击
 
 #define TJP_DEFAULT_RING_BUFFER_CAPACITY (128 * 1024) // 缓冲区大小 初始128kb
+#define TJP_DEFAULT_RING_BUFFER_MAX_CAPACITY (16 * 1024 * 1024) // 环形缓冲区扩容上限 可容纳最大消息体
+#define TJP_RING_BUFFER_SHRINK_IDLE_INTERVAL 30 // 持续低使用率30秒后缩容
+
+#define TJP_MAX_WRITE_IOV_COUNT IOV_MAX // 单次writev最多分段数 超出时分批写
+#define TJP_DEFAULT_WRITE_COALESCING_INTERVAL 0.002 // 写合并窗口 2毫秒
+#define TJP_DEFAULT_WRITE_COALESCING_MAX_BYTES (16 * 1024) // 写合并字节阈值 16KB
+
+#define TJP_DELAYED_ACK_MAX_PACKETS 16 // 延迟确认 累计16个包立即发送ACK
+#define TJP_DELAYED_ACK_INTERVAL 0.04 // 延迟确认 最长等待40毫秒
+#define TJP_SELECTIVE_ACK_BITMAP_BITS 64 // 每个SACK区段覆盖的序列号个数
+
+#define TJP_TIMER_WHEEL_TICK_INTERVAL 0.1 // 重传时间轮刻度 100毫秒 与原重传定时器精度一致
+#define TJP_TIMER_WHEEL_SLOT_COUNT 512 // 重传时间轮槽数 一圈约51秒 必须为2的幂
+
+#define TJP_RTO_INITIAL_INTERVAL 3.0 // 尚无RTT样本时的重传超时 秒
+#define TJP_RTO_MIN_INTERVAL 0.5 // 重传超时下限 秒 需覆盖延迟确认和时间轮刻度
+#define TJP_RTO_MAX_INTERVAL 30.0 // 重传超时上限(含退避) 秒
+
+#define TJP_DEFAULT_SEND_WINDOW_MESSAGES 64 // 发送窗口 默认最大在途消息数
+#define TJP_DEFAULT_SEND_WINDOW_BYTES (4 * 1024 * 1024) // 发送窗口 默认最大在途字节数 4MB
+#define TJP_SEND_SCHEDULER_QUANTUM (16 * 1024) // 发送调度 每轮基础字节额度 按优先级权重放大
+
+#define TJP_FRAGMENT_SIZE (64 * 1024) // 分片大小 超过该长度的消息按此拆分
+#define TJP_FRAGMENT_MAX_REASSEMBLIES 8 // 同时重组的消息数上限 超出时淘汰最久未更新的
+#define TJP_FRAGMENT_REASSEMBLY_TIMEOUT 60.0 // 重组超时 秒 覆盖断线重连后续传的时间
+
+#define TJP_COMPRESSION_MIN_SIZE 256 // 压缩阈值 小于该长度的载荷压缩收益抵不上开销
+#define TJP_COMPRESSION_MIN_SAVING 0.1 // 压缩后至少节省的比例 不足时按原文发送
+#define TJP_COMPRESSION_MAX_INFLATED_SIZE TJPMAX_BODY_SIZE // 解压输出上限 防止压缩炸弹
+#define TJP_COMPRESSION_DICTIONARY_MIN_SIZE 24 // 协商字典压缩后的压缩阈值 短消息也可从字典获益
+
+#define TJP_PARSE_LANE_DEPTH_WARNING 64 // 解析通道积压告警阈值 达到时输出一次告警
+
+#define TJP_STANDBY_REFRESH_INTERVAL 10.0 // 待命会话刷新间隔 秒 按获取速率调整每种类型的预连接数
+#define TJP_STANDBY_RATE_SMOOTHING 0.3 // 获取速率指数平滑系数 越大越跟随最近的请求
+#define TJP_STANDBY_LOOKAHEAD 30.0 // 预留未来多少秒的获取量 覆盖补充新连接所需的时间
 
 
 
@@ -80,6 +117,10 @@ static const uint32_t TJPSEQUENCE_MAX_VALUE = 0x00FFFFFF;         // 最大序
 static const uint32_t TJPSEQUENCE_WARNING_THRESHOLD = 0x00F00000; // 警告阈值(15M)
 static const uint32_t TJPSEQUENCE_RESET_THRESHOLD = 0x00FF0000;   // 重置阈值(16M-1M)
 
+#define TJPREPLAY_WINDOW_SIZE 1024u                                // 防重放滑动窗口大小(位) 用作数组长度 需为常量表达式
+#define TJPREPLAY_CATEGORY_COUNT 8u                               // 防重放窗口支持的类别数
+static const uint32_t TJPREPLAY_EPOCH_START_RANGE = 0x0000FFFF;   // 序列号重置后新周期的起始区间
+
 
 
 
@@ -50,6 +50,8 @@ typedef NS_ENUM(NSInteger, TJPNetworkError) {
     TJPErrorProtocolUnsupportedEncryption = 3005, // 不支持的加密类型
     TJPErrorProtocolUnsupportedCompression= 3006, // 不支持的压缩类型
     TJPErrorProtocolTimestampInvalid      = 3007, // 时间戳无效
+    TJPErrorProtocolDecompressionFailed   = 3008, // 解压失败
+    TJPErrorProtocolDecompressedTooLarge  = 3009, // 解压后长度超过限制
     
     // TLV解析错误 (4000-4999)
     TJPErrorTLVParseError                 = 4000, // TLV解析错误
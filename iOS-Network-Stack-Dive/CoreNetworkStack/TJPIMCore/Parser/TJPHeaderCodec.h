@@ -0,0 +1,40 @@
+//
+//  TJPHeaderCodec.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/9.
+//  协议头解码与校验
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// 主机字节序的协议头字段
+typedef struct {
+    uint8_t versionMajor;
+    uint8_t versionMinor;
+    uint16_t msgType;
+    uint32_t sequence;
+    uint32_t timestamp;
+    TJPEncryptType encryptType;
+    TJPCompressType compressType;
+    uint16_t sessionId;
+    uint32_t bodyLength;
+    uint32_t checksum;      // 与TJPFinalAdavancedHeader.checksum一致 不做字节序转换
+} TJPDecodedHeader;
+
+
+/// 一次遍历原始28字节协议头 完成解码和结构校验(魔数、版本、长度、时间戳、加密和压缩类型)
+/// 不包含防重放检查 校验失败时decoded内容未定义
+/// - Parameters:
+///   - bytes: 协议头原始字节 至少sizeof(TJPFinalAdavancedHeader)字节 无对齐要求
+///   - now: 当前时间(秒) 由调用方按批次缓存
+///   - decoded: 输出的主机字节序字段
+FOUNDATION_EXPORT TJPHeaderValidationResult TJPHeaderDecode(const void *bytes, uint32_t now, TJPDecodedHeader *decoded);
+
+
+/// 粗粒度时钟 秒级 开销远小于[NSDate date]
+FOUNDATION_EXPORT uint32_t TJPHeaderCoarseNow(void);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,121 @@
+//
+//  TJPHeaderCodec.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/9.
+//
+
+#import "TJPHeaderCodec.h"
+#import <stddef.h>
+#import <time.h>
+#import <libkern/OSByteOrder.h>
+#import "TJPNetworkDefine.h"
+
+// 字段偏移 与TJPFinalAdavancedHeader的packed布局一一对应
+enum {
+    kTJPHeaderMagicOffset        = 0,
+    kTJPHeaderVersionMajorOffset = 4,
+    kTJPHeaderVersionMinorOffset = 5,
+    kTJPHeaderMsgTypeOffset      = 6,
+    kTJPHeaderSequenceOffset     = 8,
+    kTJPHeaderTimestampOffset    = 12,
+    kTJPHeaderEncryptOffset      = 16,
+    kTJPHeaderCompressOffset     = 17,
+    kTJPHeaderSessionIdOffset    = 18,
+    kTJPHeaderBodyLengthOffset   = 20,
+    kTJPHeaderChecksumOffset     = 24,
+    kTJPHeaderSize               = 28
+};
+
+// 布局校验 结构体被修改时编译失败
+_Static_assert(sizeof(TJPFinalAdavancedHeader) == kTJPHeaderSize, "协议头必须为28字节");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, magic) == kTJPHeaderMagicOffset, "magic偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, version_major) == kTJPHeaderVersionMajorOffset, "version_major偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, version_minor) == kTJPHeaderVersionMinorOffset, "version_minor偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, msgType) == kTJPHeaderMsgTypeOffset, "msgType偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, sequence) == kTJPHeaderSequenceOffset, "sequence偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, timestamp) == kTJPHeaderTimestampOffset, "timestamp偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, encrypt_type) == kTJPHeaderEncryptOffset, "encrypt_type偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, compress_type) == kTJPHeaderCompressOffset, "compress_type偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, session_id) == kTJPHeaderSessionIdOffset, "session_id偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, bodyLength) == kTJPHeaderBodyLengthOffset, "bodyLength偏移错误");
+_Static_assert(offsetof(TJPFinalAdavancedHeader, checksum) == kTJPHeaderChecksumOffset, "checksum偏移错误");
+_Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "掩码比较按小端布局构造");
+
+// 前8字节(魔数+主版本+次版本+消息类型)按小端整体加载后 魔数和主版本占低40位
+static const uint64_t kTJPHeaderMagicMajorMask = 0x000000FFFFFFFFFFULL;
+
+// 支持的加密/压缩类型位图 新增类型时在此登记
+static const uint32_t kTJPSupportedEncryptMask = (1u << TJPEncryptTypeNone) | (1u << TJPEncryptTypeCRC32) | (1u << TJPEncryptTypeAES256);
+static const uint32_t kTJPSupportedCompressMask = (1u << TJPCompressTypeNone) | (1u << TJPCompressTypeZlib);
+
+static inline uint64_t TJPHeaderExpectedMagicMajor(void) {
+    // 魔数在线路上为大端 小端加载后字节反转
+    return (uint64_t)OSSwapInt32(kProtocolMagic) | ((uint64_t)kProtocolVersionMajor << 32);
+}
+
+static inline uint32_t TJPHeaderLoadBig32(const uint8_t *bytes, size_t offset) {
+    uint32_t value;
+    memcpy(&value, bytes + offset, sizeof(value));
+    return OSSwapBigToHostInt32(value);
+}
+
+static inline uint16_t TJPHeaderLoadBig16(const uint8_t *bytes, size_t offset) {
+    uint16_t value;
+    memcpy(&value, bytes + offset, sizeof(value));
+    return OSSwapBigToHostInt16(value);
+}
+
+TJPHeaderValidationResult TJPHeaderDecode(const void *bytes, uint32_t now, TJPDecodedHeader *decoded) {
+    const uint8_t *raw = bytes;
+
+    // 一次加载前8字节 魔数+主版本 合并为一次掩码比较
+    uint64_t prefix;
+    memcpy(&prefix, raw, sizeof(prefix));
+    if ((prefix & kTJPHeaderMagicMajorMask) != TJPHeaderExpectedMagicMajor()) {
+        uint32_t magic = TJPHeaderLoadBig32(raw, kTJPHeaderMagicOffset);
+        return magic != kProtocolMagic ? TJPHeaderValidationResultMagicInvalid : TJPHeaderValidationResultVersionMismatch;
+    }
+    uint8_t versionMinor = (uint8_t)(prefix >> 40);
+    if (versionMinor > kProtocolVersionMinor) {
+        return TJPHeaderValidationResultVersionMismatch;
+    }
+
+    uint32_t bodyLength = TJPHeaderLoadBig32(raw, kTJPHeaderBodyLengthOffset);
+    if (bodyLength > TJPMAX_BODY_SIZE) {
+        return TJPHeaderValidationResultBodyTooLarge;
+    }
+
+    uint32_t timestamp = TJPHeaderLoadBig32(raw, kTJPHeaderTimestampOffset);
+    int32_t timeDiff = (int32_t)(now - timestamp);
+    if (timeDiff > TJPMAX_TIME_WINDOW || timeDiff < -TJPMAX_TIME_WINDOW) {
+        return TJPHeaderValidationResultTimestampInvalid;
+    }
+
+    // 类型字节超过31时移位结果为0 一并视为不支持
+    uint8_t encryptType = raw[kTJPHeaderEncryptOffset];
+    if (encryptType >= 32 || !((1u << encryptType) & kTJPSupportedEncryptMask)) {
+        return TJPHeaderValidationResultUnsupportedEncryption;
+    }
+    uint8_t compressType = raw[kTJPHeaderCompressOffset];
+    if (compressType >= 32 || !((1u << compressType) & kTJPSupportedCompressMask)) {
+        return TJPHeaderValidationResultUnsupportedCompression;
+    }
+
+    decoded->versionMajor = kProtocolVersionMajor;
+    decoded->versionMinor = versionMinor;
+    decoded->msgType = (uint16_t)OSSwapBigToHostInt16((uint16_t)(prefix >> 48));
+    decoded->sequence = TJPHeaderLoadBig32(raw, kTJPHeaderSequenceOffset);
+    decoded->timestamp = timestamp;
+    decoded->encryptType = encryptType;
+    decoded->compressType = compressType;
+    decoded->sessionId = TJPHeaderLoadBig16(raw, kTJPHeaderSessionIdOffset);
+    decoded->bodyLength = bodyLength;
+    memcpy(&decoded->checksum, raw + kTJPHeaderChecksumOffset, sizeof(decoded->checksum));
+
+    return TJPHeaderValidationResultValid;
+}
+
+uint32_t TJPHeaderCoarseNow(void) {
+    return (uint32_t)time(NULL);
+}
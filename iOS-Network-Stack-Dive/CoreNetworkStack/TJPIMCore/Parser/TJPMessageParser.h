@@ -9,7 +9,7 @@
 #import "TJPCoreTypes.h"
 
 NS_ASSUME_NONNULL_BEGIN
-@class TJPParsedPacket, TJPMessageParser;
+@class TJPParsedPacket, TJPMessageParser, TJPCompressionCodec;
 
 @protocol TJPMessageStrategyDelegate <NSObject>
 @optional
@@ -32,12 +32,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 /// 当前状态
 @property (nonatomic, assign, readonly) TJPParseState currentState;
-/// 缓冲区 用于数据监控
+/// 缓冲区 用于数据监控 环形缓冲区模式下每次访问都会拷贝全部数据 统计大小请使用usedBufferSize
 @property (nonatomic, readonly) NSMutableData *buffer;
 /// 当前协议头
 @property (nonatomic, readonly) TJPFinalAdavancedHeader currentHeader;
 /// 当前策略
 @property (nonatomic, readonly) TJPBufferStrategy currentStrategy;
+/// 环形缓冲区并发模式
+@property (nonatomic, readonly) TJPRingBufferMode ringBufferMode;
 
 
 /// 开关控制是否使用环形缓冲区
@@ -45,9 +47,18 @@ NS_ASSUME_NONNULL_BEGIN
 /// 缓冲区总容量
 @property (nonatomic, readonly) NSUInteger bufferCapacity;
 /// 已使用大小
-@property (nonatomic, readonly) NSUInteger userdBufferSize;
+@property (nonatomic, readonly) NSUInteger usedBufferSize;
 /// 使用率 0.0 - 1.0
 @property (nonatomic, readonly) CGFloat bufferUsageRatio;
+/// 环形缓冲区扩容上限 默认TJP_DEFAULT_RING_BUFFER_MAX_CAPACITY 突发流量超过当前容量时自动扩容
+@property (nonatomic, assign) NSUInteger ringBufferMaxCapacity;
+/// 环形缓冲区扩容次数
+@property (nonatomic, readonly) NSUInteger ringBufferGrowCount;
+/// 环形缓冲区缩容次数
+@property (nonatomic, readonly) NSUInteger ringBufferShrinkCount;
+
+/// 解压编解码器 压缩包按包头compress_type在校验和通过后解压 与解析在同一队列使用
+@property (nonatomic, readonly) TJPCompressionCodec *compressionCodec;
 
 
 ///  缓冲区添加数据
@@ -56,6 +67,10 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)hasCompletePacket;
 /// 获取下一个数据
 - (TJPParsedPacket *)nextPacket;
+/// 批量取出当前缓冲区内所有完整数据包 一次遍历 一次计时
+/// - Parameter limit: 本批最多取出的包数 0表示不限制
+/// - Returns: 按接收顺序排列的数据包 解析出错时返回已成功解析的部分 并置为错误状态
+- (NSArray<TJPParsedPacket *> *)drainPacketsWithLimit:(NSUInteger)limit;
 /// 重置数据
 - (void)reset;
 
@@ -68,6 +83,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithBufferStrategy:(TJPBufferStrategy)strategy;
 /// 完整配置初始化
 - (instancetype)initWithBufferStrategy:(TJPBufferStrategy)strategy capacity:(NSUInteger)capacity;
+/// 指定环形缓冲区并发模式初始化  SPSC模式要求只有一个线程feedData 一个线程nextPacket
+- (instancetype)initWithBufferStrategy:(TJPBufferStrategy)strategy capacity:(NSUInteger)capacity ringBufferMode:(TJPRingBufferMode)mode;
 
 //************************************************
 //新增控制切换 调试方法
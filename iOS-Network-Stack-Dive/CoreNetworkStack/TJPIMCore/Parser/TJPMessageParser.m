@@ -12,24 +12,61 @@
 #import "TJPNetworkUtil.h"
 #import "TJPErrorUtil.h"
 #import "TJPRingBuffer.h"
+#import "TJPReplayWindow.h"
+#import "TJPHeaderCodec.h"
+#import "TJPCompressionCodec.h"
+
+/// 截取读取视图中 [offset, offset + length) 的子视图 调用方保证范围有效
+static TJPRingBufferReadView TJPReadViewSubrange(TJPRingBufferReadView view, NSUInteger offset, NSUInteger length) {
+    TJPRingBufferReadView subview = {0};
+    if (offset < view.firstLength) {
+        subview.firstSegment = (const uint8_t *)view.firstSegment + offset;
+        subview.firstLength = MIN(length, view.firstLength - offset);
+        if (length > subview.firstLength) {
+            subview.secondSegment = view.secondSegment;
+            subview.secondLength = length - subview.firstLength;
+        }
+    } else {
+        subview.firstSegment = (const uint8_t *)view.secondSegment + (offset - view.firstLength);
+        subview.firstLength = length;
+    }
+    return subview;
+}
 
+/// 从读取视图的offset处拷贝length字节 用于读取可能跨越两段的协议头
+static void TJPReadViewCopyBytes(TJPRingBufferReadView view, NSUInteger offset, void *buffer, NSUInteger length) {
+    TJPRingBufferReadView subview = TJPReadViewSubrange(view, offset, length);
+    memcpy(buffer, subview.firstSegment, subview.firstLength);
+    if (subview.secondLength > 0) {
+        memcpy((uint8_t *)buffer + subview.firstLength, subview.secondSegment, subview.secondLength);
+    }
+}
 
 
 @interface TJPMessageParser () {
     // 协议解析状态
     TJPFinalAdavancedHeader _currentHeader;
+    BOOL _currentHeaderDuplicate;          // 当前包为窗口内重复 校验后丢弃载荷
     TJPParseState _state;
     
     // 双缓冲区实现 - 通过开关控制
     NSMutableData *_traditionBuffer;       // 旧实现：NSMutableData
+    NSUInteger _traditionReadOffset;       // 传统缓冲区读游标 已消费前缀延迟压缩
     TJPRingBuffer *_ringBuffer;            // 新实现：环形缓冲区
     BOOL _isUseRingBuffer;                 // 实现切换开关
     TJPBufferStrategy _strategy;           // 用户设置的策略
+    TJPRingBufferMode _ringBufferMode;     // 环形缓冲区并发模式
     NSUInteger _requestCapacity;           // 用户请求的容量
+    NSUInteger _ringBufferMaxCapacity;     // 环形缓冲区扩容上限
+    NSUInteger _growCount;                 // 扩容次数
+    NSUInteger _shrinkCount;               // 缩容次数
     
     // 安全相关
-    NSMutableSet *_recentSequences;  //防重放攻击
-    NSDate *_lastCleanupTime;  //定期清理计数器
+    TJPReplayWindow *_replayWindow;  //防重放滑动窗口
+    uint32_t _coarseNow;             //粗粒度时钟 每批数据刷新一次 用于时间戳校验
+    
+    // 解压 首个压缩包到达时创建 复用inflate流
+    TJPCompressionCodec *_compressionCodec;
     
     // 简单的错误统计
     NSUInteger _errorCount;
@@ -63,17 +100,23 @@
 }
 
 - (instancetype)initWithBufferStrategy:(TJPBufferStrategy)strategy capacity:(NSUInteger)capacity {
+    return [self initWithBufferStrategy:strategy capacity:capacity ringBufferMode:TJPRingBufferModeSerialQueue];
+}
+
+- (instancetype)initWithBufferStrategy:(TJPBufferStrategy)strategy capacity:(NSUInteger)capacity ringBufferMode:(TJPRingBufferMode)mode {
     if (self = [super init]) {
         _state = TJPParseStateHeader;
         _strategy = strategy;
+        _ringBufferMode = mode;
         _requestCapacity = capacity;
+        _ringBufferMaxCapacity = TJP_DEFAULT_RING_BUFFER_MAX_CAPACITY;
         _errorCount = 0;
         _totalOperations = 0;
         _switchCount = 0;
         
         // 安全相关初始化
-        _recentSequences = [NSMutableSet setWithCapacity:1000];
-        _lastCleanupTime = [NSDate date];
+        _replayWindow = [[TJPReplayWindow alloc] init];
+        _coarseNow = TJPHeaderCoarseNow();
         
         // 初始化缓冲区
         [self setupBuffersWithStrategy:strategy capacity:capacity];
@@ -90,6 +133,7 @@
 
 - (void)setupBuffersWithStrategy:(TJPBufferStrategy)strategy capacity:(NSUInteger)capacity {
     _traditionBuffer = [NSMutableData data];
+    _traditionReadOffset = 0;
     
     switch (strategy) {
         case TJPBufferStrategyTradition:
@@ -112,12 +156,14 @@
     // 检查容量合理性
     capacity = [self validateCapacity:capacity];
     
-    _ringBuffer = [[TJPRingBuffer alloc] initWithCapacity:capacity];
+    // 优先使用镜像内存 跨越尾部的包也是连续内存 映射失败时环形缓冲区内部会回退到普通内存
+    _ringBuffer = [[TJPRingBuffer alloc] initWithCapacity:capacity mode:_ringBufferMode backend:TJPRingBufferBackendMirrored];
     if (!_ringBuffer) {
         TJPLOG_ERROR(@"环形缓冲区初始化失败，容量: %luKB", (unsigned long)capacity / 1024);
         [self recordError:@"环形缓冲区初始化失败"];
         return NO;
     }
+    _ringBuffer.maxCapacity = _ringBufferMaxCapacity;
     
     return YES;
     
@@ -153,6 +199,8 @@
     }
     
     _totalOperations++;
+    // 每批数据刷新一次时钟 本批解析出的包共用
+    _coarseNow = TJPHeaderCoarseNow();
 
     // 防止缓冲区过大导致内存耗尽
     if (data.length > TJPMAX_BUFFER_SIZE ) {
@@ -170,9 +218,6 @@
         [self feedDataWithLegacyBuffer:data];
     }
     
-    //定期清理过期序列号
-    [self cleanupExpiredSequences];
-    
     _totalParseTime += (CFAbsoluteTimeGetCurrent() - startTime);
 
 }
@@ -214,10 +259,47 @@
     return result;
 }
 
+- (NSArray<TJPParsedPacket *> *)drainPacketsWithLimit:(NSUInteger)limit {
+    if (_state == TJPParseStateError) {
+        TJPLOG_ERROR(@"解析器处于错误状态，请先重置");
+        return @[];
+    }
+    
+    // 整批只采样一次时间
+    CFTimeInterval startTime = CFAbsoluteTimeGetCurrent();
+    _coarseNow = TJPHeaderCoarseNow();
+    NSUInteger maxCount = limit > 0 ? limit : NSUIntegerMax;
+    NSMutableArray<TJPParsedPacket *> *packets = [NSMutableArray array];
+    
+    if (_isUseRingBuffer) {
+        [self drainRingBufferPackets:packets limit:maxCount];
+    } else {
+        @synchronized (self) {
+            while (packets.count < maxCount && [self hasCompletePacketWithLegacyBuffer]) {
+                TJPParsedPacket *packet = [self nextPacketWithLegacyBuffer];
+                if (!packet) {
+                    break;
+                }
+                [packets addObject:packet];
+            }
+        }
+    }
+    
+    // 性能统计
+    if (packets.count > 0) {
+        _totalPacketCount += packets.count;
+        _totalParseTime += (CFAbsoluteTimeGetCurrent() - startTime);
+    }
+    
+    return packets;
+}
+
 - (void)reset {
     [_traditionBuffer setLength:0];
+    _traditionReadOffset = 0;
     [_ringBuffer reset];
     _currentHeader = (TJPFinalAdavancedHeader){0};
+    _currentHeaderDuplicate = NO;
     _state = TJPParseStateHeader;
     
     TJPLOG_INFO(@"MessageParser 重置完成");
@@ -226,13 +308,20 @@
 #pragma mark - Ring Buffer
 - (void)feedDataWithRingBuffer:(NSData *)data {
     @try {
-        // 检查剩余空间
+        // 检查剩余空间 不足时扩容 突发流量不再丢弃已缓存的数据
         if (_ringBuffer.availableSpace < data.length) {
-            TJPLOG_ERROR(@"环形缓冲区空间不足: 需要 %lu, 可用 %lu",
-                         (unsigned long)data.length, (unsigned long)_ringBuffer.availableSpace);
-            [self reset];
-            _state = TJPParseStateError;
-            return;
+            if ([_ringBuffer ensureAvailableSpace:data.length]) {
+                _growCount++;
+            } else {
+                // 已达扩容上限 迁移到传统缓冲区继续处理
+                TJPLOG_WARN(@"环形缓冲区达到扩容上限: 需要 %lu, 可用 %lu, 切换到传统缓冲区",
+                            (unsigned long)data.length, (unsigned long)_ringBuffer.availableSpace);
+                [self switchToTraditionBuffer];
+                [self feedDataWithLegacyBuffer:data];
+                return;
+            }
+        } else if ([_ringBuffer shrinkIfUnderusedForInterval:TJP_RING_BUFFER_SHRINK_IDLE_INTERVAL]) {
+            _shrinkCount++;
         }
         
         NSUInteger written = [_ringBuffer writeData:data];
@@ -319,22 +408,99 @@
         return nil;
     }
     
-    // 读取消息体数据
-    NSData *payload = [_ringBuffer readData:bodyLength];
-    if (!payload || payload.length != bodyLength) {
-        TJPLOG_ERROR(@"消息体数据读取失败: 期望 %u, 实际 %lu",
-                    bodyLength, (unsigned long)payload.length);
+    // 获取消息体的零拷贝视图 校验和直接在缓冲区内存上计算
+    TJPRingBufferReadView view;
+    if (![_ringBuffer getReadView:&view length:bodyLength]) {
+        TJPLOG_ERROR(@"消息体数据读取失败: 期望 %u, 可用 %lu",
+                    bodyLength, (unsigned long)_ringBuffer.usedSize);
         _state = TJPParseStateError;
         return nil;
     }
     
-    // 验证校验和
-    if (![self validateChecksum:_currentHeader.checksum forData:payload]) {
+    TJPParsedPacket *packet = [self packetWithBodyReadView:view];
+    [_ringBuffer skipBytes:bodyLength];
+    return packet;
+}
+
+- (void)drainRingBufferPackets:(NSMutableArray<TJPParsedPacket *> *)packets limit:(NSUInteger)limit {
+    // 一次性获取全部已缓存数据的视图 在视图上逐帧解析 最后统一提交读指针
+    // 整批只访问缓冲区两次(取视图和提交读指针) 避免每个包多次dispatch_sync
+    TJPRingBufferReadView view;
+    NSUInteger available = [_ringBuffer getReadViewOfAvailableData:&view];
+    if (available == 0) {
+        return;
+    }
+    
+    NSUInteger consumed = 0;
+    while (packets.count < limit && _state != TJPParseStateError) {
+        if (_state == TJPParseStateHeader) {
+            if (available - consumed < sizeof(TJPFinalAdavancedHeader)) {
+                break;
+            }
+            TJPFinalAdavancedHeader header = {0};
+            TJPReadViewCopyBytes(view, consumed, &header, sizeof(TJPFinalAdavancedHeader));
+            consumed += sizeof(TJPFinalAdavancedHeader);
+            
+            NSError *validationError = nil;
+            if (![self validateHeader:header error:&validationError]) {
+                TJPLOG_ERROR(@"头部验证失败: %@", validationError.localizedDescription);
+                _state = TJPParseStateError;
+                break;
+            }
+            _currentHeader = header;
+            _state = TJPParseStateBody;
+        }
+        
+        uint32_t bodyLength = ntohl(_currentHeader.bodyLength);
+        if (available - consumed < bodyLength) {
+            break;
+        }
+        TJPRingBufferReadView bodyView = TJPReadViewSubrange(view, consumed, bodyLength);
+        consumed += bodyLength;
+        
+        TJPParsedPacket *packet = [self packetWithBodyReadView:bodyView];
+        if (packet) {
+            [packets addObject:packet];
+        }
+    }
+    
+    if (consumed > 0) {
+        [_ringBuffer skipBytes:consumed];
+    }
+}
+
+/// 校验并构建消息体 view覆盖完整消息体 调用方负责提交读指针
+- (TJPParsedPacket *)packetWithBodyReadView:(TJPRingBufferReadView)view {
+    // 验证校验和 直接在缓冲区内存上计算
+    if (![self validateChecksum:_currentHeader.checksum forReadView:view]) {
         TJPLOG_ERROR(@"校验和验证失败，可能数据已被篡改");
         _state = TJPParseStateError;
         return nil;
     }
     
+    if (_currentHeaderDuplicate) {
+        return [self duplicatePacketWithCurrentHeader];
+    }
+    
+    // 校验通过后一次性拷贝为包持有的payload 非镜像内存且跨越尾部时在此合并两段
+    // 压缩包直接从缓冲区内存解压 省去压缩数据的拷贝
+    NSData *payload = nil;
+    if (_currentHeader.compress_type == TJPCompressTypeZlib) {
+        payload = [self.compressionCodec decompressBytes:view.firstSegment length:view.firstLength secondBytes:view.secondSegment length:view.secondLength error:NULL];
+        if (!payload) {
+            TJPLOG_ERROR(@"[环形Buffer] 序列号:%u 的内容解压失败", ntohl(_currentHeader.sequence));
+            _state = TJPParseStateError;
+            return nil;
+        }
+    } else if (view.secondLength == 0) {
+        payload = [NSData dataWithBytes:view.firstSegment length:view.firstLength];
+    } else {
+        NSMutableData *joined = [NSMutableData dataWithCapacity:view.firstLength + view.secondLength];
+        [joined appendBytes:view.firstSegment length:view.firstLength];
+        [joined appendBytes:view.secondSegment length:view.secondLength];
+        payload = joined;
+    }
+    
     // 创建解析结果
     NSError *error = nil;
     TJPParsedPacket *packet = [TJPParsedPacket packetWithHeader:_currentHeader
@@ -354,18 +520,32 @@
     return packet;
 }
 
+/// 重复包不解压、不拷贝载荷 只保留协议头供会话重新确认
+- (TJPParsedPacket *)duplicatePacketWithCurrentHeader {
+    TJPParsedPacket *packet = [TJPParsedPacket packetWithHeader:_currentHeader];
+    packet.isDuplicate = YES;
+    _currentHeaderDuplicate = NO;
+    _state = TJPParseStateHeader;
+    return packet;
+}
+
 #pragma mark Tradition Buffer
 - (void)feedDataWithLegacyBuffer:(NSData *)data {
     @synchronized (self) {
-        if ((_traditionBuffer.length + data.length) > TJPMAX_BUFFER_SIZE) {
+        NSUInteger unreadLength = [self traditionUnreadLength];
+        if ((unreadLength + data.length) > TJPMAX_BUFFER_SIZE) {
             TJPLOG_ERROR(@"传统缓冲区大小超过限制: 当前 %lu, 新增 %lu, 限制 %d",
-                         (unsigned long)_traditionBuffer.length, (unsigned long)data.length, TJPMAX_BUFFER_SIZE);
+                         (unsigned long)unreadLength, (unsigned long)data.length, TJPMAX_BUFFER_SIZE);
             [self reset];
             _state = TJPParseStateError;
             [self recordError:@"缓冲区超限"];
             return;
         }
         
+        // 已消费前缀加新数据会超过上限时先压缩
+        if (_traditionBuffer.length + data.length > TJPMAX_BUFFER_SIZE) {
+            [self compactTraditionBuffer];
+        }
         [_traditionBuffer appendData:data];
     }
     
@@ -374,10 +554,10 @@
 
 - (BOOL)hasCompletePacketWithLegacyBuffer {
     if (_state == TJPParseStateHeader) {
-        return _traditionBuffer.length >= sizeof(TJPFinalAdavancedHeader);
+        return [self traditionUnreadLength] >= sizeof(TJPFinalAdavancedHeader);
     } else if (_state == TJPParseStateBody) {
         uint32_t bodyLength = ntohl(_currentHeader.bodyLength);
-        return _traditionBuffer.length >= bodyLength;
+        return [self traditionUnreadLength] >= bodyLength;
     }
     return NO;
 }
@@ -399,14 +579,14 @@
 }
 
 - (BOOL)parseHeaderWithLegacyBuffer {
-    if (_traditionBuffer.length < sizeof(TJPFinalAdavancedHeader)) {
+    if ([self traditionUnreadLength] < sizeof(TJPFinalAdavancedHeader)) {
         TJPLOG_INFO(@"数据长度不够数据头解析");
         return NO;
     }
     TJPFinalAdavancedHeader currentHeader = {0};
 
     // 解析头部
-    [_traditionBuffer getBytes:&currentHeader length:sizeof(TJPFinalAdavancedHeader)];
+    [_traditionBuffer getBytes:&currentHeader range:NSMakeRange(_traditionReadOffset, sizeof(TJPFinalAdavancedHeader))];
     
     // 安全验证
     NSError *validationError = nil;
@@ -418,8 +598,8 @@
     
     TJPLOG_INFO(@"解析数据头部成功...魔数校验成功!");
     _currentHeader = currentHeader;
-    // 移除已处理的Header数据
-    [_traditionBuffer replaceBytesInRange:NSMakeRange(0, sizeof(TJPFinalAdavancedHeader)) withBytes:NULL length:0];
+    // 移动读游标跳过已处理的Header数据
+    _traditionReadOffset += sizeof(TJPFinalAdavancedHeader);
     
 //    TJPLOG_INFO(@"解析序列号:%u 的头部成功", ntohl(_currentHeader.sequence));
     _state = TJPParseStateBody;
@@ -429,13 +609,14 @@
 
 - (TJPParsedPacket *)parseBodyWithLegacyBuffer {
     uint32_t bodyLength = ntohl(_currentHeader.bodyLength);
-    if (_traditionBuffer.length < bodyLength) {
+    if ([self traditionUnreadLength] < bodyLength) {
         TJPLOG_INFO(@"数据长度不够内容解析,等待更多数据...");
         return nil;
     }
     
-    NSData *payload = [_traditionBuffer subdataWithRange:NSMakeRange(0, bodyLength)];
-    [_traditionBuffer replaceBytesInRange:NSMakeRange(0, bodyLength) withBytes:NULL length:0];
+    NSData *payload = [_traditionBuffer subdataWithRange:NSMakeRange(_traditionReadOffset, bodyLength)];
+    _traditionReadOffset += bodyLength;
+    [self compactTraditionBufferIfNeeded];
     
     // 验证CRC32校验和
     if (![self validateChecksum:_currentHeader.checksum forData:payload]) {
@@ -444,6 +625,20 @@
         return nil;
     }
     
+    if (_currentHeaderDuplicate) {
+        return [self duplicatePacketWithCurrentHeader];
+    }
+    
+    // 校验和覆盖压缩数据 校验通过后再解压
+    if (_currentHeader.compress_type == TJPCompressTypeZlib) {
+        payload = [self.compressionCodec decompressData:payload error:NULL];
+        if (!payload) {
+            TJPLOG_ERROR(@"解压序列号:%u 的内容失败", ntohl(_currentHeader.sequence));
+            _state = TJPParseStateError;
+            return nil;
+        }
+    }
+    
     NSError *error = nil;
     TJPParsedPacket *body = [TJPParsedPacket packetWithHeader:_currentHeader payload:payload policy:TJPTLVTagPolicyRejectDuplicates maxNestedDepth:4 error:&error];
     if (error) {
@@ -458,6 +653,34 @@
     return body;
 }
 
+- (NSUInteger)traditionUnreadLength {
+    return _traditionBuffer.length - _traditionReadOffset;
+}
+
+- (void)compactTraditionBufferIfNeeded {
+    if (_traditionReadOffset == 0) {
+        return;
+    }
+    // 全部消费完直接清空 O(1)
+    if (_traditionReadOffset == _traditionBuffer.length) {
+        [_traditionBuffer setLength:0];
+        _traditionReadOffset = 0;
+        return;
+    }
+    // 已消费前缀超过一半时才搬移 摊还后每字节只搬移常数次
+    if (_traditionReadOffset > _traditionBuffer.length / 2) {
+        [self compactTraditionBuffer];
+    }
+}
+
+- (void)compactTraditionBuffer {
+    if (_traditionReadOffset == 0) {
+        return;
+    }
+    [_traditionBuffer replaceBytesInRange:NSMakeRange(0, _traditionReadOffset) withBytes:NULL length:0];
+    _traditionReadOffset = 0;
+}
+
 - (BOOL)validateChecksum:(uint32_t)expectedChecksum forData:(NSData *)data {
     uint32_t calculatedChecksum = [TJPNetworkUtil crc32ForData:data];
     
@@ -469,159 +692,128 @@
     return YES;
 }
 
-
-#pragma mark - Private Method
-- (BOOL)validateHeader:(TJPFinalAdavancedHeader)header error:(NSError **)error {
-    //魔数校验
-    if (ntohl(header.magic) != kProtocolMagic) {
-        if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorProtocolMagicInvalid
-                                    description:@"无效的魔数"
-                                      userInfo:@{@"receivedMagic": @(ntohl(header.magic)),
-                                                @"expectedMagic": @(kProtocolMagic)}];
-        }
-        TJPLOG_ERROR(@"魔数校验失败: 0x%X != 0x%X", ntohl(header.magic), kProtocolMagic);
-        return NO;
-    }
-    
-    //版本校验
-    if (header.version_major != kProtocolVersionMajor || header.version_minor > kProtocolVersionMinor) {
-        if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorProtocolVersionMismatch
-                                    description:@"不支持的协议版本"
-                                      userInfo:@{@"receivedVersion": [NSString stringWithFormat:@"%d.%d",
-                                                                    header.version_major,
-                                                                    header.version_minor],
-                                                @"supportedVersion": [NSString stringWithFormat:@"%d.%d",
-                                                                    kProtocolVersionMajor,
-                                                                    kProtocolVersionMinor]}];
-        }
-        TJPLOG_ERROR(@"协议版本不支持: %d.%d (当前支持: %d.%d)",
-                   header.version_major, header.version_minor,
-                   kProtocolVersionMajor, kProtocolVersionMinor);
-        return NO;
-    }
+- (BOOL)validateChecksum:(uint32_t)expectedChecksum forReadView:(TJPRingBufferReadView)view {
+    uint32_t calculatedChecksum = [TJPNetworkUtil crc32UpdateWithCRC:0 bytes:view.firstSegment length:view.firstLength];
+    calculatedChecksum = [TJPNetworkUtil crc32UpdateWithCRC:calculatedChecksum bytes:view.secondSegment length:view.secondLength];
     
-    //消息体长度校验
-    uint32_t bodyLength = ntohl(header.bodyLength);
-    if (bodyLength > TJPMAX_BODY_SIZE) {
-        if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorMessageTooLarge
-                                    description:@"消息体长度超过限制"
-                                      userInfo:@{@"bodyLength": @(bodyLength),
-                                                @"maxSize": @(TJPMAX_BODY_SIZE)}];
-        }
-        TJPLOG_ERROR(@"消息体长度超过限制: %u > %d", bodyLength, TJPMAX_BODY_SIZE);
+    if (calculatedChecksum != expectedChecksum) {
+        TJPLOG_ERROR(@"校验和不匹配: 期望 %u, 计算得到 %u", expectedChecksum, calculatedChecksum);
         return NO;
     }
     
-    //时间戳校验
-    uint32_t currTime = (uint32_t)[[NSDate date] timeIntervalSince1970];
-    uint32_t timestamp = ntohl(header.timestamp); // 确保字节序转换
-    int32_t timeDiff = (int32_t)currTime - (int32_t)timestamp;
+    return YES;
+}
+
 
-    if (abs(timeDiff) > TJPMAX_TIME_WINDOW) {
+#pragma mark - Private Method
+- (BOOL)validateHeader:(TJPFinalAdavancedHeader)header error:(NSError **)error {
+    // 一次遍历完成结构校验 时间戳使用本批次缓存的粗粒度时钟
+    TJPDecodedHeader decoded;
+    TJPHeaderValidationResult result = TJPHeaderDecode(&header, _coarseNow, &decoded);
+    if (result != TJPHeaderValidationResultValid) {
         if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorProtocolTimestampInvalid
-                                    description:@"时间戳超出有效窗口"
-                                      userInfo:@{@"currentTime": @(currTime),
-                                                @"messageTime": @(timestamp),
-                                                @"difference": @(timeDiff)}];
+            *error = [self errorForHeader:header validationResult:result];
         }
-        TJPLOG_ERROR(@"时间戳超出有效窗口: 当前时间 %u, 消息时间 %u, 差值 %d秒",
-                   currTime, timestamp, timeDiff);
         return NO;
     }
     
     //根据消息类型决定是否进行重放攻击检测
-    uint16_t messageType = ntohs(header.msgType);
-    uint32_t sequence = ntohl(header.sequence);
+    uint16_t messageType = decoded.msgType;
+    uint32_t sequence = decoded.sequence;
+    uint32_t timestamp = decoded.timestamp;
+    _currentHeaderDuplicate = NO;
     // ACK包和心跳包不进行重放攻击检测
-    if (messageType == TJPMessageTypeACK) {
-        TJPLOG_DEBUG(@"[TJPMessageParser] ACK包跳过重放攻击检测，序列号: %u", sequence);
-    } else if (messageType == TJPMessageTypeHeartbeat) {
-        TJPLOG_DEBUG(@"[TJPMessageParser] 心跳包跳过重放攻击检测，序列号: %u", sequence);
-    } else {
-        //序列号防重放检查
-        NSString *uniqueID = [NSString stringWithFormat:@"%u-%u", sequence, timestamp];
-        
-        @synchronized (_recentSequences) {
-            if ([_recentSequences containsObject:uniqueID]) {
-                if (error) {
-                    *error = [TJPErrorUtil errorWithCode:TJPErrorSecurityReplayAttackDetected
-                                             description:@"检测到重放攻击"
-                                                userInfo:@{@"sequence": @(sequence),
-                                                           @"timestamp": @(timestamp)}];
-                }
-                TJPLOG_ERROR(@"检测到重放攻击: 序列号 %u, 时间戳 %u", sequence, timestamp);
-                return NO;
-            }
-            [_recentSequences addObject:uniqueID];
-        }
+    if (messageType == TJPMessageTypeACK || messageType == TJPMessageTypeHeartbeat) {
+        return YES;
     }
     
-    
-    //校验加密类型和压缩类型
-    if (![self isSupportedEncryptType:header.encrypt_type]) {
-        if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorProtocolUnsupportedEncryption
-                                    description:@"不支持的加密类型"
-                                      userInfo:@{@"encryptType": @(header.encrypt_type)}];
-        }
-        TJPLOG_ERROR(@"不支持的加密类型: %d", header.encrypt_type);
-        return NO;
+    //序列号防重放检查 按类别滑动窗口
+    TJPReplayCheckResult replayResult = [_replayWindow checkAndRecordSequence:sequence timestamp:timestamp now:_coarseNow];
+    if (replayResult == TJPReplayCheckResultDuplicate) {
+        // 窗口内重复多为对端未收到ACK后的重传 继续解析 交由会话重新确认
+        TJPLOG_WARN(@"收到重复序列号 %u, 丢弃载荷并重新确认", sequence);
+        _currentHeaderDuplicate = YES;
+        return YES;
     }
-    
-    if (![self isSupportedCompressType:header.compress_type]) {
+    if (replayResult == TJPReplayCheckResultRejected) {
         if (error) {
-            *error = [TJPErrorUtil errorWithCode:TJPErrorProtocolUnsupportedCompression
-                                    description:@"不支持的压缩类型"
-                                      userInfo:@{@"compressType": @(header.compress_type)}];
+            *error = [TJPErrorUtil errorWithCode:TJPErrorSecurityReplayAttackDetected
+                                     description:@"检测到重放攻击"
+                                        userInfo:@{@"sequence": @(sequence),
+                                                   @"timestamp": @(timestamp)}];
         }
-        TJPLOG_ERROR(@"不支持的压缩类型: %d", header.compress_type);
+        TJPLOG_ERROR(@"检测到重放攻击: 序列号 %u, 时间戳 %u", sequence, timestamp);
         return NO;
     }
     
     return YES;
 }
 
-- (BOOL)isSupportedEncryptType:(TJPEncryptType)type {
-    // 根据实际支持的加密类型进行验证
-    switch (type) {
-        case TJPEncryptTypeNone:
-        case TJPEncryptTypeCRC32:
-        case TJPEncryptTypeAES256:
-            return YES;
-        default:
-            return NO;
-    }
-}
-
-- (BOOL)isSupportedCompressType:(TJPCompressType)type {
-    // 根据实际支持的压缩类型进行验证
-    switch (type) {
-        case TJPCompressTypeNone:
-        case TJPCompressTypeZlib:
-//        case TJPCompressTypeLZ4:
-            return YES;
+/// 校验失败的慢路径 构造与原有实现一致的错误信息
+- (NSError *)errorForHeader:(TJPFinalAdavancedHeader)header validationResult:(TJPHeaderValidationResult)result {
+    switch (result) {
+        case TJPHeaderValidationResultMagicInvalid:
+            TJPLOG_ERROR(@"魔数校验失败: 0x%X != 0x%X", ntohl(header.magic), kProtocolMagic);
+            return [TJPErrorUtil errorWithCode:TJPErrorProtocolMagicInvalid
+                                   description:@"无效的魔数"
+                                      userInfo:@{@"receivedMagic": @(ntohl(header.magic)),
+                                                 @"expectedMagic": @(kProtocolMagic)}];
+            
+        case TJPHeaderValidationResultVersionMismatch:
+            TJPLOG_ERROR(@"协议版本不支持: %d.%d (当前支持: %d.%d)",
+                         header.version_major, header.version_minor,
+                         kProtocolVersionMajor, kProtocolVersionMinor);
+            return [TJPErrorUtil errorWithCode:TJPErrorProtocolVersionMismatch
+                                   description:@"不支持的协议版本"
+                                      userInfo:@{@"receivedVersion": [NSString stringWithFormat:@"%d.%d",
+                                                                      header.version_major,
+                                                                      header.version_minor],
+                                                 @"supportedVersion": [NSString stringWithFormat:@"%d.%d",
+                                                                       kProtocolVersionMajor,
+                                                                       kProtocolVersionMinor]}];
+            
+        case TJPHeaderValidationResultBodyTooLarge:
+            TJPLOG_ERROR(@"消息体长度超过限制: %u > %d", ntohl(header.bodyLength), TJPMAX_BODY_SIZE);
+            return [TJPErrorUtil errorWithCode:TJPErrorMessageTooLarge
+                                   description:@"消息体长度超过限制"
+                                      userInfo:@{@"bodyLength": @(ntohl(header.bodyLength)),
+                                                 @"maxSize": @(TJPMAX_BODY_SIZE)}];
+            
+        case TJPHeaderValidationResultTimestampInvalid: {
+            uint32_t timestamp = ntohl(header.timestamp);
+            int32_t timeDiff = (int32_t)_coarseNow - (int32_t)timestamp;
+            TJPLOG_ERROR(@"时间戳超出有效窗口: 当前时间 %u, 消息时间 %u, 差值 %d秒",
+                         _coarseNow, timestamp, timeDiff);
+            return [TJPErrorUtil errorWithCode:TJPErrorProtocolTimestampInvalid
+                                   description:@"时间戳超出有效窗口"
+                                      userInfo:@{@"currentTime": @(_coarseNow),
+                                                 @"messageTime": @(timestamp),
+                                                 @"difference": @(timeDiff)}];
+        }
+            
+        case TJPHeaderValidationResultUnsupportedEncryption:
+            TJPLOG_ERROR(@"不支持的加密类型: %d", header.encrypt_type);
+            return [TJPErrorUtil errorWithCode:TJPErrorProtocolUnsupportedEncryption
+                                   description:@"不支持的加密类型"
+                                      userInfo:@{@"encryptType": @(header.encrypt_type)}];
+            
+        case TJPHeaderValidationResultUnsupportedCompression:
+            TJPLOG_ERROR(@"不支持的压缩类型: %d", header.compress_type);
+            return [TJPErrorUtil errorWithCode:TJPErrorProtocolUnsupportedCompression
+                                   description:@"不支持的压缩类型"
+                                      userInfo:@{@"compressType": @(header.compress_type)}];
+            
+        case TJPHeaderValidationResultValid:
         default:
-            return NO;
+            return nil;
     }
 }
 
-- (void)cleanupExpiredSequences {
-    NSDate *now = [NSDate date];
-    NSTimeInterval elapsed = [now timeIntervalSinceDate:_lastCleanupTime];
-    
-    // 每分钟清理一次
-    if (elapsed > 60) {
-        @synchronized (_recentSequences) {
-            // 过期的序列号集合会随着时间增加而增长，定期清理
-            TJPLOG_INFO(@"清理过期序列号缓存，当前数量: %lu", (unsigned long)_recentSequences.count);
-            [_recentSequences removeAllObjects];
-            _lastCleanupTime = now;
-        }
+- (TJPCompressionCodec *)compressionCodec {
+    if (!_compressionCodec) {
+        _compressionCodec = [[TJPCompressionCodec alloc] init];
     }
+    return _compressionCodec;
 }
 
 
@@ -655,7 +847,7 @@
         }
     }
     
-    // 边界检查
+    // 初始容量边界检查 运行中可按需扩容至ringBufferMaxCapacity
     NSUInteger minCapacity = 16 * 1024;  //最小16KB
     NSUInteger maxCapacity = 1024 * 1024; //最大1MB
     
@@ -720,7 +912,7 @@
     
     // 创建新的环形缓冲区
     capacity = [self validateCapacity:capacity];
-    TJPRingBuffer *newRingBuffer = [[TJPRingBuffer alloc] initWithCapacity:capacity];
+    TJPRingBuffer *newRingBuffer = [[TJPRingBuffer alloc] initWithCapacity:capacity mode:_ringBufferMode backend:TJPRingBufferBackendMirrored];
     
     if (!newRingBuffer) {
         TJPLOG_ERROR(@"环形缓冲区创建失败");
@@ -728,12 +920,18 @@
         return NO;
     }
     
-    // 数据迁移
-    if (_traditionBuffer.length > 0) {
-        NSUInteger written = [newRingBuffer writeData:_traditionBuffer];
-        if (written != _traditionBuffer.length) {
+    newRingBuffer.maxCapacity = _ringBufferMaxCapacity;
+    
+    // 数据迁移 只迁移未读部分
+    NSUInteger unreadLength = [self traditionUnreadLength];
+    if (unreadLength > 0) {
+        if ([newRingBuffer ensureAvailableSpace:unreadLength] && newRingBuffer.capacity > capacity) {
+            _growCount++;
+        }
+        NSUInteger written = [newRingBuffer writeBytes:(const char *)_traditionBuffer.bytes + _traditionReadOffset length:unreadLength];
+        if (written != unreadLength) {
             TJPLOG_WARN(@"数据迁移不完整: %lu/%lu",
-                       (unsigned long)written, (unsigned long)_traditionBuffer.length);
+                       (unsigned long)written, (unsigned long)unreadLength);
         }
         TJPLOG_INFO(@"成功迁移 %lu 字节数据到环形缓冲区", (unsigned long)written);
     }
@@ -741,6 +939,7 @@
     // 切换实现
     _ringBuffer = newRingBuffer;
     [_traditionBuffer setLength:0];
+    _traditionReadOffset = 0;
     _isUseRingBuffer = YES;
     _switchCount++;
     
@@ -852,7 +1051,7 @@
     if (_isUseRingBuffer) {
         return _ringBuffer.usedSize;
     } else {
-        return _traditionBuffer.length;
+        return [self traditionUnreadLength];
     }
 }
 
@@ -860,7 +1059,7 @@
     if (_isUseRingBuffer) {
         return _ringBuffer.usageRatio;
     } else {
-        return (CGFloat)_traditionBuffer.length / TJPMAX_BUFFER_SIZE;
+        return (CGFloat)[self traditionUnreadLength] / TJPMAX_BUFFER_SIZE;
     }
 }
 
@@ -868,6 +1067,27 @@
     return _strategy;
 }
 
+- (TJPRingBufferMode)ringBufferMode {
+    return _ringBufferMode;
+}
+
+- (NSUInteger)ringBufferMaxCapacity {
+    return _ringBufferMaxCapacity;
+}
+
+- (void)setRingBufferMaxCapacity:(NSUInteger)ringBufferMaxCapacity {
+    _ringBufferMaxCapacity = MIN(ringBufferMaxCapacity, (NSUInteger)TJPMAX_BUFFER_SIZE);
+    _ringBuffer.maxCapacity = _ringBufferMaxCapacity;
+}
+
+- (NSUInteger)ringBufferGrowCount {
+    return _growCount;
+}
+
+- (NSUInteger)ringBufferShrinkCount {
+    return _shrinkCount;
+}
+
 - (TJPParseState)currentState {
     return _state;
 }
@@ -889,6 +1109,8 @@
         }
         return [NSMutableData data];
     } else {
+        // 对外暴露前压缩 保证buffer只包含未读数据
+        [self compactTraditionBuffer];
         return _traditionBuffer;
     }
 }
@@ -912,12 +1134,15 @@
                (unsigned long)_errorCount, (unsigned long)_totalOperations,
                _totalOperations > 0 ? (CGFloat)_errorCount / _totalOperations * 100 : 0);
     TJPLOG_INFO(@"切换次数: %lu", (unsigned long)_switchCount);
+    TJPLOG_INFO(@"扩容/缩容次数: %lu/%lu", (unsigned long)_growCount, (unsigned long)_shrinkCount);
 }
 
 - (NSDictionary *)bufferStatistics {
     return @{
         @"strategy": [self strategyDescription:_strategy],
         @"implementation": _isUseRingBuffer ? @"ring_buffer" : @"legacy",
+        @"ringBufferMode": _ringBufferMode == TJPRingBufferModeLockFreeSPSC ? @"spsc" : @"serial_queue",
+        @"mirrored": @(_ringBuffer.isMirrored),
         @"capacity": @(self.bufferCapacity),
         @"usedSize": @(self.usedBufferSize),
         @"usageRatio": @(self.bufferUsageRatio),
@@ -925,7 +1150,9 @@
         @"errorCount": @(_errorCount),
         @"totalOperations": @(_totalOperations),
         @"errorRate": @(_totalOperations > 0 ? (CGFloat)_errorCount / _totalOperations : 0),
-        @"switchCount": @(_switchCount)
+        @"switchCount": @(_switchCount),
+        @"growCount": @(_growCount),
+        @"shrinkCount": @(_shrinkCount)
     };
 }
 
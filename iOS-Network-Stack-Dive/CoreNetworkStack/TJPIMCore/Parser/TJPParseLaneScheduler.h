@@ -0,0 +1,71 @@
+//
+//  TJPParseLaneScheduler.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/17.
+//  按会话划分的数据解析通道
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 解析通道
+ *
+ * 每个会话独占一个串行通道 同一会话的数据按提交顺序逐个解析
+ * 解析器非线程安全 只能在所属通道内访问
+ * 提交和统计接口线程安全
+ */
+@interface TJPParseLane : NSObject
+
+/// 通道标识 一般为sessionId
+@property (nonatomic, copy, readonly) NSString *label;
+/// 所在工作队列下标
+@property (nonatomic, assign, readonly) NSUInteger workerIndex;
+/// 已提交未执行完的任务数
+@property (nonatomic, assign, readonly) NSUInteger queueDepth;
+/// 历史最大队列深度
+@property (nonatomic, assign, readonly) NSUInteger maxQueueDepth;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// 提交解析任务 按提交顺序串行执行
+- (void)dispatchAsync:(dispatch_block_t)block;
+
+/// 通道统计 队列深度、提交数、完成数和排队时延
+- (NSDictionary *)statistics;
+
+@end
+
+
+/**
+ * 解析通道调度器
+ *
+ * 设计说明：
+ * - 原实现所有会话共用一个并发队列 同一会话的两次读取可能并发调用同一个解析器 且包序可能错乱
+ * - 每个会话一个串行通道 通道以固定数量的串行工作队列为目标队列 工作队列数默认等于CPU核数
+ * - 同一会话有序 不同会话之间最多按工作队列数并行 会话再多也不会创建更多线程
+ * - 新通道分配到当前通道数最少的工作队列
+ * - 调度器只弱引用通道 会话释放后通道随之释放
+ */
+@interface TJPParseLaneScheduler : NSObject
+
+/// 工作队列数
+@property (nonatomic, assign, readonly) NSUInteger workerCount;
+
+/// 初始化方法
+/// - Parameter workerCount: 工作队列数 传0使用CPU核数
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount;
+
+/// 创建解析通道
+- (TJPParseLane *)laneWithLabel:(NSString *)label;
+
+/// 当前存活的通道
+- (NSArray<TJPParseLane *> *)activeLanes;
+
+/// 调度统计 各工作队列的通道数和各通道统计
+- (NSDictionary *)statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
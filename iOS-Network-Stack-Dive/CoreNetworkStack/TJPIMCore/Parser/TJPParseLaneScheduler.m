@@ -0,0 +1,182 @@
+//
+//  TJPParseLaneScheduler.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/17.
+//
+
+#import "TJPParseLaneScheduler.h"
+#import <os/lock.h>
+#import <stdatomic.h>
+#import <time.h>
+#import "TJPNetworkDefine.h"
+
+@interface TJPParseLane ()
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+- (instancetype)initWithLabel:(NSString *)label workerIndex:(NSUInteger)workerIndex targetQueue:(dispatch_queue_t)targetQueue;
+
+@end
+
+@implementation TJPParseLane {
+    _Atomic(uint64_t) _submittedCount;
+    _Atomic(uint64_t) _completedCount;
+    _Atomic(uint64_t) _maxQueueDepth;
+    _Atomic(uint64_t) _totalWaitNanoseconds;
+    _Atomic(uint64_t) _maxWaitNanoseconds;
+}
+
+- (instancetype)initWithLabel:(NSString *)label workerIndex:(NSUInteger)workerIndex targetQueue:(dispatch_queue_t)targetQueue {
+    if (self = [super init]) {
+        _label = [label copy];
+        _workerIndex = workerIndex;
+        NSString *queueLabel = [NSString stringWithFormat:@"com.parseLane.tjp.%@", label];
+        _queue = dispatch_queue_create_with_target(queueLabel.UTF8String, DISPATCH_QUEUE_SERIAL, targetQueue);
+    }
+    return self;
+}
+
+- (void)dispatchAsync:(dispatch_block_t)block {
+    uint64_t submitted = atomic_fetch_add_explicit(&_submittedCount, 1, memory_order_relaxed) + 1;
+    uint64_t depth = submitted - atomic_load_explicit(&_completedCount, memory_order_relaxed);
+    [self updateMaximum:&_maxQueueDepth value:depth];
+    if (depth == TJP_PARSE_LANE_DEPTH_WARNING) {
+        TJPLOG_WARN(@"[TJPParseLane] 通道 %@ 积压 %llu 个解析任务，解析速度跟不上接收速度", self.label, depth);
+    }
+
+    uint64_t submitTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    dispatch_async(self.queue, ^{
+        uint64_t wait = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - submitTime;
+        atomic_fetch_add_explicit(&self->_totalWaitNanoseconds, wait, memory_order_relaxed);
+        [self updateMaximum:&self->_maxWaitNanoseconds value:wait];
+
+        block();
+
+        atomic_fetch_add_explicit(&self->_completedCount, 1, memory_order_relaxed);
+    });
+}
+
+- (NSUInteger)queueDepth {
+    uint64_t completed = atomic_load_explicit(&_completedCount, memory_order_relaxed);
+    uint64_t submitted = atomic_load_explicit(&_submittedCount, memory_order_relaxed);
+    return submitted > completed ? (NSUInteger)(submitted - completed) : 0;
+}
+
+- (NSUInteger)maxQueueDepth {
+    return (NSUInteger)atomic_load_explicit(&_maxQueueDepth, memory_order_relaxed);
+}
+
+- (NSDictionary *)statistics {
+    uint64_t completed = atomic_load_explicit(&_completedCount, memory_order_relaxed);
+    uint64_t totalWait = atomic_load_explicit(&_totalWaitNanoseconds, memory_order_relaxed);
+    return @{
+        @"label": self.label,
+        @"worker": @(self.workerIndex),
+        @"queueDepth": @(self.queueDepth),
+        @"maxQueueDepth": @(self.maxQueueDepth),
+        @"submitted": @(atomic_load_explicit(&_submittedCount, memory_order_relaxed)),
+        @"completed": @(completed),
+        @"averageWaitMs": @(completed > 0 ? totalWait / (double)completed / NSEC_PER_MSEC : 0),
+        @"maxWaitMs": @(atomic_load_explicit(&_maxWaitNanoseconds, memory_order_relaxed) / (double)NSEC_PER_MSEC)
+    };
+}
+
+- (void)updateMaximum:(_Atomic(uint64_t) *)maximum value:(uint64_t)value {
+    uint64_t current = atomic_load_explicit(maximum, memory_order_relaxed);
+    while (value > current && !atomic_compare_exchange_weak_explicit(maximum, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+@end
+
+
+@interface TJPParseLaneScheduler ()
+
+/// 串行工作队列 数量固定
+@property (nonatomic, copy) NSArray<dispatch_queue_t> *workers;
+/// 存活的通道 弱引用
+@property (nonatomic, strong) NSHashTable<TJPParseLane *> *lanes;
+
+@end
+
+@implementation TJPParseLaneScheduler {
+    os_unfair_lock _lock;
+}
+
+- (instancetype)init {
+    return [self initWithWorkerCount:0];
+}
+
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _workerCount = workerCount > 0 ? workerCount : MAX([NSProcessInfo processInfo].activeProcessorCount, (NSUInteger)1);
+        _lanes = [NSHashTable weakObjectsHashTable];
+
+        // 工作队列串行 并行度即工作队列数
+        dispatch_queue_t globalQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+        NSMutableArray<dispatch_queue_t> *workers = [NSMutableArray arrayWithCapacity:_workerCount];
+        for (NSUInteger i = 0; i < _workerCount; i++) {
+            NSString *label = [NSString stringWithFormat:@"com.parseLaneScheduler.tjp.worker.%lu", (unsigned long)i];
+            [workers addObject:dispatch_queue_create_with_target(label.UTF8String, DISPATCH_QUEUE_SERIAL, globalQueue)];
+        }
+        _workers = [workers copy];
+    }
+    return self;
+}
+
+- (TJPParseLane *)laneWithLabel:(NSString *)label {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger workerIndex = [self leastLoadedWorkerIndex];
+    TJPParseLane *lane = [[TJPParseLane alloc] initWithLabel:label workerIndex:workerIndex targetQueue:self.workers[workerIndex]];
+    [self.lanes addObject:lane];
+    os_unfair_lock_unlock(&_lock);
+
+    TJPLOG_DEBUG(@"[TJPParseLaneScheduler] 创建解析通道 %@，工作队列: %lu", label, (unsigned long)workerIndex);
+    return lane;
+}
+
+- (NSArray<TJPParseLane *> *)activeLanes {
+    os_unfair_lock_lock(&_lock);
+    NSArray<TJPParseLane *> *lanes = self.lanes.allObjects;
+    os_unfair_lock_unlock(&_lock);
+    return lanes;
+}
+
+- (NSDictionary *)statistics {
+    NSArray<TJPParseLane *> *lanes = [self activeLanes];
+    NSMutableArray<NSNumber *> *workerLanes = [NSMutableArray arrayWithCapacity:self.workerCount];
+    for (NSUInteger i = 0; i < self.workerCount; i++) {
+        [workerLanes addObject:@0];
+    }
+    NSMutableArray<NSDictionary *> *laneStatistics = [NSMutableArray arrayWithCapacity:lanes.count];
+    for (TJPParseLane *lane in lanes) {
+        workerLanes[lane.workerIndex] = @(workerLanes[lane.workerIndex].unsignedIntegerValue + 1);
+        [laneStatistics addObject:[lane statistics]];
+    }
+    return @{
+        @"workerCount": @(self.workerCount),
+        @"workerLanes": workerLanes,
+        @"lanes": laneStatistics
+    };
+}
+
+#pragma mark - Private Method
+/// 通道数最少的工作队列 需持有锁
+- (NSUInteger)leastLoadedWorkerIndex {
+    NSUInteger counts[self.workerCount];
+    memset(counts, 0, sizeof(counts));
+    for (TJPParseLane *lane in self.lanes) {
+        counts[lane.workerIndex]++;
+    }
+    NSUInteger index = 0;
+    for (NSUInteger i = 1; i < self.workerCount; i++) {
+        if (counts[i] < counts[index]) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+@end
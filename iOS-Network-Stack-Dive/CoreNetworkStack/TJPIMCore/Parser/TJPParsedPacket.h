@@ -9,6 +9,7 @@
 #import "TJPCoreTypes.h"
 
 NS_ASSUME_NONNULL_BEGIN
+@class TJPTLVContainer;
 
 
 @interface TJPParsedPacket : NSObject
@@ -20,16 +21,28 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) TJPFinalAdavancedHeader header;
 /// 消息内容
 @property (nonatomic, strong) NSData *payload;
-/// TLV解析后的字段（Tag -> Value）
-@property (nonatomic, strong) NSDictionary<NSNumber *, id> *tlvEntries; // 支持嵌套存储
+/// TLV解析后的字段（Tag -> Value） 首次访问时由tlvContainer生成 只读取个别字段请使用tlvValueForTag:
+@property (nonatomic, strong, nullable) NSDictionary<NSNumber *, id> *tlvEntries; // 支持嵌套存储
+/// TLV容器 延迟解析
+@property (nonatomic, strong, readonly, nullable) TJPTLVContainer *tlvContainer;
 /// TLV策略
 @property (nonatomic, assign) TJPTLVTagPolicy tagPolicy;
+/// 防重放窗口内已收到过的重传包 不携带载荷 只需重新确认
+@property (nonatomic, assign) BOOL isDuplicate;
 
 
 + (instancetype)packetWithHeader:(TJPFinalAdavancedHeader)header;
 
+/// TLV不在此处解析 首次访问tlvEntries/tlvValueForTag:时才建立索引
+/// 需要提前发现格式错误(截断、重复Tag、嵌套过深)时调用validateTLVWithError:
 + (instancetype)packetWithHeader:(TJPFinalAdavancedHeader)header payload:(NSData *)payload policy:(TJPTLVTagPolicy)policy maxNestedDepth:(NSUInteger)maxDepth error:(NSError **)error;
 
+/// 获取指定Tag的值 不拷贝payload
+- (nullable NSData *)tlvValueForTag:(uint16_t)tag;
+
+/// 完整校验TLV 包括所有嵌套层级
+- (BOOL)validateTLVWithError:(NSError **)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
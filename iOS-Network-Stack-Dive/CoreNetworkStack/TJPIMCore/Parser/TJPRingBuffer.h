@@ -6,14 +6,33 @@
 //  环形缓冲区
 
 #import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// 零拷贝读取视图 数据跨越缓冲区尾部时由两段连续内存组成 否则第二段为空
+/// 视图仅在对应数据被 skipBytes/readBytes/reset 消费之前有效
+typedef struct {
+    const void * _Nullable firstSegment;
+    NSUInteger firstLength;
+    const void * _Nullable secondSegment;
+    NSUInteger secondLength;
+} TJPRingBufferReadView;
+
 @interface TJPRingBuffer : NSObject
 
 /// 缓冲区总容量大小  单位字节
 @property (nonatomic, readonly) NSUInteger capacity;
 
+/// 并发访问模式
+@property (nonatomic, readonly) TJPRingBufferMode mode;
+
+/// 是否使用了镜像映射内存 镜像时读取视图始终只有一段
+@property (nonatomic, readonly, getter=isMirrored) BOOL mirrored;
+
+/// 扩容上限 默认等于初始容量(不扩容) 不超过TJPMAX_BUFFER_SIZE
+@property (nonatomic, assign) NSUInteger maxCapacity;
+
 /// 当前缓冲区已使用大小
 @property (nonatomic, readonly) NSUInteger usedSize;
 
@@ -31,6 +50,22 @@ NS_ASSUME_NONNULL_BEGIN
 /// - Parameter capacity: 缓冲区容量
 - (instancetype)initWithCapacity:(NSUInteger)capacity;
 
+/// 指定并发模式初始化
+/// TJPRingBufferModeLockFreeSPSC 模式下容量会向上取整为2的幂 取整后超出TJPMAX_BUFFER_SIZE时返回nil
+/// 且只允许一个线程写入(write)、一个线程读取(read/peek/skip/reset)
+/// - Parameters:
+///   - capacity: 缓冲区容量
+///   - mode: 并发访问模式
+- (instancetype)initWithCapacity:(NSUInteger)capacity mode:(TJPRingBufferMode)mode;
+
+/// 指定并发模式和内存后端初始化
+/// TJPRingBufferBackendMirrored 会将容量向上取整到页大小 并把同一块物理内存连续映射两次
+/// - Parameters:
+///   - capacity: 缓冲区容量
+///   - mode: 并发访问模式
+///   - backend: 内存后端
+- (instancetype)initWithCapacity:(NSUInteger)capacity mode:(TJPRingBufferMode)mode backend:(TJPRingBufferBackend)backend;
+
 
 /// 向缓冲区写入数据
 /// - Parameter data: 要写入的数据
@@ -70,6 +105,32 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 
+/// 获取指定长度数据的零拷贝读取视图(不移动读指针) 使用完毕后通过skipBytes提交
+/// - Parameters:
+///   - view: 输出的读取视图
+///   - length: 视图覆盖的字节数
+/// - Returns: 可读数据不足length时返回NO
+- (BOOL)getReadView:(TJPRingBufferReadView *)view length:(NSUInteger)length;
+
+/// 获取全部可读数据的零拷贝读取视图(不移动读指针) 一次访问同时取得可读长度 使用完毕后通过skipBytes提交
+/// - Parameter view: 输出的读取视图
+/// - Returns: 视图覆盖的字节数 没有数据时返回0
+- (NSUInteger)getReadViewOfAvailableData:(TJPRingBufferReadView *)view;
+
+
+/// 确保可写入length字节 空间不足时按2倍扩容(不超过maxCapacity) 已有数据迁移时一次性线性化
+/// 扩容后之前获取的读取视图全部失效  SPSC模式不支持扩容
+/// - Parameter length: 需要写入的字节数
+/// - Returns: 空间足够或扩容成功返回YES
+- (BOOL)ensureAvailableSpace:(NSUInteger)length;
+
+
+/// 持续低使用率超过interval后将容量减半 不低于初始容量  SPSC模式不支持缩容
+/// - Parameter interval: 低使用率需持续的时长 单位秒
+/// - Returns: 本次是否发生缩容
+- (BOOL)shrinkIfUnderusedForInterval:(NSTimeInterval)interval;
+
+
 /// 跳过指定长度数据 仅仅移动读指针
 /// - Parameter length: 要跳过的长度
 - (NSUInteger)skipBytes:(NSUInteger)length;
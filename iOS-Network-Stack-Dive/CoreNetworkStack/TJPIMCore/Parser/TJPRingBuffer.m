@@ -6,22 +6,95 @@
 //
 
 #import "TJPRingBuffer.h"
+#import <stdatomic.h>
+#import <mach/mach.h>
 #import "TJPNetworkDefine.h"
 
 @interface TJPRingBuffer () {
     char *_buffer;
     NSUInteger _capacity;
+    TJPRingBufferMode _mode;
+    BOOL _mirrored;                        // 后半段虚拟地址映射到前半段同一物理页
+    TJPRingBufferBackend _backend;
+    
+    // 动态扩缩容
+    NSUInteger _initialCapacity;           // 缩容下限
+    NSUInteger _maxCapacity;               // 扩容上限
+    CFAbsoluteTime _lowUsageSince;         // 进入低使用率的时间 0表示当前非低使用率
+    
+    // 串行队列模式
     NSUInteger _readIndex;
     NSUInteger _writeIndex;
     NSUInteger _usedSize;
     dispatch_queue_t _accessQueue;
+    
+    // SPSC模式 单调递增的读写位置 实际下标 = 位置 & _mask
+    NSUInteger _mask;
+    _Atomic(uint64_t) _writePosition;      // 仅生产者修改
+    _Atomic(uint64_t) _readPosition;       // 仅消费者修改
 }
 
 @end
 
+static inline NSUInteger TJPRoundUpToPowerOfTwo(NSUInteger value) {
+    NSUInteger result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/// 分配镜像环形内存: [address, address + capacity) 与 [address + capacity, address + 2 * capacity) 映射同一物理页
+/// capacity 必须是页大小的整数倍 失败返回NULL
+static char *TJPAllocateMirroredBuffer(NSUInteger capacity) {
+    // 两次映射之间存在竞态窗口(其他线程可能占用后半段地址) 重试几次
+    for (int attempt = 0; attempt < 3; attempt++) {
+        vm_address_t address = 0;
+        kern_return_t result = vm_allocate(mach_task_self(), &address, capacity * 2, VM_FLAGS_ANYWHERE);
+        if (result != KERN_SUCCESS) {
+            continue;
+        }
+        
+        // 释放后半段 再将前半段重映射到该位置
+        result = vm_deallocate(mach_task_self(), address + capacity, capacity);
+        if (result != KERN_SUCCESS) {
+            vm_deallocate(mach_task_self(), address, capacity * 2);
+            continue;
+        }
+        
+        vm_address_t mirrorAddress = address + capacity;
+        vm_prot_t currentProtection;
+        vm_prot_t maxProtection;
+        result = vm_remap(mach_task_self(), &mirrorAddress, capacity, 0, VM_FLAGS_FIXED,
+                          mach_task_self(), address, FALSE,
+                          &currentProtection, &maxProtection, VM_INHERIT_DEFAULT);
+        if (result != KERN_SUCCESS) {
+            vm_deallocate(mach_task_self(), address, capacity);
+            continue;
+        }
+        
+        if (mirrorAddress != address + capacity) {
+            vm_deallocate(mach_task_self(), mirrorAddress, capacity);
+            vm_deallocate(mach_task_self(), address, capacity);
+            continue;
+        }
+        
+        return (char *)address;
+    }
+    return NULL;
+}
+
 @implementation TJPRingBuffer
 #pragma mark - Lifecycle
 - (instancetype)initWithCapacity:(NSUInteger)capacity {
+    return [self initWithCapacity:capacity mode:TJPRingBufferModeSerialQueue];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity mode:(TJPRingBufferMode)mode {
+    return [self initWithCapacity:capacity mode:mode backend:TJPRingBufferBackendMalloc];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity mode:(TJPRingBufferMode)mode backend:(TJPRingBufferBackend)backend {
     if (self = [super init]) {
         // 边界判断
         if (capacity == 0  || capacity > TJPMAX_BUFFER_SIZE) {
@@ -29,21 +102,48 @@
             return nil;
         }
         
-        _capacity = capacity;
+        if (mode == TJPRingBufferModeLockFreeSPSC) {
+            // 2的幂容量 取模运算变为掩码运算
+            // 向上取整后超出上限时拒绝 不能返回比请求更小的缓冲区
+            NSUInteger rounded = TJPRoundUpToPowerOfTwo(capacity);
+            if (rounded > TJPMAX_BUFFER_SIZE) {
+                TJPLOG_ERROR(@"SPSC模式容量 %lu 向上取整为 %lu 超出上限 %lu", capacity, rounded, (unsigned long)TJPMAX_BUFFER_SIZE);
+                return nil;
+            }
+            capacity = rounded;
+            _mask = capacity - 1;
+        }
+        
+        _mode = mode;
+        _backend = backend;
+        
         // 开辟内存空间
-        _buffer = malloc(capacity);
+        BOOL mirrored = NO;
+        _buffer = [self _allocateStorageWithCapacity:&capacity mirrored:&mirrored];
         if (!_buffer) {
             TJPLOG_ERROR(@"环形缓冲区内存分配失败，容量: %lu", capacity);
             return nil;
         }
+        _mirrored = mirrored;
+        if (mode == TJPRingBufferModeLockFreeSPSC) {
+            // 镜像映射按页取整 页大小本身是2的幂 不影响掩码
+            _mask = capacity - 1;
+        }
+        
+        _capacity = capacity;
+        _initialCapacity = capacity;
+        _maxCapacity = capacity;
+        _lowUsageSince = 0;
         
         _readIndex = 0;
         _writeIndex = 0;
         _usedSize = 0;
+        atomic_init(&_writePosition, 0);
+        atomic_init(&_readPosition, 0);
         
         _accessQueue = dispatch_queue_create("com.tjp.ringBuffer.accessQueue", DISPATCH_QUEUE_SERIAL);
         
-        TJPLOG_INFO(@"环形缓冲区初始化成功，容量: %lu bytes", capacity);
+        TJPLOG_INFO(@"环形缓冲区初始化成功，容量: %lu bytes, 模式: %@", capacity, mode == TJPRingBufferModeLockFreeSPSC ? @"SPSC" : @"串行队列");
         
     }
     return self;
@@ -51,8 +151,32 @@
 
 
 - (void)dealloc {
+    [self _releaseStorage];
+}
+
+- (char *)_allocateStorageWithCapacity:(NSUInteger *)capacity mirrored:(BOOL *)mirrored {
+    *mirrored = NO;
+    if (_backend == TJPRingBufferBackendMirrored) {
+        // 镜像映射以页为单位
+        NSUInteger pageSize = vm_page_size;
+        *capacity = (*capacity + pageSize - 1) & ~(pageSize - 1);
+        char *buffer = TJPAllocateMirroredBuffer(*capacity);
+        if (buffer) {
+            *mirrored = YES;
+            return buffer;
+        }
+        TJPLOG_WARN(@"镜像内存映射失败，回退到普通内存，容量: %lu", *capacity);
+    }
+    return malloc(*capacity);
+}
+
+- (void)_releaseStorage {
     if (_buffer) {
-        free(_buffer);
+        if (_mirrored) {
+            vm_deallocate(mach_task_self(), (vm_address_t)_buffer, _capacity * 2);
+        } else {
+            free(_buffer);
+        }
         _buffer = NULL;
     }
 }
@@ -71,6 +195,10 @@
         return 0;
     }
     
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return [self _spscWriteBytes:bytes length:length];
+    }
+    
     __block NSUInteger writtenBytes = 0;
     dispatch_sync(_accessQueue, ^{
         writtenBytes = [self _unsafeWriteBytes:bytes length:length];
@@ -92,7 +220,7 @@
     //计算写入到缓冲区末尾的字节数
     NSUInteger bytesToEnd = _capacity - _writeIndex;
     
-    if (bytesToWrite <= bytesToEnd) {
+    if (_mirrored || bytesToWrite <= bytesToEnd) {
         //数据可以连续写入
         memcpy(_buffer + _writeIndex, sourceBytes, bytesToWrite);
     }else {
@@ -114,6 +242,15 @@
         return [NSData data];
     }
     
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        if (self.usedSize < length) {
+            return nil;
+        }
+        NSMutableData *result = [NSMutableData dataWithLength:length];
+        NSUInteger readBytes = [self _spscCopyBytes:result.mutableBytes length:length consume:YES];
+        return readBytes == length ? result : nil;
+    }
+    
     __block NSData *result = nil;
     dispatch_sync(_accessQueue, ^{
         if (self->_usedSize < length) {
@@ -139,6 +276,10 @@
         return 0;
     }
     
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return [self _spscCopyBytes:buffer length:length consume:YES];
+    }
+    
     __block NSUInteger readBytes = 0;
     dispatch_sync(_accessQueue, ^{
         readBytes = [self _unsafeReadBytes:buffer length:length];
@@ -159,7 +300,7 @@
     //计算从读指针到缓冲区末尾的字节数
     NSUInteger bytesToEnd = _capacity - _readIndex;
     
-    if (bytesToRead <= bytesToEnd) {
+    if (_mirrored || bytesToRead <= bytesToEnd) {
         //数据可以连续读取
         memcpy(destBuffer, _buffer + _readIndex, bytesToRead);
     }else {
@@ -180,6 +321,15 @@
         return [NSData data];
     }
     
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        if (self.usedSize < length) {
+            return nil;
+        }
+        NSMutableData *result = [NSMutableData dataWithLength:length];
+        NSUInteger peekBytes = [self _spscCopyBytes:result.mutableBytes length:length consume:NO];
+        return peekBytes == length ? result : nil;
+    }
+    
     __block NSData *result = nil;
     dispatch_sync(_accessQueue, ^{
         if (self->_usedSize < length) {
@@ -207,6 +357,10 @@
         return 0;
     }
     
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return [self _spscCopyBytes:buffer length:length consume:NO];
+    }
+    
     __block NSUInteger peekBytes = 0;
     dispatch_sync(_accessQueue, ^{
         peekBytes = [self _unsafePeekBytes:buffer length:length];
@@ -228,7 +382,7 @@
     //计算从读指针到缓冲区末尾的字节数
     NSUInteger bytesToEnd = _capacity - tempReadIndex;
     
-    if (bytesToPeek <= bytesToEnd) {
+    if (_mirrored || bytesToPeek <= bytesToEnd) {
         //数据可以连续读取
         memcpy(destBuffer, _buffer + tempReadIndex, bytesToPeek);
     }else {
@@ -242,7 +396,168 @@
 
 }
 
+- (BOOL)getReadView:(TJPRingBufferReadView *)view length:(NSUInteger)length {
+    if (!view) {
+        return NO;
+    }
+    *view = (TJPRingBufferReadView){0};
+    
+    NSUInteger readIndex = 0;
+    NSUInteger usedSize = [self _loadReadIndex:&readIndex];
+    if (usedSize < length) {
+        return NO;
+    }
+    [self _fillReadView:view readIndex:readIndex length:length];
+    return YES;
+}
+
+- (NSUInteger)getReadViewOfAvailableData:(TJPRingBufferReadView *)view {
+    if (!view) {
+        return 0;
+    }
+    *view = (TJPRingBufferReadView){0};
+    
+    // 读指针和已用大小在同一次访问中取得 视图长度即当时的可读数据量
+    NSUInteger readIndex = 0;
+    NSUInteger usedSize = [self _loadReadIndex:&readIndex];
+    if (usedSize > 0) {
+        [self _fillReadView:view readIndex:readIndex length:usedSize];
+    }
+    return usedSize;
+}
+
+/// 读取当前读指针 返回已用大小
+- (NSUInteger)_loadReadIndex:(NSUInteger *)readIndex {
+    __block NSUInteger index = 0;
+    __block NSUInteger usedSize = 0;
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        uint64_t readPos = atomic_load_explicit(&_readPosition, memory_order_relaxed);
+        uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_acquire);
+        index = (NSUInteger)readPos & _mask;
+        usedSize = (NSUInteger)(writePos - readPos);
+    } else {
+        dispatch_sync(_accessQueue, ^{
+            index = self->_readIndex;
+            usedSize = self->_usedSize;
+        });
+    }
+    *readIndex = index;
+    return usedSize;
+}
+
+- (void)_fillReadView:(TJPRingBufferReadView *)view readIndex:(NSUInteger)readIndex length:(NSUInteger)length {
+    // 可读区域只会被消费者释放 生产者不会覆盖 视图在提交前保持有效
+    NSUInteger bytesToEnd = _capacity - readIndex;
+    view->firstSegment = _buffer + readIndex;
+    if (_mirrored || length <= bytesToEnd) {
+        view->firstLength = length;
+    } else {
+        view->firstLength = bytesToEnd;
+        view->secondSegment = _buffer;
+        view->secondLength = length - bytesToEnd;
+    }
+}
+
+- (BOOL)ensureAvailableSpace:(NSUInteger)length {
+    if (self.availableSpace >= length) {
+        return YES;
+    }
+    
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        // 无锁模式下生产者无法安全迁移消费者正在读取的内存
+        return NO;
+    }
+    
+    __block BOOL grown = NO;
+    dispatch_sync(_accessQueue, ^{
+        NSUInteger required = self->_usedSize + length;
+        NSUInteger ceiling = MAX(self->_maxCapacity, self->_capacity);
+        if (required > ceiling) {
+            TJPLOG_WARN(@"环形缓冲区扩容失败: 需要 %lu, 上限 %lu", (unsigned long)required, (unsigned long)ceiling);
+            return;
+        }
+        
+        // 按2倍几何扩容 摊还每字节的迁移成本
+        NSUInteger newCapacity = self->_capacity;
+        while (newCapacity < required) {
+            newCapacity *= 2;
+        }
+        newCapacity = MIN(newCapacity, ceiling);
+        
+        NSUInteger oldCapacity = self->_capacity;
+        grown = [self _unsafeRelocateToCapacity:newCapacity];
+        if (grown) {
+            self->_lowUsageSince = 0;
+            TJPLOG_INFO(@"环形缓冲区扩容: %luKB -> %luKB", (unsigned long)oldCapacity / 1024, (unsigned long)self->_capacity / 1024);
+        }
+    });
+    return grown;
+}
+
+- (BOOL)shrinkIfUnderusedForInterval:(NSTimeInterval)interval {
+    if (_mode == TJPRingBufferModeLockFreeSPSC || _capacity <= _initialCapacity) {
+        return NO;
+    }
+    
+    __block BOOL shrunk = NO;
+    dispatch_sync(_accessQueue, ^{
+        NSUInteger targetCapacity = MAX(self->_capacity / 2, self->_initialCapacity);
+        // 使用量不超过目标容量的一半才算低使用率 避免缩容后立刻又扩容
+        if (self->_usedSize > targetCapacity / 2) {
+            self->_lowUsageSince = 0;
+            return;
+        }
+        
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        if (self->_lowUsageSince == 0) {
+            self->_lowUsageSince = now;
+            return;
+        }
+        if (now - self->_lowUsageSince < interval) {
+            return;
+        }
+        
+        NSUInteger oldCapacity = self->_capacity;
+        shrunk = [self _unsafeRelocateToCapacity:targetCapacity];
+        if (shrunk) {
+            // 每次只减半 下一次缩容重新计时
+            self->_lowUsageSince = now;
+            TJPLOG_INFO(@"环形缓冲区缩容: %luKB -> %luKB", (unsigned long)oldCapacity / 1024, (unsigned long)self->_capacity / 1024);
+        }
+    });
+    return shrunk;
+}
+
+/// 迁移到新容量的内存 已有数据一次性线性化到新内存头部 必须在_accessQueue中调用
+- (BOOL)_unsafeRelocateToCapacity:(NSUInteger)newCapacity {
+    BOOL mirrored = NO;
+    char *newBuffer = [self _allocateStorageWithCapacity:&newCapacity mirrored:&mirrored];
+    if (!newBuffer) {
+        TJPLOG_ERROR(@"环形缓冲区迁移内存分配失败，容量: %lu", (unsigned long)newCapacity);
+        return NO;
+    }
+    
+    NSUInteger usedSize = _usedSize;
+    [self _unsafePeekBytes:newBuffer length:usedSize];
+    [self _releaseStorage];
+    
+    _buffer = newBuffer;
+    _mirrored = mirrored;
+    _capacity = newCapacity;
+    _readIndex = 0;
+    _writeIndex = usedSize % newCapacity;
+    return YES;
+}
+
 - (NSUInteger)skipBytes:(NSUInteger)length {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        uint64_t readPos = atomic_load_explicit(&_readPosition, memory_order_relaxed);
+        uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_acquire);
+        NSUInteger bytesToSkip = MIN(length, (NSUInteger)(writePos - readPos));
+        atomic_store_explicit(&_readPosition, readPos + bytesToSkip, memory_order_release);
+        return bytesToSkip;
+    }
+    
     __block NSUInteger skippedBytes = 0;
     dispatch_sync(_accessQueue, ^{
         NSUInteger bytesToSkip = MIN(length, self->_usedSize);
@@ -254,6 +569,14 @@
 }
 
 - (void)reset {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        // 消费者侧重置: 丢弃当前所有可读数据 不与生产者竞争写位置
+        uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_acquire);
+        atomic_store_explicit(&_readPosition, writePos, memory_order_release);
+        TJPLOG_INFO(@"环形缓冲区已重置");
+        return;
+    }
+    
     dispatch_sync(_accessQueue, ^{
         self->_readIndex = 0;
         self->_writeIndex = 0;
@@ -270,11 +593,67 @@
     return (CGFloat)self.usedSize / (CGFloat)_capacity;
 }
 
+#pragma mark - SPSC
+- (NSUInteger)_spscWriteBytes:(const void *)bytes length:(NSUInteger)length {
+    // 写位置只有生产者修改 relaxed读取即可; 读位置需acquire保证消费者已读完旧数据
+    uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_relaxed);
+    uint64_t readPos = atomic_load_explicit(&_readPosition, memory_order_acquire);
+    
+    NSUInteger availableSpace = _capacity - (NSUInteger)(writePos - readPos);
+    NSUInteger bytesToWrite = MIN(length, availableSpace);
+    if (bytesToWrite == 0) {
+        TJPLOG_WARN(@"环形缓冲区空间不足，无法写入数据");
+        return 0;
+    }
+    
+    const char *sourceBytes = (const char *)bytes;
+    NSUInteger writeIndex = (NSUInteger)writePos & _mask;
+    NSUInteger bytesToEnd = _capacity - writeIndex;
+    
+    if (_mirrored || bytesToWrite <= bytesToEnd) {
+        memcpy(_buffer + writeIndex, sourceBytes, bytesToWrite);
+    } else {
+        memcpy(_buffer + writeIndex, sourceBytes, bytesToEnd);
+        memcpy(_buffer, sourceBytes + bytesToEnd, bytesToWrite - bytesToEnd);
+    }
+    
+    // release发布 消费者acquire读到新位置时数据一定可见
+    atomic_store_explicit(&_writePosition, writePos + bytesToWrite, memory_order_release);
+    return bytesToWrite;
+}
+
+- (NSUInteger)_spscCopyBytes:(void *)buffer length:(NSUInteger)length consume:(BOOL)consume {
+    uint64_t readPos = atomic_load_explicit(&_readPosition, memory_order_relaxed);
+    uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_acquire);
+    
+    NSUInteger bytesToCopy = MIN(length, (NSUInteger)(writePos - readPos));
+    if (bytesToCopy == 0) {
+        return 0;
+    }
+    
+    char *destBuffer = (char *)buffer;
+    NSUInteger readIndex = (NSUInteger)readPos & _mask;
+    NSUInteger bytesToEnd = _capacity - readIndex;
+    
+    if (_mirrored || bytesToCopy <= bytesToEnd) {
+        memcpy(destBuffer, _buffer + readIndex, bytesToCopy);
+    } else {
+        memcpy(destBuffer, _buffer + readIndex, bytesToEnd);
+        memcpy(destBuffer + bytesToEnd, _buffer, bytesToCopy - bytesToEnd);
+    }
+    
+    if (consume) {
+        // release归还空间 生产者acquire读到新位置后才会覆盖
+        atomic_store_explicit(&_readPosition, readPos + bytesToCopy, memory_order_release);
+    }
+    return bytesToCopy;
+}
+
 #pragma mark - Debug
 
 - (NSString *)description {
-    return [NSString stringWithFormat:@"<TJPRingBuffer: capacity=%lu, size=%lu, readIndex=%lu, writeIndex=%lu, usage=%.1f%%>",
-            _capacity, self.usedSize, self.readIndex, self.writeIndex, self.usageRatio * 100];
+    return [NSString stringWithFormat:@"<TJPRingBuffer: capacity=%lu, size=%lu, readIndex=%lu, writeIndex=%lu, usage=%.1f%%, mirrored=%d>",
+            _capacity, self.usedSize, self.readIndex, self.writeIndex, self.usageRatio * 100, _mirrored];
 }
 
 #pragma mark - Getter Method
@@ -282,7 +661,30 @@
     return _capacity;
 }
 
+- (TJPRingBufferMode)mode {
+    return _mode;
+}
+
+- (BOOL)isMirrored {
+    return _mirrored;
+}
+
+- (NSUInteger)maxCapacity {
+    return _maxCapacity;
+}
+
+- (void)setMaxCapacity:(NSUInteger)maxCapacity {
+    _maxCapacity = MIN(MAX(maxCapacity, _initialCapacity), (NSUInteger)TJPMAX_BUFFER_SIZE);
+}
+
 - (NSUInteger)usedSize {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        // 先读readPos再读writePos 保证差值非负 第三方线程观察时可能短暂偏大 需截断
+        uint64_t readPos = atomic_load_explicit(&_readPosition, memory_order_acquire);
+        uint64_t writePos = atomic_load_explicit(&_writePosition, memory_order_acquire);
+        return MIN((NSUInteger)(writePos - readPos), _capacity);
+    }
+    
     __block NSUInteger result;
     dispatch_sync(_accessQueue, ^{
         result = self->_usedSize;
@@ -291,6 +693,10 @@
 }
 
 - (NSUInteger)availableSpace {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return _capacity - self.usedSize;
+    }
+    
     __block NSUInteger result;
     dispatch_sync(_accessQueue, ^{
         result = self->_capacity - self->_usedSize;
@@ -299,6 +705,10 @@
 }
 
 - (NSUInteger)readIndex {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return (NSUInteger)atomic_load_explicit(&_readPosition, memory_order_acquire) & _mask;
+    }
+    
     __block NSUInteger result;
     dispatch_sync(_accessQueue, ^{
         result = self->_readIndex;
@@ -307,6 +717,10 @@
 }
 
 - (NSUInteger)writeIndex {
+    if (_mode == TJPRingBufferModeLockFreeSPSC) {
+        return (NSUInteger)atomic_load_explicit(&_writePosition, memory_order_acquire) & _mask;
+    }
+    
     __block NSUInteger result;
     dispatch_sync(_accessQueue, ^{
         result = self->_writeIndex;
@@ -0,0 +1,62 @@
+//
+//  TJPTLVContainer.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/8.
+//  延迟解析的TLV容器
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 延迟解析的TLV容器
+ *
+ * 设计说明：
+ * - 首次访问时才遍历数据 建立按Tag排序的 (tag, offset, length) 索引 查询使用二分查找
+ * - Value以不拷贝的方式引用原始数据 返回的NSData持有原始数据
+ * - 嵌套保留Tag(0xFFFF)的子容器在访问时才解析
+ * - 线程安全，索引建立使用 os_unfair_lock
+ */
+@interface TJPTLVContainer : NSObject
+
+/// 原始TLV数据
+@property (nonatomic, readonly) NSData *data;
+/// Tag策略
+@property (nonatomic, readonly) TJPTLVTagPolicy policy;
+/// 当前层级 顶层为0
+@property (nonatomic, readonly) NSUInteger depth;
+/// 当前层级的TLV个数 解析失败时为0
+@property (nonatomic, readonly) NSUInteger count;
+
+
+/// 初始化方法 不会立即解析
+/// - Parameters:
+///   - data: TLV数据
+///   - policy: Tag策略
+///   - maxDepth: 最大嵌套深度
+- (instancetype)initWithData:(NSData *)data policy:(TJPTLVTagPolicy)policy maxNestedDepth:(NSUInteger)maxDepth;
+
+
+/// 完整校验 包括所有嵌套层级 与旧版一次性解析的校验规则一致
+/// - Parameter error: 校验失败时的错误
+- (BOOL)validateWithError:(NSError **)error;
+
+
+/// 获取指定Tag的值 不拷贝 允许重复Tag时返回最后一个
+/// - Parameter tag: Tag
+- (nullable NSData *)valueForTag:(uint16_t)tag;
+
+
+/// 嵌套保留Tag对应的子容器 首次访问时创建
+- (nullable TJPTLVContainer *)nestedContainer;
+
+
+/// 转换为字典 Tag -> NSData 嵌套保留Tag -> NSDictionary  任意层级解析失败时返回nil
+- (nullable NSDictionary<NSNumber *, id> *)dictionaryRepresentation;
+
+
+@end
+
+NS_ASSUME_NONNULL_END
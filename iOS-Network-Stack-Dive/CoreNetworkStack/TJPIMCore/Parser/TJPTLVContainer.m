@@ -0,0 +1,300 @@
+//
+//  TJPTLVContainer.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/8.
+//
+
+#import "TJPTLVContainer.h"
+#import <os/lock.h>
+#import "TJPNetworkDefine.h"
+#import "TJPErrorUtil.h"
+
+static const uint16_t kTLVReservedNestedTag = 0xFFFF;
+static const NSUInteger kTLVInlineEntryCount = 8;   // 常见包TLV个数很少 内联存储避免分配
+
+typedef struct {
+    uint16_t tag;
+    uint32_t offset;    // Value在data中的偏移
+    uint32_t length;    // Value长度
+} TJPTLVEntry;
+
+static int TJPTLVEntryCompare(const void *lhs, const void *rhs) {
+    const TJPTLVEntry *a = lhs;
+    const TJPTLVEntry *b = rhs;
+    if (a->tag != b->tag) {
+        return a->tag < b->tag ? -1 : 1;
+    }
+    // 同Tag按出现顺序排列 保证重复Tag时最后一个生效
+    return a->offset < b->offset ? -1 : (a->offset > b->offset ? 1 : 0);
+}
+
+@interface TJPTLVContainer ()
+
+- (instancetype)initWithData:(NSData *)data policy:(TJPTLVTagPolicy)policy maxNestedDepth:(NSUInteger)maxDepth depth:(NSUInteger)depth;
+
+@end
+
+@implementation TJPTLVContainer {
+    NSUInteger _maxDepth;
+    os_unfair_lock _lock;
+
+    BOOL _indexed;
+    NSError *_indexError;
+    TJPTLVEntry _inlineEntries[kTLVInlineEntryCount];
+    TJPTLVEntry *_entries;
+    NSUInteger _entryCount;
+
+    TJPTLVContainer *_nestedContainer;
+}
+
+- (instancetype)initWithData:(NSData *)data policy:(TJPTLVTagPolicy)policy maxNestedDepth:(NSUInteger)maxDepth {
+    return [self initWithData:data policy:policy maxNestedDepth:maxDepth depth:0];
+}
+
+- (instancetype)initWithData:(NSData *)data policy:(TJPTLVTagPolicy)policy maxNestedDepth:(NSUInteger)maxDepth depth:(NSUInteger)depth {
+    if (self = [super init]) {
+        // 不可变数据copy无开销 可变数据需固定内容 保证引用的Value不被修改
+        _data = [data copy] ?: [NSData data];
+        _policy = policy;
+        _maxDepth = maxDepth;
+        _depth = depth;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _entries = _inlineEntries;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_entries != _inlineEntries) {
+        free(_entries);
+    }
+}
+
+#pragma mark - Public Method
+- (NSUInteger)count {
+    return [self ensureIndexed] ? _entryCount : 0;
+}
+
+- (BOOL)validateWithError:(NSError **)error {
+    if (![self ensureIndexed]) {
+        if (error) *error = _indexError;
+        return NO;
+    }
+
+    TJPTLVContainer *nested = [self nestedContainer];
+    if (nested) {
+        return [nested validateWithError:error];
+    }
+    return YES;
+}
+
+- (NSData *)valueForTag:(uint16_t)tag {
+    if (![self ensureIndexed]) {
+        return nil;
+    }
+
+    NSInteger index = [self lastIndexOfTag:tag];
+    if (index < 0) {
+        return nil;
+    }
+    return [self valueForEntry:_entries[index]];
+}
+
+- (TJPTLVContainer *)nestedContainer {
+    if (![self ensureIndexed]) {
+        return nil;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    if (!_nestedContainer) {
+        NSInteger index = [self lastIndexOfTag:kTLVReservedNestedTag];
+        if (index >= 0) {
+            _nestedContainer = [[TJPTLVContainer alloc] initWithData:[self valueForEntry:_entries[index]]
+                                                              policy:_policy
+                                                      maxNestedDepth:_maxDepth
+                                                               depth:_depth + 1];
+        }
+    }
+    TJPTLVContainer *nested = _nestedContainer;
+    os_unfair_lock_unlock(&_lock);
+
+    return nested;
+}
+
+- (NSDictionary<NSNumber *, id> *)dictionaryRepresentation {
+    if (![self ensureIndexed]) {
+        return nil;
+    }
+
+    NSMutableDictionary *tlvDict = [NSMutableDictionary dictionaryWithCapacity:_entryCount];
+    for (NSUInteger i = 0; i < _entryCount; i++) {
+        TJPTLVEntry entry = _entries[i];
+        if (entry.tag == kTLVReservedNestedTag) {
+            continue;
+        }
+        tlvDict[@(entry.tag)] = [self valueForEntry:entry];
+    }
+
+    TJPTLVContainer *nested = [self nestedContainer];
+    if (nested) {
+        NSDictionary *nestedDict = [nested dictionaryRepresentation];
+        if (!nestedDict) {
+            return nil;
+        }
+        tlvDict[@(kTLVReservedNestedTag)] = nestedDict;
+    }
+
+    return [tlvDict copy];
+}
+
+#pragma mark - Private Method
+- (NSData *)valueForEntry:(TJPTLVEntry)entry {
+    if (entry.length == 0) {
+        return [NSData data];
+    }
+    // 子区间引用原始数据 block持有data保证生命周期
+    NSData *data = _data;
+    return [[NSData alloc] initWithBytesNoCopy:(void *)((const uint8_t *)data.bytes + entry.offset)
+                                        length:entry.length
+                                   deallocator:^(void *bytes, NSUInteger length) {
+        (void)data;
+    }];
+}
+
+/// 二分查找 返回该Tag最后一个条目的下标 不存在返回-1
+- (NSInteger)lastIndexOfTag:(uint16_t)tag {
+    NSUInteger low = 0;
+    NSUInteger high = _entryCount;
+    // 查找第一个 tag > 目标 的位置
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (_entries[mid].tag <= tag) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0 || _entries[low - 1].tag != tag) {
+        return -1;
+    }
+    return (NSInteger)low - 1;
+}
+
+- (BOOL)ensureIndexed {
+    os_unfair_lock_lock(&_lock);
+    if (!_indexed) {
+        NSError *error = nil;
+        if (![self buildIndexWithError:&error]) {
+            _indexError = error;
+            _entryCount = 0;
+        }
+        _indexed = YES;
+    }
+    BOOL success = (_indexError == nil);
+    os_unfair_lock_unlock(&_lock);
+
+    return success;
+}
+
+// TLV索引核心逻辑
+- (BOOL)buildIndexWithError:(NSError **)error {
+    if (_depth > _maxDepth) {
+        if (error) {
+            *error = [TJPErrorUtil errorWithCode:TJPErrorTLVNestedTooDeep
+                                    description:[NSString stringWithFormat:@"嵌套深度超过限制:%lu", (unsigned long)_maxDepth]
+                                      userInfo:@{@"maxDepth": @(_maxDepth), @"currentDepth": @(_depth)}];
+        }
+        return NO;
+    }
+
+    const uint8_t *bytes = _data.bytes;
+    NSUInteger length = _data.length;
+    NSUInteger offset = 0;
+    NSUInteger capacity = kTLVInlineEntryCount;
+    BOOL sorted = YES;
+
+    while (offset < length) {
+        //解析Tag
+        if (offset + 2 > length) {
+            TJPLOG_ERROR(@"TLV解析失败：Tag不完整 (offset=%lu, total=%lu)", (unsigned long)offset, (unsigned long)length);
+            if (error) {
+                *error = [TJPErrorUtil errorWithCode:TJPErrorTLVIncompleteTag
+                                        description:@"TLV解析失败：Tag不完整"
+                                          userInfo:@{@"offset": @(offset), @"length": @(length)}];
+            }
+            return NO;
+        }
+
+        uint16_t tag = 0;
+        memcpy(&tag, bytes + offset, sizeof(tag));
+        tag = CFSwapInt16BigToHost(tag);
+        offset += 2;
+
+        //解析Length
+        if (offset + 4 > length) {
+            TJPLOG_ERROR(@"TLV解析失败：Length不完整 (offset=%lu)", (unsigned long)offset);
+            if (error) {
+                *error = [TJPErrorUtil errorWithCode:TJPErrorTLVIncompleteLength
+                                        description:@"TLV解析失败：Length不完整"
+                                          userInfo:@{@"offset": @(offset), @"length": @(length)}];
+            }
+            return NO;
+        }
+
+        uint32_t valueLen = 0;
+        memcpy(&valueLen, bytes + offset, sizeof(valueLen));
+        valueLen = CFSwapInt32BigToHost(valueLen);
+        offset += 4;
+
+        //解析Value
+        if (valueLen > length - offset) {
+            TJPLOG_ERROR(@"TLV解析失败：Value长度越界 (声明长度=%u, 剩余长度=%lu)", valueLen, (unsigned long)(length - offset));
+            if (error) {
+                *error = [TJPErrorUtil errorWithCode:TJPErrorTLVIncompleteValue
+                                        description:@"TLV解析失败：Value长度越界"
+                                          userInfo:@{@"valueLen": @(valueLen)}];
+            }
+            return NO;
+        }
+
+        //扩容索引
+        if (_entryCount == capacity) {
+            capacity *= 2;
+            if (_entries == _inlineEntries) {
+                _entries = malloc(capacity * sizeof(TJPTLVEntry));
+                memcpy(_entries, _inlineEntries, sizeof(_inlineEntries));
+            } else {
+                _entries = realloc(_entries, capacity * sizeof(TJPTLVEntry));
+            }
+        }
+
+        if (_entryCount > 0 && _entries[_entryCount - 1].tag > tag) {
+            sorted = NO;
+        }
+        _entries[_entryCount++] = (TJPTLVEntry){ .tag = tag, .offset = (uint32_t)offset, .length = valueLen };
+        offset += valueLen;
+    }
+
+    if (!sorted) {
+        qsort(_entries, _entryCount, sizeof(TJPTLVEntry), TJPTLVEntryCompare);
+    }
+
+    //查重Tag 排序后相同Tag相邻
+    for (NSUInteger i = 1; i < _entryCount; i++) {
+        uint16_t tag = _entries[i].tag;
+        if (_policy == TJPTLVTagPolicyRejectDuplicates && tag == _entries[i - 1].tag) {
+            TJPLOG_ERROR(@"%@", [NSString stringWithFormat:@"重复Tag:0x%04X", tag]);
+            if (error) {
+                *error = [TJPErrorUtil errorWithCode:TJPErrorTLVDuplicateTag
+                                        description:@"TLV解析失败：重复Tag"
+                                            userInfo:@{@"tag": @(tag)}];
+            }
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+@end
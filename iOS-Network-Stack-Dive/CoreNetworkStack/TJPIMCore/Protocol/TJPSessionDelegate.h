@@ -49,6 +49,12 @@ NS_ASSUME_NONNULL_BEGIN
 // 发送消息失败
 - (void)session:(id<TJPSessionProtocol>)session didFailToSendMessageWithMessage:(NSString *)messageId error:(NSError *)error;
 
+// === 流量控制回调 ===
+// 发送窗口已满 新消息开始排队 应暂缓提交大消息
+- (void)session:(id<TJPSessionProtocol>)session sendWindowDidCloseWithQueuedMessages:(NSUInteger)queuedCount queuedBytes:(NSUInteger)queuedBytes;
+// 排队消息已全部发出 可继续提交
+- (void)sessionSendWindowDidOpen:(id<TJPSessionProtocol>)session;
+
 
 /**
  * 版本协商完成时调用
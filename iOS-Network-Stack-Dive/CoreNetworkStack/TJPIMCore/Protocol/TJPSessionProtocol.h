@@ -47,6 +47,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)sendData:(NSData *)data;
 /// 带回调的发送消息
 - (NSString *)sendData:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType completion:(void(^)(NSString *msgId, NSError *error))completion;
+/// 指定优先级的发送消息 决定在发送调度器中的排队级别
+- (NSString *)sendData:(NSData *)data messageType:(TJPMessageType)messageType encryptType:(TJPEncryptType)encryptType compressType:(TJPCompressType)compressType priority:(TJPMessagePriority)priority completion:(void(^)(NSString *msgId, NSError *error))completion;
 
 /// 发送心跳包
 - (void)sendHeartbeat:(NSData *)heartbeatData;
@@ -0,0 +1,38 @@
+//
+//  TJPReplayWindow.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/6.
+//  防重放滑动窗口
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 防重放滑动窗口
+ *
+ * 设计说明：
+ * - 参考IPsec反重放窗口 每个消息类别维护 最大序列号 + 固定大小位图
+ * - 序列号按 8位类别 + 24位序列号 拆分 与TJPSequenceManager一致
+ * - 内存固定 检查过程无堆分配 线程安全，使用 os_unfair_lock
+ * - 窗口内重复的序列号单独返回 由调用方丢弃并重新确认 不作为错误
+ * - 落后于窗口的序列号视为重放 除非识别为对端序列号重置后的新周期
+ */
+@interface TJPReplayWindow : NSObject
+
+/// 检查序列号是否为首次出现 首次出现时记录到窗口
+/// - Parameters:
+///   - sequence: 完整32位序列号(主机字节序)
+///   - timestamp: 消息时间戳(秒)
+///   - now: 当前时间(秒)
+/// - Returns: Accepted表示首次出现  Duplicate表示窗口内重复(合法重传)  Rejected表示重放或已过期
+- (TJPReplayCheckResult)checkAndRecordSequence:(uint32_t)sequence timestamp:(uint32_t)timestamp now:(uint32_t)now;
+
+/// 清空所有类别的窗口
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
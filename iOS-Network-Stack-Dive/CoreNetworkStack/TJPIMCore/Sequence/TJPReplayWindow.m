@@ -0,0 +1,140 @@
+//
+//  TJPReplayWindow.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/6.
+//
+
+#import "TJPReplayWindow.h"
+#import <os/lock.h>
+#import "TJPNetworkDefine.h"
+
+#define TJPREPLAY_WINDOW_WORDS (TJPREPLAY_WINDOW_SIZE / 64)
+
+typedef struct {
+    uint32_t highest;                              // 已接收的最大序列号(24位)
+    uint32_t highestTimestamp;                     // 最大序列号对应的时间戳
+    uint32_t epochStartTimestamp;                  // 因序列号重置开启新周期的时间 0表示未发生
+    BOOL initialized;                              // 是否收到过该类别的消息
+    uint64_t bitmap[TJPREPLAY_WINDOW_WORDS];       // 第i位表示 highest - i 已接收
+} TJPReplayWindowState;
+
+/// 位图整体左移shift位 即窗口向前滑动
+static void TJPReplayBitmapShift(uint64_t *words, uint32_t shift) {
+    uint32_t wordShift = shift / 64;
+    uint32_t bitShift = shift % 64;
+    for (int i = TJPREPLAY_WINDOW_WORDS - 1; i >= 0; i--) {
+        int source = i - (int)wordShift;
+        uint64_t value = 0;
+        if (source >= 0) {
+            value = words[source] << bitShift;
+            if (bitShift > 0 && source > 0) {
+                value |= words[source - 1] >> (64 - bitShift);
+            }
+        }
+        words[i] = value;
+    }
+}
+
+static inline BOOL TJPReplayBitmapTest(const uint64_t *words, uint32_t offset) {
+    return (words[offset / 64] >> (offset % 64)) & 1;
+}
+
+static inline void TJPReplayBitmapSet(uint64_t *words, uint32_t offset) {
+    words[offset / 64] |= (uint64_t)1 << (offset % 64);
+}
+
+/// 以sequence为起点重新建立窗口
+static void TJPReplayWindowRebase(TJPReplayWindowState *state, uint32_t sequence, uint32_t timestamp) {
+    memset(state->bitmap, 0, sizeof(state->bitmap));
+    state->highest = sequence;
+    state->highestTimestamp = timestamp;
+    state->initialized = YES;
+    TJPReplayBitmapSet(state->bitmap, 0);
+}
+
+@implementation TJPReplayWindow {
+    TJPReplayWindowState _states[TJPREPLAY_CATEGORY_COUNT];
+    os_unfair_lock _lock;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        memset(_states, 0, sizeof(_states));
+    }
+    return self;
+}
+
+- (TJPReplayCheckResult)checkAndRecordSequence:(uint32_t)sequence timestamp:(uint32_t)timestamp now:(uint32_t)now {
+    uint32_t category = (sequence >> TJPSEQUENCE_BODY_BITS) & TJPSEQUENCE_CATEGORY_MASK;
+    uint32_t body = sequence & TJPSEQUENCE_BODY_MASK;
+    if (category >= TJPREPLAY_CATEGORY_COUNT) {
+        TJPLOG_ERROR(@"[TJPReplayWindow] 未知的序列号类别: %u", category);
+        return TJPReplayCheckResultRejected;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    TJPReplayWindowState *state = &_states[category];
+    TJPReplayCheckResult result = [self checkState:state body:body timestamp:timestamp now:now];
+    os_unfair_lock_unlock(&_lock);
+
+    return result;
+}
+
+- (TJPReplayCheckResult)checkState:(TJPReplayWindowState *)state body:(uint32_t)body timestamp:(uint32_t)timestamp now:(uint32_t)now {
+    if (!state->initialized) {
+        TJPReplayWindowRebase(state, body, timestamp);
+        return TJPReplayCheckResultAccepted;
+    }
+
+    // 新周期开启后的时间窗口内 上一周期的大序列号一律视为重放 防止窗口被拉回旧周期
+    BOOL inNewEpoch = state->epochStartTimestamp != 0 && (int32_t)(now - state->epochStartTimestamp) <= TJPMAX_TIME_WINDOW;
+
+    if (body > state->highest) {
+        if (inNewEpoch && body >= TJPSEQUENCE_WARNING_THRESHOLD) {
+            return TJPReplayCheckResultRejected;
+        }
+        uint32_t shift = body - state->highest;
+        if (shift >= TJPREPLAY_WINDOW_SIZE) {
+            memset(state->bitmap, 0, sizeof(state->bitmap));
+        } else {
+            TJPReplayBitmapShift(state->bitmap, shift);
+        }
+        TJPReplayBitmapSet(state->bitmap, 0);
+        state->highest = body;
+        state->highestTimestamp = timestamp;
+        return TJPReplayCheckResultAccepted;
+    }
+
+    uint32_t offset = state->highest - body;
+    if (offset < TJPREPLAY_WINDOW_SIZE) {
+        if (TJPReplayBitmapTest(state->bitmap, offset)) {
+            return TJPReplayCheckResultDuplicate;
+        }
+        TJPReplayBitmapSet(state->bitmap, offset);
+        return TJPReplayCheckResultAccepted;
+    }
+
+    // 落后于窗口 以下情况视为对端开启了新周期
+    // 1. 窗口已接近上限 且新序列号位于起始区间(对端提前重置)
+    // 2. 窗口内最新消息已超出时间窗口 旧周期的消息都会被时间戳校验拒绝
+    BOOL sequenceWrapped = state->highest >= TJPSEQUENCE_WARNING_THRESHOLD && body <= TJPREPLAY_EPOCH_START_RANGE;
+    BOOL windowExpired = (int32_t)(now - state->highestTimestamp) > TJPMAX_TIME_WINDOW;
+    if (sequenceWrapped || windowExpired) {
+        TJPLOG_INFO(@"[TJPReplayWindow] 序列号开启新周期: %u -> %u", state->highest, body);
+        TJPReplayWindowRebase(state, body, timestamp);
+        state->epochStartTimestamp = sequenceWrapped ? now : 0;
+        return TJPReplayCheckResultAccepted;
+    }
+
+    return TJPReplayCheckResultRejected;
+}
+
+- (void)reset {
+    os_unfair_lock_lock(&_lock);
+    memset(_states, 0, sizeof(_states));
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
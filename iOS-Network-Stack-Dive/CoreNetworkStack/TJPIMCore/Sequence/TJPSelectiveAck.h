@@ -0,0 +1,41 @@
+//
+//  TJPSelectiveAck.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/10.
+//  选择性确认编解码
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 选择性确认(SACK)编解码
+ *
+ * 协议格式：
+ * - ACK包体为一个TLV Tag = TJP_TLV_TAG_SELECTIVE_ACK
+ * - Value由若干12字节区段组成 每段为 base(4字节) + bitmap(8字节) 均为网络字节序
+ * - bitmap第i位表示序列号 base+i 已收到 第0位恒为1
+ * - 协议头序列号填首个区段的base 未协商该特性的对端仍可按单个ACK处理
+ */
+@interface TJPSelectiveAck : NSObject
+
+/// 将序列号集合编码为TLV Value
+/// - Parameter sequences: 已收到的序列号 不能为空
++ (NSData *)valueWithSequences:(NSIndexSet *)sequences;
+
+/// 解码TLV Value
+/// - Parameter value: TLV Value
+/// - Returns: 覆盖的全部序列号 格式错误返回nil
++ (nullable NSIndexSet *)sequencesFromValue:(NSData *)value;
+
+/// 构建完整的SACK数据包
+/// - Parameters:
+///   - sequences: 已收到的序列号 不能为空
+///   - sessionID: 16位会话ID
++ (NSData *)ackPacketWithSequences:(NSIndexSet *)sequences sessionID:(uint16_t)sessionID;
+
+@end
+
+NS_ASSUME_NONNULL_END
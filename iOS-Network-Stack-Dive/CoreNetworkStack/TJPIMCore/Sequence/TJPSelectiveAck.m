@@ -0,0 +1,106 @@
+//
+//  TJPSelectiveAck.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/10.
+//
+
+#import "TJPSelectiveAck.h"
+#import "TJPNetworkDefine.h"
+#import "TJPNetworkUtil.h"
+#import "TJPMessageBuilder.h"
+
+static const NSUInteger kTJPSelectiveAckSegmentSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+@implementation TJPSelectiveAck
+
++ (NSData *)valueWithSequences:(NSIndexSet *)sequences {
+    NSMutableData *value = [NSMutableData dataWithCapacity:kTJPSelectiveAckSegmentSize];
+    __block uint32_t base = 0;
+    __block uint64_t bitmap = 0;
+    
+    void (^appendSegment)(void) = ^{
+        uint32_t netBase = htonl(base);
+        uint64_t netBitmap = OSSwapHostToBigInt64(bitmap);
+        [value appendBytes:&netBase length:sizeof(netBase)];
+        [value appendBytes:&netBitmap length:sizeof(netBitmap)];
+    };
+    
+    // 升序遍历 超出当前区段覆盖范围时开启新区段
+    [sequences enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+        uint32_t sequence = (uint32_t)idx;
+        if (bitmap != 0 && sequence - base >= TJP_SELECTIVE_ACK_BITMAP_BITS) {
+            appendSegment();
+            bitmap = 0;
+        }
+        if (bitmap == 0) {
+            base = sequence;
+        }
+        bitmap |= 1ULL << (sequence - base);
+    }];
+    if (bitmap != 0) {
+        appendSegment();
+    }
+    
+    return value;
+}
+
++ (NSIndexSet *)sequencesFromValue:(NSData *)value {
+    if (value.length == 0 || value.length % kTJPSelectiveAckSegmentSize != 0) {
+        TJPLOG_ERROR(@"[TJPSelectiveAck] SACK数据长度非法: %lu", (unsigned long)value.length);
+        return nil;
+    }
+    
+    NSMutableIndexSet *sequences = [NSMutableIndexSet indexSet];
+    const uint8_t *bytes = value.bytes;
+    for (NSUInteger offset = 0; offset < value.length; offset += kTJPSelectiveAckSegmentSize) {
+        uint32_t base = 0;
+        uint64_t bitmap = 0;
+        memcpy(&base, bytes + offset, sizeof(base));
+        memcpy(&bitmap, bytes + offset + sizeof(base), sizeof(bitmap));
+        base = ntohl(base);
+        bitmap = OSSwapBigToHostInt64(bitmap);
+        
+        if (!(bitmap & 1)) {
+            TJPLOG_ERROR(@"[TJPSelectiveAck] SACK区段格式错误: base=%u 未被确认", base);
+            return nil;
+        }
+        
+        while (bitmap) {
+            uint32_t bit = (uint32_t)__builtin_ctzll(bitmap);
+            // 超出32位的序列号无意义 忽略
+            if ((uint64_t)base + bit <= UINT32_MAX) {
+                [sequences addIndex:base + bit];
+            }
+            bitmap &= bitmap - 1;
+        }
+    }
+    
+    return sequences;
+}
+
++ (NSData *)ackPacketWithSequences:(NSIndexSet *)sequences sessionID:(uint16_t)sessionID {
+    NSData *value = [self valueWithSequences:sequences];
+    
+    // ACK消息体 - 单个SACK TLV
+    NSMutableData *body = [NSMutableData dataWithCapacity:sizeof(uint16_t) + sizeof(uint32_t) + value.length];
+    uint16_t tag = htons(TJP_TLV_TAG_SELECTIVE_ACK);
+    uint32_t length = htonl((uint32_t)value.length);
+    [body appendBytes:&tag length:sizeof(tag)];
+    [body appendBytes:&length length:sizeof(length)];
+    [body appendData:value];
+    
+    TJPFinalAdavancedHeader header = [TJPMessageBuilder headerWithMessageType:TJPMessageTypeACK
+                                                                     sequence:(uint32_t)sequences.firstIndex
+                                                                   bodyLength:(uint32_t)body.length
+                                                                     checksum:[TJPNetworkUtil crc32ForData:body]
+                                                                  encryptType:TJPEncryptTypeNone
+                                                                 compressType:TJPCompressTypeNone
+                                                                    sessionID:sessionID];
+    
+    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packet appendData:body];
+    return packet;
+}
+
+@end
@@ -0,0 +1,43 @@
+//
+//  TJPCRC32.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/5.
+//  CRC32(IEEE 802.3) 校验 结果与zlib crc32逐位一致
+
+#import <Foundation/Foundation.h>
+#import "TJPCoreTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface TJPCRC32 : NSObject
+
+/// 当前设备上选用的实现 优先硬件加速 不支持时使用slice-by-8
+@property (class, nonatomic, readonly) TJPCRC32Implementation activeImplementation;
+
+
+/// 增量更新crc32 首段传入0 分段数据依次传入上一段的结果
+/// - Parameters:
+///   - crc: 上一段的crc结果
+///   - bytes: 数据指针
+///   - length: 数据长度
++ (uint32_t)updateCRC:(uint32_t)crc bytes:(const void * _Nullable)bytes length:(NSUInteger)length;
+
+
+/// 使用指定实现增量更新crc32 用于测试和基准对比 当前设备不支持的实现回退到activeImplementation
+/// - Parameters:
+///   - crc: 上一段的crc结果
+///   - bytes: 数据指针
+///   - length: 数据长度
+///   - implementation: 指定实现
++ (uint32_t)updateCRC:(uint32_t)crc bytes:(const void * _Nullable)bytes length:(NSUInteger)length implementation:(TJPCRC32Implementation)implementation;
+
+
+/// 当前设备是否支持指定实现
+/// - Parameter implementation: 指定实现
++ (BOOL)isImplementationAvailable:(TJPCRC32Implementation)implementation;
+
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,333 @@
+//
+//  TJPCRC32.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/5.
+//
+
+#import "TJPCRC32.h"
+#import <zlib.h>
+
+#if defined(__aarch64__) || defined(__arm64__)
+#import <arm_acle.h>
+#import <sys/sysctl.h>
+#define TJP_CRC32_ARM_HARDWARE 1
+#elif defined(__x86_64__)
+#import <immintrin.h>
+#define TJP_CRC32_X86_PCLMUL 1
+#endif
+
+typedef uint32_t (*TJPCRC32UpdateFunction)(uint32_t crc, const uint8_t *bytes, size_t length);
+
+/// IEEE 802.3 反射多项式
+static const uint32_t kTJPCRC32Polynomial = 0xEDB88320;
+
+/// slice-by-8 查表 第k张表表示该字节之后再经过k个零字节的结果
+static uint32_t TJPCRC32Table[8][256];
+
+static void TJPCRC32BuildTables(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ kTJPCRC32Polynomial : crc >> 1;
+        }
+        TJPCRC32Table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = TJPCRC32Table[0][i];
+        for (int slice = 1; slice < 8; slice++) {
+            crc = (crc >> 8) ^ TJPCRC32Table[0][crc & 0xFF];
+            TJPCRC32Table[slice][i] = crc;
+        }
+    }
+}
+
+#pragma mark - Zlib
+static uint32_t TJPCRC32UpdateZlib(uint32_t crc, const uint8_t *bytes, size_t length) {
+    // zlib单次长度为uInt 超大数据分块
+    while (length > 0) {
+        uInt chunk = (uInt)MIN(length, (size_t)UINT32_MAX);
+        crc = (uint32_t)crc32(crc, bytes, chunk);
+        bytes += chunk;
+        length -= chunk;
+    }
+    return crc;
+}
+
+#pragma mark - Slice-by-8
+/// 内部状态(已取反)上逐字节处理
+static inline uint32_t TJPCRC32RawBytes(uint32_t state, const uint8_t *bytes, size_t length) {
+    while (length--) {
+        state = TJPCRC32Table[0][(state ^ *bytes++) & 0xFF] ^ (state >> 8);
+    }
+    return state;
+}
+
+/// 内部状态(已取反)上每次处理8字节 按小端读取
+static uint32_t TJPCRC32RawSliceBy8(uint32_t state, const uint8_t *bytes, size_t length) {
+    // 先对齐到8字节边界
+    while (length > 0 && ((uintptr_t)bytes & 7) != 0) {
+        state = TJPCRC32Table[0][(state ^ *bytes++) & 0xFF] ^ (state >> 8);
+        length--;
+    }
+
+    while (length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, bytes, sizeof(low));
+        memcpy(&high, bytes + 4, sizeof(high));
+        low ^= state;
+        state = TJPCRC32Table[7][low & 0xFF] ^
+                TJPCRC32Table[6][(low >> 8) & 0xFF] ^
+                TJPCRC32Table[5][(low >> 16) & 0xFF] ^
+                TJPCRC32Table[4][low >> 24] ^
+                TJPCRC32Table[3][high & 0xFF] ^
+                TJPCRC32Table[2][(high >> 8) & 0xFF] ^
+                TJPCRC32Table[1][(high >> 16) & 0xFF] ^
+                TJPCRC32Table[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+
+    return TJPCRC32RawBytes(state, bytes, length);
+}
+
+static uint32_t TJPCRC32UpdateSliceBy8(uint32_t crc, const uint8_t *bytes, size_t length) {
+    return ~TJPCRC32RawSliceBy8(~crc, bytes, length);
+}
+
+#pragma mark - Hardware
+#if TJP_CRC32_ARM_HARDWARE
+/// ARMv8 CRC32X/CRC32B 指令 多项式与IEEE一致(非CRC32C)
+/// CRC扩展在ARMv8.0上是可选的 单独按crc目标编译 是否调用由运行时检测决定
+__attribute__((target("crc")))
+static uint32_t TJPCRC32UpdateHardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    uint32_t state = ~crc;
+    while (length > 0 && ((uintptr_t)bytes & 7) != 0) {
+        state = __crc32b(state, *bytes++);
+        length--;
+    }
+
+    // 展开4路 减少循环开销
+    while (length >= 32) {
+        uint64_t words[4];
+        memcpy(words, bytes, sizeof(words));
+        state = __crc32d(state, words[0]);
+        state = __crc32d(state, words[1]);
+        state = __crc32d(state, words[2]);
+        state = __crc32d(state, words[3]);
+        bytes += 32;
+        length -= 32;
+    }
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        state = __crc32d(state, word);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length--) {
+        state = __crc32b(state, *bytes++);
+    }
+    return ~state;
+}
+
+static BOOL TJPCRC32HardwareSupported(void) {
+#if defined(__ARM_FEATURE_CRC32)
+    return YES;
+#else
+    int supported = 0;
+    size_t size = sizeof(supported);
+    if (sysctlbyname("hw.optional.armv8_crc32", &supported, &size, NULL, 0) != 0) {
+        return NO;
+    }
+    return supported != 0;
+#endif
+}
+
+#elif TJP_CRC32_X86_PCLMUL
+/// 使用PCLMULQDQ并行折叠 参考Intel白皮书"Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+/// 要求length为16的倍数且不小于64  state为内部状态(已取反)
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t TJPCRC32RawPCLMUL(uint32_t state, const uint8_t *bytes, size_t length) {
+    // 反射域折叠常数与Barrett约减常数
+    static const uint64_t k1k2[] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t k3k4[] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t k5k0[] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t poly[] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(bytes + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(bytes + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(bytes + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(bytes + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)state));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    bytes += 64;
+    length -= 64;
+
+    // 4路并行 每次折叠64字节
+    while (length >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128((const __m128i *)(bytes + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(bytes + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(bytes + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(bytes + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        bytes += 64;
+        length -= 64;
+    }
+
+    // 4路合并为128位
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // 剩余16字节块逐块折叠
+    while (length >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)bytes);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        bytes += 16;
+        length -= 16;
+    }
+
+    // 128位折叠到64位
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett约减到32位
+    x0 = _mm_load_si128((const __m128i *)poly);
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t TJPCRC32UpdateHardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    uint32_t state = ~crc;
+    // 小于64字节的数据折叠没有收益 直接查表
+    if (length >= 64) {
+        size_t foldLength = length & ~(size_t)15;
+        state = TJPCRC32RawPCLMUL(state, bytes, foldLength);
+        bytes += foldLength;
+        length -= foldLength;
+    }
+    return ~TJPCRC32RawSliceBy8(state, bytes, length);
+}
+
+static BOOL TJPCRC32HardwareSupported(void) {
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+
+#else
+static uint32_t TJPCRC32UpdateHardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    return TJPCRC32UpdateSliceBy8(crc, bytes, length);
+}
+
+static BOOL TJPCRC32HardwareSupported(void) {
+    return NO;
+}
+#endif
+
+
+@implementation TJPCRC32
+
+static TJPCRC32Implementation _activeImplementation;
+static TJPCRC32UpdateFunction _activeFunction;
+
++ (void)initialize {
+    if (self != [TJPCRC32 class]) {
+        return;
+    }
+    TJPCRC32BuildTables();
+
+    if (TJPCRC32HardwareSupported()) {
+        _activeImplementation = TJPCRC32ImplementationHardware;
+        _activeFunction = TJPCRC32UpdateHardware;
+    } else {
+        _activeImplementation = TJPCRC32ImplementationSliceBy8;
+        _activeFunction = TJPCRC32UpdateSliceBy8;
+    }
+}
+
++ (TJPCRC32Implementation)activeImplementation {
+    return _activeImplementation;
+}
+
++ (uint32_t)updateCRC:(uint32_t)crc bytes:(const void *)bytes length:(NSUInteger)length {
+    if (!bytes || length == 0) {
+        return crc;
+    }
+    return _activeFunction(crc, (const uint8_t *)bytes, length);
+}
+
++ (uint32_t)updateCRC:(uint32_t)crc bytes:(const void *)bytes length:(NSUInteger)length implementation:(TJPCRC32Implementation)implementation {
+    if (!bytes || length == 0) {
+        return crc;
+    }
+
+    switch (implementation) {
+        case TJPCRC32ImplementationZlib:
+            return TJPCRC32UpdateZlib(crc, (const uint8_t *)bytes, length);
+        case TJPCRC32ImplementationSliceBy8:
+            return TJPCRC32UpdateSliceBy8(crc, (const uint8_t *)bytes, length);
+        case TJPCRC32ImplementationHardware:
+        default:
+            return _activeFunction(crc, (const uint8_t *)bytes, length);
+    }
+}
+
++ (BOOL)isImplementationAvailable:(TJPCRC32Implementation)implementation {
+    switch (implementation) {
+        case TJPCRC32ImplementationZlib:
+        case TJPCRC32ImplementationSliceBy8:
+            return YES;
+        case TJPCRC32ImplementationHardware:
+            return TJPCRC32HardwareSupported();
+        default:
+            return NO;
+    }
+}
+
+@end
@@ -24,11 +24,20 @@ typedef enum {
     
     // 群聊能力
     TJP_FEATURE_GROUP_CHAT = 0x0010,   // 0000 0000 0001 0000
+    
+    // 累计/选择性确认能力 (一个ACK确认多个序列号)
+    TJP_FEATURE_SELECTIVE_ACK = 0x0020, // 0000 0000 0010 0000
+    
+    // 大消息分片能力
+    TJP_FEATURE_FRAGMENTATION = 0x0040, // 0000 0000 0100 0000
+    
+    // 预置字典压缩能力 (需同时协商压缩能力)
+    TJP_FEATURE_COMPRESSION_DICTIONARY = 0x0080, // 0000 0000 1000 0000
 } TJPFeatureFlag;
 
 // 当前客户端支持的特性组合
-// 这里表示支持: 基本消息 + 加密 + 压缩
-#define TJP_SUPPORTED_FEATURES (TJP_FEATURE_BASIC | TJP_FEATURE_ENCRYPTION | TJP_FEATURE_COMPRESSION)
+// 这里表示支持: 基本消息 + 加密 + 压缩 + 选择性确认 + 分片 + 字典压缩
+#define TJP_SUPPORTED_FEATURES (TJP_FEATURE_BASIC | TJP_FEATURE_ENCRYPTION | TJP_FEATURE_COMPRESSION | TJP_FEATURE_SELECTIVE_ACK | TJP_FEATURE_FRAGMENTATION | TJP_FEATURE_COMPRESSION_DICTIONARY)
 
 
 typedef enum {
@@ -36,6 +45,11 @@ typedef enum {
     TJP_TLV_TAG_VERSION_REQUEST    = 0x0001,    // 版本协商请求
     TJP_TLV_TAG_VERSION_RESPONSE   = 0x0002,    // 版本协商响应
     
+    // 传输控制相关
+    TJP_TLV_TAG_SELECTIVE_ACK      = 0x0003,    // 选择性确认 Value为若干(base, bitmap)区段
+    TJP_TLV_TAG_FLOW_WINDOW        = 0x0004,    // 接收窗口通告 Value为最大消息数(4字节)+最大字节数(4字节) 0表示不限制
+    TJP_TLV_TAG_FRAGMENT_HEADER    = 0x0005,    // 分片头 位于分片消息载荷开头 其后为分片数据
+    
     // 业务消息相关
     TJP_TLV_TAG_READ_RECEIPT       = 0x0010,    // 已读回执
     TJP_TLV_TAG_GROUP_MESSAGE      = 0x0011,    // 群聊消息
@@ -58,6 +72,12 @@ typedef NS_ENUM(NSUInteger, TJPSessionType) {
 };
 
 
+// 收包解析执行方式
+typedef NS_ENUM(NSUInteger, TJPParseExecutionMode) {
+    TJPParseExecutionModeLane = 0,   // 投递到会话解析通道 解析与socket读取互不阻塞
+    TJPParseExecutionModeInline,     // 在socket回调队列直接解析 只把完整数据包批量交给下游
+};
+
 typedef NS_ENUM(NSUInteger, TJPTLVTagPolicy) {
     TJPTLVTagPolicyAllowDuplicates,         //允许重复Tag
     TJPTLVTagPolicyRejectDuplicates         //不允许重复Tag
@@ -101,7 +121,15 @@ typedef NS_ENUM(uint16_t, TJPMessageType) {
     TJPMessageTypeHeartbeat = 1,       // 心跳消息
     TJPMessageTypeACK = 2,             // 确认消息
     TJPMessageTypeControl = 3,         // 控制消息
-    TJPMessageTypeReadReceipt          // 已读回执
+    TJPMessageTypeReadReceipt,         // 已读回执
+    TJPMessageTypeFragment             // 大消息分片 载荷为分片头TLV+分片数据
+};
+
+typedef NS_ENUM(NSUInteger, TJPFragmentReassemblyResult) {
+    TJPFragmentReassemblyResultIncomplete = 0,  // 已接收 等待其余分片
+    TJPFragmentReassemblyResultCompleted,       // 全部分片到齐 消息已重组
+    TJPFragmentReassemblyResultDuplicate,       // 重复分片 已忽略
+    TJPFragmentReassemblyResultInvalid          // 格式错误、校验失败或与已收分片不一致
 };
 
 typedef NS_ENUM(NSUInteger, TJPMessageState) {
@@ -156,6 +184,39 @@ typedef NS_ENUM(NSUInteger, TJPBufferStrategy) {
     TJPBufferStrategyRingBuffer      //环形缓冲区
 };
 
+typedef NS_ENUM(NSUInteger, TJPRingBufferMode) {
+    TJPRingBufferModeSerialQueue = 0,   //串行队列保护 任意线程读写
+    TJPRingBufferModeLockFreeSPSC       //无锁单生产者单消费者 容量为2的幂
+};
+
+typedef NS_ENUM(NSUInteger, TJPRingBufferBackend) {
+    TJPRingBufferBackendMalloc = 0,     //普通堆内存 跨越尾部的数据分段拷贝
+    TJPRingBufferBackendMirrored        //虚拟内存镜像映射 任意可读区域都是连续内存 失败时回退到Malloc
+};
+
+typedef NS_ENUM(NSUInteger, TJPCRC32Implementation) {
+    TJPCRC32ImplementationZlib = 0,     //zlib crc32 作为基准
+    TJPCRC32ImplementationSliceBy8,     //slice-by-8 查表 纯软件实现
+    TJPCRC32ImplementationHardware      //ARMv8 CRC32指令 / x86 PCLMUL折叠
+};
+
+typedef NS_ENUM(NSUInteger, TJPHeaderValidationResult) {
+    TJPHeaderValidationResultValid = 0,
+    TJPHeaderValidationResultMagicInvalid,              //魔数错误
+    TJPHeaderValidationResultVersionMismatch,           //协议版本不支持
+    TJPHeaderValidationResultBodyTooLarge,              //消息体长度超限
+    TJPHeaderValidationResultTimestampInvalid,          //时间戳超出窗口
+    TJPHeaderValidationResultUnsupportedEncryption,     //不支持的加密类型
+    TJPHeaderValidationResultUnsupportedCompression     //不支持的压缩类型
+};
+
+//防重放窗口检查结果
+typedef NS_ENUM(NSUInteger, TJPReplayCheckResult) {
+    TJPReplayCheckResultAccepted = 0,       //首次出现 已记录
+    TJPReplayCheckResultDuplicate,          //窗口内重复 对端重传或ACK丢失 丢弃载荷并重新确认
+    TJPReplayCheckResultRejected            //落后于窗口或类别未知 视为重放攻击
+};
+
 typedef NS_ENUM(NSUInteger, TJPNetworkQoS) {
     TJPNetworkQoSDefault              = 1 << 0,
     TJPNetworkQoSBackground           = 1 << 1,
@@ -39,6 +39,25 @@ NS_ASSUME_NONNULL_BEGIN
 /// 是否使用TLS
 @property (nonatomic, assign) BOOL useTLS;
 
+/// 是否开启写合并 默认NO
+@property (nonatomic, assign) BOOL writeCoalescingEnabled;
+
+/// 写合并窗口（秒） 默认0.002
+@property (nonatomic, assign) NSTimeInterval writeCoalescingInterval;
+
+/// 写合并字节阈值 达到后立即发送 默认16KB
+@property (nonatomic, assign) NSUInteger writeCoalescingMaxBytes;
+
+/// 发送窗口最大在途消息数 0表示不限制 默认64
+@property (nonatomic, assign) NSUInteger sendWindowMaxMessages;
+
+/// 发送窗口最大在途字节数 0表示不限制 默认4MB
+@property (nonatomic, assign) NSUInteger sendWindowMaxBytes;
+
+/// 收包解析执行方式 默认TJPParseExecutionModeLane
+/// Inline模式省去每次读取的队列切换 适合小包多、对时延敏感的会话 解析耗时会占用socket回调队列
+@property (nonatomic, assign) TJPParseExecutionMode parseExecutionMode;
+
 /// 指标收集级别，默认为基本级别
 @property (nonatomic, assign) TJPMetricsLevel metricsLevel;
 
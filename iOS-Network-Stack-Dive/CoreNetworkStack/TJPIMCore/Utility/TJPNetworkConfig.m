@@ -37,6 +37,12 @@
         _shouldReconnectAfterServerClose = NO;
         _useTLS = NO;
         _connectTimeout = 15.0;
+        _writeCoalescingEnabled = NO;
+        _writeCoalescingInterval = TJP_DEFAULT_WRITE_COALESCING_INTERVAL;
+        _writeCoalescingMaxBytes = TJP_DEFAULT_WRITE_COALESCING_MAX_BYTES;
+        _sendWindowMaxMessages = TJP_DEFAULT_SEND_WINDOW_MESSAGES;
+        _sendWindowMaxBytes = TJP_DEFAULT_SEND_WINDOW_BYTES;
+        _parseExecutionMode = TJPParseExecutionModeLane;
         
         
         // 默认指标设置
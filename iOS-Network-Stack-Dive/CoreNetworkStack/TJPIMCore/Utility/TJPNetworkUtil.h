@@ -12,13 +12,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface TJPNetworkUtil : NSObject
 
-/// crc32校验
+/// crc32校验 由TJPCRC32按设备选择硬件加速或slice-by-8实现
 + (uint32_t)crc32ForData:(NSData *)data;
 
-/// 使用zlib 数据压缩  
+/// 增量crc32 用于分段数据(如环形缓冲区读取视图)原地校验  首段传入crc为0
++ (uint32_t)crc32UpdateWithCRC:(uint32_t)crc bytes:(const void *)bytes length:(NSUInteger)length;
+
+/// 使用zlib 数据压缩 一次性调用 会话内收发使用TJPCompressionCodec复用压缩流
 + (NSData *)compressData:(NSData *)data;
 
-/// 数据解压
+/// 数据解压 输出超过TJP_COMPRESSION_MAX_INFLATED_SIZE或数据损坏时返回nil
 + (NSData *)decompressData:(NSData *)data;
 
 + (NSString *)base64EncodeData:(NSData *)data;
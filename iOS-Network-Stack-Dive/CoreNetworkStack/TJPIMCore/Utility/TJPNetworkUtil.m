@@ -11,6 +11,7 @@
 #import <zlib.h>
 
 #import "TJPNetworkDefine.h"
+#import "TJPCRC32.h"
 
 @implementation TJPNetworkUtil
 
@@ -44,13 +45,11 @@
         return 0;
     }
     
-    uLong crc = crc32(0L, Z_NULL, 0);
-    crc = crc32(crc, [data bytes], (uInt)[data length]);
-    
-#ifdef DEBUG
-NSLog(@"Calculated CRC32: %u", (uint32_t)crc);
-#endif
-    return (uint32_t)crc;
+    return [TJPCRC32 updateCRC:0 bytes:data.bytes length:data.length];
+}
+
++ (uint32_t)crc32UpdateWithCRC:(uint32_t)crc bytes:(const void *)bytes length:(NSUInteger)length {
+    return [TJPCRC32 updateCRC:crc bytes:bytes length:length];
 }
 
 
@@ -66,39 +65,29 @@ NSLog(@"Calculated CRC32: %u", (uint32_t)crc);
     
     //设置zlib压缩流属性
     z_stream stream;
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-    //输入数据的长度
-    stream.avail_in = (uint)data.length;
-    //输出数据的长度
-    stream.next_in = (Bytef *)data.bytes;
-    //输出数据总长度
-    stream.total_out = 0;
+    memset(&stream, 0, sizeof(stream));
     
     //关键步骤 初始化压缩流
     if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
         return nil;
     }
     
-    //分配16k的缓冲区用于存储压缩后的数据
-    NSMutableData *compressed = [NSMutableData dataWithLength:16384];
-    while (stream.avail_out == 0) {
-        if (stream.total_out >= compressed.length) {
-            //如果初始化16k不够则再增加16k
-            [compressed increaseLengthBy:16384];
-        }
-        
-        //输出数据的位置
-        stream.next_out = compressed.mutableBytes + stream.total_out;
-        //输出数据的剩余空间
-        stream.avail_out = (uint)(compressed.length - stream.total_out);
-        //关键步骤 开始压缩
-        deflate(&stream, Z_FINISH);
-    }
+    //按deflateBound一次分配足够的输出空间 单次调用完成压缩
+    uLong bound = deflateBound(&stream, (uLong)data.length);
+    NSMutableData *compressed = [NSMutableData dataWithLength:bound];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    stream.next_out = compressed.mutableBytes;
+    stream.avail_out = (uInt)bound;
+    
+    //关键步骤 开始压缩
+    int status = deflate(&stream, Z_FINISH);
     
     //关键步骤 结束压缩并释放资源
     deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        return nil;
+    }
     //压缩后的实际长度
     compressed.length = stream.total_out;
     return compressed;
@@ -109,35 +98,40 @@ NSLog(@"Calculated CRC32: %u", (uint32_t)crc);
     
     //设置解压流属性
     z_stream stream;
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-    stream.avail_in = (uint)data.length;
+    memset(&stream, 0, sizeof(stream));
+    stream.avail_in = (uInt)data.length;
     stream.next_in = (Bytef *)data.bytes;
-    stream.total_out = 0;
     
     //关键步骤 初始化解压流
     if (inflateInit(&stream) != Z_OK) {
         return nil;
     }
     
-    //初始化缓冲区空间
-    NSMutableData *decompressed = [NSMutableData dataWithLength:data.length * 2];
-    while (stream.avail_out == 0) {
+    //初始化缓冲区空间 不足时翻倍 输出超过上限视为异常数据
+    NSUInteger maxLength = TJP_COMPRESSION_MAX_INFLATED_SIZE;
+    NSMutableData *decompressed = [NSMutableData dataWithLength:MIN(MAX(data.length * 4, (NSUInteger)4096), maxLength)];
+    int status = Z_OK;
+    while (status == Z_OK) {
         if (stream.total_out >= decompressed.length) {
-            [decompressed increaseLengthBy:data.length];
+            if (decompressed.length >= maxLength) {
+                break;
+            }
+            decompressed.length = MIN(decompressed.length * 2, maxLength);
         }
         
         //输出数据的位置
-        stream.next_out = decompressed.mutableBytes + stream.total_out;
+        stream.next_out = (Bytef *)decompressed.mutableBytes + stream.total_out;
         //输出数据的剩余空间
-        stream.avail_out = (uint)(decompressed.length - stream.total_out);
+        stream.avail_out = (uInt)(decompressed.length - stream.total_out);
         //关键步骤 执行解压操作
-        inflate(&stream, Z_FINISH);
+        status = inflate(&stream, Z_NO_FLUSH);
     }
     
     //关键步骤 结束解压并释放相关资源
     inflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        return nil;
+    }
     //解压后的实际大小
     decompressed.length = stream.total_out;
     return decompressed;
@@ -0,0 +1,69 @@
+//
+//  TJPTimerWheel.h
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/11.
+//  哈希时间轮
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// 到期回调 同一刻度内到期的key一次性回调
+typedef void (^TJPTimerWheelExpirationHandler)(NSArray<NSString *> *expiredKeys);
+
+/**
+ * 哈希时间轮
+ *
+ * 设计说明：
+ * - 所有定时任务共用一个周期性dispatch_source 按刻度推进 没有任务时停止计时
+ * - 按到期刻度散列到槽中 槽内为双向链表 插入和取消均为O(1)
+ * - 超过一圈的任务保留在槽中 推进到对应刻度时才触发
+ * - 每个任务同时以key和序列号索引 两者都可用于取消
+ * - 非线程安全 所有方法必须在初始化时指定的队列上调用 回调也在该队列执行
+ */
+@interface TJPTimerWheel : NSObject
+
+/// 未到期任务数
+@property (nonatomic, readonly) NSUInteger count;
+/// 当前刻度
+@property (nonatomic, readonly) uint64_t currentTick;
+/// 刻度间隔(秒)
+@property (nonatomic, readonly) NSTimeInterval tickInterval;
+/// 到期回调
+@property (nonatomic, copy, nullable) TJPTimerWheelExpirationHandler expirationHandler;
+
+
+/// 初始化方法
+/// - Parameters:
+///   - tickInterval: 刻度间隔(秒)
+///   - slotCount: 槽数 向上取整为2的幂
+///   - queue: 串行队列 计时与回调均在该队列
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval slotCount:(NSUInteger)slotCount queue:(dispatch_queue_t)queue;
+
+
+/// 安排定时任务 同一key已存在时替换
+/// - Parameters:
+///   - key: 任务标识 如消息ID
+///   - sequence: 关联的序列号
+///   - interval: 延迟(秒) 向上取整到刻度 至少一个刻度
+- (void)scheduleKey:(NSString *)key sequence:(uint32_t)sequence afterInterval:(NSTimeInterval)interval;
+
+/// 按key取消 存在并取消时返回YES
+- (BOOL)cancelKey:(NSString *)key;
+
+/// 按序列号取消 存在并取消时返回YES
+- (BOOL)cancelSequence:(uint32_t)sequence;
+
+/// 是否存在该key的任务
+- (BOOL)containsKey:(NSString *)key;
+
+/// 取消全部任务并停止计时
+- (void)cancelAll;
+
+/// 立即推进指定刻度数并处理到期任务 主要用于测试
+- (void)advanceTicks:(uint64_t)ticks;
+
+@end
+
+NS_ASSUME_NONNULL_END
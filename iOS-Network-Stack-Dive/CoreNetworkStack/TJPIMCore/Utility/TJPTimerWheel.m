@@ -0,0 +1,268 @@
+//
+//  TJPTimerWheel.m
+//  iOS-Network-Stack-Dive
+//
+//  Created by 唐佳鹏 on 2025/6/11.
+//
+
+#import "TJPTimerWheel.h"
+#import <time.h>
+
+static const uint32_t kTJPTimerNodeNil = UINT32_MAX;
+static const uint32_t kTJPTimerInitialNodeCapacity = 64;
+
+typedef struct {
+    uint64_t deadline;      // 到期刻度
+    uint32_t prev;          // 槽内前驱
+    uint32_t next;          // 槽内后继 空闲节点复用为空闲链表
+    uint32_t sequence;
+    CFStringRef key;        // 持有 空闲节点为NULL
+} TJPTimerWheelNode;
+
+// 整数键的CFDictionary键值 +1避免0被当作NULL
+#define TJPTimerIndexToValue(index) ((const void *)(uintptr_t)((index) + 1))
+#define TJPTimerValueToIndex(value) ((uint32_t)((uintptr_t)(value) - 1))
+
+@implementation TJPTimerWheel {
+    dispatch_queue_t _queue;
+    dispatch_source_t _tickSource;
+    uint64_t _tickNanoseconds;
+    
+    uint32_t *_slotHeads;
+    uint32_t _slotMask;
+    
+    TJPTimerWheelNode *_nodes;
+    uint32_t _nodeCapacity;
+    uint32_t _freeHead;
+    
+    CFMutableDictionaryRef _keyIndex;       // key -> 节点下标
+    CFMutableDictionaryRef _sequenceIndex;  // 序列号 -> 节点下标
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval slotCount:(NSUInteger)slotCount queue:(dispatch_queue_t)queue {
+    if (self = [super init]) {
+        _queue = queue;
+        _tickInterval = tickInterval > 0 ? tickInterval : 0.1;
+        _tickNanoseconds = MAX((uint64_t)(_tickInterval * NSEC_PER_SEC), 1ull);
+        
+        uint32_t slots = 1;
+        while (slots < MAX(slotCount, (NSUInteger)2)) {
+            slots <<= 1;
+        }
+        _slotMask = slots - 1;
+        _slotHeads = malloc(slots * sizeof(uint32_t));
+        memset(_slotHeads, 0xFF, slots * sizeof(uint32_t));
+        
+        _freeHead = kTJPTimerNodeNil;
+        _keyIndex = CFDictionaryCreateMutable(NULL, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+        _sequenceIndex = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+        _currentTick = [self nowTick];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self stopTicking];
+    for (uint32_t i = 0; i < _nodeCapacity; i++) {
+        if (_nodes[i].key) {
+            CFRelease(_nodes[i].key);
+        }
+    }
+    free(_nodes);
+    free(_slotHeads);
+    CFRelease(_keyIndex);
+    CFRelease(_sequenceIndex);
+}
+
+#pragma mark - Public Method
+- (void)scheduleKey:(NSString *)key sequence:(uint32_t)sequence afterInterval:(NSTimeInterval)interval {
+    NSParameterAssert(key);
+    [self cancelKey:key];
+    
+    // 计时器落后于当前时间时以当前时间为基准
+    uint64_t baseTick = MAX(_currentTick, [self nowTick]);
+    if (_count == 0) {
+        _currentTick = baseTick;
+    }
+    uint64_t ticks = (uint64_t)ceil(MAX(interval, 0) * NSEC_PER_SEC / _tickNanoseconds);
+    uint64_t deadline = baseTick + MAX(ticks, 1ull);
+    
+    uint32_t index = [self allocateNode];
+    TJPTimerWheelNode *node = &_nodes[index];
+    node->deadline = deadline;
+    node->sequence = sequence;
+    node->key = CFStringCreateCopy(NULL, (__bridge CFStringRef)key);
+    
+    // 头插到槽链表
+    uint32_t slot = (uint32_t)(deadline & _slotMask);
+    node->prev = kTJPTimerNodeNil;
+    node->next = _slotHeads[slot];
+    if (node->next != kTJPTimerNodeNil) {
+        _nodes[node->next].prev = index;
+    }
+    _slotHeads[slot] = index;
+    
+    CFDictionarySetValue(_keyIndex, node->key, TJPTimerIndexToValue(index));
+    CFDictionarySetValue(_sequenceIndex, TJPTimerIndexToValue(sequence), TJPTimerIndexToValue(index));
+    _count++;
+    
+    [self startTickingIfNeeded];
+}
+
+- (BOOL)cancelKey:(NSString *)key {
+    const void *value = NULL;
+    if (!key || !CFDictionaryGetValueIfPresent(_keyIndex, (__bridge CFStringRef)key, &value)) {
+        return NO;
+    }
+    [self removeNodeAtIndex:TJPTimerValueToIndex(value)];
+    return YES;
+}
+
+- (BOOL)cancelSequence:(uint32_t)sequence {
+    const void *value = NULL;
+    if (!CFDictionaryGetValueIfPresent(_sequenceIndex, TJPTimerIndexToValue(sequence), &value)) {
+        return NO;
+    }
+    [self removeNodeAtIndex:TJPTimerValueToIndex(value)];
+    return YES;
+}
+
+- (BOOL)containsKey:(NSString *)key {
+    return key && CFDictionaryContainsKey(_keyIndex, (__bridge CFStringRef)key);
+}
+
+- (void)cancelAll {
+    for (uint32_t i = 0; i < _nodeCapacity; i++) {
+        if (_nodes[i].key) {
+            CFRelease(_nodes[i].key);
+            _nodes[i].key = NULL;
+        }
+        _nodes[i].next = (i + 1 < _nodeCapacity) ? i + 1 : kTJPTimerNodeNil;
+    }
+    _freeHead = _nodeCapacity > 0 ? 0 : kTJPTimerNodeNil;
+    memset(_slotHeads, 0xFF, (_slotMask + 1) * sizeof(uint32_t));
+    CFDictionaryRemoveAllValues(_keyIndex);
+    CFDictionaryRemoveAllValues(_sequenceIndex);
+    _count = 0;
+    
+    [self stopTicking];
+}
+
+- (void)advanceTicks:(uint64_t)ticks {
+    [self expireTimersThroughTick:_currentTick + ticks];
+}
+
+#pragma mark - Private Method
+- (uint64_t)nowTick {
+    // 与dispatch_time一致 设备休眠期间不计时
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW) / _tickNanoseconds;
+}
+
+- (void)expireTimersThroughTick:(uint64_t)targetTick {
+    if (targetTick <= _currentTick) {
+        return;
+    }
+    
+    // 落后超过一圈时每个槽只需扫描一次
+    NSMutableArray<NSString *> *expiredKeys = nil;
+    uint64_t steps = MIN(targetTick - _currentTick, (uint64_t)_slotMask + 1);
+    for (uint64_t step = 1; step <= steps; step++) {
+        uint32_t index = _slotHeads[(_currentTick + step) & _slotMask];
+        while (index != kTJPTimerNodeNil) {
+            uint32_t next = _nodes[index].next;
+            // 未满一圈的任务留在槽中
+            if (_nodes[index].deadline <= targetTick) {
+                if (!expiredKeys) {
+                    expiredKeys = [NSMutableArray array];
+                }
+                [expiredKeys addObject:(__bridge NSString *)_nodes[index].key];
+                [self removeNodeAtIndex:index];
+            }
+            index = next;
+        }
+    }
+    _currentTick = targetTick;
+    
+    if (_count == 0) {
+        [self stopTicking];
+    }
+    
+    // 状态更新完成后回调 回调中可重新安排任务
+    if (expiredKeys.count > 0 && self.expirationHandler) {
+        self.expirationHandler(expiredKeys);
+    }
+}
+
+- (uint32_t)allocateNode {
+    if (_freeHead == kTJPTimerNodeNil) {
+        uint32_t oldCapacity = _nodeCapacity;
+        uint32_t newCapacity = oldCapacity > 0 ? oldCapacity * 2 : kTJPTimerInitialNodeCapacity;
+        _nodes = realloc(_nodes, newCapacity * sizeof(TJPTimerWheelNode));
+        memset(_nodes + oldCapacity, 0, (newCapacity - oldCapacity) * sizeof(TJPTimerWheelNode));
+        for (uint32_t i = oldCapacity; i < newCapacity; i++) {
+            _nodes[i].next = (i + 1 < newCapacity) ? i + 1 : kTJPTimerNodeNil;
+        }
+        _freeHead = oldCapacity;
+        _nodeCapacity = newCapacity;
+    }
+    
+    uint32_t index = _freeHead;
+    _freeHead = _nodes[index].next;
+    return index;
+}
+
+- (void)removeNodeAtIndex:(uint32_t)index {
+    TJPTimerWheelNode *node = &_nodes[index];
+    
+    // 从槽链表摘除
+    if (node->prev != kTJPTimerNodeNil) {
+        _nodes[node->prev].next = node->next;
+    } else {
+        _slotHeads[node->deadline & _slotMask] = node->next;
+    }
+    if (node->next != kTJPTimerNodeNil) {
+        _nodes[node->next].prev = node->prev;
+    }
+    
+    // 序列号可能已被其他任务复用 只移除指向自己的索引
+    const void *value = NULL;
+    if (CFDictionaryGetValueIfPresent(_sequenceIndex, TJPTimerIndexToValue(node->sequence), &value) && TJPTimerValueToIndex(value) == index) {
+        CFDictionaryRemoveValue(_sequenceIndex, TJPTimerIndexToValue(node->sequence));
+    }
+    CFDictionaryRemoveValue(_keyIndex, node->key);
+    CFRelease(node->key);
+    node->key = NULL;
+    
+    node->next = _freeHead;
+    _freeHead = index;
+    _count--;
+}
+
+- (void)startTickingIfNeeded {
+    if (_tickSource) {
+        return;
+    }
+    
+    _tickSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+    dispatch_source_set_timer(_tickSource,
+                              dispatch_time(DISPATCH_TIME_NOW, (int64_t)_tickNanoseconds),
+                              _tickNanoseconds,
+                              _tickNanoseconds / 10);
+    
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(_tickSource, ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) return;
+        [strongSelf expireTimersThroughTick:[strongSelf nowTick]];
+    });
+    dispatch_resume(_tickSource);
+}
+
+- (void)stopTicking {
+    if (_tickSource) {
+        dispatch_source_cancel(_tickSource);
+        _tickSource = nil;
+    }
+}
+
+@end
@@ -22,6 +22,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)stop;
 - (void)sendACKForSequence:(uint32_t)seq toSocket:(GCDAsyncSocket *)socket;
 - (void)sendHeartbeatACKForSequence:(uint32_t)seq toSocket:(GCDAsyncSocket *)socket;
+/// 向客户端推送一条普通数据消息
+- (void)sendDataPayload:(NSData *)payload toSocket:(GCDAsyncSocket *)socket;
 
 @end
 
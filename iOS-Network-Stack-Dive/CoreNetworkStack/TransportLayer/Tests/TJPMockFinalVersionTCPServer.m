@@ -11,6 +11,9 @@
 #import "TJPNetworkUtil.h"
 #import "TJPSequenceManager.h"
 #import "TJPNetworkDefine.h"
+#import "TJPSelectiveAck.h"
+#import "TJPFragmentReassembler.h"
+#import "TJPCompressionCodec.h"
 
 static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
 
@@ -19,6 +22,15 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
 
 @property (nonatomic, strong) TJPSequenceManager *sequenceManager;
 
+// 已协商选择性确认的客户端 -> 待确认序列号
+@property (nonatomic, strong) NSMapTable<GCDAsyncSocket *, NSMutableIndexSet *> *pendingAckSequences;
+
+// 大消息分片重组
+@property (nonatomic, strong) TJPFragmentReassembler *fragmentReassembler;
+
+// 消息体解压
+@property (nonatomic, strong) TJPCompressionCodec *compressionCodec;
+
 
 @end
 
@@ -33,6 +45,9 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
     if (self) {
         _connectedSockets = [NSMutableArray array];
         _receiveBuffer = [NSMutableData data];
+        _pendingAckSequences = [NSMapTable weakToStrongObjectsMapTable];
+        _fragmentReassembler = [[TJPFragmentReassembler alloc] initWithMaxTransfers:TJP_FRAGMENT_MAX_REASSEMBLIES timeout:TJP_FRAGMENT_REASSEMBLY_TIMEOUT];
+        _compressionCodec = [[TJPCompressionCodec alloc] init];
         
         // 初始化服务器端序列号管理器
         _sequenceManager = [[TJPSequenceManager alloc] initWithSessionId:@"mock_server_session"];
@@ -116,6 +131,19 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
         return;
     }
     
+    // 校验和覆盖压缩数据 校验通过后解压
+    if (compressType == TJPCompressTypeZlib) {
+        NSError *decompressError = nil;
+        NSData *inflated = [self.compressionCodec decompressData:payload error:&decompressError];
+        if (!inflated) {
+            NSLog(@"[MOCK SERVER] 解压失败: %@", decompressError.localizedDescription);
+            [sock disconnect];
+            return;
+        }
+        NSLog(@"[MOCK SERVER] 解压消息体: %lu -> %lu 字节", (unsigned long)payload.length, (unsigned long)inflated.length);
+        payload = inflated;
+    }
+    
     // 根据消息类型验证序列号类别
     [self validateReceivedMessage:msgType sequence:seq];
     
@@ -127,8 +155,12 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
             if (self.didReceiveDataHandler) {
                 self.didReceiveDataHandler(payload, seq);
             }
-            // 发送传输层ACK
-            [self sendACKForSequence:seq sessionId:sessionId toSocket:sock];
+            // 发送传输层ACK 已协商选择性确认时累计发送
+            if ([self.pendingAckSequences objectForKey:sock]) {
+                [self scheduleSelectiveACKForSequence:seq sessionId:sessionId toSocket:sock];
+            } else {
+                [self sendACKForSequence:seq sessionId:sessionId toSocket:sock];
+            }
             
             // 模拟接收端自动发送已读回执
             [self simulateAutoReadReceiptForMessage:seq sessionId:sessionId toSocket:sock];
@@ -180,8 +212,33 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
         }
         break;
             
+        case TJPMessageTypeFragment: // 大消息分片
+        {
+            NSData *completedData = nil;
+            TJPFragmentReassemblyResult result = [self.fragmentReassembler appendFragmentPayload:payload completedData:&completedData];
+            if (result == TJPFragmentReassemblyResultInvalid) {
+                NSLog(@"[MOCK SERVER] 丢弃无效分片，序列号: %u", seq);
+                break;
+            }
+            
+            NSLog(@"[MOCK SERVER] 🧩 处理消息分片，序列号: %u", seq);
+            if ([self.pendingAckSequences objectForKey:sock]) {
+                [self scheduleSelectiveACKForSequence:seq sessionId:sessionId toSocket:sock];
+            } else {
+                [self sendACKForSequence:seq sessionId:sessionId toSocket:sock];
+            }
+            
+            if (result == TJPFragmentReassemblyResultCompleted) {
+                NSLog(@"[MOCK SERVER] 分片重组完成，消息大小: %lu 字节", (unsigned long)completedData.length);
+                if (self.didReceiveDataHandler) {
+                    self.didReceiveDataHandler(completedData, seq);
+                }
+            }
+        }
+            break;
+            
         case TJPMessageTypeACK:  // 🔧 添加这个
-            NSLog(@"[MOCK SERVER] 收到ACK确认，序列号: %u", seq);
+            NSLog(@"[MOCK SERVER] 收到ACK确认，序列号: %u, 包体长度: %lu", seq, (unsigned long)payload.length);
             // ACK消息通常不需要特殊处理，只需要记录即可
             break;
             
@@ -207,6 +264,7 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
 
 - (void)socketDidDisconnect:(GCDAsyncSocket *)sock withError:(NSError *)err {
     [self.connectedSockets removeObject:sock];
+    [self.pendingAckSequences removeObjectForKey:sock];
 }
 
 - (void)socket:(GCDAsyncSocket *)sock didReceiveError:(NSError *)error {
@@ -249,6 +307,40 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
 
 }
 
+- (void)scheduleSelectiveACKForSequence:(uint32_t)seq sessionId:(uint16_t)sessionId toSocket:(GCDAsyncSocket *)socket {
+    NSMutableIndexSet *pending = [self.pendingAckSequences objectForKey:socket];
+    BOOL wasEmpty = pending.count == 0;
+    [pending addIndex:seq];
+    
+    if (pending.count >= TJP_DELAYED_ACK_MAX_PACKETS) {
+        [self flushSelectiveACKWithSessionId:sessionId toSocket:socket];
+        return;
+    }
+    
+    if (wasEmpty) {
+        __weak typeof(socket) weakSocket = socket;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(TJP_DELAYED_ACK_INTERVAL * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            GCDAsyncSocket *strongSocket = weakSocket;
+            if (strongSocket) {
+                [self flushSelectiveACKWithSessionId:sessionId toSocket:strongSocket];
+            }
+        });
+    }
+}
+
+- (void)flushSelectiveACKWithSessionId:(uint16_t)sessionId toSocket:(GCDAsyncSocket *)socket {
+    NSMutableIndexSet *pending = [self.pendingAckSequences objectForKey:socket];
+    if (pending.count == 0) {
+        return;
+    }
+    
+    NSData *ackData = [TJPSelectiveAck ackPacketWithSequences:pending sessionID:sessionId];
+    NSLog(@"[MOCK SERVER] 📤 发送SACK确认包，确认 %lu 个序列号，起始序列号: %lu", (unsigned long)pending.count, (unsigned long)pending.firstIndex);
+    [pending removeAllIndexes];
+    
+    [socket writeData:ackData withTimeout:10.0 tag:0];
+}
+
 - (void)sendControlACKForSequence:(uint32_t)seq sessionId:(uint16_t)sessionId toSocket:(GCDAsyncSocket *)socket {
     NSLog(@"[MOCK SERVER] 📤 准备发送控制消息ACK，序列号: %u", seq);
 
@@ -358,7 +450,11 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
     uint8_t serverMajorVersion = kProtocolVersionMajor;
     uint8_t serverMinorVersion = kProtocolVersionMinor;
     uint16_t serverVersion = (serverMajorVersion << 8) | serverMinorVersion;
-    uint16_t agreedFeatures = features & 0x000F; // 仅支持客户端请求的部分功能
+    uint16_t agreedFeatures = features & (0x000F | TJP_FEATURE_SELECTIVE_ACK | TJP_FEATURE_FRAGMENTATION | TJP_FEATURE_COMPRESSION_DICTIONARY); // 仅支持客户端请求的部分功能
+    
+    if (agreedFeatures & TJP_FEATURE_SELECTIVE_ACK) {
+        [self.pendingAckSequences setObject:[NSMutableIndexSet indexSet] forKey:socket];
+    }
 
     // 构建TLV数据
     NSMutableData *tlvData = [NSMutableData data];
@@ -555,6 +651,27 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
     NSLog(@"[MOCK SERVER] ✅ 已读回执ACK已发送，序列号: %u", seq);
 }
 
+// 推送普通数据消息
+- (void)sendDataPayload:(NSData *)payload toSocket:(GCDAsyncSocket *)socket {
+    TJPFinalAdavancedHeader header = {0};
+    header.magic = htonl(kProtocolMagic);
+    header.version_major = kProtocolVersionMajor;
+    header.version_minor = kProtocolVersionMinor;
+    header.msgType = htons(TJPMessageTypeNormalData);
+    header.sequence = htonl([self.sequenceManager nextSequenceForCategory:TJPMessageCategoryNormal]);
+    header.timestamp = htonl((uint32_t)[[NSDate date] timeIntervalSince1970]);
+    header.encrypt_type = TJPEncryptTypeNone;
+    header.compress_type = TJPCompressTypeNone;
+    header.session_id = htons(1234); // 简化处理
+    header.bodyLength = htonl((uint32_t)payload.length);
+    // 与客户端解析器的比较方式一致 按主机字节序写入
+    header.checksum = [TJPNetworkUtil crc32ForData:payload];
+    
+    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packet appendData:payload];
+    [socket writeData:packet withTimeout:-1 tag:0];
+}
+
 - (NSString *)featureDescriptionWithFlags:(uint16_t)flags {
     NSMutableString *desc = [NSMutableString string];
     
@@ -563,6 +680,9 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
     if (flags & 0x0004) [desc appendString:@"压缩 "];
     if (flags & 0x0008) [desc appendString:@"已读回执 "];
     if (flags & 0x0010) [desc appendString:@"群聊 "];
+    if (flags & 0x0020) [desc appendString:@"选择性确认 "];
+    if (flags & 0x0040) [desc appendString:@"分片 "];
+    if (flags & 0x0080) [desc appendString:@"字典压缩 "];
     
     return desc.length > 0 ? desc : @"无特性";
 }
@@ -626,6 +746,7 @@ static const NSUInteger kHeaderLength = sizeof(TJPFinalAdavancedHeader);
     switch (msgType) {
         case TJPMessageTypeNormalData:
         case TJPMessageTypeReadReceipt:
+        case TJPMessageTypeFragment:
             expectedCategory = TJPMessageCategoryNormal;
             break;
         case TJPMessageTypeControl:
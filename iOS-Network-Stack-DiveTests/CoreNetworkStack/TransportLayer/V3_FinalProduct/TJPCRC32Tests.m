@@ -0,0 +1,114 @@
+//
+//  TJPCRC32Tests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/5.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import "TJPCRC32.h"
+#import "TJPNetworkUtil.h"
+
+static const NSUInteger kBenchmarkTotalBytes = 256 * 1024 * 1024;   // 每个尺寸累计处理256MB
+
+@interface TJPCRC32Tests : XCTestCase
+
+@property (nonatomic, strong) NSData *randomData;
+
+@end
+
+@implementation TJPCRC32Tests
+
+- (void)setUp {
+    NSMutableData *data = [NSMutableData dataWithLength:10 * 1024 * 1024 + 64];
+    arc4random_buf(data.mutableBytes, data.length);
+    self.randomData = data;
+}
+
+- (void)tearDown {
+    self.randomData = nil;
+}
+
+#pragma mark - 功能测试
+- (void)testAllImplementationsMatchZlib {
+    const uint8_t *bytes = self.randomData.bytes;
+    NSArray<NSNumber *> *implementations = @[@(TJPCRC32ImplementationSliceBy8), @(TJPCRC32ImplementationHardware)];
+
+    // 覆盖各种长度和未对齐起始地址
+    for (NSUInteger length = 0; length < 1100; length++) {
+        for (NSUInteger offset = 0; offset < 9; offset++) {
+            uint32_t expected = (uint32_t)crc32(0, bytes + offset, (uInt)length);
+            for (NSNumber *implementation in implementations) {
+                uint32_t actual = [TJPCRC32 updateCRC:0 bytes:bytes + offset length:length implementation:implementation.unsignedIntegerValue];
+                if (actual != expected) {
+                    XCTFail(@"实现%@结果不一致: 长度 %lu 偏移 %lu", implementation, (unsigned long)length, (unsigned long)offset);
+                    return;
+                }
+            }
+        }
+    }
+
+    // 已知向量
+    XCTAssertEqual([TJPCRC32 updateCRC:0 bytes:"123456789" length:9], 0xCBF43926);
+    XCTAssertEqual([TJPCRC32 updateCRC:0 bytes:NULL length:0], 0);
+}
+
+- (void)testIncrementalUpdateAcrossSegments {
+    const uint8_t *bytes = self.randomData.bytes;
+    NSUInteger length = 1024 * 1024;
+    uint32_t expected = (uint32_t)crc32(0, bytes, (uInt)length);
+
+    // 模拟环形缓冲区两段视图和流式到达的不规则分段
+    for (NSNumber *split in @[@1, @7, @63, @64, @65, @4096, @(length - 1)]) {
+        NSUInteger first = split.unsignedIntegerValue;
+        uint32_t crc = [TJPCRC32 updateCRC:0 bytes:bytes length:first];
+        crc = [TJPCRC32 updateCRC:crc bytes:bytes + first length:length - first];
+        XCTAssertEqual(crc, expected, @"分段位置 %lu 增量结果应一致", (unsigned long)first);
+    }
+
+    uint32_t streamed = 0;
+    NSUInteger offset = 0;
+    while (offset < length) {
+        NSUInteger chunk = MIN((NSUInteger)arc4random_uniform(3000) + 1, length - offset);
+        streamed = [TJPNetworkUtil crc32UpdateWithCRC:streamed bytes:bytes + offset length:chunk];
+        offset += chunk;
+    }
+    XCTAssertEqual(streamed, expected, @"流式增量结果应一致");
+    XCTAssertEqual([TJPNetworkUtil crc32ForData:[self.randomData subdataWithRange:NSMakeRange(0, length)]], expected);
+}
+
+#pragma mark - 基准测试
+- (void)testThroughputBenchmark {
+    NSLog(@"\n=== CRC32 吞吐量基准测试 (当前实现: %lu) ===", (unsigned long)TJPCRC32.activeImplementation);
+    NSLog(@"%10@ | %10@ | %10@ | %10@", @"大小", @"zlib", @"slice-by-8", @"硬件");
+
+    NSArray<NSNumber *> *sizes = @[@64, @256, @1024, @(16 * 1024), @(256 * 1024), @(1024 * 1024), @(10 * 1024 * 1024)];
+    for (NSNumber *size in sizes) {
+        NSUInteger length = size.unsignedIntegerValue;
+        double zlibRate = [self throughputForImplementation:TJPCRC32ImplementationZlib length:length];
+        double sliceRate = [self throughputForImplementation:TJPCRC32ImplementationSliceBy8 length:length];
+        double hardwareRate = [self throughputForImplementation:TJPCRC32ImplementationHardware length:length];
+        NSLog(@"%10lu | %7.2fGB/s | %7.2fGB/s | %7.2fGB/s", (unsigned long)length, zlibRate, sliceRate, hardwareRate);
+
+        if (length >= 1024 && [TJPCRC32 isImplementationAvailable:TJPCRC32ImplementationHardware]) {
+            XCTAssertGreaterThan(hardwareRate, sliceRate, @"硬件加速应快于查表实现");
+        }
+    }
+}
+
+- (double)throughputForImplementation:(TJPCRC32Implementation)implementation length:(NSUInteger)length {
+    const uint8_t *bytes = self.randomData.bytes;
+    NSUInteger iterations = MAX(kBenchmarkTotalBytes / length, (NSUInteger)1);
+    volatile uint32_t sink = 0;
+
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < iterations; i++) {
+        sink ^= [TJPCRC32 updateCRC:0 bytes:bytes length:length implementation:implementation];
+    }
+    CFTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+
+    return (double)iterations * length / duration / 1e9;
+}
+
+@end
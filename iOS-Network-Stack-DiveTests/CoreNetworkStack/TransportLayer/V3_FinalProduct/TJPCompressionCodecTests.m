@@ -0,0 +1,227 @@
+//
+//  TJPCompressionCodecTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/15.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import "TJPCompressionCodec.h"
+#import "TJPMessageContext.h"
+#import "TJPMessageParser.h"
+#import "TJPParsedPacket.h"
+#import "TJPMessageSerializer.h"
+#import "TJPNetworkUtil.h"
+#import "TJPNetworkErrorDefine.h"
+
+static const NSUInteger kCompressionBenchmarkIterations = 2000;  // 基准测试次数
+
+@interface TJPCompressionCodecTests : XCTestCase
+
+@end
+
+@implementation TJPCompressionCodecTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+/// 可压缩的文本消息TLV
+- (NSData *)textPayloadWithRepeat:(NSUInteger)repeat {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < repeat; i++) {
+        [text appendFormat:@"第%lu条测试消息 hello world ", (unsigned long)i % 10];
+    }
+    return [TJPMessageSerializer serializeText:text tag:TJPContentTypeText];
+}
+
+- (NSData *)randomDataWithLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+#pragma mark - 功能测试
+- (void)testCompressRoundTripReusesStreams {
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    for (NSUInteger i = 1; i <= 5; i++) {
+        NSData *payload = [self textPayloadWithRepeat:100 * i];
+        NSTimeInterval cpuTime = -1;
+        NSData *compressed = [codec compressData:payload cpuTime:&cpuTime];
+        XCTAssertNotNil(compressed);
+        XCTAssertLessThan(compressed.length, payload.length);
+        XCTAssertGreaterThanOrEqual(cpuTime, 0);
+        
+        // 每条消息独立成流 可用一次性接口解压
+        XCTAssertEqualObjects([TJPNetworkUtil decompressData:compressed], payload);
+        XCTAssertEqualObjects([codec decompressData:compressed error:NULL], payload);
+    }
+    
+    NSDictionary *stats = [codec statistics];
+    XCTAssertEqual([stats[@"compressedMessages"] integerValue], 5);
+    XCTAssertEqual([stats[@"inflatedMessages"] integerValue], 5);
+    XCTAssertLessThan([stats[@"compressionRatio"] doubleValue], 1.0);
+}
+
+- (void)testSkipsSmallAndIncompressiblePayloads {
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    
+    // 低于阈值
+    XCTAssertNil([codec compressData:[self textPayloadWithRepeat:1] cpuTime:NULL]);
+    
+    // 图片内容标签
+    NSMutableData *image = [[TJPMessageSerializer serializeText:[@"" stringByPaddingToLength:4096 withString:@"a" startingAtIndex:0] tag:TJPContentTypeImage] mutableCopy];
+    XCTAssertFalse([codec shouldCompressData:image]);
+    
+    // TLV包裹的JPEG
+    NSMutableData *jpeg = [NSMutableData dataWithLength:4096];
+    uint8_t *bytes = jpeg.mutableBytes;
+    bytes[0] = 0x10; bytes[1] = 0x07;
+    bytes[6] = 0xFF; bytes[7] = 0xD8; bytes[8] = 0xFF;
+    XCTAssertFalse([codec shouldCompressData:jpeg]);
+    
+    // 随机数据压缩收益不足
+    NSData *random = [self randomDataWithLength:8192];
+    XCTAssertNil([codec compressData:random cpuTime:NULL]);
+    
+    XCTAssertEqual([[codec statistics][@"compressedMessages"] integerValue], 0);
+}
+
+- (void)testShortPayloadWithZeroThreshold {
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    codec.minimumLength = 0;
+    
+    // 不足两字节时没有内容标签可读
+    uint8_t byte = 0x10;
+    XCTAssertFalse([codec shouldCompressData:[NSData data]]);
+    XCTAssertFalse([codec shouldCompressData:[NSData dataWithBytes:&byte length:1]]);
+}
+
+- (void)testDecompressionOutputIsCapped {
+    // 16MB的0压缩后只有十几KB
+    NSData *bomb = [TJPNetworkUtil compressData:[NSMutableData dataWithLength:16 * 1024 * 1024]];
+    XCTAssertNotNil(bomb);
+    XCTAssertLessThan(bomb.length, 64 * 1024);
+    
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    codec.maximumInflatedLength = 1024 * 1024;
+    NSError *error = nil;
+    XCTAssertNil([codec decompressData:bomb error:&error]);
+    XCTAssertEqual(error.code, TJPErrorProtocolDecompressedTooLarge);
+    XCTAssertEqual([[codec statistics][@"rejectedMessages"] integerValue], 1);
+    
+    // 一次性接口同样受上限保护
+    XCTAssertNil([TJPNetworkUtil decompressData:bomb]);
+    
+    // 拒绝后流已重置 仍可正常解压
+    NSData *payload = [self textPayloadWithRepeat:100];
+    XCTAssertEqualObjects([codec decompressData:[TJPNetworkUtil compressData:payload] error:NULL], payload);
+}
+
+- (void)testCorruptedAndSegmentedInput {
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    NSData *payload = [self textPayloadWithRepeat:200];
+    NSData *compressed = [codec compressData:payload cpuTime:NULL];
+    
+    // 截断
+    NSError *error = nil;
+    XCTAssertNil([codec decompressData:[compressed subdataWithRange:NSMakeRange(0, compressed.length / 2)] error:&error]);
+    XCTAssertEqual(error.code, TJPErrorProtocolDecompressionFailed);
+    
+    // 尾部多余数据
+    NSMutableData *trailing = [compressed mutableCopy];
+    [trailing appendBytes:"xx" length:2];
+    XCTAssertNil([codec decompressData:trailing error:NULL]);
+    
+    // 环形缓冲区跨越尾部时分两段输入
+    NSUInteger split = compressed.length / 3;
+    NSData *segmented = [codec decompressBytes:compressed.bytes length:split secondBytes:(const uint8_t *)compressed.bytes + split length:compressed.length - split error:NULL];
+    XCTAssertEqualObjects(segmented, payload);
+}
+
+- (void)testContextCompressesWirePayload {
+    NSData *payload = [self textPayloadWithRepeat:200];
+    TJPMessageContext *context = [TJPMessageContext contextWithData:payload seq:1 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeZlib sessionId:@"test-session"];
+    [context compressPayloadWithCodec:[[TJPCompressionCodec alloc] init]];
+    
+    XCTAssertEqual(context.compressType, TJPCompressTypeZlib);
+    XCTAssertLessThan(context.wirePayload.length, payload.length);
+    XCTAssertLessThan(context.compressionRatio, 1.0);
+    XCTAssertEqualObjects(context.payload, payload, @"原始载荷保持不变");
+    
+    NSData *packet = (NSData *)[context buildPacketData];
+    const TJPFinalAdavancedHeader *header = packet.bytes;
+    XCTAssertEqual(ntohl(header->bodyLength), context.wirePayload.length);
+    
+    // 不值得压缩时改为不压缩
+    TJPMessageContext *small = [TJPMessageContext contextWithData:[self textPayloadWithRepeat:1] seq:2 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeZlib sessionId:@"test-session"];
+    [small compressPayloadWithCodec:[[TJPCompressionCodec alloc] init]];
+    XCTAssertEqual(small.compressType, TJPCompressTypeNone);
+    XCTAssertEqualObjects(small.wirePayload, small.payload);
+}
+
+- (void)testParserInflatesCompressedPackets {
+    NSData *payload = [self textPayloadWithRepeat:200];
+    NSData *compressed = [TJPNetworkUtil compressData:payload];
+    
+    TJPFinalAdavancedHeader header = {0};
+    header.magic = htonl(kProtocolMagic);
+    header.version_major = kProtocolVersionMajor;
+    header.version_minor = kProtocolVersionMinor;
+    header.msgType = htons(TJPMessageTypeNormalData);
+    header.sequence = htonl(1);
+    header.timestamp = htonl((uint32_t)[[NSDate date] timeIntervalSince1970]);
+    header.encrypt_type = TJPEncryptTypeNone;
+    header.compress_type = TJPCompressTypeZlib;
+    header.bodyLength = htonl((uint32_t)compressed.length);
+    header.checksum = [TJPNetworkUtil crc32ForData:compressed];
+    
+    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packet appendData:compressed];
+    
+    for (NSNumber *ringBuffer in @[@NO, @YES]) {
+        TJPMessageParser *parser = [[TJPMessageParser alloc] initWithRingBufferEnabled:ringBuffer.boolValue];
+        [parser feedData:packet];
+        TJPParsedPacket *parsed = [parser nextPacket];
+        XCTAssertNotNil(parsed);
+        XCTAssertEqualObjects(parsed.payload, payload);
+    }
+}
+
+#pragma mark - 基准测试
+- (void)testPooledStreamBenchmark {
+    NSLog(@"\n=== 压缩流复用基准测试 (%lu 次) ===", (unsigned long)kCompressionBenchmarkIterations);
+    NSData *payload = [self textPayloadWithRepeat:100];
+    
+    // 旧实现: 每条消息deflateInit/deflateEnd
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < kCompressionBenchmarkIterations; i++) {
+        @autoreleasepool {
+            [TJPNetworkUtil compressData:payload];
+        }
+    }
+    CFTimeInterval oneShotDuration = CFAbsoluteTimeGetCurrent() - start;
+    
+    // 新实现: 复用deflate流 只做Reset
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < kCompressionBenchmarkIterations; i++) {
+        @autoreleasepool {
+            [codec compressData:payload cpuTime:NULL];
+        }
+    }
+    CFTimeInterval pooledDuration = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSDictionary *stats = [codec statistics];
+    NSLog(@"消息大小: %lu 字节, 压缩率: %.2f", (unsigned long)payload.length, [stats[@"compressionRatio"] doubleValue]);
+    NSLog(@"每次初始化: %.2f 条/秒", kCompressionBenchmarkIterations / oneShotDuration);
+    NSLog(@"复用压缩流: %.2f 条/秒", kCompressionBenchmarkIterations / pooledDuration);
+    NSLog(@"提升倍数: %.2fx", oneShotDuration / pooledDuration);
+    
+    XCTAssertEqual([stats[@"compressedMessages"] integerValue], kCompressionBenchmarkIterations);
+}
+
+@end
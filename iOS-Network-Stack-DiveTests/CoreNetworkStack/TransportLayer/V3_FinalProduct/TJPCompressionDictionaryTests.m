@@ -0,0 +1,148 @@
+//
+//  TJPCompressionDictionaryTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/16.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import "TJPCompressionCodec.h"
+#import "TJPCompressionDictionary.h"
+#import "TJPMessageSerializer.h"
+#import "TJPNetworkDefine.h"
+#import "TJPNetworkErrorDefine.h"
+
+@interface TJPCompressionDictionaryTests : XCTestCase
+
+@end
+
+@implementation TJPCompressionDictionaryTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+/// 典型短消息语料
+- (NSArray<NSData *> *)shortMessageCorpus {
+    NSArray<NSString *> *texts = @[
+        @"好的收到", @"你在哪", @"明天一起吃饭吗？", @"我们一起去开会吧，现在在哪个地方",
+        @"ok thanks, see you later", @"sorry for the late reply, I'm on my way", @"哈哈哈哈 没问题",
+        @"good morning! do you have a moment?", @"辛苦了，早上好", @"稍等一下，马上到了",
+        @"今天晚上几点下班", @"{\"type\":\"text\",\"content\":\"hello\"}", @"收到，谢谢",
+        @"can you please send me the file", @"你们什么时候到", @"晚安", @"嗯嗯 知道了",
+        @"let me know when you are free",
+    ];
+    NSMutableArray<NSData *> *corpus = [NSMutableArray arrayWithCapacity:texts.count];
+    for (NSString *text in texts) {
+        [corpus addObject:[TJPMessageSerializer serializeText:text tag:TJPContentTypeText]];
+    }
+    return corpus;
+}
+
+- (TJPCompressionCodec *)dictionaryCodec {
+    TJPCompressionCodec *codec = [[TJPCompressionCodec alloc] init];
+    codec.presetDictionary = [TJPCompressionDictionary defaultDictionary];
+    codec.minimumLength = TJP_COMPRESSION_DICTIONARY_MIN_SIZE;
+    return codec;
+}
+
+#pragma mark - 功能测试
+- (void)testDictionaryRoundTrip {
+    TJPCompressionCodec *sender = [self dictionaryCodec];
+    // 接收端未配置字典 按流头部的字典ID自动选择
+    TJPCompressionCodec *receiver = [[TJPCompressionCodec alloc] init];
+
+    NSUInteger compressedCount = 0;
+    for (NSData *payload in [self shortMessageCorpus]) {
+        NSData *compressed = [sender compressData:payload cpuTime:NULL];
+        if (!compressed) {
+            continue;
+        }
+        compressedCount++;
+        XCTAssertLessThan(compressed.length, payload.length);
+        XCTAssertEqualObjects([receiver decompressData:compressed error:NULL], payload);
+    }
+    XCTAssertGreaterThan(compressedCount, 0);
+    XCTAssertEqual([[sender statistics][@"dictionaryMessages"] integerValue], compressedCount);
+}
+
+- (void)testDictionaryIdIsAdler32 {
+    NSData *dictionary = [TJPCompressionDictionary defaultDictionary];
+    uLong adler = adler32(adler32(0L, Z_NULL, 0), dictionary.bytes, (uInt)dictionary.length);
+    XCTAssertEqual([TJPCompressionDictionary defaultDictionaryId], (uint32_t)adler);
+    XCTAssertEqualObjects([TJPCompressionDictionary dictionaryForId:(uint32_t)adler], dictionary);
+    XCTAssertNil([TJPCompressionDictionary dictionaryForId:(uint32_t)adler + 1]);
+}
+
+- (void)testUnknownDictionaryIdFails {
+    // 用另一份字典压缩 接收端不认识其字典ID
+    NSData *payload = [TJPMessageSerializer serializeText:@"hello hello hello hello hello" tag:TJPContentTypeText];
+    NSData *unknownDictionary = [@"hello world" dataUsingEncoding:NSUTF8StringEncoding];
+
+    z_stream stream = {0};
+    XCTAssertEqual(deflateInit(&stream, Z_DEFAULT_COMPRESSION), Z_OK);
+    deflateSetDictionary(&stream, unknownDictionary.bytes, (uInt)unknownDictionary.length);
+    NSMutableData *compressed = [NSMutableData dataWithLength:deflateBound(&stream, payload.length)];
+    stream.next_in = (Bytef *)payload.bytes;
+    stream.avail_in = (uInt)payload.length;
+    stream.next_out = compressed.mutableBytes;
+    stream.avail_out = (uInt)compressed.length;
+    XCTAssertEqual(deflate(&stream, Z_FINISH), Z_STREAM_END);
+    compressed.length = stream.total_out;
+    deflateEnd(&stream);
+
+    TJPCompressionCodec *receiver = [[TJPCompressionCodec alloc] init];
+    NSError *error = nil;
+    XCTAssertNil([receiver decompressData:compressed error:&error]);
+    XCTAssertEqual(error.code, TJPErrorProtocolDecompressionFailed);
+
+    // 失败后流已重置 仍可解压字典压缩的消息
+    NSData *valid = [[self dictionaryCodec] compressData:payload cpuTime:NULL];
+    XCTAssertNotNil(valid);
+    XCTAssertEqualObjects([receiver decompressData:valid error:NULL], payload);
+}
+
+- (void)testResetDropsDictionary {
+    TJPCompressionCodec *codec = [self dictionaryCodec];
+    NSData *payload = [self shortMessageCorpus][3];
+    XCTAssertNotNil([codec compressData:payload cpuTime:NULL]);
+
+    // 断线或会话复用后恢复默认配置 短消息不再压缩
+    [codec reset];
+    XCTAssertNil(codec.presetDictionary);
+    XCTAssertEqual(codec.minimumLength, TJP_COMPRESSION_MIN_SIZE);
+    XCTAssertNil([codec compressData:payload cpuTime:NULL]);
+    XCTAssertEqual([[codec statistics][@"dictionaryMessages"] integerValue], 1);
+}
+
+#pragma mark - 基准测试
+- (void)testShortMessageWireBytesBenchmark {
+    NSArray<NSData *> *corpus = [self shortMessageCorpus];
+    NSLog(@"\n=== 短消息传输字节数对比 (%lu 条) ===", (unsigned long)corpus.count);
+
+    // 旧实现: 逐条独立压缩 无字典 收益不足时按原文发送
+    TJPCompressionCodec *plainCodec = [[TJPCompressionCodec alloc] init];
+    plainCodec.minimumLength = TJP_COMPRESSION_DICTIONARY_MIN_SIZE;
+    TJPCompressionCodec *dictionaryCodec = [self dictionaryCodec];
+
+    NSUInteger rawBytes = 0, plainBytes = 0, dictionaryBytes = 0;
+    for (NSData *payload in corpus) {
+        rawBytes += payload.length;
+        NSData *plain = [plainCodec compressData:payload cpuTime:NULL];
+        plainBytes += plain ? plain.length : payload.length;
+        NSData *dictionary = [dictionaryCodec compressData:payload cpuTime:NULL];
+        dictionaryBytes += dictionary ? dictionary.length : payload.length;
+    }
+
+    NSLog(@"原文: %lu 字节", (unsigned long)rawBytes);
+    NSLog(@"无字典压缩: %lu 字节 (%.1f%%), 压缩条数: %@", (unsigned long)plainBytes, plainBytes * 100.0 / rawBytes, [plainCodec statistics][@"compressedMessages"]);
+    NSLog(@"预置字典压缩: %lu 字节 (%.1f%%), 压缩条数: %@", (unsigned long)dictionaryBytes, dictionaryBytes * 100.0 / rawBytes, [dictionaryCodec statistics][@"compressedMessages"]);
+
+    XCTAssertLessThan(dictionaryBytes, rawBytes);
+    XCTAssertLessThan(dictionaryBytes, plainBytes);
+}
+
+@end
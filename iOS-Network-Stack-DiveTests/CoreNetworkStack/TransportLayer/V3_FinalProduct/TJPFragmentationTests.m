@@ -0,0 +1,191 @@
+//
+//  TJPFragmentationTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/14.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPFragmentCodec.h"
+#import "TJPFragmentReassembler.h"
+#import "TJPFragmentTransfer.h"
+#import "TJPMessageContext.h"
+
+static const NSUInteger kTestFragmentSize = 1024;
+
+@interface TJPFragmentationTests : XCTestCase
+
+@end
+
+@implementation TJPFragmentationTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (NSData *)randomDataWithLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+- (TJPFragmentReassembler *)reassembler {
+    return [[TJPFragmentReassembler alloc] initWithMaxTransfers:4 timeout:60];
+}
+
+#pragma mark - 功能测试
+- (void)testSplitAndReassembleOutOfOrder {
+    NSData *data = [self randomDataWithLength:kTestFragmentSize * 5 + 123];
+    NSUInteger count = [TJPFragmentCodec fragmentCountForLength:data.length fragmentSize:kTestFragmentSize];
+    XCTAssertEqual(count, 6);
+    
+    NSMutableArray<NSData *> *fragments = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count; i++) {
+        [fragments addObject:[TJPFragmentCodec fragmentPayloadForData:data transferId:42 index:i fragmentSize:kTestFragmentSize]];
+    }
+    
+    // 末尾分片先到 中间分片重复
+    NSArray<NSNumber *> *order = @[@5, @2, @0, @2, @4, @1, @3];
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    NSData *completed = nil;
+    for (NSUInteger i = 0; i < order.count; i++) {
+        TJPFragmentReassemblyResult result = [reassembler appendFragmentPayload:fragments[order[i].unsignedIntegerValue] completedData:&completed];
+        if (i == 3) {
+            XCTAssertEqual(result, TJPFragmentReassemblyResultDuplicate);
+        } else if (i == order.count - 1) {
+            XCTAssertEqual(result, TJPFragmentReassemblyResultCompleted);
+        } else {
+            XCTAssertEqual(result, TJPFragmentReassemblyResultIncomplete);
+        }
+    }
+    
+    XCTAssertEqualObjects(completed, data);
+    XCTAssertEqual(reassembler.activeTransferCount, 0);
+    
+    // 完成后迟到的重传判为重复
+    XCTAssertEqual([reassembler appendFragmentPayload:fragments[1] completedData:NULL], TJPFragmentReassemblyResultDuplicate);
+}
+
+- (void)testCorruptedFragmentRejected {
+    NSData *data = [self randomDataWithLength:kTestFragmentSize * 2];
+    NSMutableData *fragment = [[TJPFragmentCodec fragmentPayloadForData:data transferId:7 index:0 fragmentSize:kTestFragmentSize] mutableCopy];
+    ((uint8_t *)fragment.mutableBytes)[fragment.length - 1] ^= 0xFF;
+    
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    XCTAssertEqual([reassembler appendFragmentPayload:fragment completedData:NULL], TJPFragmentReassemblyResultInvalid, @"CRC校验失败的分片不接收");
+    XCTAssertEqual(reassembler.activeTransferCount, 0);
+    
+    // 截断的分片头
+    XCTAssertEqual([reassembler appendFragmentPayload:[fragment subdataWithRange:NSMakeRange(0, 10)] completedData:NULL], TJPFragmentReassemblyResultInvalid);
+}
+
+- (void)testInconsistentFragmentRejected {
+    NSData *data = [self randomDataWithLength:kTestFragmentSize * 3];
+    NSData *other = [self randomDataWithLength:kTestFragmentSize * 4];
+    
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    XCTAssertEqual([reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:9 index:0 fragmentSize:kTestFragmentSize] completedData:NULL], TJPFragmentReassemblyResultIncomplete);
+    
+    // 同一传输ID但总长度不同
+    XCTAssertEqual([reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:other transferId:9 index:1 fragmentSize:kTestFragmentSize] completedData:NULL], TJPFragmentReassemblyResultInvalid);
+    
+    // 按不同分片大小切分 分片数与已收分片不一致
+    XCTAssertEqual([reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:9 index:1 fragmentSize:kTestFragmentSize / 2] completedData:NULL], TJPFragmentReassemblyResultInvalid);
+}
+
+- (void)testInvalidFirstFragmentDoesNotFixFragmentSize {
+    NSData *data = [self randomDataWithLength:3000];
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    
+    // 首个到达的分片按1100字节切分 偏移被篡改 分片数和总长度与真实分片一致
+    NSMutableData *forged = [[TJPFragmentCodec fragmentPayloadForData:data transferId:11 index:1 fragmentSize:1100] mutableCopy];
+    uint32_t forgedOffset = 0;
+    // Tag(2)+Length(4)之后 偏移字段位于分片头第12字节
+    [forged replaceBytesInRange:NSMakeRange(6 + 12, sizeof(forgedOffset)) withBytes:&forgedOffset];
+    XCTAssertEqual([reassembler appendFragmentPayload:forged completedData:NULL], TJPFragmentReassemblyResultInvalid);
+    
+    // 不合法的分片不应决定分片大小 真实分片仍可完成重组
+    TJPFragmentReassemblyResult result = TJPFragmentReassemblyResultInvalid;
+    NSData *completed = nil;
+    for (NSUInteger index = 0; index < 3; index++) {
+        result = [reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:11 index:index fragmentSize:kTestFragmentSize] completedData:&completed];
+    }
+    XCTAssertEqual(result, TJPFragmentReassemblyResultCompleted);
+    XCTAssertEqualObjects(completed, data);
+}
+
+- (void)testMalformedLastFragmentDoesNotMarkTransferCompleted {
+    NSData *data = [self randomDataWithLength:3000];
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    
+    // 末尾分片按1100字节切分 先于其他分片到达 拼接后长度不一致
+    NSData *malformedLast = [TJPFragmentCodec fragmentPayloadForData:data transferId:12 index:2 fragmentSize:1100];
+    XCTAssertEqual([reassembler appendFragmentPayload:malformedLast completedData:NULL], TJPFragmentReassemblyResultIncomplete);
+    for (NSUInteger index = 0; index < 2; index++) {
+        TJPFragmentReassemblyResult result = [reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:12 index:index fragmentSize:kTestFragmentSize] completedData:NULL];
+        XCTAssertEqual(result, index == 1 ? TJPFragmentReassemblyResultInvalid : TJPFragmentReassemblyResultIncomplete);
+    }
+    
+    // 校验失败的传输不应记为已完成 重传的合法分片可以重新重组
+    TJPFragmentReassemblyResult result = TJPFragmentReassemblyResultInvalid;
+    NSData *completed = nil;
+    for (NSUInteger index = 0; index < 3; index++) {
+        result = [reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:12 index:index fragmentSize:kTestFragmentSize] completedData:&completed];
+    }
+    XCTAssertEqual(result, TJPFragmentReassemblyResultCompleted);
+    XCTAssertEqualObjects(completed, data);
+}
+
+- (void)testReassemblyLimitEvictsOldestTransfer {
+    NSData *data = [self randomDataWithLength:kTestFragmentSize * 2];
+    TJPFragmentReassembler *reassembler = [[TJPFragmentReassembler alloc] initWithMaxTransfers:2 timeout:60];
+    for (uint32_t transferId = 1; transferId <= 3; transferId++) {
+        [reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:transferId index:0 fragmentSize:kTestFragmentSize] completedData:NULL];
+    }
+    XCTAssertEqual(reassembler.activeTransferCount, 2);
+    
+    // 被淘汰的传输需要重新接收首个分片
+    XCTAssertEqual([reassembler appendFragmentPayload:[TJPFragmentCodec fragmentPayloadForData:data transferId:1 index:1 fragmentSize:kTestFragmentSize] completedData:NULL], TJPFragmentReassemblyResultIncomplete);
+}
+
+- (void)testTransferResumesFromFirstUnacknowledgedFragment {
+    TJPMessageContext *message = [TJPMessageContext contextWithData:[self randomDataWithLength:kTestFragmentSize * 4] seq:0 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@"test-session"];
+    message.priority = TJPMessagePriorityHigh;
+    TJPFragmentTransfer *transfer = [[TJPFragmentTransfer alloc] initWithMessage:message fragmentSize:kTestFragmentSize];
+    XCTAssertEqual(transfer.fragmentCount, 4);
+    
+    NSMutableArray<TJPMessageContext *> *sent = [NSMutableArray array];
+    TJPMessageContext *fragment = nil;
+    while ((fragment = [transfer nextFragmentContext])) {
+        [sent addObject:fragment];
+    }
+    XCTAssertEqual(sent.count, 4);
+    XCTAssertEqual(sent[0].messageType, TJPMessageTypeFragment);
+    XCTAssertEqual(sent[0].priority, TJPMessagePriorityHigh);
+    XCTAssertEqualObjects(sent[0].parentMessageId, message.messageId);
+    
+    // 分片0和2已确认 断线后续传只补发1和3
+    [transfer acknowledgeFragmentAtIndex:0];
+    [transfer acknowledgeFragmentAtIndex:2];
+    [transfer rewindToFirstUnacknowledgedFragment];
+    XCTAssertEqual([transfer nextFragmentContext].fragmentIndex, 1);
+    XCTAssertEqual([transfer nextFragmentContext].fragmentIndex, 3);
+    XCTAssertNil([transfer nextFragmentContext]);
+    XCTAssertFalse(transfer.isComplete);
+    
+    [transfer acknowledgeFragmentAtIndex:1];
+    [transfer acknowledgeFragmentAtIndex:3];
+    XCTAssertTrue(transfer.isComplete);
+    
+    // 传输ID不变 接收端可继续拼接重连前收到的分片
+    TJPFragmentReassembler *reassembler = [self reassembler];
+    NSData *completed = nil;
+    for (TJPMessageContext *context in sent) {
+        [reassembler appendFragmentPayload:context.payload completedData:&completed];
+    }
+    XCTAssertEqualObjects(completed, message.payload);
+}
+
+@end
@@ -0,0 +1,186 @@
+//
+//  TJPHeaderCodecTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/9.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPHeaderCodec.h"
+#import "TJPNetworkDefine.h"
+
+static const NSUInteger kHeaderBenchmarkIterations = 5000000;   // 基准测试次数
+
+@interface TJPHeaderCodecTests : XCTestCase
+
+@end
+
+@implementation TJPHeaderCodecTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (TJPFinalAdavancedHeader)validHeaderWithNow:(uint32_t)now {
+    TJPFinalAdavancedHeader header = {0};
+    header.magic = htonl(kProtocolMagic);
+    header.version_major = kProtocolVersionMajor;
+    header.version_minor = kProtocolVersionMinor;
+    header.msgType = htons(TJPMessageTypeControl);
+    header.sequence = htonl(0x02000123);
+    header.timestamp = htonl(now);
+    header.encrypt_type = TJPEncryptTypeCRC32;
+    header.compress_type = TJPCompressTypeZlib;
+    header.session_id = htons(0xBEEF);
+    header.bodyLength = htonl(1024);
+    header.checksum = 0x11223344;
+    return header;
+}
+
+#pragma mark - 功能测试
+- (void)testDecodeValidHeader {
+    uint32_t now = TJPHeaderCoarseNow();
+    TJPFinalAdavancedHeader header = [self validHeaderWithNow:now];
+
+    TJPDecodedHeader decoded;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultValid);
+    XCTAssertEqual(decoded.msgType, TJPMessageTypeControl);
+    XCTAssertEqual(decoded.sequence, 0x02000123);
+    XCTAssertEqual(decoded.timestamp, now);
+    XCTAssertEqual(decoded.encryptType, TJPEncryptTypeCRC32);
+    XCTAssertEqual(decoded.compressType, TJPCompressTypeZlib);
+    XCTAssertEqual(decoded.sessionId, 0xBEEF);
+    XCTAssertEqual(decoded.bodyLength, 1024);
+    XCTAssertEqual(decoded.checksum, 0x11223344, @"校验和保持原样");
+}
+
+- (void)testDecodeRejectsInvalidFields {
+    uint32_t now = TJPHeaderCoarseNow();
+    TJPDecodedHeader decoded;
+
+    TJPFinalAdavancedHeader header = [self validHeaderWithNow:now];
+    header.magic = htonl(0xDEADBEEF);
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultMagicInvalid);
+
+    header = [self validHeaderWithNow:now];
+    header.version_major = kProtocolVersionMajor + 1;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultVersionMismatch);
+
+    header = [self validHeaderWithNow:now];
+    header.version_minor = kProtocolVersionMinor + 1;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultVersionMismatch);
+
+    header = [self validHeaderWithNow:now];
+    header.bodyLength = htonl(TJPMAX_BODY_SIZE + 1);
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultBodyTooLarge);
+
+    header = [self validHeaderWithNow:now - TJPMAX_TIME_WINDOW - 1];
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultTimestampInvalid);
+    header = [self validHeaderWithNow:now + TJPMAX_TIME_WINDOW + 1];
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultTimestampInvalid);
+
+    header = [self validHeaderWithNow:now];
+    header.encrypt_type = 7;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultUnsupportedEncryption);
+    header.encrypt_type = 200;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultUnsupportedEncryption);
+
+    header = [self validHeaderWithNow:now];
+    header.compress_type = 2;
+    XCTAssertEqual(TJPHeaderDecode(&header, now, &decoded), TJPHeaderValidationResultUnsupportedCompression);
+}
+
+- (void)testDecodeFromUnalignedBytes {
+    uint32_t now = TJPHeaderCoarseNow();
+    TJPFinalAdavancedHeader header = [self validHeaderWithNow:now];
+    uint8_t buffer[sizeof(header) + 1];
+    memcpy(buffer + 1, &header, sizeof(header));
+
+    TJPDecodedHeader decoded;
+    XCTAssertEqual(TJPHeaderDecode(buffer + 1, now, &decoded), TJPHeaderValidationResultValid, @"环形缓冲区视图中的头部可能未对齐");
+    XCTAssertEqual(decoded.sequence, 0x02000123);
+}
+
+#pragma mark - 基准测试
+- (void)testHeaderValidationBenchmark {
+    NSLog(@"\n=== 协议头校验基准测试 (%lu 次) ===", (unsigned long)kHeaderBenchmarkIterations);
+    uint32_t now = TJPHeaderCoarseNow();
+    TJPFinalAdavancedHeader header = [self validHeaderWithNow:now];
+
+    // 旧实现: 逐字段ntoh + 每包[NSDate date] + switch判断类型
+    NSUInteger legacyValid = 0;
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < kHeaderBenchmarkIterations; i++) {
+        @autoreleasepool {
+            if ([self legacyValidateHeader:header]) {
+                legacyValid++;
+            }
+        }
+    }
+    CFTimeInterval legacyDuration = CFAbsoluteTimeGetCurrent() - start;
+
+    // 新实现: 一次遍历 + 批次时钟
+    NSUInteger codecValid = 0;
+    TJPDecodedHeader decoded;
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < kHeaderBenchmarkIterations; i++) {
+        if (TJPHeaderDecode(&header, now, &decoded) == TJPHeaderValidationResultValid) {
+            codecValid++;
+        }
+    }
+    CFTimeInterval codecDuration = CFAbsoluteTimeGetCurrent() - start;
+
+    double legacyRate = kHeaderBenchmarkIterations / legacyDuration;
+    double codecRate = kHeaderBenchmarkIterations / codecDuration;
+    NSLog(@"旧实现: %.2f M头部/秒", legacyRate / 1e6);
+    NSLog(@"新实现: %.2f M头部/秒", codecRate / 1e6);
+    NSLog(@"提升倍数: %.2fx", codecRate / legacyRate);
+
+    XCTAssertEqual(legacyValid, kHeaderBenchmarkIterations);
+    XCTAssertEqual(codecValid, kHeaderBenchmarkIterations);
+    XCTAssertGreaterThan(codecRate, legacyRate);
+}
+
+/// 与原validateHeader:error:等价的结构校验 不含防重放
+- (BOOL)legacyValidateHeader:(TJPFinalAdavancedHeader)header {
+    if (ntohl(header.magic) != kProtocolMagic) {
+        return NO;
+    }
+    if (header.version_major != kProtocolVersionMajor || header.version_minor > kProtocolVersionMinor) {
+        return NO;
+    }
+    if (ntohl(header.bodyLength) > TJPMAX_BODY_SIZE) {
+        return NO;
+    }
+    uint32_t currTime = (uint32_t)[[NSDate date] timeIntervalSince1970];
+    int32_t timeDiff = (int32_t)currTime - (int32_t)ntohl(header.timestamp);
+    if (abs(timeDiff) > TJPMAX_TIME_WINDOW) {
+        return NO;
+    }
+    return [self isSupportedEncryptType:header.encrypt_type] && [self isSupportedCompressType:header.compress_type];
+}
+
+- (BOOL)isSupportedEncryptType:(TJPEncryptType)type {
+    switch (type) {
+        case TJPEncryptTypeNone:
+        case TJPEncryptTypeCRC32:
+        case TJPEncryptTypeAES256:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+- (BOOL)isSupportedCompressType:(TJPCompressType)type {
+    switch (type) {
+        case TJPCompressTypeNone:
+        case TJPCompressTypeZlib:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+@end
@@ -8,6 +8,7 @@
 #import <XCTest/XCTest.h>
 #import "TJPMessageContext.h"
 #import "TJPNetworkUtil.h"
+#import "TJPMessageBuilder.h"
 
 @interface TJPMessageContextTests : XCTestCase
 
@@ -72,6 +73,73 @@
 
 
 
+- (void)testBuildRetryPacketDataReusesPayload {
+    NSMutableData *testData = [NSMutableData dataWithLength:64 * 1024];
+    memset(testData.mutableBytes, 0xAB, testData.length);
+    
+    TJPMessageContext *context = [TJPMessageContext contextWithData:testData seq:7 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@"0A0B0C0D-0000-0000-0000-000000000000"];
+    
+    dispatch_data_t first = [context buildPacketData];
+    XCTAssertFalse(context.isRetransmitted);
+    dispatch_data_t retry = [context buildRetryPacketData];
+    XCTAssertEqual(context.retryCount, 1);
+    XCTAssertTrue(context.isRetransmitted, @"重发的消息不参与RTT采样");
+    XCTAssertEqual(dispatch_data_get_size(retry), testData.length + sizeof(TJPFinalAdavancedHeader));
+    
+    // 协议头与载荷为独立分段 重传复用同一块载荷内存
+    __block NSMutableArray<NSValue *> *firstRegions = [NSMutableArray array];
+    __block NSMutableArray<NSValue *> *retryRegions = [NSMutableArray array];
+    dispatch_data_apply(first, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        [firstRegions addObject:[NSValue valueWithPointer:buffer]];
+        return true;
+    });
+    dispatch_data_apply(retry, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        [retryRegions addObject:[NSValue valueWithPointer:buffer]];
+        return true;
+    });
+    XCTAssertEqual(retryRegions.count, 2, @"协议头+载荷两段");
+    XCTAssertEqualObjects(firstRegions.lastObject, retryRegions.lastObject, @"重传不应重新拷贝载荷");
+    
+    // 可变数据在构建时已固定 之后修改不影响重传内容
+    memset(testData.mutableBytes, 0, testData.length);
+    NSData *flat = (NSData *)[context buildRetryPacketData];
+    const uint8_t *body = (const uint8_t *)flat.bytes + sizeof(TJPFinalAdavancedHeader);
+    XCTAssertEqual(body[0], 0xAB);
+    XCTAssertEqual(body[testData.length - 1], 0xAB);
+}
+
+- (void)testBuildPacketDataMatchesContiguousPacket {
+    NSData *testData = [@"Gather write payload" dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *sessionId = [[NSUUID UUID] UUIDString];
+    
+    NSData *contiguous = [TJPMessageBuilder buildPacketWithMessageType:TJPMessageTypeNormalData sequence:42 payload:testData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionID:sessionId];
+    NSData *gathered = (NSData *)[TJPMessageBuilder buildPacketDataWithMessageType:TJPMessageTypeNormalData sequence:42 payload:testData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionID:sessionId];
+    XCTAssertEqual(gathered.length, contiguous.length);
+    
+    // 时间戳可能跨秒 比较时忽略
+    NSMutableData *lhs = [contiguous mutableCopy];
+    NSMutableData *rhs = [gathered mutableCopy];
+    size_t timestampOffset = offsetof(TJPFinalAdavancedHeader, timestamp);
+    memset((uint8_t *)lhs.mutableBytes + timestampOffset, 0, sizeof(uint32_t));
+    memset((uint8_t *)rhs.mutableBytes + timestampOffset, 0, sizeof(uint32_t));
+    XCTAssertEqualObjects(lhs, rhs);
+}
+
+- (void)testDefaultPriorityFollowsMessageType {
+    NSData *testData = [@"priority" dataUsingEncoding:NSUTF8StringEncoding];
+    TJPMessageContext *data = [TJPMessageContext contextWithData:testData seq:1 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@""];
+    TJPMessageContext *receipt = [TJPMessageContext contextWithData:testData seq:2 messageType:TJPMessageTypeReadReceipt encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@""];
+    XCTAssertEqual(data.priority, TJPMessagePriorityNormal);
+    XCTAssertEqual(receipt.priority, TJPMessagePriorityUrgent, @"已读回执不应排在大消息之后");
+    
+    // 控制帧原样发出
+    NSData *packet = [TJPMessageBuilder buildPacketWithMessageType:TJPMessageTypeACK sequence:9 payload:testData encryptType:TJPEncryptTypeNone compressType:TJPCompressTypeNone sessionID:@""];
+    TJPMessageContext *control = [TJPMessageContext controlContextWithPacket:packet messageType:TJPMessageTypeACK seq:9 sessionId:@""];
+    XCTAssertEqual(control.priority, TJPMessagePriorityUrgent);
+    XCTAssertEqualObjects((NSData *)[control buildPacketData], packet);
+}
+
+
 - (void)testExample {
     // This is an example of a functional test case.
     // Use XCTAssert and related functions to verify your tests produce the correct results.
@@ -9,6 +9,7 @@
 #import "TJPMessageParser.h"
 #import "TJPParsedPacket.h"
 #import "TJPNetworkUtil.h"
+#import "TJPNetworkDefine.h"
 #import <mach/mach.h>
 
 static const NSUInteger kTestDataSize = 1024;      // 1KB测试数据
@@ -339,6 +340,233 @@ static const NSUInteger kLargeDataSize = 1024 * 64; // 64KB大数据测试
     return totalTime;
 }
 
+- (void)testRingBufferGrowsOnBurstInsteadOfReset {
+    TJPMessageParser *parser = [[TJPMessageParser alloc] initWithBufferStrategy:TJPBufferStrategyRingBuffer capacity:16 * 1024];
+    NSUInteger initialCapacity = parser.bufferCapacity;
+
+    // 单次突发数据超过初始容量 模拟历史消息同步
+    NSMutableData *burst = [NSMutableData data];
+    NSUInteger packetCount = 0;
+    while (burst.length <= initialCapacity * 2) {
+        [burst appendData:[self generatePacketWithSequence:(uint32_t)(50000 + packetCount)]];
+        packetCount++;
+    }
+    [parser feedData:burst];
+
+    XCTAssertNotEqual(parser.currentState, TJPParseStateError, @"突发流量不应导致解析器进入错误状态");
+    XCTAssertTrue(parser.isUseRingBuffer, @"应继续使用环形缓冲区");
+    XCTAssertGreaterThan(parser.ringBufferGrowCount, 0, @"应记录扩容次数");
+    XCTAssertGreaterThan(parser.bufferCapacity, initialCapacity);
+
+    NSUInteger parsedCount = 0;
+    while ([parser hasCompletePacket]) {
+        if ([parser nextPacket]) {
+            parsedCount++;
+        }
+    }
+    XCTAssertEqual(parsedCount, packetCount, @"突发流量中的所有包都应被解析");
+}
+
+- (void)testDefaultParserGrowsRingBuffer {
+    // 未显式配置扩容上限 使用默认值
+    TJPMessageParser *parser = [[TJPMessageParser alloc] initWithRingBufferEnabled:YES];
+    XCTAssertEqual(parser.ringBufferMaxCapacity, TJP_DEFAULT_RING_BUFFER_MAX_CAPACITY, @"默认应允许扩容");
+    NSUInteger initialCapacity = parser.bufferCapacity;
+
+    NSMutableData *burst = [NSMutableData data];
+    NSUInteger packetCount = 0;
+    while (burst.length <= initialCapacity + initialCapacity / 2) {
+        [burst appendData:[self generatePacketWithSequence:(uint32_t)(60000 + packetCount)]];
+        packetCount++;
+    }
+    [parser feedData:burst];
+
+    XCTAssertNotEqual(parser.currentState, TJPParseStateError);
+    XCTAssertGreaterThan(parser.ringBufferGrowCount, 0);
+    NSUInteger parsedCount = 0;
+    while ([parser hasCompletePacket]) {
+        if ([parser nextPacket]) {
+            parsedCount++;
+        }
+    }
+    XCTAssertEqual(parsedCount, packetCount);
+}
+
+- (void)testCoalescedPacketsLegacyBenchmark {
+    const NSUInteger packetCount = 10000;
+    NSLog(@"\n=== 传统缓冲区 粘包(%lu个包一次feedData) 性能对比 ===", (unsigned long)packetCount);
+
+    NSMutableData *coalesced = [NSMutableData data];
+    for (NSUInteger i = 0; i < packetCount; i++) {
+        [coalesced appendData:[self generatePacketWithSequence:(uint32_t)(100000 + i)]];
+    }
+
+    // 旧实现: 每次解析头部和消息体后都从头部移除 memmove剩余全部数据
+    CFTimeInterval baselineStart = CFAbsoluteTimeGetCurrent();
+    NSMutableData *legacyBuffer = [coalesced mutableCopy];
+    NSUInteger baselineCount = 0;
+    while (legacyBuffer.length >= sizeof(TJPFinalAdavancedHeader)) {
+        TJPFinalAdavancedHeader header = {0};
+        [legacyBuffer getBytes:&header length:sizeof(header)];
+        [legacyBuffer replaceBytesInRange:NSMakeRange(0, sizeof(header)) withBytes:NULL length:0];
+        uint32_t bodyLength = ntohl(header.bodyLength);
+        NSData *payload = [legacyBuffer subdataWithRange:NSMakeRange(0, bodyLength)];
+        [legacyBuffer replaceBytesInRange:NSMakeRange(0, bodyLength) withBytes:NULL length:0];
+        if (payload) {
+            baselineCount++;
+        }
+    }
+    CFTimeInterval baselineDuration = CFAbsoluteTimeGetCurrent() - baselineStart;
+
+    // 新实现: 读游标 + 延迟压缩
+    TJPMessageParser *parser = [[TJPMessageParser alloc] initWithRingBufferEnabled:NO];
+    CFTimeInterval cursorStart = CFAbsoluteTimeGetCurrent();
+    [parser feedData:coalesced];
+    NSUInteger parsedCount = 0;
+    while ([parser hasCompletePacket]) {
+        if ([parser nextPacket]) {
+            parsedCount++;
+        }
+    }
+    CFTimeInterval cursorDuration = CFAbsoluteTimeGetCurrent() - cursorStart;
+
+    NSLog(@"旧实现(仅缓冲区搬移): %.3f ms", baselineDuration * 1000);
+    NSLog(@"读游标实现(完整解析): %.3f ms", cursorDuration * 1000);
+
+    XCTAssertEqual(baselineCount, packetCount);
+    XCTAssertEqual(parsedCount, packetCount, @"所有粘包都应被解析");
+    XCTAssertEqual(parser.usedBufferSize, 0, @"解析完成后缓冲区应为空");
+}
+
+- (void)testDrainPacketsMatchesPerPacketLoop {
+    for (NSNumber *enabled in @[@YES, @NO]) {
+        TJPMessageParser *parser = [[TJPMessageParser alloc] initWithRingBufferEnabled:enabled.boolValue];
+        NSMutableData *stream = [NSMutableData data];
+        for (uint32_t i = 0; i < 5; i++) {
+            [stream appendData:[self generateFloodPacketWithSequence:300000 + i]];
+        }
+        // 末尾附加半个包 应保留在缓冲区等待后续数据
+        NSData *tail = [self generateFloodPacketWithSequence:300005];
+        [stream appendData:[tail subdataWithRange:NSMakeRange(0, 40)]];
+        [parser feedData:stream];
+
+        NSArray<TJPParsedPacket *> *limited = [parser drainPacketsWithLimit:2];
+        XCTAssertEqual(limited.count, 2, @"应遵守数量上限");
+        NSArray<TJPParsedPacket *> *rest = [parser drainPacketsWithLimit:0];
+        XCTAssertEqual(rest.count, 3);
+        XCTAssertEqual(limited.firstObject.sequence, 300000);
+        XCTAssertEqual(rest.lastObject.sequence, 300004, @"批量取出应保持接收顺序");
+
+        [parser feedData:[tail subdataWithRange:NSMakeRange(40, tail.length - 40)]];
+        NSArray<TJPParsedPacket *> *last = [parser drainPacketsWithLimit:0];
+        XCTAssertEqual(last.count, 1, @"补齐半包后应能取出");
+        XCTAssertEqual(last.firstObject.sequence, 300005);
+        XCTAssertEqual(parser.usedBufferSize, 0);
+    }
+}
+
+- (void)testDuplicateRetransmitKeepsParserRunning {
+    for (NSNumber *enabled in @[@YES, @NO]) {
+        TJPMessageParser *parser = [[TJPMessageParser alloc] initWithRingBufferEnabled:enabled.boolValue];
+        // 对端未收到ACK 重传了相同序列号的包
+        NSMutableData *stream = [NSMutableData data];
+        [stream appendData:[self generatePacketWithSequence:400000]];
+        [stream appendData:[self generatePacketWithSequence:400000]];
+        [stream appendData:[self generatePacketWithSequence:400001]];
+        [parser feedData:stream];
+
+        NSArray<TJPParsedPacket *> *packets = [parser drainPacketsWithLimit:0];
+        XCTAssertNotEqual(parser.currentState, TJPParseStateError, @"重传不应使解析器进入错误状态");
+        XCTAssertEqual(packets.count, 3);
+        XCTAssertFalse(packets[0].isDuplicate);
+        XCTAssertTrue(packets[1].isDuplicate, @"重复包应标记出来交由会话重新确认");
+        XCTAssertNil(packets[1].payload, @"重复包不携带载荷");
+        XCTAssertEqual(packets[1].sequence, 400000);
+        XCTAssertFalse(packets[2].isDuplicate, @"重复包之后的数据应继续解析");
+        XCTAssertNotNil(packets[2].payload);
+    }
+}
+
+- (void)testDrainPacketsFloodBenchmark {
+    const uint32_t packetCount = 20000;
+    const NSUInteger chunkSize = 4096;
+    NSLog(@"\n=== 64字节小包洪泛 逐包解析 vs 批量解析 (%u个包, %lu字节/次读取) ===", packetCount, (unsigned long)chunkSize);
+
+    NSMutableData *loopStream = [NSMutableData data];
+    NSMutableData *drainStream = [NSMutableData data];
+    for (uint32_t i = 0; i < packetCount; i++) {
+        [loopStream appendData:[self generateFloodPacketWithSequence:400000 + i]];
+        [drainStream appendData:[self generateFloodPacketWithSequence:500000 + i]];
+    }
+
+    // 逐包解析: hasCompletePacket + nextPacket
+    TJPMessageParser *loopParser = [[TJPMessageParser alloc] initWithRingBufferEnabled:YES];
+    __block NSUInteger loopCount = 0;
+    CFTimeInterval loopDuration = [self feedStream:loopStream chunkSize:chunkSize parser:loopParser handler:^{
+        while ([loopParser hasCompletePacket]) {
+            if ([loopParser nextPacket]) {
+                loopCount++;
+            }
+        }
+    }];
+
+    // 批量解析: drainPacketsWithLimit
+    TJPMessageParser *drainParser = [[TJPMessageParser alloc] initWithRingBufferEnabled:YES];
+    __block NSUInteger drainCount = 0;
+    CFTimeInterval drainDuration = [self feedStream:drainStream chunkSize:chunkSize parser:drainParser handler:^{
+        drainCount += [drainParser drainPacketsWithLimit:0].count;
+    }];
+
+    double loopRate = packetCount / loopDuration;
+    double drainRate = packetCount / drainDuration;
+    NSLog(@"逐包解析: %.0f 包/秒", loopRate);
+    NSLog(@"批量解析: %.0f 包/秒", drainRate);
+    NSLog(@"提升倍数: %.2fx", drainRate / loopRate);
+
+    XCTAssertEqual(loopCount, packetCount);
+    XCTAssertEqual(drainCount, packetCount, @"批量解析应取出全部数据包");
+    XCTAssertGreaterThan(drainRate, loopRate, @"批量解析应快于逐包解析");
+}
+
+/// 按socket读取粒度分块喂入数据 每块之后执行一次取包
+- (CFTimeInterval)feedStream:(NSData *)stream chunkSize:(NSUInteger)chunkSize parser:(TJPMessageParser *)parser handler:(void (^)(void))handler {
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger offset = 0; offset < stream.length; offset += chunkSize) {
+        NSUInteger length = MIN(chunkSize, stream.length - offset);
+        [parser feedData:[stream subdataWithRange:NSMakeRange(offset, length)]];
+        handler();
+    }
+    return CFAbsoluteTimeGetCurrent() - start;
+}
+
+/// 生成总长64字节的数据包 28字节头部 + 36字节TLV消息体
+- (NSData *)generateFloodPacketWithSequence:(uint32_t)sequence {
+    NSMutableData *payload = [NSMutableData data];
+    uint16_t tag = CFSwapInt16HostToBig(0x1001);
+    uint8_t value[30];
+    memset(value, 'F', sizeof(value));
+    uint32_t length = CFSwapInt32HostToBig((uint32_t)sizeof(value));
+    [payload appendBytes:&tag length:sizeof(tag)];
+    [payload appendBytes:&length length:sizeof(length)];
+    [payload appendBytes:value length:sizeof(value)];
+
+    TJPFinalAdavancedHeader header = {0};
+    header.magic = htonl(kProtocolMagic);
+    header.version_major = kProtocolVersionMajor;
+    header.version_minor = kProtocolVersionMinor;
+    header.msgType = htons(TJPMessageTypeNormalData);
+    header.sequence = htonl(sequence);
+    header.timestamp = htonl((uint32_t)[[NSDate date] timeIntervalSince1970]);
+    header.encrypt_type = TJPEncryptTypeNone;
+    header.compress_type = TJPCompressTypeNone;
+    header.bodyLength = htonl((uint32_t)payload.length);
+    header.checksum = [TJPNetworkUtil crc32ForData:payload];
+
+    NSMutableData *packetData = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packetData appendData:payload];
+    return packetData;
+}
+
 #pragma mark - 并发安全测试
 
 - (void)testConcurrentSafety {
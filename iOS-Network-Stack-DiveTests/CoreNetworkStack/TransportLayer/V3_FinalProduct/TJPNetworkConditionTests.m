@@ -7,6 +7,7 @@
 
 #import <XCTest/XCTest.h>
 #import "TJPNetworkCondition.h"
+#import "TJPNetworkDefine.h"
 
 @interface TJPNetworkConditionTests : XCTestCase
 
@@ -46,6 +47,41 @@
     XCTAssertEqual(condition.qualityLevel, TJPNetworkQualityPoor, @"网络质量评估错误（差网络）");
 }
 
+- (void)testRetransmissionTimeoutBeforeSamples {
+    XCTAssertEqualWithAccuracy(self.condition.retransmissionTimeout, TJP_RTO_INITIAL_INTERVAL, 0.0001, @"无样本时使用初始RTO");
+    XCTAssertEqualWithAccuracy([self.condition retransmissionTimeoutForRetryCount:1], TJP_RTO_INITIAL_INTERVAL * 2, 0.0001);
+}
+
+- (void)testRetransmissionTimeoutFollowsJacobsonKarels {
+    // 首个样本 SRTT=R RTTVAR=R/2 RTO=R+4*RTTVAR=3R
+    [self.condition updateRTTWithSample:400];
+    XCTAssertEqualWithAccuracy(self.condition.smoothedRoundTripTime, 400, 0.0001);
+    XCTAssertEqualWithAccuracy(self.condition.roundTripTimeVariance, 200, 0.0001);
+    XCTAssertEqualWithAccuracy(self.condition.retransmissionTimeout, 1.2, 0.0001);
+    
+    // 第二个样本 RTTVAR=3/4*200+1/4*|400-200|=200 SRTT=7/8*400+1/8*200=375
+    [self.condition updateRTTWithSample:200];
+    XCTAssertEqualWithAccuracy(self.condition.roundTripTimeVariance, 200, 0.0001);
+    XCTAssertEqualWithAccuracy(self.condition.smoothedRoundTripTime, 375, 0.0001);
+    XCTAssertEqualWithAccuracy(self.condition.retransmissionTimeout, 1.175, 0.0001);
+}
+
+- (void)testRetransmissionTimeoutClampedAndBackedOff {
+    // 稳定的低延迟网络收敛到下限
+    for (int i = 0; i < 50; i++) {
+        [self.condition updateRTTWithSample:20];
+    }
+    XCTAssertEqualWithAccuracy(self.condition.retransmissionTimeout, TJP_RTO_MIN_INTERVAL, 0.0001, @"RTO不应低于下限");
+    
+    // 指数退避
+    XCTAssertEqualWithAccuracy([self.condition retransmissionTimeoutForRetryCount:0], TJP_RTO_MIN_INTERVAL, 0.0001);
+    XCTAssertEqualWithAccuracy([self.condition retransmissionTimeoutForRetryCount:2], TJP_RTO_MIN_INTERVAL * 4, 0.0001);
+    XCTAssertEqualWithAccuracy([self.condition retransmissionTimeoutForRetryCount:100], TJP_RTO_MAX_INTERVAL, 0.0001, @"退避不应超过上限");
+    
+    // 极高延迟也不超过上限
+    [self.condition updateRTTWithSample:120000];
+    XCTAssertEqualWithAccuracy(self.condition.retransmissionTimeout, TJP_RTO_MAX_INTERVAL, 0.0001);
+}
 
 - (void)tearDown {
     // Put teardown code here. This method is called after the invocation of each test method in the class.
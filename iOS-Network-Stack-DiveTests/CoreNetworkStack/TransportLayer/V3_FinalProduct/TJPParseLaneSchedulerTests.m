@@ -0,0 +1,224 @@
+//
+//  TJPParseLaneSchedulerTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/17.
+//
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "TJPParseLaneScheduler.h"
+#import "TJPMessageParser.h"
+#import "TJPParsedPacket.h"
+#import "TJPNetworkUtil.h"
+
+static const NSUInteger kStressWorkerCount = 4;       // 工作队列数
+static const NSUInteger kStressSessionCount = 16;     // 并发会话数
+static const NSUInteger kStressPacketsPerSession = 2000; // 每个会话的数据包数
+static const NSUInteger kStressChunkSize = 97;        // 每次读取的字节数 故意不与包边界对齐
+
+/// 压力测试并发计数 块内不能捕获C数组 放在堆上
+typedef struct {
+    atomic_int *laneActive;     // 每个通道正在执行的任务数
+    atomic_int activeTotal;
+    atomic_int maxActiveTotal;
+    atomic_int laneViolations;
+} TJPLaneStressCounters;
+
+@interface TJPParseLaneSchedulerTests : XCTestCase
+
+@end
+
+@implementation TJPParseLaneSchedulerTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (NSData *)packetWithSequence:(uint32_t)sequence {
+    NSMutableData *payload = [NSMutableData data];
+    uint16_t tag = CFSwapInt16HostToBig(0x1001);
+    NSData *value = [[NSString stringWithFormat:@"lane-packet-%u", sequence] dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t length = CFSwapInt32HostToBig((uint32_t)value.length);
+    [payload appendBytes:&tag length:sizeof(tag)];
+    [payload appendBytes:&length length:sizeof(length)];
+    [payload appendData:value];
+
+    TJPFinalAdavancedHeader header = {0};
+    header.magic = htonl(kProtocolMagic);
+    header.version_major = kProtocolVersionMajor;
+    header.version_minor = kProtocolVersionMinor;
+    header.msgType = htons(TJPMessageTypeNormalData);
+    header.sequence = htonl(sequence);
+    header.timestamp = htonl((uint32_t)[[NSDate date] timeIntervalSince1970]);
+    header.encrypt_type = TJPEncryptTypeNone;
+    header.compress_type = TJPCompressTypeNone;
+    header.bodyLength = htonl((uint32_t)payload.length);
+    header.checksum = [TJPNetworkUtil crc32ForData:payload];
+
+    NSMutableData *packet = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [packet appendData:payload];
+    return packet;
+}
+
+#pragma mark - 功能测试
+- (void)testNewLanesGoToLeastLoadedWorker {
+    TJPParseLaneScheduler *scheduler = [[TJPParseLaneScheduler alloc] initWithWorkerCount:3];
+    NSMutableArray<TJPParseLane *> *lanes = [NSMutableArray array];
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < 7; i++) {
+            [lanes addObject:[scheduler laneWithLabel:[NSString stringWithFormat:@"lane-%lu", (unsigned long)i]]];
+        }
+    }
+    XCTAssertEqualObjects([scheduler statistics][@"workerLanes"], (@[@3, @2, @2]));
+
+    // 通道随会话释放 空出的工作队列优先分配
+    @autoreleasepool {
+        [lanes removeObjectsInArray:[lanes filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"workerIndex == 1"]]];
+    }
+    XCTAssertEqual([scheduler activeLanes].count, 5);
+    XCTAssertEqual([scheduler laneWithLabel:@"lane-new"].workerIndex, 1);
+}
+
+- (void)testDefaultWorkerCountMatchesCores {
+    TJPParseLaneScheduler *scheduler = [[TJPParseLaneScheduler alloc] initWithWorkerCount:0];
+    XCTAssertEqual(scheduler.workerCount, [NSProcessInfo processInfo].activeProcessorCount);
+}
+
+- (void)testQueueDepthMetrics {
+    TJPParseLaneScheduler *scheduler = [[TJPParseLaneScheduler alloc] initWithWorkerCount:1];
+    TJPParseLane *lane = [scheduler laneWithLabel:@"depth"];
+
+    // 第一个任务阻塞 后续任务全部积压
+    dispatch_semaphore_t gate = dispatch_semaphore_create(0);
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+    [lane dispatchAsync:^{
+        dispatch_semaphore_wait(gate, DISPATCH_TIME_FOREVER);
+        dispatch_group_leave(group);
+    }];
+    for (NSUInteger i = 0; i < 5; i++) {
+        dispatch_group_enter(group);
+        [lane dispatchAsync:^{
+            dispatch_group_leave(group);
+        }];
+    }
+    XCTAssertEqual(lane.queueDepth, 6);
+    XCTAssertEqual(lane.maxQueueDepth, 6);
+
+    dispatch_semaphore_signal(gate);
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+
+    // completed在任务返回后才累加 稍等统计追上
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:1.0];
+    while (lane.queueDepth > 0 && [deadline timeIntervalSinceNow] > 0) {
+        usleep(1000);
+    }
+    NSDictionary *stats = [lane statistics];
+    XCTAssertEqual([stats[@"queueDepth"] integerValue], 0);
+    XCTAssertEqual([stats[@"submitted"] integerValue], 6);
+    XCTAssertEqual([stats[@"completed"] integerValue], 6);
+    XCTAssertEqual([stats[@"maxQueueDepth"] integerValue], 6);
+    XCTAssertGreaterThan([stats[@"maxWaitMs"] doubleValue], 0);
+}
+
+#pragma mark - 压力测试
+- (void)testMultiSessionFloodKeepsPerSessionOrder {
+    NSLog(@"\n=== 解析通道压力测试 (%lu 个会话 x %lu 个包, %lu 个工作队列) ===", (unsigned long)kStressSessionCount, (unsigned long)kStressPacketsPerSession, (unsigned long)kStressWorkerCount);
+    TJPParseLaneScheduler *scheduler = [[TJPParseLaneScheduler alloc] initWithWorkerCount:kStressWorkerCount];
+
+    NSMutableArray<TJPParseLane *> *lanes = [NSMutableArray arrayWithCapacity:kStressSessionCount];
+    NSMutableArray<TJPMessageParser *> *parsers = [NSMutableArray arrayWithCapacity:kStressSessionCount];
+    NSMutableArray<NSMutableArray<NSNumber *> *> *received = [NSMutableArray arrayWithCapacity:kStressSessionCount];
+    NSMutableArray<NSData *> *streams = [NSMutableArray arrayWithCapacity:kStressSessionCount];
+    for (NSUInteger i = 0; i < kStressSessionCount; i++) {
+        [lanes addObject:[scheduler laneWithLabel:[NSString stringWithFormat:@"session-%lu", (unsigned long)i]]];
+        [parsers addObject:[[TJPMessageParser alloc] initWithRingBufferEnabled:YES]];
+        [received addObject:[NSMutableArray arrayWithCapacity:kStressPacketsPerSession]];
+
+        NSMutableData *stream = [NSMutableData data];
+        for (uint32_t sequence = 1; sequence <= kStressPacketsPerSession; sequence++) {
+            [stream appendData:[self packetWithSequence:sequence]];
+        }
+        [streams addObject:stream];
+    }
+
+    // 同一通道内出现并发执行即为违规 全局并发数不得超过工作队列数
+    TJPLaneStressCounters *counters = calloc(1, sizeof(TJPLaneStressCounters));
+    counters->laneActive = calloc(kStressSessionCount, sizeof(atomic_int));
+
+    dispatch_group_t group = dispatch_group_create();
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+
+    // 每个会话一个读取线程 模拟各自socket同时涌入数据
+    dispatch_apply(kStressSessionCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        NSData *stream = streams[index];
+        TJPParseLane *lane = lanes[index];
+        TJPMessageParser *parser = parsers[index];
+        NSMutableArray<NSNumber *> *sequences = received[index];
+
+        for (NSUInteger offset = 0; offset < stream.length; offset += kStressChunkSize) {
+            NSData *chunk = [stream subdataWithRange:NSMakeRange(offset, MIN(kStressChunkSize, stream.length - offset))];
+            dispatch_group_enter(group);
+            [lane dispatchAsync:^{
+                if (atomic_fetch_add(&counters->laneActive[index], 1) != 0) {
+                    atomic_fetch_add(&counters->laneViolations, 1);
+                }
+                int active = atomic_fetch_add(&counters->activeTotal, 1) + 1;
+                int currentMax = atomic_load(&counters->maxActiveTotal);
+                while (active > currentMax && !atomic_compare_exchange_weak(&counters->maxActiveTotal, &currentMax, active)) {
+                }
+
+                [parser feedData:chunk];
+                for (TJPParsedPacket *packet in [parser drainPacketsWithLimit:0]) {
+                    [sequences addObject:@(packet.sequence)];
+                }
+
+                atomic_fetch_sub(&counters->activeTotal, 1);
+                atomic_fetch_sub(&counters->laneActive[index], 1);
+                dispatch_group_leave(group);
+            }];
+        }
+    });
+
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC)), 0);
+    CFTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+
+    NSUInteger totalPackets = 0;
+    for (NSUInteger i = 0; i < kStressSessionCount; i++) {
+        NSArray<NSNumber *> *sequences = received[i];
+        XCTAssertEqual(sequences.count, kStressPacketsPerSession, @"会话 %lu 丢包", (unsigned long)i);
+        for (NSUInteger j = 0; j < sequences.count; j++) {
+            if (sequences[j].unsignedIntValue != j + 1) {
+                XCTFail(@"会话 %lu 第 %lu 个包乱序: %@", (unsigned long)i, (unsigned long)j, sequences[j]);
+                break;
+            }
+        }
+        XCTAssertNotEqual(parsers[i].currentState, TJPParseStateError);
+        totalPackets += sequences.count;
+    }
+
+    NSUInteger maxDepth = 0;
+    double maxWaitMs = 0;
+    for (TJPParseLane *lane in lanes) {
+        NSDictionary *stats = [lane statistics];
+        maxDepth = MAX(maxDepth, [stats[@"maxQueueDepth"] unsignedIntegerValue]);
+        maxWaitMs = MAX(maxWaitMs, [stats[@"maxWaitMs"] doubleValue]);
+    }
+
+    NSLog(@"总数据包: %lu, 耗时: %.3f 秒, 吞吐: %.2f 包/秒", (unsigned long)totalPackets, duration, totalPackets / duration);
+    int maxActiveTotal = atomic_load(&counters->maxActiveTotal);
+    int laneViolations = atomic_load(&counters->laneViolations);
+    free(counters->laneActive);
+    free(counters);
+    NSLog(@"最大并发解析数: %d, 通道内并发违规: %d", maxActiveTotal, laneViolations);
+    NSLog(@"单通道最大积压: %lu, 最大排队时延: %.2f ms", (unsigned long)maxDepth, maxWaitMs);
+
+    XCTAssertEqual(totalPackets, kStressSessionCount * kStressPacketsPerSession);
+    XCTAssertEqual(laneViolations, 0);
+    XCTAssertLessThanOrEqual(maxActiveTotal, (int)kStressWorkerCount);
+}
+
+@end
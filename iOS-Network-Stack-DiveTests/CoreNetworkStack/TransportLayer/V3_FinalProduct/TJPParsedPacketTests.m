@@ -0,0 +1,171 @@
+//
+//  TJPParsedPacketTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/8.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPParsedPacket.h"
+#import "TJPTLVContainer.h"
+#import "TJPErrorUtil.h"
+
+@interface TJPParsedPacketTests : XCTestCase
+
+@end
+
+@implementation TJPParsedPacketTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+#pragma mark - Helper
+- (void)appendTag:(uint16_t)tag value:(NSData *)value toData:(NSMutableData *)data {
+    uint16_t bigTag = CFSwapInt16HostToBig(tag);
+    uint32_t bigLength = CFSwapInt32HostToBig((uint32_t)value.length);
+    [data appendBytes:&bigTag length:sizeof(bigTag)];
+    [data appendBytes:&bigLength length:sizeof(bigLength)];
+    [data appendData:value];
+}
+
+- (NSData *)utf8:(NSString *)string {
+    return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (TJPParsedPacket *)packetWithPayload:(NSData *)payload policy:(TJPTLVTagPolicy)policy {
+    TJPFinalAdavancedHeader header = {0};
+    header.bodyLength = htonl((uint32_t)payload.length);
+    return [TJPParsedPacket packetWithHeader:header payload:payload policy:policy maxNestedDepth:4 error:nil];
+}
+
+#pragma mark - 功能测试
+- (void)testValuesAreZeroCopyAndLookupIsSorted {
+    NSMutableData *payload = [NSMutableData data];
+    // 乱序Tag 验证排序后的二分查找
+    [self appendTag:0x3003 value:[self utf8:@"third"] toData:payload];
+    [self appendTag:0x1001 value:[self utf8:@"first"] toData:payload];
+    [self appendTag:0x2002 value:[NSData data] toData:payload];
+    NSData *immutablePayload = [payload copy];
+
+    TJPParsedPacket *packet = [self packetWithPayload:immutablePayload policy:TJPTLVTagPolicyRejectDuplicates];
+    NSData *first = [packet tlvValueForTag:0x1001];
+    XCTAssertEqualObjects(first, [self utf8:@"first"]);
+    XCTAssertEqualObjects([packet tlvValueForTag:0x3003], [self utf8:@"third"]);
+    XCTAssertEqual([packet tlvValueForTag:0x2002].length, 0);
+    XCTAssertNil([packet tlvValueForTag:0x4004]);
+    XCTAssertEqual(packet.tlvContainer.count, 3);
+
+    // 值直接引用payload内存
+    const uint8_t *payloadStart = immutablePayload.bytes;
+    const uint8_t *valueStart = first.bytes;
+    XCTAssertTrue(valueStart >= payloadStart && valueStart < payloadStart + immutablePayload.length, @"Value应为payload子区间");
+
+    XCTAssertEqualObjects(packet.tlvEntries[@0x1001], [self utf8:@"first"], @"兼容字典访问");
+}
+
+- (void)testDuplicateTagPolicy {
+    NSMutableData *payload = [NSMutableData data];
+    [self appendTag:0x1001 value:[self utf8:@"old"] toData:payload];
+    [self appendTag:0x2002 value:[self utf8:@"x"] toData:payload];
+    [self appendTag:0x1001 value:[self utf8:@"new"] toData:payload];
+
+    TJPParsedPacket *rejecting = [self packetWithPayload:payload policy:TJPTLVTagPolicyRejectDuplicates];
+    XCTAssertNotNil(rejecting, @"构建时不解析TLV");
+    NSError *error = nil;
+    XCTAssertFalse([rejecting validateTLVWithError:&error]);
+    XCTAssertEqual(error.code, TJPErrorTLVDuplicateTag, @"重复Tag应被拒绝");
+    XCTAssertNil(rejecting.tlvEntries);
+    XCTAssertNil([rejecting tlvValueForTag:0x2002]);
+
+    TJPParsedPacket *allowing = [self packetWithPayload:payload policy:TJPTLVTagPolicyAllowDuplicates];
+    XCTAssertTrue([allowing validateTLVWithError:nil]);
+    XCTAssertEqualObjects([allowing tlvValueForTag:0x1001], [self utf8:@"new"], @"允许重复时最后一个生效");
+    XCTAssertEqualObjects(allowing.tlvEntries[@0x1001], [self utf8:@"new"]);
+}
+
+- (void)testNestedContainerDecodedOnDemand {
+    // 构建5层嵌套 超过最大深度4
+    NSMutableData *innermost = [NSMutableData data];
+    [self appendTag:0x1001 value:[self utf8:@"Hello"] toData:innermost];
+    NSData *inner = innermost;
+    for (int depth = 0; depth < 5; depth++) {
+        NSMutableData *wrapper = [NSMutableData data];
+        [self appendTag:0xFFFF value:inner toData:wrapper];
+        inner = wrapper;
+    }
+
+    TJPParsedPacket *packet = [self packetWithPayload:inner policy:TJPTLVTagPolicyRejectDuplicates];
+    TJPTLVContainer *container = packet.tlvContainer;
+    NSUInteger reachable = 0;
+    while (container.nestedContainer) {
+        container = container.nestedContainer;
+        reachable++;
+    }
+    XCTAssertEqual(reachable, 4, @"超过最大深度的层级不应被解析");
+
+    NSError *error = nil;
+    XCTAssertFalse([packet validateTLVWithError:&error]);
+    XCTAssertEqual(error.code, TJPErrorTLVNestedTooDeep);
+    XCTAssertNil(packet.tlvEntries, @"任意层级失败时字典为nil");
+}
+
+- (void)testTruncatedPayload {
+    NSMutableData *payload = [NSMutableData data];
+    [self appendTag:0x1001 value:[self utf8:@"value"] toData:payload];
+    [payload setLength:payload.length - 2];
+
+    TJPParsedPacket *packet = [self packetWithPayload:payload policy:TJPTLVTagPolicyRejectDuplicates];
+    NSError *error = nil;
+    XCTAssertFalse([packet validateTLVWithError:&error]);
+    XCTAssertEqual(error.code, TJPErrorTLVIncompleteValue);
+}
+
+#pragma mark - 基准测试
+- (void)testPacketCreationBenchmark {
+    NSMutableData *payload = [NSMutableData data];
+    for (uint16_t tag = 1; tag <= 6; tag++) {
+        [self appendTag:tag value:[self utf8:@"benchmark-value"] toData:payload];
+    }
+    const NSUInteger iterations = 200000;
+
+    // 只构建不访问TLV 对应ACK/心跳包的路径
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < iterations; i++) {
+        @autoreleasepool {
+            [self packetWithPayload:payload policy:TJPTLVTagPolicyRejectDuplicates];
+        }
+    }
+    CFTimeInterval createOnly = CFAbsoluteTimeGetCurrent() - start;
+
+    // 构建后读取单个字段
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < iterations; i++) {
+        @autoreleasepool {
+            TJPParsedPacket *packet = [self packetWithPayload:payload policy:TJPTLVTagPolicyRejectDuplicates];
+            [packet tlvValueForTag:3];
+        }
+    }
+    CFTimeInterval singleLookup = CFAbsoluteTimeGetCurrent() - start;
+
+    // 构建后访问完整字典 与旧版一次性解析开销相当
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < iterations; i++) {
+        @autoreleasepool {
+            TJPParsedPacket *packet = [self packetWithPayload:payload policy:TJPTLVTagPolicyRejectDuplicates];
+            (void)packet.tlvEntries;
+        }
+    }
+    CFTimeInterval fullDictionary = CFAbsoluteTimeGetCurrent() - start;
+
+    NSLog(@"\n=== TJPParsedPacket 构建基准测试 (6个TLV) ===");
+    NSLog(@"仅构建: %.1f ns/包", createOnly * 1e9 / iterations);
+    NSLog(@"构建+单字段查询: %.1f ns/包", singleLookup * 1e9 / iterations);
+    NSLog(@"构建+完整字典: %.1f ns/包", fullDictionary * 1e9 / iterations);
+
+    XCTAssertLessThan(createOnly, fullDictionary, @"未访问TLV时不应产生解析开销");
+}
+
+@end
@@ -0,0 +1,138 @@
+//
+//  TJPReceiveLatencyTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/18.
+//
+
+#import <XCTest/XCTest.h>
+#import <time.h>
+#import "TJPConcreteSession.h"
+#import "TJPMockFinalVersionTCPServer.h"
+#import "TJPNetworkConfig.h"
+#import "TJPConnectStateMachine.h"
+#import "TJPSessionDelegate.h"
+
+static const NSUInteger kLatencyPacketCount = 300;            // 每种模式推送的消息数
+static const useconds_t kLatencyPacketInterval = 2000;        // 推送间隔 微秒 避免排队干扰时延
+static const uint16_t kLatencyServerPort = 54330;
+
+@interface TJPReceiveLatencyTests : XCTestCase <TJPSessionDelegate>
+
+/// 服务端写出到代理回调的时延 纳秒 仅在主线程访问
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *latencies;
+@property (nonatomic, strong) XCTestExpectation *receiveExpectation;
+
+@end
+
+@implementation TJPReceiveLatencyTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+#pragma mark - TJPSessionDelegate
+- (void)session:(id<TJPSessionProtocol>)session didReceiveRawData:(NSData *)data {
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    // 载荷为Tag(2) + Length(4) + 发送时间(8)
+    if (data.length < 14) {
+        return;
+    }
+    uint64_t sendTime;
+    memcpy(&sendTime, (const uint8_t *)data.bytes + 6, sizeof(sendTime));
+    [self.latencies addObject:@(now - sendTime)];
+    if (self.latencies.count == kLatencyPacketCount) {
+        [self.receiveExpectation fulfill];
+    }
+}
+
+#pragma mark - Helper
+- (NSData *)payloadWithSendTime:(uint64_t)sendTime {
+    NSMutableData *payload = [NSMutableData data];
+    uint16_t tag = CFSwapInt16HostToBig(0x1001);
+    uint32_t length = CFSwapInt32HostToBig((uint32_t)sizeof(sendTime));
+    [payload appendBytes:&tag length:sizeof(tag)];
+    [payload appendBytes:&length length:sizeof(length)];
+    [payload appendBytes:&sendTime length:sizeof(sendTime)];
+    return payload;
+}
+
+/// 按分位取时延 毫秒
+- (double)percentile:(double)percentile ofLatencies:(NSArray<NSNumber *> *)latencies {
+    if (latencies.count == 0) {
+        return 0;
+    }
+    NSArray<NSNumber *> *sorted = [latencies sortedArrayUsingSelector:@selector(compare:)];
+    NSUInteger index = MIN((NSUInteger)(percentile * sorted.count), sorted.count - 1);
+    return sorted[index].unsignedLongLongValue / (double)NSEC_PER_MSEC;
+}
+
+/// 指定解析模式下 服务端逐条推送 收集每条消息的时延
+- (NSArray<NSNumber *> *)measureLatenciesWithMode:(TJPParseExecutionMode)mode port:(uint16_t)port {
+    TJPMockFinalVersionTCPServer *server = [[TJPMockFinalVersionTCPServer alloc] init];
+    [server startWithPort:port];
+
+    TJPNetworkConfig *config = [[TJPNetworkConfig alloc] init];
+    config.maxRetry = 0;
+    config.heartbeat = 60.0;
+    config.parseExecutionMode = mode;
+    TJPConcreteSession *session = [[TJPConcreteSession alloc] initWithConfiguration:config];
+    session.delegate = self;
+
+    XCTestExpectation *connected = [self expectationWithDescription:@"Connected"];
+    [session.stateMachine onStateChange:^(TJPConnectState oldState, TJPConnectState newState) {
+        if ([newState isEqualToString:TJPConnectStateConnected]) {
+            [connected fulfill];
+        }
+    }];
+    [session connectToHost:@"127.0.0.1" port:port];
+    [self waitForExpectations:@[connected] timeout:5.0];
+
+    // 服务端accept回调可能晚于客户端连接成功
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2.0];
+    while (server.connectedSockets.count == 0 && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    GCDAsyncSocket *socket = server.connectedSockets.firstObject;
+    XCTAssertNotNil(socket);
+
+    self.latencies = [NSMutableArray arrayWithCapacity:kLatencyPacketCount];
+    self.receiveExpectation = [self expectationWithDescription:@"Received all packets"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for (NSUInteger i = 0; i < kLatencyPacketCount; i++) {
+            [server sendDataPayload:[self payloadWithSendTime:clock_gettime_nsec_np(CLOCK_UPTIME_RAW)] toSocket:socket];
+            usleep(kLatencyPacketInterval);
+        }
+    });
+    [self waitForExpectations:@[self.receiveExpectation] timeout:20.0];
+
+    NSArray<NSNumber *> *latencies = [self.latencies copy];
+    session.delegate = nil;
+    [session disconnect];
+    [server stop];
+    return latencies;
+}
+
+#pragma mark - 基准测试
+- (void)testInlineParseReceiveLatency {
+    NSLog(@"\n=== 收包时延对比 (每种模式 %lu 条消息) ===", (unsigned long)kLatencyPacketCount);
+
+    NSArray<NSNumber *> *laneLatencies = [self measureLatenciesWithMode:TJPParseExecutionModeLane port:kLatencyServerPort];
+    NSArray<NSNumber *> *inlineLatencies = [self measureLatenciesWithMode:TJPParseExecutionModeInline port:kLatencyServerPort + 1];
+    XCTAssertEqual(laneLatencies.count, kLatencyPacketCount);
+    XCTAssertEqual(inlineLatencies.count, kLatencyPacketCount);
+
+    double laneP50 = [self percentile:0.50 ofLatencies:laneLatencies];
+    double laneP99 = [self percentile:0.99 ofLatencies:laneLatencies];
+    double inlineP50 = [self percentile:0.50 ofLatencies:inlineLatencies];
+    double inlineP99 = [self percentile:0.99 ofLatencies:inlineLatencies];
+
+    NSLog(@"解析通道模式: p50 %.3f ms, p99 %.3f ms", laneP50, laneP99);
+    NSLog(@"内联解析模式: p50 %.3f ms, p99 %.3f ms", inlineP50, inlineP99);
+    // 内联模式少了主线程转发和解析通道两次切换 墙钟时延受机器负载影响 只输出对比不做断言
+    NSLog(@"p50降低: %.3f ms (%.1f%%), p99降低: %.3f ms (%.1f%%)", laneP50 - inlineP50, (1 - inlineP50 / laneP50) * 100, laneP99 - inlineP99, (1 - inlineP99 / laneP99) * 100);
+}
+
+@end
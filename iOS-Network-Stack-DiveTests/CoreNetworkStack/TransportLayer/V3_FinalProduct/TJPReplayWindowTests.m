@@ -0,0 +1,110 @@
+//
+//  TJPReplayWindowTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/6.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPReplayWindow.h"
+#import "TJPNetworkDefine.h"
+
+static uint32_t TJPTestSequence(TJPMessageCategory category, uint32_t body) {
+    return ((uint32_t)category << TJPSEQUENCE_BODY_BITS) | (body & TJPSEQUENCE_BODY_MASK);
+}
+
+@interface TJPReplayWindowTests : XCTestCase
+
+@property (nonatomic, strong) TJPReplayWindow *window;
+@property (nonatomic, assign) uint32_t now;
+
+@end
+
+@implementation TJPReplayWindowTests
+
+- (void)setUp {
+    self.window = [[TJPReplayWindow alloc] init];
+    self.now = (uint32_t)[[NSDate date] timeIntervalSince1970];
+}
+
+- (void)tearDown {
+    self.window = nil;
+}
+
+- (TJPReplayCheckResult)checkCategory:(TJPMessageCategory)category body:(uint32_t)body {
+    return [self.window checkAndRecordSequence:TJPTestSequence(category, body) timestamp:self.now now:self.now];
+}
+
+- (void)testDuplicateAndOutOfOrderWithinWindow {
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:100], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:100], TJPReplayCheckResultDuplicate, @"窗口内重复视为重传 不作为重放");
+
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:105], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:102], TJPReplayCheckResultAccepted, @"窗口内乱序到达应接受");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:102], TJPReplayCheckResultDuplicate);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:101], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:105], TJPReplayCheckResultDuplicate);
+}
+
+- (void)testWindowSlidesAcrossWordBoundaries {
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1000], TJPReplayCheckResultAccepted);
+    // 滑动非64整数倍 验证位图跨字移位
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1000 + 70], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1000], TJPReplayCheckResultDuplicate, @"滑动后旧记录应保留");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1001], TJPReplayCheckResultAccepted);
+
+    // 滑出窗口后旧序列号视为重放
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1000 + 70 + TJPREPLAY_WINDOW_SIZE], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1001], TJPReplayCheckResultRejected, @"落后于窗口应被拒绝");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1000 + 71 + 1], TJPReplayCheckResultAccepted);
+}
+
+- (void)testCategoriesAreIndependent {
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:500], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryControl body:500], TJPReplayCheckResultAccepted, @"不同类别互不影响");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryControl body:500], TJPReplayCheckResultDuplicate);
+
+    uint32_t unknownCategory = (0x20u << TJPSEQUENCE_BODY_BITS) | 1;
+    XCTAssertEqual([self.window checkAndRecordSequence:unknownCategory timestamp:self.now now:self.now], TJPReplayCheckResultRejected, @"未知类别应被拒绝");
+}
+
+- (void)testSequenceWrapStartsNewEpoch {
+    uint32_t nearEnd = TJPSEQUENCE_RESET_THRESHOLD - 1;
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:nearEnd], TJPReplayCheckResultAccepted);
+
+    // 对端提前重置后从0开始
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:0], TJPReplayCheckResultAccepted, @"重置后的新周期应接受");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:1], TJPReplayCheckResultDuplicate);
+
+    // 新周期内重放上一周期的消息
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:nearEnd], TJPReplayCheckResultRejected, @"上一周期的序列号不应把窗口拉回");
+}
+
+- (void)testStaleSequenceBeforeWrapRejected {
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryControl body:5000], TJPReplayCheckResultAccepted);
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryControl body:10], TJPReplayCheckResultRejected, @"未接近回绕时落后于窗口应拒绝");
+}
+
+- (void)testExpiredWindowRebases {
+    uint32_t past = self.now - TJPMAX_TIME_WINDOW - 5;
+    XCTAssertEqual([self.window checkAndRecordSequence:TJPTestSequence(TJPMessageCategoryNormal, 8000) timestamp:past now:past], TJPReplayCheckResultAccepted);
+
+    // 最新消息已超出时间窗口 旧周期不可能再被重放
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:20], TJPReplayCheckResultAccepted, @"窗口过期后应重新建立");
+    XCTAssertEqual([self checkCategory:TJPMessageCategoryNormal body:20], TJPReplayCheckResultDuplicate);
+}
+
+- (void)testCheckPerformance {
+    const uint32_t count = 1000000;
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (uint32_t i = 0; i < count; i++) {
+        // 每8个包乱序一次
+        uint32_t body = (i % 8 == 7) ? i - 3 : i;
+        [self.window checkAndRecordSequence:TJPTestSequence(TJPMessageCategoryNormal, body) timestamp:self.now now:self.now];
+    }
+    CFTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+    NSLog(@"\n=== 防重放窗口检查: %.1f ns/op ===", duration * 1e9 / count);
+}
+
+@end
@@ -0,0 +1,250 @@
+//
+//  TJPRingBufferTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/3.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach.h>
+#import "TJPRingBuffer.h"
+#import "TJPNetworkDefine.h"
+
+static const NSUInteger kBenchmarkIterations = 1000000;    // 基准测试次数
+static const NSUInteger kBenchmarkChunkSize = 64;          // 每次读写字节数
+
+@interface TJPRingBufferTests : XCTestCase
+
+@end
+
+@implementation TJPRingBufferTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+#pragma mark - 功能测试
+- (void)testSPSCCapacityRoundsUpToPowerOfTwo {
+    TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:100 * 1024 mode:TJPRingBufferModeLockFreeSPSC];
+    XCTAssertEqual(buffer.capacity, 128 * 1024, @"SPSC模式容量应向上取整为2的幂");
+    XCTAssertEqual(buffer.mode, TJPRingBufferModeLockFreeSPSC);
+
+    TJPRingBuffer *queueBuffer = [[TJPRingBuffer alloc] initWithCapacity:100 * 1024];
+    XCTAssertEqual(queueBuffer.capacity, 100 * 1024, @"队列模式容量保持不变");
+    XCTAssertEqual(queueBuffer.mode, TJPRingBufferModeSerialQueue);
+}
+
+- (void)testWrapAroundConsistency {
+    for (NSNumber *modeValue in @[@(TJPRingBufferModeSerialQueue), @(TJPRingBufferModeLockFreeSPSC)]) {
+        TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:16 mode:modeValue.unsignedIntegerValue];
+        uint8_t scratch[16] = {0};
+
+        // 推进读写指针使下次写入环绕
+        XCTAssertEqual([buffer writeBytes:"0123456789" length:10], 10);
+        XCTAssertEqual([buffer readBytes:scratch length:10], 10);
+
+        const char *payload = "abcdefghijkl";
+        XCTAssertEqual([buffer writeBytes:payload length:12], 12, @"环绕写入应完整");
+        XCTAssertEqual(buffer.usedSize, 12);
+        XCTAssertEqual(buffer.availableSpace, 4);
+
+        NSData *peeked = [buffer peekData:12];
+        XCTAssertEqualObjects(peeked, [NSData dataWithBytes:payload length:12]);
+
+        NSData *read = [buffer readData:12];
+        XCTAssertEqualObjects(read, [NSData dataWithBytes:payload length:12], @"环绕读取数据应一致");
+        XCTAssertFalse([buffer hasAvailableData:1]);
+
+        // 满载后写入应被截断
+        uint8_t full[20] = {0};
+        XCTAssertEqual([buffer writeBytes:full length:20], 16);
+        XCTAssertEqual([buffer skipBytes:20], 16);
+
+        [buffer writeBytes:"xyz" length:3];
+        [buffer reset];
+        XCTAssertEqual(buffer.usedSize, 0, @"重置后应为空");
+    }
+}
+
+- (void)testSPSCCapacityNeverShrinksBelowRequest {
+    // 上限以内的请求向上取整后超出上限时应拒绝 而不是返回更小的缓冲区
+    NSUInteger requested = TJPMAX_BUFFER_SIZE - 1;
+    XCTAssertNil([[TJPRingBuffer alloc] initWithCapacity:requested mode:TJPRingBufferModeLockFreeSPSC]);
+    
+    TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:1000 mode:TJPRingBufferModeLockFreeSPSC];
+    XCTAssertEqual(buffer.capacity, 1024);
+}
+
+- (void)testReadViewSegments {
+    for (NSNumber *modeValue in @[@(TJPRingBufferModeSerialQueue), @(TJPRingBufferModeLockFreeSPSC)]) {
+        TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:16 mode:modeValue.unsignedIntegerValue];
+        TJPRingBufferReadView view;
+
+        XCTAssertFalse([buffer getReadView:&view length:1], @"空缓冲区不应返回视图");
+
+        // 连续数据 单段视图
+        [buffer writeBytes:"0123456789" length:10];
+        XCTAssertTrue([buffer getReadView:&view length:10]);
+        XCTAssertEqual(view.firstLength, 10);
+        XCTAssertEqual(view.secondLength, 0);
+        XCTAssertEqual(memcmp(view.firstSegment, "0123456789", 10), 0);
+        XCTAssertEqual(buffer.usedSize, 10, @"获取视图不应移动读指针");
+        [buffer skipBytes:10];
+
+        // 跨越尾部 两段视图
+        [buffer writeBytes:"abcdefghijkl" length:12];
+        XCTAssertTrue([buffer getReadView:&view length:12]);
+        XCTAssertEqual(view.firstLength, 6);
+        XCTAssertEqual(view.secondLength, 6);
+        XCTAssertEqual(memcmp(view.firstSegment, "abcdef", 6), 0);
+        XCTAssertEqual(memcmp(view.secondSegment, "ghijkl", 6), 0);
+        XCTAssertEqual([buffer skipBytes:12], 12);
+        XCTAssertEqual(buffer.usedSize, 0);
+    }
+}
+
+- (void)testReadViewOfAvailableData {
+    for (NSNumber *modeValue in @[@(TJPRingBufferModeSerialQueue), @(TJPRingBufferModeLockFreeSPSC)]) {
+        TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:16 mode:modeValue.unsignedIntegerValue];
+        TJPRingBufferReadView view;
+        XCTAssertEqual([buffer getReadViewOfAvailableData:&view], 0, @"空缓冲区视图长度为0");
+
+        [buffer writeBytes:"0123456789" length:10];
+        [buffer skipBytes:10];
+        [buffer writeBytes:"abcdefghijkl" length:12];
+        XCTAssertEqual([buffer getReadViewOfAvailableData:&view], 12, @"视图覆盖全部可读数据");
+        XCTAssertEqual(view.firstLength + view.secondLength, 12);
+        XCTAssertEqual(memcmp(view.firstSegment, "abcdef", view.firstLength), 0);
+        XCTAssertEqual(buffer.usedSize, 12, @"获取视图不应移动读指针");
+    }
+}
+
+- (void)testMirroredBackendIsAlwaysContiguous {
+    for (NSNumber *modeValue in @[@(TJPRingBufferModeSerialQueue), @(TJPRingBufferModeLockFreeSPSC)]) {
+        TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:1000
+                                                                   mode:modeValue.unsignedIntegerValue
+                                                                backend:TJPRingBufferBackendMirrored];
+        XCTAssertNotNil(buffer);
+        XCTAssertTrue(buffer.isMirrored, @"镜像映射应当成功");
+        XCTAssertEqual(buffer.capacity % vm_page_size, 0, @"镜像容量应按页对齐");
+
+        NSUInteger capacity = buffer.capacity;
+        NSMutableData *filler = [NSMutableData dataWithLength:capacity - 8];
+        [buffer writeData:filler];
+        [buffer skipBytes:filler.length];
+
+        // 写入跨越尾部的数据 读取视图应为单段
+        NSData *payload = [@"mirrored-ring-buffer" dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqual([buffer writeData:payload], payload.length);
+
+        TJPRingBufferReadView view;
+        XCTAssertTrue([buffer getReadView:&view length:payload.length]);
+        XCTAssertEqual(view.firstLength, payload.length, @"镜像内存下视图应始终连续");
+        XCTAssertEqual(view.secondLength, 0);
+        XCTAssertEqual(memcmp(view.firstSegment, payload.bytes, payload.length), 0);
+        XCTAssertEqualObjects([buffer readData:payload.length], payload);
+    }
+}
+
+- (void)testGrowLinearizesAndShrinksBack {
+    TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:16];
+    buffer.maxCapacity = 64;
+
+    // 制造环绕数据
+    uint8_t scratch[16] = {0};
+    [buffer writeBytes:"0123456789" length:10];
+    [buffer readBytes:scratch length:10];
+    [buffer writeBytes:"abcdefghijkl" length:12];
+
+    XCTAssertTrue([buffer ensureAvailableSpace:30], @"未超过上限时应扩容成功");
+    XCTAssertEqual(buffer.capacity, 64, @"应按2倍扩容到满足需求");
+    XCTAssertEqual(buffer.readIndex, 0, @"扩容后数据应线性化到头部");
+    XCTAssertEqualObjects([buffer peekData:12], [NSData dataWithBytes:"abcdefghijkl" length:12]);
+    XCTAssertFalse([buffer ensureAvailableSpace:60], @"超过上限时应扩容失败");
+
+    // 低使用率持续后逐级缩容 不低于初始容量
+    [buffer skipBytes:12];
+    XCTAssertFalse([buffer shrinkIfUnderusedForInterval:0], @"首次检测只开始计时");
+    XCTAssertTrue([buffer shrinkIfUnderusedForInterval:0]);
+    XCTAssertEqual(buffer.capacity, 32);
+    XCTAssertTrue([buffer shrinkIfUnderusedForInterval:0]);
+    XCTAssertEqual(buffer.capacity, 16);
+    XCTAssertFalse([buffer shrinkIfUnderusedForInterval:0], @"不应低于初始容量");
+}
+
+- (void)testSPSCConcurrentProducerConsumer {
+    TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:4096 mode:TJPRingBufferModeLockFreeSPSC];
+    const uint32_t total = 200000;
+
+    dispatch_queue_t producerQueue = dispatch_queue_create("com.tjp.test.producer", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_t consumerQueue = dispatch_queue_create("com.tjp.test.consumer", DISPATCH_QUEUE_SERIAL);
+    dispatch_group_t group = dispatch_group_create();
+
+    dispatch_group_async(group, producerQueue, ^{
+        uint32_t next = 0;
+        while (next < total) {
+            if ([buffer writeBytes:&next length:sizeof(next)] == sizeof(next)) {
+                next++;
+            }
+        }
+    });
+
+    __block BOOL ordered = YES;
+    dispatch_group_async(group, consumerQueue, ^{
+        uint32_t expected = 0;
+        uint32_t value = 0;
+        while (expected < total) {
+            if (![buffer hasAvailableData:sizeof(value)]) {
+                continue;
+            }
+            [buffer readBytes:&value length:sizeof(value)];
+            if (value != expected) {
+                ordered = NO;
+                break;
+            }
+            expected++;
+        }
+    });
+
+    long result = dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(30 * NSEC_PER_SEC)));
+    XCTAssertEqual(result, 0, @"生产消费应在超时前完成");
+    XCTAssertTrue(ordered, @"SPSC模式下数据应保持有序且不丢失");
+}
+
+#pragma mark - 基准测试
+- (void)testReadWriteBenchmark {
+    NSLog(@"\n=== 环形缓冲区读写基准测试 (%lu 字节/次) ===", (unsigned long)kBenchmarkChunkSize);
+
+    double queueNs = [self benchmarkWithMode:TJPRingBufferModeSerialQueue];
+    double spscNs = [self benchmarkWithMode:TJPRingBufferModeLockFreeSPSC];
+
+    NSLog(@"串行队列模式: %.1f ns/op", queueNs);
+    NSLog(@"SPSC无锁模式: %.1f ns/op", spscNs);
+    NSLog(@"提升倍数: %.2fx", queueNs / spscNs);
+
+    XCTAssertLessThan(spscNs, queueNs, @"SPSC模式应快于串行队列模式");
+}
+
+/// 每次操作包含 hasAvailableData + writeBytes + peekBytes + readBytes 与解析器调用路径一致
+- (double)benchmarkWithMode:(TJPRingBufferMode)mode {
+    TJPRingBuffer *buffer = [[TJPRingBuffer alloc] initWithCapacity:64 * 1024 mode:mode];
+    uint8_t chunk[kBenchmarkChunkSize];
+    uint8_t output[kBenchmarkChunkSize];
+    memset(chunk, 0xAB, sizeof(chunk));
+
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+        [buffer writeBytes:chunk length:sizeof(chunk)];
+        if ([buffer hasAvailableData:sizeof(output)]) {
+            [buffer peekBytes:output length:sizeof(output)];
+            [buffer readBytes:output length:sizeof(output)];
+        }
+    }
+    CFTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+
+    return duration * 1e9 / kBenchmarkIterations;
+}
+
+@end
@@ -0,0 +1,174 @@
+//
+//  TJPSelectiveAckTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/10.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPSelectiveAck.h"
+#import "TJPConcreteSession.h"
+#import "TJPNetworkConfig.h"
+#import "TJPMessageContext.h"
+#import "TJPParsedPacket.h"
+#import "TJPTLVContainer.h"
+#import "TJPNetworkUtil.h"
+#import "TJPNetworkDefine.h"
+
+/// 会话内部状态 仅测试使用
+@interface TJPConcreteSession (TJPSelectiveAckTesting)
+
+@property (nonatomic, strong) dispatch_queue_t sessionQueue;
+@property (nonatomic, assign) uint16_t negotiatedFeatures;
+@property (nonatomic, strong) NSMutableIndexSet *pendingAckSequences;
+
+- (void)processReceivedPacket:(TJPParsedPacket *)packet;
+- (void)scheduleDelayedAckForSequences:(NSIndexSet *)sequences;
+
+@end
+
+@interface TJPSelectiveAckTests : XCTestCase
+
+@end
+
+@implementation TJPSelectiveAckTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (TJPConcreteSession *)selectiveAckSession {
+    TJPConcreteSession *session = [[TJPConcreteSession alloc] initWithConfiguration:[TJPNetworkConfig defaultConfig]];
+    session.negotiatedFeatures = TJP_FEATURE_SELECTIVE_ACK;
+    return session;
+}
+
+#pragma mark - 编解码
+- (void)testEncodeDecodeRoundTrip {
+    NSMutableIndexSet *sequences = [NSMutableIndexSet indexSet];
+    [sequences addIndexesInRange:NSMakeRange(500, 3)];
+    [sequences addIndex:563];
+    [sequences addIndex:9000];
+
+    NSData *packetData = [TJPSelectiveAck ackPacketWithSequences:sequences sessionID:0x1234];
+    TJPFinalAdavancedHeader header;
+    [packetData getBytes:&header length:sizeof(header)];
+    XCTAssertEqual(ntohs(header.msgType), TJPMessageTypeACK);
+    XCTAssertEqual(ntohl(header.sequence), 500, @"协议头序列号为首个区段的base 兼容单个ACK");
+    XCTAssertEqual(ntohs(header.session_id), 0x1234);
+
+    NSData *body = [packetData subdataWithRange:NSMakeRange(sizeof(header), packetData.length - sizeof(header))];
+    XCTAssertEqual(ntohl(header.bodyLength), body.length);
+    XCTAssertEqual(ntohl(header.checksum), [TJPNetworkUtil crc32ForData:body]);
+
+    TJPTLVContainer *container = [[TJPTLVContainer alloc] initWithData:body policy:TJPTLVTagPolicyRejectDuplicates maxNestedDepth:4];
+    NSData *value = [container valueForTag:TJP_TLV_TAG_SELECTIVE_ACK];
+    XCTAssertNotNil(value);
+    XCTAssertEqualObjects([TJPSelectiveAck sequencesFromValue:value], sequences);
+}
+
+- (void)testMalformedValueRejected {
+    NSData *value = [TJPSelectiveAck valueWithSequences:[NSIndexSet indexSetWithIndex:7]];
+    XCTAssertNil([TJPSelectiveAck sequencesFromValue:[value subdataWithRange:NSMakeRange(0, value.length - 1)]], @"长度不是区段整数倍");
+
+    // base位未置1
+    uint32_t base = htonl(10);
+    uint64_t bitmap = OSSwapHostToBigInt64(0x2);
+    NSMutableData *invalid = [NSMutableData dataWithBytes:&base length:sizeof(base)];
+    [invalid appendBytes:&bitmap length:sizeof(bitmap)];
+    XCTAssertNil([TJPSelectiveAck sequencesFromValue:invalid]);
+}
+
+#pragma mark - 区段合并与拆分
+- (void)testOutOfOrderRangesMergeIntoOneSegment {
+    // 乱序到达的序列号在64位内合并为一个区段
+    NSMutableIndexSet *sequences = [NSMutableIndexSet indexSet];
+    for (NSNumber *sequence in @[@105, @100, @163, @101, @130]) {
+        [sequences addIndex:sequence.unsignedIntegerValue];
+    }
+    NSData *value = [TJPSelectiveAck valueWithSequences:sequences];
+    XCTAssertEqual(value.length, 12, @"跨度不超过64 编码为一个区段");
+    XCTAssertEqualObjects([TJPSelectiveAck sequencesFromValue:value], sequences);
+}
+
+- (void)testDistantRangesSplitIntoSegments {
+    // 跨度超过位图宽度时拆分 每个区段以其首个序列号为base
+    NSMutableIndexSet *sequences = [NSMutableIndexSet indexSet];
+    [sequences addIndexesInRange:NSMakeRange(1, 4)];
+    [sequences addIndex:1 + TJP_SELECTIVE_ACK_BITMAP_BITS];
+    [sequences addIndexesInRange:NSMakeRange(1000, 2)];
+    NSData *value = [TJPSelectiveAck valueWithSequences:sequences];
+    XCTAssertEqual(value.length, 3 * 12);
+
+    uint32_t secondBase = 0;
+    [value getBytes:&secondBase range:NSMakeRange(12, sizeof(secondBase))];
+    XCTAssertEqual(ntohl(secondBase), 1 + TJP_SELECTIVE_ACK_BITMAP_BITS);
+    XCTAssertEqualObjects([TJPSelectiveAck sequencesFromValue:value], sequences);
+}
+
+#pragma mark - 会话收发
+- (void)testReceivedSackRetiresOnlyCoveredMessages {
+    TJPConcreteSession *session = [self selectiveAckSession];
+    dispatch_sync(session.sessionQueue, ^{
+        for (uint32_t sequence = 1; sequence <= 6; sequence++) {
+            NSString *messageId = [NSString stringWithFormat:@"msg-%u", sequence];
+            TJPMessageContext *context = [TJPMessageContext contextWithData:[NSData dataWithBytes:&sequence length:sizeof(sequence)] seq:sequence messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:session.sessionId];
+            context.messageId = messageId;
+            session.pendingMessages[messageId] = context;
+            session.sequenceToMessageId[@(sequence)] = messageId;
+        }
+    });
+
+    NSMutableIndexSet *acked = [NSMutableIndexSet indexSet];
+    [acked addIndexesInRange:NSMakeRange(1, 2)];
+    [acked addIndex:4];
+    NSData *ackData = [TJPSelectiveAck ackPacketWithSequences:acked sessionID:0];
+    TJPFinalAdavancedHeader header;
+    [ackData getBytes:&header length:sizeof(header)];
+    NSData *body = [ackData subdataWithRange:NSMakeRange(sizeof(header), ackData.length - sizeof(header))];
+    TJPParsedPacket *packet = [TJPParsedPacket packetWithHeader:header payload:body policy:TJPTLVTagPolicyRejectDuplicates maxNestedDepth:4 error:nil];
+    XCTAssertNotNil(packet);
+
+    dispatch_sync(session.sessionQueue, ^{
+        [session processReceivedPacket:packet];
+    });
+
+    __block NSArray<NSString *> *remaining = nil;
+    dispatch_sync(session.sessionQueue, ^{
+        remaining = [session.pendingMessages.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    });
+    XCTAssertEqualObjects(remaining, (@[@"msg-3", @"msg-5", @"msg-6"]), @"只移除SACK覆盖的在途消息");
+}
+
+- (void)testReceivedDataAcknowledgedInBatches {
+    TJPConcreteSession *session = [self selectiveAckSession];
+
+    // 未达阈值 等待延迟确认
+    NSMutableIndexSet *sequences = [NSMutableIndexSet indexSetWithIndex:1];
+    [sequences addIndex:3];
+    [session scheduleDelayedAckForSequences:sequences];
+    __block NSUInteger pending = 0;
+    dispatch_sync(session.sessionQueue, ^{
+        pending = session.pendingAckSequences.count;
+    });
+    XCTAssertEqual(pending, 2);
+
+    // 延迟到期后一次发出
+    XCTestExpectation *flushed = [self expectationWithDescription:@"Delayed ACK flushed"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(TJP_DELAYED_ACK_INTERVAL * 3 * NSEC_PER_SEC)), session.sessionQueue, ^{
+        XCTAssertEqual(session.pendingAckSequences.count, 0);
+        [flushed fulfill];
+    });
+    [self waitForExpectations:@[flushed] timeout:2.0];
+
+    // 累计达到阈值立即发出
+    [session scheduleDelayedAckForSequences:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(10, TJP_DELAYED_ACK_MAX_PACKETS)]];
+    dispatch_sync(session.sessionQueue, ^{
+        pending = session.pendingAckSequences.count;
+    });
+    XCTAssertEqual(pending, 0);
+}
+
+@end
@@ -0,0 +1,128 @@
+//
+//  TJPSendSchedulerTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/13.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPSendScheduler.h"
+#import "TJPSendWindow.h"
+#import "TJPMessageContext.h"
+
+static const NSUInteger kSchedulerTestQuantum = 1024;
+
+@interface TJPSendSchedulerTests : XCTestCase
+
+@property (nonatomic, strong) TJPSendScheduler *scheduler;
+
+@end
+
+@implementation TJPSendSchedulerTests
+
+- (void)setUp {
+    self.scheduler = [[TJPSendScheduler alloc] initWithQuantum:kSchedulerTestQuantum];
+}
+
+- (void)tearDown {
+    self.scheduler = nil;
+}
+
+- (TJPMessageContext *)messageWithLength:(NSUInteger)length priority:(TJPMessagePriority)priority {
+    TJPMessageContext *context = [TJPMessageContext contextWithData:[NSMutableData dataWithLength:length] seq:0 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@"test-session"];
+    context.priority = priority;
+    return context;
+}
+
+/// 每条消息计入额度的字节数恰好为quantum
+- (TJPMessageContext *)quantumMessageWithPriority:(TJPMessagePriority)priority {
+    return [self messageWithLength:kSchedulerTestQuantum - sizeof(TJPFinalAdavancedHeader) priority:priority];
+}
+
+#pragma mark - 功能测试
+- (void)testUrgentIsStrictPriority {
+    for (NSUInteger i = 0; i < 3; i++) {
+        [self.scheduler enqueueMessage:[self quantumMessageWithPriority:TJPMessagePriorityHigh]];
+    }
+    TJPMessageContext *urgent = [self messageWithLength:10 priority:TJPMessagePriorityUrgent];
+    [self.scheduler dequeueMessage];
+    [self.scheduler enqueueMessage:urgent];
+    
+    XCTAssertEqual([self.scheduler peekMessage], urgent);
+    XCTAssertEqual([self.scheduler peekMessage], urgent, @"peek不应改变调度结果");
+    XCTAssertEqual([self.scheduler dequeueMessage], urgent, @"紧急消息应立即插到最前");
+}
+
+- (void)testWeightedFairSharing {
+    // 三个级别都积压时 出队比例应接近权重4:2:1
+    for (NSUInteger i = 0; i < 100; i++) {
+        [self.scheduler enqueueMessage:[self quantumMessageWithPriority:TJPMessagePriorityHigh]];
+        [self.scheduler enqueueMessage:[self quantumMessageWithPriority:TJPMessagePriorityNormal]];
+        [self.scheduler enqueueMessage:[self quantumMessageWithPriority:TJPMessagePriorityLow]];
+    }
+    
+    NSUInteger counts[TJPMessagePriorityUrgent + 1] = {0};
+    for (NSUInteger i = 0; i < 70; i++) {
+        counts[[self.scheduler dequeueMessage].priority]++;
+    }
+    XCTAssertEqual(counts[TJPMessagePriorityHigh], 40);
+    XCTAssertEqual(counts[TJPMessagePriorityNormal], 20);
+    XCTAssertEqual(counts[TJPMessagePriorityLow], 10);
+}
+
+- (void)testLargeMessageDoesNotStarveOtherLevels {
+    // 大消息需要累积多轮额度 期间其他级别照常发送
+    TJPMessageContext *large = [self messageWithLength:20 * kSchedulerTestQuantum priority:TJPMessagePriorityHigh];
+    [self.scheduler enqueueMessage:large];
+    for (NSUInteger i = 0; i < 10; i++) {
+        [self.scheduler enqueueMessage:[self messageWithLength:10 priority:TJPMessagePriorityLow]];
+    }
+    
+    XCTAssertEqual([self.scheduler dequeueMessage].priority, TJPMessagePriorityLow, @"低优先级小消息先获得发送机会");
+    NSUInteger position = 1;
+    TJPMessageContext *message = nil;
+    while ((message = [self.scheduler dequeueMessage])) {
+        position++;
+        if (message == large) break;
+    }
+    XCTAssertEqual(message, large, @"大消息最终也能发出");
+    XCTAssertEqual(position, 11, @"低优先级消息全部发出后才轮到大消息");
+}
+
+- (void)testFIFOWithinLevel {
+    NSMutableArray *messages = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 5; i++) {
+        TJPMessageContext *message = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+        [messages addObject:message];
+        [self.scheduler enqueueMessage:message];
+    }
+    for (TJPMessageContext *message in messages) {
+        XCTAssertEqual([self.scheduler dequeueMessage], message);
+    }
+    XCTAssertNil([self.scheduler dequeueMessage]);
+}
+
+- (void)testStatistics {
+    [self.scheduler enqueueMessage:[self messageWithLength:10 priority:TJPMessagePriorityLow]];
+    [self.scheduler enqueueMessage:[self messageWithLength:20 priority:TJPMessagePriorityLow]];
+    [self.scheduler enqueueMessage:[self messageWithLength:30 priority:TJPMessagePriorityHigh]];
+    XCTAssertEqual([self.scheduler queueDepthForPriority:TJPMessagePriorityLow], 2);
+    XCTAssertEqual(self.scheduler.totalBytes, 60 + 3 * sizeof(TJPFinalAdavancedHeader));
+    
+    [self.scheduler dequeueMessage];
+    NSDictionary *statistics = [self.scheduler statistics];
+    NSDictionary *high = statistics[@(TJPMessagePriorityHigh)];
+    XCTAssertEqualObjects(high[@"dequeued"], @1);
+    XCTAssertEqualObjects(high[@"queueDepth"], @0);
+    
+    NSArray<NSNumber *> *histogram = high[@"latencyHistogram"];
+    XCTAssertEqual(histogram.count, [TJPSendScheduler latencyHistogramBounds].count + 1);
+    XCTAssertEqual([[histogram valueForKeyPath:@"@sum.self"] integerValue], 1, @"出队一次应落入一个时延桶");
+    
+    NSArray *remaining = [self.scheduler removeAllMessages];
+    XCTAssertEqual(remaining.count, 2);
+    XCTAssertEqual(self.scheduler.count, 0);
+    XCTAssertEqual(self.scheduler.totalBytes, 0);
+}
+
+@end
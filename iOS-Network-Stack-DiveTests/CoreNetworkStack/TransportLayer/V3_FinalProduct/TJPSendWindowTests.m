@@ -0,0 +1,147 @@
+//
+//  TJPSendWindowTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/12.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPSendWindow.h"
+#import "TJPMessageContext.h"
+
+@interface TJPSendWindowTests : XCTestCase
+
+@end
+
+@implementation TJPSendWindowTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (TJPMessageContext *)messageWithLength:(NSUInteger)length priority:(TJPMessagePriority)priority {
+    TJPMessageContext *context = [TJPMessageContext contextWithData:[NSMutableData dataWithLength:length] seq:0 messageType:TJPMessageTypeNormalData encryptType:TJPEncryptTypeCRC32 compressType:TJPCompressTypeNone sessionId:@"test-session"];
+    context.priority = priority;
+    return context;
+}
+
+#pragma mark - 功能测试
+- (void)testMessageCountLimit {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:2 maxInFlightBytes:0];
+    TJPMessageContext *first = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *second = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *third = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    [window enqueueMessage:first];
+    [window enqueueMessage:second];
+    [window enqueueMessage:third];
+    
+    XCTAssertEqual([window dequeueSendableMessage], first);
+    XCTAssertEqual([window dequeueSendableMessage], second);
+    XCTAssertNil([window dequeueSendableMessage], @"在途消息数已满");
+    XCTAssertEqual(window.inFlightCount, 2);
+    XCTAssertEqual(window.queuedCount, 1);
+    
+    XCTAssertTrue([window releaseMessageId:first.messageId]);
+    XCTAssertFalse([window releaseMessageId:first.messageId], @"重复释放应返回NO");
+    XCTAssertEqual([window dequeueSendableMessage], third, @"ACK释放额度后继续发送");
+}
+
+- (void)testByteBudget {
+    NSUInteger header = sizeof(TJPFinalAdavancedHeader);
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:0 maxInFlightBytes:2 * (100 + header)];
+    TJPMessageContext *first = [self messageWithLength:100 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *second = [self messageWithLength:100 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *third = [self messageWithLength:1 priority:TJPMessagePriorityNormal];
+    [window enqueueMessage:first];
+    [window enqueueMessage:second];
+    [window enqueueMessage:third];
+    
+    XCTAssertNotNil([window dequeueSendableMessage]);
+    XCTAssertNotNil([window dequeueSendableMessage]);
+    XCTAssertEqual(window.inFlightBytes, 2 * (100 + header));
+    XCTAssertNil([window dequeueSendableMessage], @"字节预算已用完");
+    XCTAssertEqual(window.queuedBytes, 1 + header);
+}
+
+- (void)testOversizedMessageAllowedWhenWindowEmpty {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:0 maxInFlightBytes:1024];
+    TJPMessageContext *large = [self messageWithLength:4096 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *small = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    [window enqueueMessage:large];
+    [window enqueueMessage:small];
+    
+    XCTAssertEqual([window dequeueSendableMessage], large, @"窗口为空时超大消息也应放行");
+    XCTAssertNil([window dequeueSendableMessage]);
+    [window releaseMessageId:large.messageId];
+    XCTAssertEqual([window dequeueSendableMessage], small);
+}
+
+- (void)testPriorityOrder {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:0 maxInFlightBytes:0];
+    TJPMessageContext *low = [self messageWithLength:10 priority:TJPMessagePriorityLow];
+    TJPMessageContext *normal1 = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *normal2 = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *urgent = [self messageWithLength:10 priority:TJPMessagePriorityUrgent];
+    [window enqueueMessage:low];
+    [window enqueueMessage:normal1];
+    [window enqueueMessage:normal2];
+    [window enqueueMessage:urgent];
+    
+    XCTAssertEqual([window dequeueSendableMessage], urgent);
+    XCTAssertEqual([window dequeueSendableMessage], normal1, @"同优先级先进先出");
+    XCTAssertEqual([window dequeueSendableMessage], normal2);
+    XCTAssertEqual([window dequeueSendableMessage], low);
+    XCTAssertNil([window dequeueSendableMessage]);
+}
+
+- (void)testAdvertisedWindowShrinksLimit {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:10 maxInFlightBytes:0];
+    window.advertisedMessages = 1;
+    [window enqueueMessage:[self messageWithLength:10 priority:TJPMessagePriorityNormal]];
+    [window enqueueMessage:[self messageWithLength:10 priority:TJPMessagePriorityNormal]];
+    
+    XCTAssertNotNil([window dequeueSendableMessage]);
+    XCTAssertNil([window dequeueSendableMessage], @"取本地与对端通告的较小值");
+    
+    window.advertisedMessages = 0;
+    XCTAssertNotNil([window dequeueSendableMessage], @"撤销通告后恢复本地限制");
+}
+
+- (void)testResetReturnsQueuedMessages {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:1 maxInFlightBytes:0];
+    [window enqueueMessage:[self messageWithLength:10 priority:TJPMessagePriorityNormal]];
+    TJPMessageContext *queued = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    [window enqueueMessage:queued];
+    [window dequeueSendableMessage];
+    
+    NSArray *remaining = [window reset];
+    XCTAssertEqualObjects(remaining, @[queued]);
+    XCTAssertEqual(window.inFlightCount, 0);
+    XCTAssertEqual(window.inFlightBytes, 0);
+    XCTAssertEqual(window.queuedCount, 0);
+    XCTAssertEqual(window.queuedBytes, 0);
+}
+
+- (void)testControlFrameBypassesCredits {
+    TJPSendWindow *window = [[TJPSendWindow alloc] initWithMaxInFlightMessages:1 maxInFlightBytes:0];
+    TJPMessageContext *data = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    TJPMessageContext *queued = [self messageWithLength:10 priority:TJPMessagePriorityNormal];
+    [window enqueueMessage:data];
+    [window enqueueMessage:queued];
+    XCTAssertEqual([window dequeueSendableMessage], data);
+    XCTAssertNil([window dequeueSendableMessage], @"窗口已满");
+
+    // 窗口关闭时控制帧照常发出 且排在已排队的数据之前
+    NSData *ackPacket = [NSMutableData dataWithLength:sizeof(TJPFinalAdavancedHeader) + 4];
+    TJPMessageContext *ack = [TJPMessageContext controlContextWithPacket:ackPacket messageType:TJPMessageTypeACK seq:7 sessionId:@"test-session"];
+    XCTAssertEqual(ack.priority, TJPMessagePriorityUrgent);
+    [window enqueueMessage:ack];
+    XCTAssertEqual(window.queuedBytes, ackPacket.length + [TJPSendWindow windowBytesForMessage:queued]);
+    XCTAssertEqual([window dequeueSendableMessage], ack);
+    XCTAssertEqual(window.inFlightCount, 1, @"控制帧不计入在途");
+    XCTAssertNil([window dequeueSendableMessage]);
+}
+
+@end
@@ -0,0 +1,151 @@
+//
+//  TJPSessionIdleListTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//
+
+#import <XCTest/XCTest.h>
+#import <time.h>
+#import "TJPSessionIdleList.h"
+#import "TJPConcreteSession.h"
+#import "TJPNetworkConfig.h"
+
+static const NSUInteger kIdleListAcquireRounds = 2000;   // 每种池大小的获取/归还轮数
+
+@interface TJPSessionIdleListTests : XCTestCase
+
+@end
+
+@implementation TJPSessionIdleListTests
+
+- (void)setUp {
+}
+
+- (void)tearDown {
+}
+
+- (TJPConcreteSession *)sessionActiveSecondsAgo:(NSTimeInterval)seconds {
+    TJPConcreteSession *session = [[TJPConcreteSession alloc] initWithConfiguration:[TJPNetworkConfig defaultConfig]];
+    session.lastActiveTime = [NSDate dateWithTimeIntervalSinceNow:-seconds];
+    return session;
+}
+
+#pragma mark - 功能测试
+- (void)testInsertKeepsMostRecentlyActiveAtHead {
+    TJPSessionIdleList *list = [[TJPSessionIdleList alloc] init];
+    TJPConcreteSession *older = [self sessionActiveSecondsAgo:30];
+    TJPConcreteSession *newest = [self sessionActiveSecondsAgo:1];
+    TJPConcreteSession *oldest = [self sessionActiveSecondsAgo:120];
+
+    [list insertSession:older];
+    [list insertSession:newest];
+    [list insertSession:oldest];
+
+    XCTAssertEqual(list.count, 3);
+    XCTAssertEqual(list.head, newest);
+    XCTAssertEqual(list.tail, oldest);
+    XCTAssertEqualObjects([list allSessions], (@[newest, older, oldest]));
+
+    // 重复插入被忽略
+    [list insertSession:older];
+    XCTAssertEqual(list.count, 3);
+}
+
+- (void)testRemoveAndPop {
+    TJPSessionIdleList *list = [[TJPSessionIdleList alloc] init];
+    TJPConcreteSession *a = [self sessionActiveSecondsAgo:1];
+    TJPConcreteSession *b = [self sessionActiveSecondsAgo:2];
+    TJPConcreteSession *c = [self sessionActiveSecondsAgo:3];
+    [list insertSession:a];
+    [list insertSession:b];
+    [list insertSession:c];
+
+    // 摘除中间节点
+    XCTAssertTrue([list removeSession:b]);
+    XCTAssertFalse([list removeSession:b]);
+    XCTAssertFalse([list containsSession:b]);
+    XCTAssertNil(b.poolPrev);
+    XCTAssertNil(b.poolNext);
+    XCTAssertEqualObjects([list allSessions], (@[a, c]));
+
+    XCTAssertEqual([list popTail], c);
+    XCTAssertEqual([list popHead], a);
+    XCTAssertNil([list popHead]);
+    XCTAssertNil(list.tail);
+    XCTAssertEqual(list.count, 0);
+}
+
+- (void)testReleasedSessionReturnsToHead {
+    TJPSessionIdleList *list = [[TJPSessionIdleList alloc] init];
+    for (NSUInteger i = 1; i <= 4; i++) {
+        [list insertSession:[self sessionActiveSecondsAgo:i * 10]];
+    }
+
+    // 取出复用后再归还 刚活跃过 回到头部
+    TJPConcreteSession *session = [list popTail];
+    session.lastActiveTime = [NSDate date];
+    [list insertSession:session];
+    XCTAssertEqual(list.head, session);
+    XCTAssertEqual(list.count, 4);
+}
+
+#pragma mark - 基准测试
+- (void)testAcquireCostIndependentOfPoolSize {
+    NSLog(@"\n=== 会话池获取耗时 (每种池大小 %lu 轮获取/归还) ===", (unsigned long)kIdleListAcquireRounds);
+    NSArray<NSNumber *> *poolSizes = @[@8, @64, @256];
+    NSMutableArray<NSNumber *> *listCosts = [NSMutableArray array];
+
+    for (NSNumber *poolSize in poolSizes) {
+        NSMutableArray<TJPConcreteSession *> *sessions = [NSMutableArray array];
+        for (NSUInteger i = 0; i < poolSize.unsignedIntegerValue; i++) {
+            [sessions addObject:[self sessionActiveSecondsAgo:i + 1]];
+        }
+
+        // 旧实现: 复制数组 逐个健康检查并计算空闲时间 选出空闲最短的会话
+        NSMutableArray<TJPConcreteSession *> *legacyPool = [sessions mutableCopy];
+        uint64_t start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        for (NSUInteger round = 0; round < kIdleListAcquireRounds; round++) {
+            TJPConcreteSession *best = nil;
+            NSTimeInterval shortestIdleTime = INFINITY;
+            for (TJPConcreteSession *session in [legacyPool copy]) {
+                [session checkHealthyForSession];
+                NSTimeInterval idleTime = [[NSDate date] timeIntervalSinceDate:session.lastActiveTime];
+                if (idleTime < shortestIdleTime) {
+                    shortestIdleTime = idleTime;
+                    best = session;
+                }
+            }
+            [legacyPool removeObject:best];
+            best.lastActiveTime = [NSDate date];
+            [legacyPool addObject:best];
+        }
+        double legacyNs = (double)(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start) / kIdleListAcquireRounds;
+
+        // 新实现: 取链表头部 只检查候选
+        TJPSessionIdleList *list = [[TJPSessionIdleList alloc] init];
+        for (TJPConcreteSession *session in sessions) {
+            [list insertSession:session];
+        }
+        start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        for (NSUInteger round = 0; round < kIdleListAcquireRounds; round++) {
+            TJPConcreteSession *best = [list popHead];
+            [best checkHealthyForSession];
+            best.lastActiveTime = [NSDate date];
+            [list insertSession:best];
+        }
+        double listNs = (double)(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start) / kIdleListAcquireRounds;
+        [listCosts addObject:@(listNs)];
+        [list removeAllSessions];
+
+        NSLog(@"池大小 %3lu: 旧实现 %.2f μs/次, 空闲链表 %.2f μs/次, 提升 %.1fx", (unsigned long)poolSize.unsignedIntegerValue, legacyNs / 1000, listNs / 1000, legacyNs / listNs);
+        XCTAssertLessThan(listNs, legacyNs);
+    }
+
+    // 池扩大32倍 单次获取耗时应基本不变
+    double growth = listCosts.lastObject.doubleValue / listCosts.firstObject.doubleValue;
+    NSLog(@"空闲链表耗时增长 (256 vs 8): %.2fx", growth);
+    XCTAssertLessThan(growth, 4.0);
+}
+
+@end
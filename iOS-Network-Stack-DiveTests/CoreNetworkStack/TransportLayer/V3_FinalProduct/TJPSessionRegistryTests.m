@@ -0,0 +1,180 @@
+//
+//  TJPSessionRegistryTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "TJPSessionRegistry.h"
+#import "TJPConcreteSession.h"
+#import "TJPNetworkConfig.h"
+
+static const NSUInteger kRegistrySenderThreads = 8;           // 并发发送线程数
+static const NSUInteger kRegistryLookupsPerThread = 20000;     // 每个线程的查找次数
+static const useconds_t kRegistryBookkeepingMicroseconds = 50; // 模拟一次会话回收/重连的管理耗时
+
+@interface TJPSessionRegistryTests : XCTestCase
+
+@property (nonatomic, strong) NSArray<TJPConcreteSession *> *sessions;
+
+@end
+
+@implementation TJPSessionRegistryTests
+
+- (void)setUp {
+    NSMutableArray<TJPConcreteSession *> *sessions = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 4; i++) {
+        [sessions addObject:[[TJPConcreteSession alloc] initWithConfiguration:[TJPNetworkConfig defaultConfig]]];
+    }
+    self.sessions = sessions;
+}
+
+- (void)tearDown {
+    self.sessions = nil;
+}
+
+#pragma mark - 功能测试
+- (void)testRegisterAndLookup {
+    TJPSessionRegistry *registry = [[TJPSessionRegistry alloc] init];
+    TJPConcreteSession *chat = self.sessions[0];
+    TJPConcreteSession *media = self.sessions[1];
+
+    XCTAssertNil([registry registerSession:chat type:TJPSessionTypeChat]);
+    XCTAssertNil([registry registerSession:media type:TJPSessionTypeMedia]);
+    XCTAssertEqual(registry.count, 2);
+    XCTAssertEqual([registry sessionForType:TJPSessionTypeChat], chat);
+    XCTAssertEqual([registry sessionWithId:media.sessionId], media);
+    XCTAssertNil([registry sessionForType:TJPSessionTypeFile]);
+
+    // 同类型重新注册 返回原映射
+    TJPConcreteSession *newChat = self.sessions[2];
+    XCTAssertEqualObjects([registry registerSession:newChat type:TJPSessionTypeChat], chat.sessionId);
+    XCTAssertEqual([registry sessionForType:TJPSessionTypeChat], newChat);
+    XCTAssertEqual(registry.count, 3, @"旧会话仍在活跃表中 直到显式移除");
+}
+
+- (void)testUnregisterOnlyRemovesOwnTypeMapping {
+    TJPSessionRegistry *registry = [[TJPSessionRegistry alloc] init];
+    TJPConcreteSession *oldChat = self.sessions[0];
+    TJPConcreteSession *newChat = self.sessions[1];
+    [registry registerSession:oldChat type:TJPSessionTypeChat];
+    [registry registerSession:newChat type:TJPSessionTypeChat];
+
+    // 类型映射已指向新会话 移除旧会话不影响映射
+    XCTAssertTrue([registry unregisterSession:oldChat]);
+    XCTAssertEqual([registry sessionForType:TJPSessionTypeChat], newChat);
+
+    XCTAssertTrue([registry unregisterSession:newChat]);
+    XCTAssertNil([registry sessionForType:TJPSessionTypeChat]);
+    XCTAssertEqual(registry.count, 0);
+    XCTAssertFalse([registry unregisterSession:newChat]);
+}
+
+- (void)testSnapshotsAreImmutable {
+    TJPSessionRegistry *registry = [[TJPSessionRegistry alloc] init];
+    [registry registerSession:self.sessions[0] type:TJPSessionTypeChat];
+    NSDictionary *snapshot = registry.sessionsById;
+    NSDictionary *typeSnapshot = registry.sessionIdsByType;
+
+    [registry registerSession:self.sessions[1] type:TJPSessionTypeMedia];
+    [registry unregisterSession:self.sessions[0]];
+
+    XCTAssertEqual(snapshot.count, 1, @"已取出的快照不受后续写入影响");
+    XCTAssertEqual(typeSnapshot.count, 1);
+    XCTAssertEqual(registry.sessionsById.count, 1);
+    XCTAssertEqualObjects(registry.sessionIdsByType[@(TJPSessionTypeMedia)], self.sessions[1].sessionId);
+}
+
+#pragma mark - 基准测试
+- (void)testLookupContentionBenchmark {
+    NSLog(@"\n=== 会话查找竞争基准测试 (%lu 线程 x %lu 次查找, 后台持续增删会话) ===", (unsigned long)kRegistrySenderThreads, (unsigned long)kRegistryLookupsPerThread);
+    NSArray<NSNumber *> *types = @[@(TJPSessionTypeChat), @(TJPSessionTypeMedia), @(TJPSessionTypeSignaling), @(TJPSessionTypeFile)];
+
+    // 旧实现: 串行队列 + dispatch_sync 读写 管理操作在同一队列内执行
+    dispatch_queue_t legacyQueue = dispatch_queue_create("com.tjp.test.legacyRegistry", DISPATCH_QUEUE_SERIAL);
+    NSMapTable<NSString *, TJPConcreteSession *> *legacyMap = [NSMapTable strongToStrongObjectsMapTable];
+    NSMutableDictionary<NSNumber *, NSString *> *legacyTypeMap = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < types.count; i++) {
+        [legacyMap setObject:self.sessions[i] forKey:self.sessions[i].sessionId];
+        legacyTypeMap[types[i]] = self.sessions[i].sessionId;
+    }
+
+    __block atomic_ulong legacyHits = 0;
+    CFTimeInterval legacyDuration = [self runLookupsWithWriter:^(NSUInteger round) {
+        TJPConcreteSession *session = self.sessions[round % types.count];
+        dispatch_sync(legacyQueue, ^{
+            [legacyMap removeObjectForKey:session.sessionId];
+            usleep(kRegistryBookkeepingMicroseconds);
+            [legacyMap setObject:session forKey:session.sessionId];
+        });
+    } lookup:^(NSUInteger index) {
+        __block TJPConcreteSession *session = nil;
+        dispatch_sync(legacyQueue, ^{
+            NSString *sessionId = legacyTypeMap[types[index % types.count]];
+            session = sessionId ? [legacyMap objectForKey:sessionId] : nil;
+        });
+        if (session) {
+            atomic_fetch_add_explicit(&legacyHits, 1, memory_order_relaxed);
+        }
+    }];
+
+    // 新实现: 写时复制快照 管理操作不阻塞查找
+    TJPSessionRegistry *registry = [[TJPSessionRegistry alloc] init];
+    for (NSUInteger i = 0; i < types.count; i++) {
+        [registry registerSession:self.sessions[i] type:types[i].unsignedIntegerValue];
+    }
+    dispatch_queue_t bookkeepingQueue = dispatch_queue_create("com.tjp.test.bookkeeping", DISPATCH_QUEUE_SERIAL);
+
+    __block atomic_ulong registryHits = 0;
+    CFTimeInterval registryDuration = [self runLookupsWithWriter:^(NSUInteger round) {
+        NSUInteger index = round % types.count;
+        TJPConcreteSession *session = self.sessions[index];
+        [registry unregisterSession:session];
+        dispatch_sync(bookkeepingQueue, ^{
+            usleep(kRegistryBookkeepingMicroseconds);
+        });
+        [registry registerSession:session type:types[index].unsignedIntegerValue];
+    } lookup:^(NSUInteger index) {
+        if ([registry sessionForType:types[index % types.count].unsignedIntegerValue]) {
+            atomic_fetch_add_explicit(&registryHits, 1, memory_order_relaxed);
+        }
+    }];
+
+    double totalLookups = kRegistrySenderThreads * kRegistryLookupsPerThread;
+    NSLog(@"旧实现(串行队列): %.2f M次/秒, 命中 %lu", totalLookups / legacyDuration / 1e6, atomic_load(&legacyHits));
+    NSLog(@"新实现(写时复制): %.2f M次/秒, 命中 %lu", totalLookups / registryDuration / 1e6, atomic_load(&registryHits));
+    NSLog(@"提升倍数: %.2fx", legacyDuration / registryDuration);
+
+    // 耗时受机器负载影响 只输出对比 不做断言
+    XCTAssertGreaterThan(atomic_load(&legacyHits), 0);
+    XCTAssertGreaterThan(atomic_load(&registryHits), 0);
+}
+
+/// 多线程并发查找 同时后台线程持续执行写操作 返回查找总耗时
+- (CFTimeInterval)runLookupsWithWriter:(void (^)(NSUInteger round))writer lookup:(void (^)(NSUInteger index))lookup {
+    __block atomic_bool finished = false;
+    dispatch_semaphore_t writerDone = dispatch_semaphore_create(0);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSUInteger round = 0;
+        while (!atomic_load(&finished)) {
+            writer(round++);
+        }
+        dispatch_semaphore_signal(writerDone);
+    });
+
+    CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+    dispatch_apply(kRegistrySenderThreads, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < kRegistryLookupsPerThread; i++) {
+            lookup(thread + i);
+        }
+    });
+    CFTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+
+    atomic_store(&finished, true);
+    dispatch_semaphore_wait(writerDone, DISPATCH_TIME_FOREVER);
+    return duration;
+}
+
+@end
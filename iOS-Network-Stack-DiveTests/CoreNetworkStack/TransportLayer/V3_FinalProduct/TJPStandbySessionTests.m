@@ -0,0 +1,141 @@
+//
+//  TJPStandbySessionTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/19.
+//
+
+#import <XCTest/XCTest.h>
+#import <time.h>
+#import "TJPLightweightSessionPool.h"
+#import "TJPConcreteSession.h"
+#import "TJPMockFinalVersionTCPServer.h"
+#import "TJPNetworkConfig.h"
+
+static const uint16_t kStandbyServerPort = 54340;
+
+@interface TJPStandbySessionTests : XCTestCase
+
+@property (nonatomic, strong) TJPMockFinalVersionTCPServer *server;
+@property (nonatomic, strong) TJPLightweightSessionPool *pool;
+@property (nonatomic, strong) TJPNetworkConfig *config;
+
+@end
+
+@implementation TJPStandbySessionTests
+
+- (void)setUp {
+    self.server = [[TJPMockFinalVersionTCPServer alloc] init];
+    [self.server startWithPort:kStandbyServerPort];
+
+    self.config = [TJPNetworkConfig configWithHost:@"127.0.0.1" port:kStandbyServerPort maxRetry:0 heartbeat:60.0];
+
+    TJPSessionPoolConfig poolConfig = {
+        .maxPoolSize = 3,
+        .maxIdleTime = 180,
+        .cleanupInterval = 30,
+        .maxReuseCount = 30,
+        .maxStandbyCount = 2
+    };
+    self.pool = [[TJPLightweightSessionPool alloc] init];
+    [self.pool startWithConfig:poolConfig];
+}
+
+- (void)tearDown {
+    [self.pool stop];
+    [self.server stop];
+    self.pool = nil;
+    self.server = nil;
+}
+
+/// 运行RunLoop直到条件满足或超时
+- (BOOL)waitUntil:(BOOL (^)(void))condition timeout:(NSTimeInterval)timeout {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition() && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.005]];
+    }
+    return condition();
+}
+
+#pragma mark - 功能测试
+- (void)testStandbyKeepsMinimumReadySession {
+    [self.pool enableStandbyForType:TJPSessionTypeChat withConfig:self.config];
+
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeChat] >= 1;
+    } timeout:5.0], @"待命会话应完成连接和握手");
+    XCTAssertEqual([self.pool getStandbyTargetForType:TJPSessionTypeChat], 1, @"没有获取记录时保留1个");
+    XCTAssertEqual([self.pool getStandbyTargetForType:TJPSessionTypeMedia], 0, @"未启用的类型没有待命会话");
+    XCTAssertEqual([self.pool getPoolStats].standbySessions, 1);
+}
+
+- (void)testStandbyIgnoredForDifferentHost {
+    [self.pool enableStandbyForType:TJPSessionTypeChat withConfig:self.config];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeChat] >= 1;
+    } timeout:5.0]);
+
+    TJPNetworkConfig *otherConfig = [TJPNetworkConfig configWithHost:@"127.0.0.1" port:kStandbyServerPort + 1 maxRetry:0 heartbeat:60.0];
+    TJPConcreteSession *session = (TJPConcreteSession *)[self.pool acquireSessionForType:TJPSessionTypeChat withConfig:otherConfig];
+    XCTAssertFalse([session isStandbyReady], @"目标主机不同时不取用待命会话");
+    XCTAssertEqual([self.pool getPoolStats].standbyHitCount, 0);
+    [self.pool removeSession:session];
+}
+
+- (void)testDrainAndRebuild {
+    [self.pool enableStandbyForType:TJPSessionTypeSignaling withConfig:self.config];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeSignaling] >= 1;
+    } timeout:5.0]);
+
+    [self.pool drainStandbySessions];
+    XCTAssertEqual([self.pool getPoolStats].standbySessions, 0);
+
+    [self.pool rebuildStandbySessions];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeSignaling] >= 1;
+    } timeout:5.0], @"网络恢复后重建待命会话");
+}
+
+#pragma mark - 基准测试
+- (void)testStandbyRemovesConnectSetupFromAcquire {
+    NSLog(@"\n=== 待命会话获取耗时对比 (获取到可发送) ===");
+
+    // 冷获取: 新建会话 连接并完成版本握手
+    uint64_t start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    TJPConcreteSession *coldSession = (TJPConcreteSession *)[self.pool acquireSessionForType:TJPSessionTypeMedia withConfig:self.config];
+    [coldSession connectToHost:self.config.host port:self.config.port];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [coldSession isStandbyReady];
+    } timeout:5.0]);
+    double coldMs = (double)(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start) / NSEC_PER_MSEC;
+
+    // 待命获取: 会话取出时已连接并完成握手
+    [self.pool enableStandbyForType:TJPSessionTypeChat withConfig:self.config];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeChat] >= 1;
+    } timeout:5.0]);
+
+    start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    TJPConcreteSession *standbySession = (TJPConcreteSession *)[self.pool acquireSessionForType:TJPSessionTypeChat withConfig:self.config];
+    BOOL readyOnAcquire = [standbySession isStandbyReady];
+    double standbyMs = (double)(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start) / NSEC_PER_MSEC;
+
+    NSLog(@"冷获取(建连+握手): %.3f ms", coldMs);
+    NSLog(@"待命获取: %.3f ms, 取出即可发送: %@", standbyMs, readyOnAcquire ? @"是" : @"否");
+
+    XCTAssertTrue(readyOnAcquire);
+    XCTAssertFalse(standbySession.isStandby);
+    XCTAssertEqual([self.pool getPoolStats].standbyHitCount, 1);
+    XCTAssertLessThan(standbyMs, coldMs);
+
+    // 被取走的待命会话随后补充
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self.pool getReadyStandbyCountForType:TJPSessionTypeChat] >= 1;
+    } timeout:5.0], @"取用后应补充待命会话");
+
+    [self.pool removeSession:coldSession];
+    [self.pool removeSession:standbySession];
+}
+
+@end
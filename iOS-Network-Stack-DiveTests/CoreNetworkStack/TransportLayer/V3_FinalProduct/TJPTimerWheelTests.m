@@ -0,0 +1,228 @@
+//
+//  TJPTimerWheelTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/11.
+//
+
+#import <XCTest/XCTest.h>
+#import "TJPTimerWheel.h"
+
+static const NSUInteger kTimerBenchmarkCount = 10000;       // 基准测试待确认消息数
+static const NSTimeInterval kTimerBenchmarkInterval = 10;   // 与默认重传间隔一致
+
+@interface TJPTimerWheelTests : XCTestCase
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) TJPTimerWheel *wheel;
+@property (nonatomic, strong) NSMutableArray<NSString *> *expiredKeys;
+@property (nonatomic, assign) NSUInteger expirationCallbacks;
+
+@end
+
+@implementation TJPTimerWheelTests
+
+- (void)setUp {
+    self.queue = dispatch_queue_create("com.tjp.timerWheelTests", DISPATCH_QUEUE_SERIAL);
+    self.wheel = [[TJPTimerWheel alloc] initWithTickInterval:0.1 slotCount:8 queue:self.queue];
+    self.expiredKeys = [NSMutableArray array];
+    self.expirationCallbacks = 0;
+    
+    __weak typeof(self) weakSelf = self;
+    self.wheel.expirationHandler = ^(NSArray<NSString *> *expiredKeys) {
+        weakSelf.expirationCallbacks++;
+        [weakSelf.expiredKeys addObjectsFromArray:expiredKeys];
+    };
+}
+
+- (void)tearDown {
+    dispatch_sync(self.queue, ^{
+        [self.wheel cancelAll];
+    });
+    self.wheel = nil;
+}
+
+- (void)onQueue:(dispatch_block_t)block {
+    dispatch_sync(self.queue, block);
+}
+
+#pragma mark - 功能测试
+- (void)testExpiresAtDeadlineTick {
+    [self onQueue:^{
+        [self.wheel scheduleKey:@"a" sequence:1 afterInterval:0.3];
+        [self.wheel scheduleKey:@"b" sequence:2 afterInterval:0.5];
+        XCTAssertEqual(self.wheel.count, 2);
+        
+        [self.wheel advanceTicks:2];
+        XCTAssertEqual(self.expiredKeys.count, 0, @"未到期不应触发");
+        
+        [self.wheel advanceTicks:1];
+        XCTAssertEqualObjects(self.expiredKeys, @[@"a"]);
+        
+        [self.wheel advanceTicks:2];
+        XCTAssertEqualObjects(self.expiredKeys, (@[@"a", @"b"]));
+        XCTAssertEqual(self.wheel.count, 0);
+    }];
+}
+
+- (void)testSameTickExpiresInOneCallback {
+    [self onQueue:^{
+        for (NSUInteger i = 0; i < 5; i++) {
+            [self.wheel scheduleKey:[NSString stringWithFormat:@"msg-%lu", (unsigned long)i] sequence:(uint32_t)i afterInterval:0.2];
+        }
+        [self.wheel advanceTicks:2];
+        XCTAssertEqual(self.expiredKeys.count, 5);
+        XCTAssertEqual(self.expirationCallbacks, 1, @"同一刻度到期的任务应批量回调");
+    }];
+}
+
+- (void)testCancelByKeyAndSequence {
+    [self onQueue:^{
+        [self.wheel scheduleKey:@"a" sequence:10 afterInterval:0.1];
+        [self.wheel scheduleKey:@"b" sequence:11 afterInterval:0.1];
+        [self.wheel scheduleKey:@"c" sequence:12 afterInterval:0.1];
+        
+        XCTAssertTrue([self.wheel cancelKey:@"a"]);
+        XCTAssertFalse([self.wheel cancelKey:@"a"], @"重复取消应返回NO");
+        XCTAssertTrue([self.wheel cancelSequence:11]);
+        XCTAssertFalse([self.wheel containsKey:@"b"]);
+        XCTAssertFalse([self.wheel cancelSequence:99]);
+        
+        [self.wheel advanceTicks:1];
+        XCTAssertEqualObjects(self.expiredKeys, @[@"c"]);
+    }];
+}
+
+- (void)testRescheduleReplacesExistingEntry {
+    [self onQueue:^{
+        [self.wheel scheduleKey:@"a" sequence:1 afterInterval:0.1];
+        [self.wheel scheduleKey:@"a" sequence:2 afterInterval:0.4];
+        XCTAssertEqual(self.wheel.count, 1);
+        XCTAssertFalse([self.wheel cancelSequence:1], @"旧序列号索引应随替换移除");
+        
+        [self.wheel advanceTicks:1];
+        XCTAssertEqual(self.expiredKeys.count, 0);
+        [self.wheel advanceTicks:3];
+        XCTAssertEqualObjects(self.expiredKeys, @[@"a"]);
+    }];
+}
+
+- (void)testEntriesBeyondOneRevolutionDoNotFireEarly {
+    [self onQueue:^{
+        // 8个槽 2.0秒为20个刻度 绕轮两圈多
+        [self.wheel scheduleKey:@"far" sequence:1 afterInterval:2.0];
+        [self.wheel scheduleKey:@"near" sequence:2 afterInterval:0.4];
+        
+        for (NSUInteger tick = 1; tick < 20; tick++) {
+            [self.wheel advanceTicks:1];
+        }
+        XCTAssertEqualObjects(self.expiredKeys, @[@"near"]);
+        
+        [self.wheel advanceTicks:1];
+        XCTAssertEqualObjects(self.expiredKeys, (@[@"near", @"far"]));
+    }];
+}
+
+- (void)testLargeJumpSweepsEachSlotOnce {
+    [self onQueue:^{
+        for (NSUInteger i = 0; i < 20; i++) {
+            [self.wheel scheduleKey:[NSString stringWithFormat:@"msg-%lu", (unsigned long)i] sequence:(uint32_t)i afterInterval:0.1 * (i + 1)];
+        }
+        [self.wheel advanceTicks:100];
+        XCTAssertEqual(self.expiredKeys.count, 20);
+        XCTAssertEqual(self.expirationCallbacks, 1);
+        XCTAssertEqual(self.wheel.count, 0);
+    }];
+}
+
+- (void)testHandlerMayRescheduleExpiredKey {
+    __weak typeof(self) weakSelf = self;
+    self.wheel.expirationHandler = ^(NSArray<NSString *> *expiredKeys) {
+        [weakSelf.expiredKeys addObjectsFromArray:expiredKeys];
+        for (NSString *key in expiredKeys) {
+            [weakSelf.wheel scheduleKey:key sequence:1 afterInterval:0.1];
+        }
+    };
+    [self onQueue:^{
+        [self.wheel scheduleKey:@"retry" sequence:1 afterInterval:0.1];
+        [self.wheel advanceTicks:1];
+        [self.wheel advanceTicks:1];
+        XCTAssertEqualObjects(self.expiredKeys, (@[@"retry", @"retry"]), @"回调中重新安排应在下一刻度触发");
+        XCTAssertTrue([self.wheel containsKey:@"retry"]);
+    }];
+}
+
+- (void)testTickSourceFiresOnQueue {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"时间轮刻度触发"];
+    self.wheel.expirationHandler = ^(NSArray<NSString *> *expiredKeys) {
+        [expectation fulfill];
+    };
+    [self onQueue:^{
+        [self.wheel scheduleKey:@"a" sequence:1 afterInterval:0.2];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+#pragma mark - 基准测试
+- (void)testRetransmissionTimerBenchmark {
+    NSLog(@"\n=== 重传计时器基准测试 (%lu 条待确认消息) ===", (unsigned long)kTimerBenchmarkCount);
+    NSMutableArray<NSString *> *messageIds = [NSMutableArray arrayWithCapacity:kTimerBenchmarkCount];
+    for (NSUInteger i = 0; i < kTimerBenchmarkCount; i++) {
+        [messageIds addObject:[[NSUUID UUID] UUIDString]];
+    }
+    
+    // 旧实现: 每条消息一个dispatch_source 收到ACK时取消
+    __block CFTimeInterval gcdScheduleDuration = 0;
+    __block CFTimeInterval gcdCancelDuration = 0;
+    [self onQueue:^{
+        NSMutableDictionary<NSString *, dispatch_source_t> *timers = [NSMutableDictionary dictionaryWithCapacity:kTimerBenchmarkCount];
+        uint64_t interval = (uint64_t)(kTimerBenchmarkInterval * NSEC_PER_SEC);
+        
+        CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+        for (NSString *messageId in messageIds) {
+            dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+            dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), DISPATCH_TIME_FOREVER, NSEC_PER_SEC / 10);
+            dispatch_source_set_event_handler(timer, ^{
+                (void)messageId;
+            });
+            timers[messageId] = timer;
+            dispatch_resume(timer);
+        }
+        gcdScheduleDuration = CFAbsoluteTimeGetCurrent() - start;
+        
+        start = CFAbsoluteTimeGetCurrent();
+        for (NSString *messageId in messageIds) {
+            dispatch_source_cancel(timers[messageId]);
+            [timers removeObjectForKey:messageId];
+        }
+        gcdCancelDuration = CFAbsoluteTimeGetCurrent() - start;
+    }];
+    
+    // 新实现: 时间轮
+    __block CFTimeInterval wheelScheduleDuration = 0;
+    __block CFTimeInterval wheelCancelDuration = 0;
+    [self onQueue:^{
+        CFTimeInterval start = CFAbsoluteTimeGetCurrent();
+        uint32_t sequence = 0;
+        for (NSString *messageId in messageIds) {
+            [self.wheel scheduleKey:messageId sequence:sequence++ afterInterval:kTimerBenchmarkInterval];
+        }
+        wheelScheduleDuration = CFAbsoluteTimeGetCurrent() - start;
+        XCTAssertEqual(self.wheel.count, kTimerBenchmarkCount);
+        
+        start = CFAbsoluteTimeGetCurrent();
+        for (NSString *messageId in messageIds) {
+            [self.wheel cancelKey:messageId];
+        }
+        wheelCancelDuration = CFAbsoluteTimeGetCurrent() - start;
+        XCTAssertEqual(self.wheel.count, 0);
+    }];
+    
+    NSLog(@"GCD定时器: 安排 %.2f ms, 取消 %.2f ms", gcdScheduleDuration * 1000, gcdCancelDuration * 1000);
+    NSLog(@"时间轮: 安排 %.2f ms, 取消 %.2f ms", wheelScheduleDuration * 1000, wheelCancelDuration * 1000);
+    NSLog(@"提升倍数: %.2fx", (gcdScheduleDuration + gcdCancelDuration) / (wheelScheduleDuration + wheelCancelDuration));
+    
+    XCTAssertLessThan(wheelScheduleDuration + wheelCancelDuration, gcdScheduleDuration + gcdCancelDuration);
+}
+
+@end
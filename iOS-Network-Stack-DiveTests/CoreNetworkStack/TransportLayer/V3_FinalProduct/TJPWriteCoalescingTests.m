@@ -0,0 +1,201 @@
+//
+//  TJPWriteCoalescingTests.m
+//  iOS-Network-Stack-DiveTests
+//
+//  Created by 唐佳鹏 on 2025/6/9.
+//
+
+#import <XCTest/XCTest.h>
+#import <GCDAsyncSocket.h>
+#import <os/lock.h>
+#import "TJPConnectionManager.h"
+#import "TJPNetworkDefine.h"
+
+static const uint16_t kCoalescingServerPort = 54350;
+
+/// 写合并内部状态 仅测试使用
+@interface TJPConnectionManager (TJPWriteCoalescingTesting)
+
+@property (nonatomic, strong) dispatch_queue_t socketQueue;
+@property (nonatomic, strong, nullable) dispatch_data_t coalescingData;
+@property (nonatomic, assign) NSUInteger coalescedFrameCount;
+@property (nonatomic, assign) NSUInteger queuedSocketWrites;
+
+@end
+
+@interface TJPWriteCoalescingTests : XCTestCase <GCDAsyncSocketDelegate>
+
+@property (nonatomic, strong) GCDAsyncSocket *listenSocket;
+@property (nonatomic, strong) NSMutableArray<GCDAsyncSocket *> *acceptedSockets;
+@property (nonatomic, strong) dispatch_queue_t serverQueue;
+@property (nonatomic, assign) NSUInteger receivedBytes;
+@property (nonatomic, strong) TJPConnectionManager *manager;
+
+@end
+
+@implementation TJPWriteCoalescingTests {
+    os_unfair_lock _receivedLock;
+}
+
+- (void)setUp {
+    _receivedLock = OS_UNFAIR_LOCK_INIT;
+    self.acceptedSockets = [NSMutableArray array];
+    self.serverQueue = dispatch_queue_create("com.tjp.test.coalescingServer", DISPATCH_QUEUE_SERIAL);
+    self.listenSocket = [[GCDAsyncSocket alloc] initWithDelegate:self delegateQueue:self.serverQueue];
+    NSError *error = nil;
+    XCTAssertTrue([self.listenSocket acceptOnPort:kCoalescingServerPort error:&error], @"%@", error);
+
+    self.manager = [[TJPConnectionManager alloc] initWithDelegateQueue:nil];
+    self.manager.writeCoalescingEnabled = YES;
+    [self.manager connectToHost:@"127.0.0.1" port:kCoalescingServerPort];
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return self.manager.isConnected;
+    } timeout:5.0]);
+}
+
+- (void)tearDown {
+    [self.manager disconnect];
+    self.manager = nil;
+    dispatch_sync(self.serverQueue, ^{
+        for (GCDAsyncSocket *socket in self.acceptedSockets) {
+            [socket disconnect];
+        }
+        [self.acceptedSockets removeAllObjects];
+    });
+    [self.listenSocket disconnect];
+    self.listenSocket = nil;
+}
+
+#pragma mark - GCDAsyncSocketDelegate
+- (void)socket:(GCDAsyncSocket *)sock didAcceptNewSocket:(GCDAsyncSocket *)newSocket {
+    [self.acceptedSockets addObject:newSocket];
+    [newSocket readDataWithTimeout:-1 tag:0];
+}
+
+- (void)socket:(GCDAsyncSocket *)sock didReadData:(NSData *)data withTag:(long)tag {
+    os_unfair_lock_lock(&_receivedLock);
+    _receivedBytes += data.length;
+    os_unfair_lock_unlock(&_receivedLock);
+    [sock readDataWithTimeout:-1 tag:0];
+}
+
+#pragma mark - Helpers
+- (NSUInteger)serverReceivedBytes {
+    os_unfair_lock_lock(&_receivedLock);
+    NSUInteger bytes = _receivedBytes;
+    os_unfair_lock_unlock(&_receivedLock);
+    return bytes;
+}
+
+/// 运行RunLoop直到条件满足或超时
+- (BOOL)waitUntil:(BOOL (^)(void))condition timeout:(NSTimeInterval)timeout {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition() && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.005]];
+    }
+    return condition();
+}
+
+- (dispatch_data_t)frameWithLength:(NSUInteger)length {
+    NSMutableData *frame = [NSMutableData dataWithLength:length];
+    return dispatch_data_create(frame.bytes, frame.length, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+}
+
+- (NSUInteger)pendingFrameCount {
+    __block NSUInteger count = 0;
+    dispatch_sync(self.manager.socketQueue, ^{
+        count = self.manager.coalescedFrameCount;
+    });
+    return count;
+}
+
+#pragma mark - 功能测试
+- (void)testFramesCoalescedWithinWindow {
+    self.manager.writeCoalescingInterval = 10.0;
+    for (long tag = 1; tag <= 3; tag++) {
+        [self.manager sendPacketData:[self frameWithLength:100] withTimeout:-1 tag:tag];
+    }
+
+    XCTAssertEqual([self pendingFrameCount], 3, @"窗口内的帧应合并等待");
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqual([self serverReceivedBytes], 0, @"窗口未到且未达阈值时不应写出");
+}
+
+- (void)testFlushOnByteThreshold {
+    self.manager.writeCoalescingInterval = 10.0;
+    self.manager.writeCoalescingMaxBytes = 1024;
+    [self.manager sendPacketData:[self frameWithLength:400] withTimeout:-1 tag:1];
+    [self.manager sendPacketData:[self frameWithLength:400] withTimeout:-1 tag:2];
+    XCTAssertEqual([self pendingFrameCount], 2);
+
+    [self.manager sendPacketData:[self frameWithLength:400] withTimeout:-1 tag:3];
+    XCTAssertEqual([self pendingFrameCount], 0, @"达到字节阈值应立即写出");
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self serverReceivedBytes] == 1200;
+    } timeout:2.0]);
+}
+
+- (void)testFlushOnTimer {
+    self.manager.writeCoalescingInterval = 0.05;
+    [self.manager sendPacketData:[self frameWithLength:200] withTimeout:-1 tag:1];
+    [self.manager sendPacketData:[self frameWithLength:200] withTimeout:-1 tag:2];
+    XCTAssertEqual([self pendingFrameCount], 2);
+
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self serverReceivedBytes] == 400;
+    } timeout:2.0], @"窗口到期后应写出");
+    XCTAssertEqual([self pendingFrameCount], 0);
+}
+
+- (void)testUrgentBypassesWindow {
+    self.manager.writeCoalescingInterval = 10.0;
+    [self.manager sendPacketData:[self frameWithLength:300] withTimeout:-1 tag:1];
+    [self.manager sendPacketData:[self frameWithLength:50] withTimeout:-1 tag:2 priority:TJPMessagePriorityUrgent];
+
+    XCTAssertEqual([self pendingFrameCount], 0, @"紧急消息不等待窗口");
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self serverReceivedBytes] == 350;
+    } timeout:2.0], @"已合并的帧随紧急消息一并写出");
+}
+
+- (void)testDisconnectDropsPendingWrites {
+    self.manager.writeCoalescingInterval = 0.2;
+    [self.manager sendPacketData:[self frameWithLength:100] withTimeout:-1 tag:1];
+    [self.manager sendPacketData:[self frameWithLength:100] withTimeout:-1 tag:2];
+    XCTAssertEqual([self pendingFrameCount], 2);
+
+    [self.manager disconnect];
+    XCTAssertEqual([self pendingFrameCount], 0);
+    __block dispatch_data_t pendingData = nil;
+    dispatch_sync(self.manager.socketQueue, ^{
+        pendingData = self.manager.coalescingData;
+    });
+    XCTAssertNil(pendingData, @"断开时应丢弃未写出的帧");
+
+    // 原窗口到期后也不应再写出
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.4]];
+    XCTAssertEqual([self serverReceivedBytes], 0);
+}
+
+- (void)testVectoredWriteSpansMultipleIovBatches {
+    // 分段数超过单次writev上限 应分批直接写出 不退回socket写队列
+    self.manager.writeCoalescingEnabled = NO;
+    const NSUInteger regionCount = TJP_MAX_WRITE_IOV_COUNT * 2 + 7;
+    const NSUInteger regionLength = 8;
+    dispatch_data_t data = dispatch_data_empty;
+    for (NSUInteger i = 0; i < regionCount; i++) {
+        data = dispatch_data_create_concat(data, [self frameWithLength:regionLength]);
+    }
+    [self.manager sendPacketData:data withTimeout:-1 tag:1];
+
+    __block NSUInteger queuedWrites = NSUIntegerMax;
+    dispatch_sync(self.manager.socketQueue, ^{
+        queuedWrites = self.manager.queuedSocketWrites;
+    });
+    XCTAssertEqual(queuedWrites, 0, @"全部分段应由writev写出");
+    XCTAssertTrue([self waitUntil:^BOOL{
+        return [self serverReceivedBytes] == regionCount * regionLength;
+    } timeout:2.0]);
+}
+
+@end